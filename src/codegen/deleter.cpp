@@ -87,7 +87,7 @@ void Deleter::Delete(uint32_t tile_group_id, uint32_t tuple_offset) {
   // We've acquired ownership of the latest version, and it isn't locked by any
   // other threads. Now, let's insert an empty version.
 
-  ItemPointer new_location = table_->InsertEmptyVersion();
+  ItemPointer new_location = table_->InsertEmptyVersion(old_location);
 
   // Insertion into the table may fail. PerformDelete() should not be called if
   // the insertion fails. At this point, we've acquired a write lock on the
@@ -20,6 +20,7 @@
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
 #include "storage/tile.h"
+#include "storage/tuple.h"
 
 namespace peloton {
 namespace codegen {
@@ -29,9 +30,21 @@ void Inserter::Init(storage::DataTable *table,
   PELOTON_ASSERT(table && executor_context);
   table_ = table;
   executor_context_ = executor_context;
+
+  // the partition or page of a tuple is only known once its values are
+  // stored, so the tuples of partitioned and clustered tables are built in
+  // a scratch tuple first
+  scratch_tuple_ = nullptr;
+  if (table_->IsPlacedByKey()) {
+    scratch_tuple_ = new storage::Tuple(table_->GetSchema(), true);
+  }
 }
 
 char *Inserter::AllocateTupleStorage() {
+  if (scratch_tuple_ != nullptr) {
+    return scratch_tuple_->GetData();
+  }
+
   location_ = table_->GetEmptyTupleSlot(nullptr);
 
   // Get the tile offset assuming that it is a row store
@@ -44,16 +57,27 @@ char *Inserter::AllocateTupleStorage() {
 }
 
 peloton::type::AbstractPool *Inserter::GetPool() {
+  // varlen values of the scratch tuple are copied into the tile on insert
+  if (scratch_tuple_ != nullptr) {
+    return executor_context_->GetPool();
+  }
+
   // This should be called after AllocateTupleStorage()
   PELOTON_ASSERT(tile_);
   return tile_->GetPool();
 }
 
 void Inserter::Insert() {
-  PELOTON_ASSERT(table_ && executor_context_ && tile_);
+  PELOTON_ASSERT(table_ && executor_context_);
   auto *txn = executor_context_->GetTransaction();
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
 
+  // move the scratch tuple into a slot of its partition or page
+  if (scratch_tuple_ != nullptr) {
+    location_ = table_->GetEmptyTupleSlot(scratch_tuple_);
+  }
+  PELOTON_ASSERT(location_.IsNull() == false);
+
   ContainerTuple<storage::TileGroup> tuple(
       table_->GetTileGroupById(location_.block).get(), location_.offset);
   ItemPointer *index_entry_ptr = nullptr;
@@ -69,6 +93,7 @@ void Inserter::Insert() {
 void Inserter::TearDown() {
   // Updater object does not destruct its own data structures
   tile_.reset();
+  delete scratch_tuple_;
 }
 
 }  // namespace codegen
@@ -57,8 +57,8 @@ llvm::Value *Table::GetZoneMapManager(CodeGen &codegen) const {
 // num_tile_groups = GetTileGroupCount(table_ptr)
 //
 // for (; tile_group_idx < num_tile_groups; ++tile_group_idx) {
+//   tile_group_ptr := GetTileGroup(table_ptr, tile_group_idx)
 //   if (ShouldScanTileGroup(predicate_array, tile_group_idx)) {
-//      tile_group_ptr := GetTileGroup(table_ptr, tile_group_idx)
 //      consumer.TileGroupStart(tile_group_ptr);
 //      tile_group.TidScan(tile_group_ptr, column_layouts, vector_size,
 //                         consumer);
@@ -103,10 +103,9 @@ void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
     tile_group_idx = loop.GetLoopVar(0);
     llvm::Value *tile_group_ptr =
         GetTileGroup(codegen, table_ptr, tile_group_idx);
-    llvm::Value *tile_group_id =
-        tile_group_.GetTileGroupId(codegen, tile_group_ptr);
 
-    // Check zone map
+    // Check zone map, which also rules out tile groups dropped after
+    // compaction
     llvm::Value *cond = codegen.Call(
         ZoneMapManagerProxy::ShouldScanTileGroup,
         {GetZoneMapManager(codegen), predicate_array,
@@ -114,6 +113,9 @@ void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
 
     codegen::lang::If should_scan_tilegroup{codegen, cond};
     {
+      llvm::Value *tile_group_id =
+          tile_group_.GetTileGroupId(codegen, tile_group_ptr);
+
       // Inform the consumer that we're starting iteration over the tile group
       consumer.TileGroupStart(codegen, tile_group_id, tile_group_ptr);
 
@@ -39,6 +39,14 @@ void Updater::Init(storage::DataTable *table,
       new TargetList(target_vector, target_vector + target_vector_size);
 
   statement_write_set_ = new WriteSet();
+
+  // an update of the partition or cluster key may move a row to another
+  // partition or page, so the new rows of such tables are built in a
+  // scratch tuple first
+  scratch_tuple_ = nullptr;
+  if (table_->IsPlacedByKey()) {
+    scratch_tuple_ = new storage::Tuple(table_->GetSchema(), true);
+  }
 }
 
 char *Updater::GetDataPtr(uint32_t tile_group_id, uint32_t tuple_offset) {
@@ -77,7 +85,7 @@ char *Updater::Prepare(uint32_t tile_group_id, uint32_t tuple_offset) {
   if (acquired_ownership_ == false)
     return nullptr;
 
-  new_location_ = table_->AcquireVersion();
+  new_location_ = table_->AcquireVersion(old_location_);
   return GetDataPtr(new_location_.block, new_location_.offset);
 }
 
@@ -106,7 +114,7 @@ char *Updater::PreparePK(uint32_t tile_group_id, uint32_t tuple_offset) {
 
   // Delete the old tuple
   ItemPointer old_location(tile_group_id, tuple_offset);
-  ItemPointer empty_location = table_->InsertEmptyVersion();
+  ItemPointer empty_location = table_->InsertEmptyVersion(old_location);
   if (empty_location.IsNull() == true && acquired_ownership_ == true) {
     TransactionRuntime::YieldOwnership(*txn, tile_group_header,
                                        tuple_offset);
@@ -117,11 +125,20 @@ char *Updater::PreparePK(uint32_t tile_group_id, uint32_t tuple_offset) {
   AddToStatementWriteSet(empty_location);
 
   // Get the tuple data pointer for a new version
+  if (scratch_tuple_ != nullptr) {
+    tile_.reset();
+    return scratch_tuple_->GetData();
+  }
   new_location_ = table_->GetEmptyTupleSlot(nullptr);
   return GetDataPtr(new_location_.block, new_location_.offset);
 }
 
 peloton::type::AbstractPool *Updater::GetPool() {
+  // varlen values of the scratch tuple are copied into the tile on insert
+  if (scratch_tuple_ != nullptr && tile_ == nullptr) {
+    return executor_context_->GetPool();
+  }
+
   // This should be called after Prepare() or PreparePK()
   PELOTON_ASSERT(tile_);
   return tile_->GetPool();
@@ -170,9 +187,14 @@ void Updater::UpdatePK() {
             table_->GetName().c_str(), table_->GetDatabaseOid(),
             table_->GetOid());
   auto *txn = executor_context_->GetTransaction();
-  auto tile_group = table_->GetTileGroupById(new_location_.block).get();
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
 
+  // move the scratch tuple into a slot of its partition or page
+  if (scratch_tuple_ != nullptr) {
+    new_location_ = table_->GetEmptyTupleSlot(scratch_tuple_);
+  }
+  auto tile_group = table_->GetTileGroupById(new_location_.block).get();
+
   // Insert a new tuple
   ContainerTuple<storage::TileGroup> tuple(tile_group, new_location_.offset);
   ItemPointer *index_entry_ptr = nullptr;
@@ -192,6 +214,7 @@ void Updater::TearDown() {
   tile_.reset();
   delete target_list_;
   delete statement_write_set_;
+  delete scratch_tuple_;
 }
 
 }  // namespace codegen
@@ -12,6 +12,7 @@
 
 #include "common/init.h"
 
+#include <algorithm>
 #include <gflags/gflags.h>
 #include <google/protobuf/stubs/common.h>
 
@@ -22,6 +23,8 @@
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
 #include "settings/settings_manager.h"
+#include "storage/backend_manager.h"
+#include "storage/tile_group_factory.h"
 #include "threadpool/mono_queue_pool.h"
 #include "tuning/index_tuner.h"
 #include "tuning/layout_tuner.h"
@@ -51,11 +54,25 @@ void PelotonInit::Initialize() {
   // start parallel execution pool
   threadpool::MonoQueuePool::GetExecutionInstance().Startup();
 
-  //int parallelism = (CONNECTION_THREAD_COUNT + 3) / 4;
-  //storage::DataTable::SetActiveTileGroupCount(parallelism);
-  //storage::DataTable::SetActiveIndirectionArrayCount(parallelism);
-  storage::DataTable::SetActiveTileGroupCount(1);
-  storage::DataTable::SetActiveIndirectionArrayCount(1);
+  // one insert lane per connection thread
+  size_t parallelism = std::max<size_t>(CONNECTION_THREAD_COUNT, 1);
+  storage::DataTable::SetActiveTileGroupCount(parallelism);
+  storage::DataTable::SetActiveIndirectionArrayCount(parallelism);
+
+  if (settings::SettingsManager::GetBool(settings::SettingId::tile_huge_pages)) {
+    storage::TileGroupFactory::SetDefaultBackendType(BackendType::HUGE_PAGE);
+  }
+
+  // tiles in the data file take precedence over huge pages
+  auto data_file_directory =
+      settings::SettingsManager::GetString(settings::SettingId::data_file_directory);
+  if (data_file_directory.empty() == false) {
+    size_t data_file_size =
+        settings::SettingsManager::GetInt(settings::SettingId::data_file_size);
+    storage::BackendManager::GetInstance().OpenDataFile(
+        data_file_directory, data_file_size * 1024 * 1024);
+    storage::TileGroupFactory::SetDefaultBackendType(BackendType::SSD);
+  }
 
   // start epoch.
   concurrency::EpochManagerFactory::GetInstance().StartEpoch();
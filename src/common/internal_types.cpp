@@ -170,6 +170,8 @@ std::string BackendTypeToString(BackendType type) {
       return "SSD";
     case (BackendType::HDD):
       return "HDD";
+    case (BackendType::HUGE_PAGE):
+      return "HUGE_PAGE";
     case (BackendType::INVALID):
       return "INVALID";
     default: {
@@ -192,6 +194,8 @@ BackendType StringToBackendType(const std::string &str) {
     return BackendType::SSD;
   } else if (str == "HDD") {
     return BackendType::HDD;
+  } else if (str == "HUGE_PAGE") {
+    return BackendType::HUGE_PAGE;
   } else {
     throw ConversionException(StringUtil::Format(
         "No BackendType conversion from string '%s'", str.c_str()));
@@ -204,6 +208,47 @@ std::ostream &operator<<(std::ostream &os, const BackendType &type) {
   return os;
 }
 
+//===--------------------------------------------------------------------===//
+// PartitionType <--> String Utilities
+//===--------------------------------------------------------------------===//
+
+std::string PartitionTypeToString(PartitionType type) {
+  switch (type) {
+    case (PartitionType::RANGE):
+      return "RANGE";
+    case (PartitionType::HASH):
+      return "HASH";
+    case (PartitionType::INVALID):
+      return "INVALID";
+    default: {
+      throw ConversionException(StringUtil::Format(
+          "No string conversion for PartitionType value '%d'",
+          static_cast<int>(type)));
+    }
+  }
+  return ("INVALID");
+}
+
+PartitionType StringToPartitionType(const std::string &str) {
+  std::string upper_str = StringUtil::Upper(str);
+  if (upper_str == "INVALID") {
+    return PartitionType::INVALID;
+  } else if (upper_str == "RANGE") {
+    return PartitionType::RANGE;
+  } else if (upper_str == "HASH") {
+    return PartitionType::HASH;
+  } else {
+    throw ConversionException(StringUtil::Format(
+        "No PartitionType conversion from string '%s'", upper_str.c_str()));
+  }
+  return PartitionType::INVALID;
+}
+
+std::ostream &operator<<(std::ostream &os, const PartitionType &type) {
+  os << PartitionTypeToString(type);
+  return os;
+}
+
 //===--------------------------------------------------------------------===//
 // Value <--> String Utilities
 //===--------------------------------------------------------------------===//
@@ -1156,6 +1201,9 @@ std::string IndexTypeToString(IndexType type) {
     case IndexType::ART: {
       return "ART";
     }
+    case IndexType::BPLUSTREE: {
+      return "BPLUSTREE";
+    }
     default: {
       throw ConversionException(
           StringUtil::Format("No string conversion for IndexType value '%d'",
@@ -1178,6 +1226,8 @@ IndexType StringToIndexType(const std::string &str) {
     return IndexType::SKIPLIST;
   } else if (upper_str == "ART") {
     return IndexType::ART;
+  } else if (upper_str == "BPLUSTREE") {
+    return IndexType::BPLUSTREE;
   } else {
     throw ConversionException(StringUtil::Format(
         "No IndexType conversion from string '%s'", upper_str.c_str()));
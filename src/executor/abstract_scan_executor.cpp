@@ -13,6 +13,7 @@
 #include "executor/abstract_scan_executor.h"
 
 #include "common/internal_types.h"
+#include "executor/blocked_bloom_filter.h"
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
 #include "expression/abstract_expression.h"
@@ -48,8 +49,76 @@ bool AbstractScanExecutor::DInit() {
 
   column_ids_ = std::move(node.GetColumnIds());
 
+  num_tuples_produced_ = 0;
+
+  return true;
+}
+
+/**
+ * @brief Stops at tile granularity once the tuple budget is spent, so that
+ * a scan under a LIMIT reads no further tile groups than it needs.
+ * @return true on success, false otherwise.
+ */
+bool AbstractScanExecutor::DExecute() {
+  if (num_tuples_produced_ >= tuple_budget_) {
+    LOG_TRACE("Tuple budget of %lu spent", tuple_budget_);
+    return false;
+  }
+
+  if (DScan() == false) {
+    return false;
+  }
+  num_tuples_produced_ += GetOutputInfo()->GetTupleCount();
   return true;
 }
 
+void AbstractScanExecutor::SetKeyFilter(
+    const BlockedBloomFilter *key_filter,
+    const std::vector<oid_t> &key_column_ids) {
+  key_filter_ = nullptr;
+  key_filter_column_ids_.clear();
+  if (key_filter == nullptr) {
+    return;
+  }
+
+  // The output columns of a table scan are the table columns column_ids_
+  for (auto column_id : key_column_ids) {
+    if (column_id >= column_ids_.size()) {
+      return;
+    }
+    key_filter_column_ids_.push_back(column_ids_[column_id]);
+  }
+  key_filter_ = key_filter;
+}
+
+bool AbstractScanExecutor::PassesKeyFilter(storage::TileGroup *tile_group,
+                                           oid_t tuple_id) const {
+  if (key_filter_ == nullptr) {
+    return true;
+  }
+  // hashed as ContainerTuple hashes the keys of the filter
+  size_t hash = 0;
+  for (auto column_id : key_filter_column_ids_) {
+    tile_group->GetValue(tuple_id, column_id).HashCombine(hash);
+  }
+  return key_filter_->MayContain(hash);
+}
+
+void AbstractScanExecutor::FilterKeys(storage::TileGroup *tile_group,
+                                      std::vector<oid_t> &position_list) const {
+  if (key_filter_ == nullptr) {
+    return;
+  }
+  size_t match_count = 0;
+  for (auto tuple_id : position_list) {
+    if (PassesKeyFilter(tile_group, tuple_id)) {
+      position_list[match_count++] = tuple_id;
+    }
+  }
+  LOG_TRACE("Key filter kept %lu of %lu tuples", match_count,
+            position_list.size());
+  position_list.resize(match_count);
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -121,15 +121,10 @@ bool AggregateExecutor::DExecute() {
       }
     }
 
-    LOG_TRACE("Looping over tile..");
+    LOG_TRACE("Advancing over tile..");
 
-    for (oid_t tuple_id : *tile) {
-      std::unique_ptr<ContainerTuple<LogicalTile>> cur_tuple(
-          new ContainerTuple<LogicalTile>(tile.get(), tuple_id));
-
-      if (aggregator->Advance(cur_tuple.get()) == false) {
-        return false;
-      }
+    if (aggregator->AdvanceTile(std::move(tile)) == false) {
+      return false;
     }
     LOG_TRACE("Finished processing logical tile");
   }
@@ -0,0 +1,595 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// aggregation_hash_table.cpp
+//
+// Identification: src/executor/aggregation_hash_table.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/aggregation_hash_table.h"
+
+#include <cstring>
+#include <limits>
+
+#include "common/abstract_tuple.h"
+#include "common/exception.h"
+#include "expression/abstract_expression.h"
+#include "planner/aggregate_plan.h"
+#include "type/value_factory.h"
+#include "util/hash_util.h"
+
+namespace peloton {
+namespace executor {
+
+namespace {
+
+const size_t INITIAL_SLOT_COUNT = 256;
+
+// what follows in a spill file
+const char SPILLED_ENTRY = 'E';
+const char SPILLED_DISTINCT_VALUE = 'D';
+
+bool IsFixedWidth(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+    case type::TypeId::TIMESTAMP:
+    case type::TypeId::DATE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsInteger(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// whether the aggregate keeps a state for values of the type
+bool IsAggregateType(ExpressionType agg_type, type::TypeId type_id) {
+  switch (agg_type) {
+    case ExpressionType::AGGREGATE_COUNT:
+    case ExpressionType::AGGREGATE_COUNT_STAR:
+      return IsFixedWidth(type_id);
+    case ExpressionType::AGGREGATE_SUM:
+    case ExpressionType::AGGREGATE_AVG:
+      return IsInteger(type_id) || type_id == type::TypeId::DECIMAL;
+    case ExpressionType::AGGREGATE_MIN:
+    case ExpressionType::AGGREGATE_MAX:
+      return IsInteger(type_id) || type_id == type::TypeId::DECIMAL ||
+             type_id == type::TypeId::TIMESTAMP ||
+             type_id == type::TypeId::DATE;
+    default:
+      return false;
+  }
+}
+
+// whether the sum fits the integer type, as checked by Value::Add
+bool FitsIn(type::TypeId type_id, int64_t value) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+      return value >= std::numeric_limits<int8_t>::min() &&
+             value <= std::numeric_limits<int8_t>::max();
+    case type::TypeId::SMALLINT:
+      return value >= std::numeric_limits<int16_t>::min() &&
+             value <= std::numeric_limits<int16_t>::max();
+    case type::TypeId::INTEGER:
+      return value >= std::numeric_limits<int32_t>::min() &&
+             value <= std::numeric_limits<int32_t>::max();
+    default:
+      return true;
+  }
+}
+
+}  // namespace
+
+bool AggregationHashTable::IsSupported(const planner::AggregatePlan *node,
+                                       const AbstractTuple *tuple,
+                                       size_t num_input_columns,
+                                       std::vector<type::TypeId> &input_types) {
+  for (auto &term : node->GetUniqueAggTerms()) {
+    // an aggregate without an expression advances on the integer 1
+    auto type_id = term.expression == nullptr
+                       ? type::TypeId::INTEGER
+                       : term.expression->GetValueType();
+    if (IsAggregateType(term.aggtype, type_id) == false) {
+      return false;
+    }
+  }
+
+  input_types.clear();
+  for (oid_t column_id = 0; column_id < num_input_columns; column_id++) {
+    auto type_id = tuple->GetValue(column_id).GetTypeId();
+    if (IsFixedWidth(type_id) == false) {
+      return false;
+    }
+    input_types.push_back(type_id);
+  }
+  return true;
+}
+
+AggregationHashTable::AggregationHashTable(
+    const planner::AggregatePlan *node,
+    const std::vector<type::TypeId> &input_types,
+    ExecutorContext *executor_context)
+    : node_(node),
+      executor_context_(executor_context),
+      input_types_(input_types),
+      key_size_(0),
+      tuple_size_(0) {
+  for (auto type_id : input_types_) {
+    column_offsets_.push_back(tuple_size_);
+    tuple_size_ += type::Type::GetTypeSize(type_id);
+  }
+  for (oid_t column_id : node_->GetGroupbyColIds()) {
+    key_offsets_.push_back(key_size_);
+    key_size_ += type::Type::GetTypeSize(input_types_[column_id]);
+  }
+
+  // the states are aligned on 8 bytes
+  tuple_offset_ = sizeof(uint64_t) + key_size_;
+  states_offset_ = (tuple_offset_ + tuple_size_ + 7) & ~static_cast<size_t>(7);
+  entry_size_ = states_offset_ +
+                node_->GetUniqueAggTerms().size() * sizeof(AggregateState);
+
+  distinct_type_offset_ = key_size_ + sizeof(oid_t);
+  distinct_data_offset_ = distinct_type_offset_ + sizeof(type::TypeId);
+  distinct_record_size_ = distinct_data_offset_ + sizeof(uint64_t);
+
+  for (auto &term : node_->GetUniqueAggTerms()) {
+    has_distinct_ = has_distinct_ || term.distinct;
+  }
+
+  key_buffer_.resize(key_size_);
+  distinct_buffer_.resize(distinct_record_size_);
+  pool_.reset(new type::ArenaPool(false));
+  slots_.assign(INITIAL_SLOT_COUNT, Slot{0, nullptr});
+  distinct_slots_.assign(INITIAL_SLOT_COUNT, Slot{0, nullptr});
+}
+
+void AggregationHashTable::Advance(const AbstractTuple *tuple) {
+  auto &group_by_col_ids = node_->GetGroupbyColIds();
+  char *key = key_buffer_.data();
+  for (size_t i = 0; i < group_by_col_ids.size(); i++) {
+    tuple->GetValue(group_by_col_ids[i])
+        .SerializeTo(key + key_offsets_[i], true, nullptr);
+  }
+
+  bool added;
+  char *entry = FindOrAddEntry(Hash(key, key_size_), key, added);
+  if (added) {
+    // keep the first tuple of the group
+    char *first_tuple = entry + tuple_offset_;
+    for (oid_t column_id = 0; column_id < input_types_.size(); column_id++) {
+      tuple->GetValue(column_id)
+          .SerializeTo(first_tuple + column_offsets_[column_id], true,
+                       nullptr);
+    }
+  }
+
+  auto states = GetStates(entry);
+  auto &aggregate_terms = node_->GetUniqueAggTerms();
+  for (oid_t aggno = 0; aggno < aggregate_terms.size(); aggno++) {
+    auto &term = aggregate_terms[aggno];
+    type::Value value = type::ValueFactory::GetIntegerValue(1);
+    if (term.expression != nullptr) {
+      value = term.expression->Evaluate(tuple, nullptr, executor_context_);
+    }
+    if (term.distinct && AddDistinctValue(key, aggno, value) == false) {
+      continue;
+    }
+    CombineState(term.aggtype, states[aggno], MakeState(term.aggtype, value));
+  }
+}
+
+void AggregationHashTable::Merge(const AggregationHashTable &other) {
+  for (auto other_entry : other.entries_) {
+    MergeEntry(other_entry);
+  }
+  for (auto other_distinct_value : other.distinct_values_) {
+    MergeDistinctValue(other_distinct_value);
+  }
+}
+
+void AggregationHashTable::GetFirstTuple(
+    const char *entry, std::vector<type::Value> &values) const {
+  values.clear();
+  const char *first_tuple = entry + tuple_offset_;
+  for (oid_t column_id = 0; column_id < input_types_.size(); column_id++) {
+    values.push_back(type::Value::DeserializeFrom(
+        first_tuple + column_offsets_[column_id], input_types_[column_id],
+        true, nullptr));
+  }
+}
+
+void AggregationHashTable::GetAggregateValues(
+    const char *entry, std::vector<type::Value> &values) const {
+  values.clear();
+  auto states = GetStates(entry);
+  auto &aggregate_terms = node_->GetUniqueAggTerms();
+  for (oid_t aggno = 0; aggno < aggregate_terms.size(); aggno++) {
+    values.push_back(FinalizeState(aggregate_terms[aggno].aggtype,
+                                   states[aggno]));
+  }
+}
+
+void AggregationHashTable::Spill(const std::vector<std::FILE *> &files) {
+  for (auto entry : entries_) {
+    // slots are chosen on the low bits of the hash, files on the high ones
+    auto file = files[(GetHash(entry) >> 32) % files.size()];
+    if (std::fputc(SPILLED_ENTRY, file) == EOF ||
+        std::fwrite(entry, entry_size_, 1, file) != 1) {
+      throw ExecutorException("Failed to spill the groups of an aggregation");
+    }
+  }
+
+  // after the entries, so that the group of a value is there when the value
+  // is loaded
+  for (auto distinct_value : distinct_values_) {
+    const char *record = distinct_value + sizeof(uint64_t);
+    auto file = files[(Hash(record, key_size_) >> 32) % files.size()];
+    if (std::fputc(SPILLED_DISTINCT_VALUE, file) == EOF ||
+        std::fwrite(distinct_value, sizeof(uint64_t) + distinct_record_size_,
+                    1, file) != 1) {
+      throw ExecutorException("Failed to spill the groups of an aggregation");
+    }
+  }
+  Clear();
+}
+
+void AggregationHashTable::Load(std::FILE *file) {
+  std::rewind(file);
+  std::vector<char> entry(entry_size_);
+  std::vector<char> distinct_value(sizeof(uint64_t) + distinct_record_size_);
+  int tag;
+  while ((tag = std::fgetc(file)) != EOF) {
+    if (tag == SPILLED_ENTRY &&
+        std::fread(entry.data(), entry.size(), 1, file) == 1) {
+      MergeEntry(entry.data());
+    } else if (tag == SPILLED_DISTINCT_VALUE &&
+               std::fread(distinct_value.data(), distinct_value.size(), 1,
+                          file) == 1) {
+      MergeDistinctValue(distinct_value.data());
+    } else {
+      break;
+    }
+  }
+  if (std::ferror(file) || std::feof(file) == false) {
+    throw ExecutorException("Failed to read the spilled groups of an "
+                            "aggregation");
+  }
+}
+
+void AggregationHashTable::Clear() {
+  entries_.clear();
+  slots_.assign(INITIAL_SLOT_COUNT, Slot{0, nullptr});
+  distinct_values_.clear();
+  distinct_slots_.assign(INITIAL_SLOT_COUNT, Slot{0, nullptr});
+  pool_.reset(new type::ArenaPool(false));
+}
+
+uint64_t AggregationHashTable::Hash(const char *key, size_t size) {
+  uint64_t hash = size;
+  size_t offset = 0;
+  for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, key + offset, sizeof(word));
+    hash = HashUtil::MixBits(hash ^ word);
+  }
+  if (offset < size) {
+    uint64_t word = 0;
+    std::memcpy(&word, key + offset, size - offset);
+    hash = HashUtil::MixBits(hash ^ word);
+  }
+  return HashUtil::MixBits(hash);
+}
+
+AggregationHashTable::AggregateState AggregationHashTable::MakeState(
+    ExpressionType agg_type, const type::Value &value) {
+  AggregateState state;
+  state.count = 0;
+  state.integer = 0;
+  state.type_id = value.GetTypeId();
+
+  // COUNT(*) counts NULL too, the other aggregates skip it
+  if (agg_type == ExpressionType::AGGREGATE_COUNT_STAR) {
+    state.count = 1;
+    return state;
+  }
+  if (value.IsNull()) {
+    return state;
+  }
+  state.count = 1;
+  if (agg_type == ExpressionType::AGGREGATE_COUNT) {
+    return state;
+  }
+
+  switch (state.type_id) {
+    case type::TypeId::TINYINT:
+      state.integer = value.GetAs<int8_t>();
+      break;
+    case type::TypeId::SMALLINT:
+      state.integer = value.GetAs<int16_t>();
+      break;
+    case type::TypeId::INTEGER:
+      state.integer = value.GetAs<int32_t>();
+      break;
+    case type::TypeId::BIGINT:
+      state.integer = value.GetAs<int64_t>();
+      break;
+    case type::TypeId::DATE:
+      state.integer = value.GetAs<uint32_t>();
+      break;
+    case type::TypeId::TIMESTAMP:
+      state.integer = static_cast<int64_t>(value.GetAs<uint64_t>());
+      break;
+    case type::TypeId::DECIMAL:
+      state.decimal = value.GetAs<double>();
+      break;
+    default:
+      throw ExecutorException("Cannot aggregate a value of type " +
+                              TypeIdToString(state.type_id));
+  }
+  return state;
+}
+
+void AggregationHashTable::CombineState(ExpressionType agg_type,
+                                        AggregateState &state,
+                                        const AggregateState &other) {
+  if (agg_type == ExpressionType::AGGREGATE_COUNT ||
+      agg_type == ExpressionType::AGGREGATE_COUNT_STAR) {
+    state.count += other.count;
+    return;
+  }
+  if (other.count == 0) {
+    return;
+  }
+  if (state.count == 0) {
+    state = other;
+    return;
+  }
+
+  int64_t count = state.count + other.count;
+  bool is_decimal = state.type_id == type::TypeId::DECIMAL ||
+                    other.type_id == type::TypeId::DECIMAL;
+  double decimal = state.type_id == type::TypeId::DECIMAL
+                       ? state.decimal
+                       : static_cast<double>(state.integer);
+  double other_decimal = other.type_id == type::TypeId::DECIMAL
+                             ? other.decimal
+                             : static_cast<double>(other.integer);
+
+  switch (agg_type) {
+    case ExpressionType::AGGREGATE_SUM:
+    case ExpressionType::AGGREGATE_AVG: {
+      if (is_decimal) {
+        state.decimal = decimal + other_decimal;
+        state.type_id = type::TypeId::DECIMAL;
+        break;
+      }
+      // the sum has the wider of the two types, as with Value::Add
+      auto type_id = type::Type::GetTypeSize(state.type_id) >=
+                             type::Type::GetTypeSize(other.type_id)
+                         ? state.type_id
+                         : other.type_id;
+      int64_t sum;
+      if (__builtin_add_overflow(state.integer, other.integer, &sum) ||
+          FitsIn(type_id, sum) == false) {
+        throw Exception(ExceptionType::OUT_OF_RANGE,
+                        "Numeric value out of range.");
+      }
+      state.integer = sum;
+      state.type_id = type_id;
+      break;
+    }
+    case ExpressionType::AGGREGATE_MIN:
+    case ExpressionType::AGGREGATE_MAX: {
+      bool less = is_decimal ? other_decimal < decimal
+                             : other.integer < state.integer;
+      bool greater = is_decimal ? other_decimal > decimal
+                                : other.integer > state.integer;
+      if ((agg_type == ExpressionType::AGGREGATE_MIN && less) ||
+          (agg_type == ExpressionType::AGGREGATE_MAX && greater)) {
+        state = other;
+      }
+      break;
+    }
+    default:
+      throw ExecutorException("Unknown aggregate type " +
+                              ExpressionTypeToString(agg_type));
+  }
+  state.count = count;
+}
+
+type::Value AggregationHashTable::FinalizeState(ExpressionType agg_type,
+                                                const AggregateState &state) {
+  if (agg_type == ExpressionType::AGGREGATE_COUNT ||
+      agg_type == ExpressionType::AGGREGATE_COUNT_STAR) {
+    return type::ValueFactory::GetBigIntValue(state.count);
+  }
+  if (state.count == 0) {
+    return type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER);
+  }
+  if (agg_type == ExpressionType::AGGREGATE_AVG) {
+    double sum = state.type_id == type::TypeId::DECIMAL
+                     ? state.decimal
+                     : static_cast<double>(state.integer);
+    return type::ValueFactory::GetDecimalValue(
+        sum / static_cast<double>(state.count));
+  }
+
+  switch (state.type_id) {
+    case type::TypeId::TINYINT:
+      return type::ValueFactory::GetTinyIntValue(
+          static_cast<int8_t>(state.integer));
+    case type::TypeId::SMALLINT:
+      return type::ValueFactory::GetSmallIntValue(
+          static_cast<int16_t>(state.integer));
+    case type::TypeId::INTEGER:
+      return type::ValueFactory::GetIntegerValue(
+          static_cast<int32_t>(state.integer));
+    case type::TypeId::BIGINT:
+      return type::ValueFactory::GetBigIntValue(state.integer);
+    case type::TypeId::DATE:
+      return type::ValueFactory::GetDateValue(
+          static_cast<uint32_t>(state.integer));
+    case type::TypeId::TIMESTAMP:
+      return type::ValueFactory::GetTimestampValue(state.integer);
+    default:
+      return type::ValueFactory::GetDecimalValue(state.decimal);
+  }
+}
+
+AggregationHashTable::Slot &AggregationHashTable::FindSlot(
+    std::vector<Slot> &slots, uint64_t hash, const char *key,
+    size_t key_size) {
+  size_t mask = slots.size() - 1;
+  size_t slot_id = hash & mask;
+  while (true) {
+    auto &slot = slots[slot_id];
+    if (slot.entry == nullptr ||
+        (slot.hash == hash &&
+         std::memcmp(slot.entry + sizeof(uint64_t), key, key_size) == 0)) {
+      return slot;
+    }
+    slot_id = (slot_id + 1) & mask;
+  }
+}
+
+char *AggregationHashTable::FindOrAddEntry(uint64_t hash, const char *key,
+                                           bool &added) {
+  if (2 * (entries_.size() + 1) > slots_.size()) {
+    Grow(slots_, entries_);
+  }
+
+  auto &slot = FindSlot(slots_, hash, key, key_size_);
+  if (slot.entry != nullptr) {
+    added = false;
+    return slot.entry;
+  }
+
+  char *entry = static_cast<char *>(pool_->Allocate(entry_size_));
+  *reinterpret_cast<uint64_t *>(entry) = hash;
+  std::memcpy(entry + sizeof(uint64_t), key, key_size_);
+  // no aggregate has advanced
+  std::memset(entry + tuple_offset_, 0, entry_size_ - tuple_offset_);
+  slot.hash = hash;
+  slot.entry = entry;
+  entries_.push_back(entry);
+  added = true;
+  return entry;
+}
+
+void AggregationHashTable::MergeEntry(const char *other_entry) {
+  bool added;
+  char *entry = FindOrAddEntry(GetHash(other_entry),
+                               other_entry + sizeof(uint64_t), added);
+  if (added) {
+    std::memcpy(entry + tuple_offset_, other_entry + tuple_offset_,
+                states_offset_ - tuple_offset_);
+  }
+
+  auto states = GetStates(entry);
+  auto other_states = GetStates(other_entry);
+  auto &aggregate_terms = node_->GetUniqueAggTerms();
+  for (oid_t aggno = 0; aggno < aggregate_terms.size(); aggno++) {
+    if (aggregate_terms[aggno].distinct == false) {
+      CombineState(aggregate_terms[aggno].aggtype, states[aggno],
+                   other_states[aggno]);
+    }
+  }
+}
+
+bool AggregationHashTable::AddDistinctValue(const char *key, oid_t aggno,
+                                            const type::Value &value) {
+  auto type_id = value.GetTypeId();
+  if (IsFixedWidth(type_id) == false) {
+    throw ExecutorException("Cannot aggregate a value of type " +
+                            TypeIdToString(type_id));
+  }
+
+  char *record = distinct_buffer_.data();
+  std::memcpy(record, key, key_size_);
+  std::memcpy(record + key_size_, &aggno, sizeof(aggno));
+  std::memcpy(record + distinct_type_offset_, &type_id, sizeof(type_id));
+  std::memset(record + distinct_data_offset_, 0, sizeof(uint64_t));
+  value.SerializeTo(record + distinct_data_offset_, true, nullptr);
+  return AddDistinctRecord(Hash(record, distinct_record_size_), record);
+}
+
+bool AggregationHashTable::AddDistinctRecord(uint64_t hash,
+                                             const char *record) {
+  if (2 * (distinct_values_.size() + 1) > distinct_slots_.size()) {
+    Grow(distinct_slots_, distinct_values_);
+  }
+
+  auto &slot = FindSlot(distinct_slots_, hash, record, distinct_record_size_);
+  if (slot.entry != nullptr) {
+    return false;
+  }
+
+  char *distinct_value = static_cast<char *>(
+      pool_->Allocate(sizeof(uint64_t) + distinct_record_size_));
+  *reinterpret_cast<uint64_t *>(distinct_value) = hash;
+  std::memcpy(distinct_value + sizeof(uint64_t), record,
+              distinct_record_size_);
+  slot.hash = hash;
+  slot.entry = distinct_value;
+  distinct_values_.push_back(distinct_value);
+  return true;
+}
+
+void AggregationHashTable::MergeDistinctValue(
+    const char *other_distinct_value) {
+  const char *record = other_distinct_value + sizeof(uint64_t);
+  if (AddDistinctRecord(GetHash(other_distinct_value), record) == false) {
+    return;
+  }
+
+  bool added;
+  char *entry = FindOrAddEntry(Hash(record, key_size_), record, added);
+  PELOTON_ASSERT(added == false);
+
+  oid_t aggno;
+  type::TypeId type_id;
+  std::memcpy(&aggno, record + key_size_, sizeof(aggno));
+  std::memcpy(&type_id, record + distinct_type_offset_, sizeof(type_id));
+  auto value = type::Value::DeserializeFrom(record + distinct_data_offset_,
+                                            type_id, true, nullptr);
+
+  auto agg_type = node_->GetUniqueAggTerms()[aggno].aggtype;
+  CombineState(agg_type, GetStates(entry)[aggno], MakeState(agg_type, value));
+}
+
+void AggregationHashTable::Grow(std::vector<Slot> &slots,
+                                const std::vector<char *> &entries) {
+  slots.assign(2 * slots.size(), Slot{0, nullptr});
+  size_t mask = slots.size() - 1;
+  for (auto entry : entries) {
+    uint64_t hash = GetHash(entry);
+    size_t slot_id = hash & mask;
+    while (slots[slot_id].entry != nullptr) {
+      slot_id = (slot_id + 1) & mask;
+    }
+    slots[slot_id] = {hash, entry};
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -16,7 +16,10 @@
 #include "common/logger.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/executor_context.h"
+#include "settings/settings_manager.h"
 #include "storage/abstract_table.h"
+#include "threadpool/mono_queue_pool.h"
+#include "threadpool/parallel_for.h"
 
 namespace peloton {
 namespace executor {
@@ -90,7 +93,8 @@ type::Value AbstractAttributeAggregator::Finalize() {
  * used to retrieve pass-through values;
  * Right is the tuple holding all aggregated values.
  */
-bool Helper(const planner::AggregatePlan *node, AbstractAttributeAggregator **aggregates,
+bool Helper(const planner::AggregatePlan *node,
+            std::vector<type::Value> &aggregate_values,
             storage::AbstractTable *output_table,
             const AbstractTuple *delegate_tuple,
             executor::ExecutorContext *econtext) {
@@ -98,20 +102,7 @@ bool Helper(const planner::AggregatePlan *node, AbstractAttributeAggregator **ag
   std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
 
   /*
-   * 1) Construct a vector of aggregated values
-   */
-  std::vector<type::Value> aggregate_values;
-  auto &aggregate_terms = node->GetUniqueAggTerms();
-  for (oid_t column_itr = 0; column_itr < aggregate_terms.size();
-       column_itr++) {
-    if (aggregates[column_itr] != nullptr) {
-      type::Value final_val = aggregates[column_itr]->Finalize();
-      aggregate_values.push_back(final_val);
-    }
-  }
-
-  /*
-   * 2) Evaluate filter predicate;
+   * 1) Evaluate filter predicate;
    * if fail, just return
    */
   std::unique_ptr<ContainerTuple<std::vector<type::Value>>>
@@ -126,7 +117,7 @@ bool Helper(const planner::AggregatePlan *node, AbstractAttributeAggregator **ag
   }
 
   /*
-   * 3) Construct the tuple to insert using projectInfo
+   * 2) Construct the tuple to insert using projectInfo
    */
   node->GetProjectInfo()->Evaluate(tuple.get(), delegate_tuple,
                                    aggref_tuple.get(), econtext);
@@ -146,6 +137,36 @@ bool Helper(const planner::AggregatePlan *node, AbstractAttributeAggregator **ag
   return true;
 }
 
+bool Helper(const planner::AggregatePlan *node,
+            AbstractAttributeAggregator **aggregates,
+            storage::AbstractTable *output_table,
+            const AbstractTuple *delegate_tuple,
+            executor::ExecutorContext *econtext) {
+  // Construct a vector of aggregated values
+  std::vector<type::Value> aggregate_values;
+  auto &aggregate_terms = node->GetUniqueAggTerms();
+  for (oid_t column_itr = 0; column_itr < aggregate_terms.size();
+       column_itr++) {
+    if (aggregates[column_itr] != nullptr) {
+      type::Value final_val = aggregates[column_itr]->Finalize();
+      aggregate_values.push_back(final_val);
+    }
+  }
+
+  return Helper(node, aggregate_values, output_table, delegate_tuple,
+                econtext);
+}
+
+bool AbstractAggregator::AdvanceTile(std::unique_ptr<LogicalTile> tile) {
+  for (oid_t tuple_id : *tile) {
+    ContainerTuple<LogicalTile> cur_tuple(tile.get(), tuple_id);
+    if (Advance(&cur_tuple) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // Hash Aggregator
 //===--------------------------------------------------------------------===//
@@ -154,7 +175,10 @@ HashAggregator::HashAggregator(const planner::AggregatePlan *node,
                                executor::ExecutorContext *econtext,
                                size_t num_input_columns)
     : AbstractAggregator(node, output_table, econtext),
-      num_input_columns(num_input_columns) {}
+      num_input_columns(num_input_columns) {
+  memory_limit_ = settings::SettingsManager::GetDouble(
+      settings::SettingId::hash_aggregation_memory_limit);
+}
 //  group_by_key_values.resize(node->GetGroupbyColIds().size(),
 //      type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER));
 //}
@@ -171,6 +195,15 @@ HashAggregator::~HashAggregator() {
 }
 
 bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
+  if (initialized_ == false) {
+    Initialize(cur_tuple);
+  }
+  if (table_ != nullptr) {
+    table_->Advance(cur_tuple);
+    CheckMemoryUsage();
+    return true;
+  }
+
   AggregateList *aggregate_list;
 
   // Configure a group-by-key and search for the required group.
@@ -227,7 +260,143 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
   return true;
 }
 
+bool HashAggregator::AdvanceTile(std::unique_ptr<LogicalTile> tile) {
+  if (tile->GetTupleCount() == 0) {
+    return true;
+  }
+  if (initialized_ == false) {
+    ContainerTuple<LogicalTile> first_tuple(tile.get(), *tile->begin());
+    Initialize(&first_tuple);
+  }
+  if (table_ == nullptr) {
+    return AbstractAggregator::AdvanceTile(std::move(tile));
+  }
+
+  pending_tuple_count_ += tile->GetTupleCount();
+  pending_tiles_.push_back(std::move(tile));
+  if (pending_tuple_count_ >= BATCH_SIZE) {
+    AdvancePendingTiles();
+  }
+  return true;
+}
+
+void HashAggregator::Initialize(const AbstractTuple *first_tuple) {
+  if (AggregationHashTable::IsSupported(node, first_tuple, num_input_columns,
+                                        input_types_)) {
+    table_.reset(
+        new AggregationHashTable(node, input_types_, executor_context));
+  }
+  initialized_ = true;
+}
+
+void HashAggregator::AdvancePendingTiles() {
+  auto &worker_pool = threadpool::MonoQueuePool::GetExecutionInstance();
+  size_t task_count =
+      std::min<size_t>(pending_tiles_.size(), worker_pool.NumWorkers() + 1);
+
+  // a value DISTINCT aggregates have seen must be seen by all of them
+  if (task_count <= 1 || table_->HasDistinct()) {
+    for (auto &tile : pending_tiles_) {
+      for (oid_t tuple_id : *tile) {
+        ContainerTuple<LogicalTile> cur_tuple(tile.get(), tuple_id);
+        table_->Advance(&cur_tuple);
+      }
+      CheckMemoryUsage();
+    }
+  } else {
+    // each task aggregates consecutive tiles into a table of its own, the
+    // tables are merged in the order of their tiles so that each group
+    // keeps its first tuple
+    std::vector<std::unique_ptr<AggregationHashTable>> tables(task_count);
+    threadpool::ParallelFor(task_count, [&](size_t task_id) {
+      tables[task_id].reset(
+          new AggregationHashTable(node, input_types_, executor_context));
+
+      size_t end = (task_id + 1) * pending_tiles_.size() / task_count;
+      for (size_t i = task_id * pending_tiles_.size() / task_count; i < end;
+           i++) {
+        for (oid_t tuple_id : *pending_tiles_[i]) {
+          ContainerTuple<LogicalTile> cur_tuple(pending_tiles_[i].get(),
+                                                tuple_id);
+          tables[task_id]->Advance(&cur_tuple);
+        }
+      }
+    });
+
+    for (auto &table : tables) {
+      table_->Merge(*table);
+      table.reset();
+      CheckMemoryUsage();
+    }
+  }
+
+  pending_tiles_.clear();
+  pending_tuple_count_ = 0;
+}
+
+void HashAggregator::CheckMemoryUsage() {
+  if (table_->GetMemoryUsage() <= memory_limit_) {
+    return;
+  }
+
+  if (spill_files_.empty()) {
+    for (size_t i = 0; i < SPILL_PARTITION_COUNT; i++) {
+      std::unique_ptr<std::FILE, FileCloser> file(std::tmpfile());
+      if (file == nullptr) {
+        throw ExecutorException(
+            "Failed to create a file to spill the groups of an aggregation");
+      }
+      spill_files_.push_back(std::move(file));
+    }
+  }
+
+  LOG_TRACE("Spilling %lu groups", table_->GetEntries().size());
+  std::vector<std::FILE *> files;
+  for (auto &file : spill_files_) {
+    files.push_back(file.get());
+  }
+  table_->Spill(files);
+}
+
+bool HashAggregator::OutputGroups() {
+  std::vector<type::Value> first_tuple_values;
+  std::vector<type::Value> aggregate_values;
+  ContainerTuple<std::vector<type::Value>> first_tuple(&first_tuple_values);
+  for (auto entry : table_->GetEntries()) {
+    table_->GetFirstTuple(entry, first_tuple_values);
+    table_->GetAggregateValues(entry, aggregate_values);
+    if (Helper(node, aggregate_values, output_table, &first_tuple,
+               this->executor_context) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool HashAggregator::Finalize() {
+  if (table_ != nullptr) {
+    AdvancePendingTiles();
+    if (spill_files_.empty()) {
+      return OutputGroups();
+    }
+
+    // the groups of a partition are all in its file
+    std::vector<std::FILE *> files;
+    for (auto &file : spill_files_) {
+      files.push_back(file.get());
+    }
+    table_->Spill(files);
+    for (auto &file : spill_files_) {
+      table_->Load(file.get());
+      file.reset();
+      if (OutputGroups() == false) {
+        return false;
+      }
+      table_->Clear();
+    }
+    return true;
+  }
+
   for (auto entry : aggregates_map) {
     // Construct a container for the first tuple
     ContainerTuple<std::vector<type::Value>> first_tuple(
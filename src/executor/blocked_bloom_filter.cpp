@@ -0,0 +1,37 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// blocked_bloom_filter.cpp
+//
+// Identification: src/executor/blocked_bloom_filter.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/blocked_bloom_filter.h"
+
+namespace peloton {
+namespace executor {
+
+BlockedBloomFilter::BlockedBloomFilter(size_t key_count) {
+  // a power of two # of blocks, at least BITS_PER_KEY bits per key
+  const size_t block_bit_count = BLOCK_WORD_COUNT * 64;
+  while ((1ull << block_bits_) * block_bit_count < key_count * BITS_PER_KEY) {
+    block_bits_++;
+  }
+  words_.resize((1ull << block_bits_) * BLOCK_WORD_COUNT, 0);
+}
+
+void BlockedBloomFilter::Add(uint64_t hash) {
+  hash = HashUtil::MixBits(hash);
+  uint64_t *block = &words_[GetBlockOffset(hash)];
+  uint64_t bits = HashUtil::MixBits(hash);
+  for (size_t word = 0; word < BLOCK_WORD_COUNT; word++) {
+    block[word] |= 1ull << ((bits >> (word * 6)) & 63);
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -17,7 +17,9 @@
 #include "concurrency/transaction_context.h"
 #include "executor/executor_context.h"
 #include "planner/create_plan.h"
+#include "storage/data_table.h"
 #include "storage/database.h"
+#include "storage/partition_scheme.h"
 #include "storage/storage_manager.h"
 #include "type/value_factory.h"
 
@@ -253,6 +255,46 @@ bool CreateExecutor::CreateTable(const planner::CreatePlan &node) {
                                   check.constraint_name);
     }
 
+    // Partition the table
+    if (node.GetPartitionType() != PartitionType::INVALID) {
+      auto source_schema = source_table->GetSchema();
+      auto key_name = node.GetPartitionKey();
+      oid_t key_col_id = source_schema->GetColumnID(key_name);
+      if (key_col_id == INVALID_OID) {
+        std::string error = StringUtil::Format(
+            "Invalid partition key column name '%s.%s'", table_name.c_str(),
+            key_name.c_str());
+        throw ExecutorException(error);
+      }
+      auto key_type = source_schema->GetType(key_col_id);
+
+      std::vector<type::Value> bounds;
+      for (auto bound : node.GetPartitionBounds()) {
+        bounds.push_back(
+            type::ValueFactory::GetVarcharValue(bound).CastAs(key_type));
+      }
+
+      source_table->SetPartitionScheme(
+          std::unique_ptr<storage::PartitionScheme>(
+              new storage::PartitionScheme(node.GetPartitionType(),
+                                           key_col_id, key_type,
+                                           node.GetPartitionCount(),
+                                           std::move(bounds))));
+    }
+
+    // Cluster the table
+    if (node.GetClusterKey().empty() == false) {
+      auto key_name = node.GetClusterKey();
+      oid_t key_col_id = source_table->GetSchema()->GetColumnID(key_name);
+      if (key_col_id == INVALID_OID) {
+        std::string error = StringUtil::Format(
+            "Invalid cluster key column name '%s.%s'", table_name.c_str(),
+            key_name.c_str());
+        throw ExecutorException(error);
+      }
+      source_table->SetClusterKey(key_col_id);
+    }
+
   } else if (current_txn->GetResult() == ResultType::FAILURE) {
     LOG_TRACE("Creating table failed!");
   } else {
@@ -215,7 +215,8 @@ bool DeleteExecutor::DExecute() {
         }
         // if it is the latest version and not locked by other threads, then
         // insert an empty version.
-        ItemPointer new_location = target_table_->InsertEmptyVersion();
+        ItemPointer new_location =
+            target_table_->InsertEmptyVersion(old_location);
 
         // PerformDelete() will not be executed if the insertion failed.
         // There is a write lock acquired, but since it is not in the write set,
@@ -74,26 +74,36 @@ bool HashExecutor::DExecute() {
       column_ids_.push_back(tuple_value->GetColumnId());
     }
 
-    // Construct the hash table by going over each child logical tile and
-    // hashing
+    // Only the non-empty tiles are output
     for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
          child_tile_itr++) {
-      auto tile = child_tiles_[child_tile_itr].get();
-
-      // Go over all tuples in the logical tile
-      if (tile->GetTupleCount() > 0) {
+      if (child_tiles_[child_tile_itr]->GetTupleCount() > 0) {
         output_tile_itrs_.emplace_back(child_tile_itr);
+      }
+    }
+
+    if (build_key_filter_) {
+      BuildKeyFilter();
+    }
+
+    if (radix_join_ == false || BuildRadixTable() == false) {
+      // Construct the hash table by going over each child logical tile and
+      // hashing
+      for (size_t output_tile_itr = 0;
+           output_tile_itr < output_tile_itrs_.size(); output_tile_itr++) {
+        auto tile = child_tiles_[output_tile_itrs_[output_tile_itr]].get();
+
+        // Go over all tuples in the logical tile
         for (oid_t tuple_id : *tile) {
           // Key : container tuple with a subset of tuple attributes
-          // Value : < child_tile offset, tuple offset >
+          // Value : < output tile offset, tuple offset >
           auto key = HashMapType::key_type(tile, tuple_id, &column_ids_);
           if (hash_table_.find(key) != hash_table_.end()) {
             //If data is already present, remove from output
             //but leave data for hash joins.
             tile->RemoveVisibility(tuple_id);
           }
-          hash_table_[key].insert(
-              std::make_pair(output_tile_itrs_.size()-1, tuple_id));
+          hash_table_[key].insert(std::make_pair(output_tile_itr, tuple_id));
         }
       }
     }
@@ -111,5 +121,54 @@ bool HashExecutor::DExecute() {
   }
 }
 
+void HashExecutor::BuildKeyFilter() {
+  size_t key_count = 0;
+  for (auto output_tile_itr : output_tile_itrs_) {
+    key_count += child_tiles_[output_tile_itr]->GetTupleCount();
+  }
+
+  // hashed as the hash table hashes them
+  key_filter_.reset(new BlockedBloomFilter(key_count));
+  for (auto output_tile_itr : output_tile_itrs_) {
+    auto tile = child_tiles_[output_tile_itr].get();
+    for (oid_t tuple_id : *tile) {
+      ContainerTuple<LogicalTile> key(tile, tuple_id, &column_ids_);
+      key_filter_->Add(key.HashCode());
+    }
+  }
+  LOG_TRACE("Key filter of %lu keys in %lu bytes", key_count,
+            key_filter_->GetSize());
+}
+
+bool HashExecutor::BuildRadixTable() {
+  if (column_ids_.size() != 1) {
+    return false;
+  }
+
+  std::vector<RadixJoinTable::Row> rows;
+  for (size_t output_tile_itr = 0; output_tile_itr < output_tile_itrs_.size();
+       output_tile_itr++) {
+    auto tile = child_tiles_[output_tile_itrs_[output_tile_itr]].get();
+    if (RadixJoinTable::GatherRows(tile, output_tile_itr, column_ids_[0],
+                                   rows) == false) {
+      return false;
+    }
+  }
+  if (rows.size() < RadixJoinTable::MIN_BUILD_ROW_COUNT) {
+    return false;
+  }
+
+  LOG_TRACE("Radix partitioning %lu rows", rows.size());
+  radix_table_.reset(new RadixJoinTable(std::move(rows)));
+
+  // As with the hash table, a row whose key is already present is removed
+  // from the output but left for hash joins
+  for (auto &row : radix_table_->GetDuplicateRows()) {
+    child_tiles_[output_tile_itrs_[row.tile_offset]]->RemoveVisibility(
+        row.tuple_id);
+  }
+  return true;
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -10,6 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <tuple>
+
+#include "common/exception.h"
 #include "common/internal_types.h"
 #include "common/logger.h"
 #include "executor/logical_tile_factory.h"
@@ -17,6 +21,7 @@
 #include "expression/abstract_expression.h"
 #include "expression/tuple_value_expression.h"
 #include "common/container_tuple.h"
+#include "planner/hash_plan.h"
 
 namespace peloton {
 namespace executor {
@@ -40,6 +45,39 @@ bool HashJoinExecutor::DInit() {
 
   hash_executor_ = reinterpret_cast<HashExecutor *>(children_[1]);
 
+  // Joins on a single integer key may use a radix partitioned hash table
+  std::vector<const expression::AbstractExpression *> left_hashed_cols;
+  GetPlanNode<planner::HashJoinPlan>().GetLeftHashKeys(left_hashed_cols);
+  auto &right_hashed_cols =
+      static_cast<const planner::HashPlan *>(children_[1]->GetRawNode())
+          ->GetHashKeys();
+  hash_executor_->SetRadixJoin(
+      left_hashed_cols.size() == 1 && right_hashed_cols.size() == 1 &&
+      RadixJoinTable::IsKeyType(left_hashed_cols[0]->GetValueType()) &&
+      RadixJoinTable::IsKeyType(right_hashed_cols[0]->GetValueType()));
+
+  // A left tuple whose key is in no right tuple only shows up in the output
+  // of left and full outer joins, the left scan can drop it otherwise. Keys
+  // only hash alike if their types are the same.
+  if (left_scan_ != nullptr) {
+    left_scan_->SetKeyFilter(nullptr, {});
+  }
+  left_scan_ = nullptr;
+  bool keys_match = left_hashed_cols.size() == right_hashed_cols.size();
+  for (size_t key_itr = 0; keys_match && key_itr < left_hashed_cols.size();
+       key_itr++) {
+    keys_match = left_hashed_cols[key_itr]->GetExpressionType() ==
+                     ExpressionType::VALUE_TUPLE &&
+                 left_hashed_cols[key_itr]->GetValueType() ==
+                     right_hashed_cols[key_itr]->GetValueType();
+  }
+  if (GetPlanNode<planner::HashJoinPlan>().IsBloomFilterEnabled() &&
+      join_type_ != JoinType::LEFT && join_type_ != JoinType::OUTER &&
+      keys_match) {
+    left_scan_ = dynamic_cast<AbstractScanExecutor *>(children_[0]);
+  }
+  hash_executor_->SetBuildKeyFilter(left_scan_ != nullptr);
+
   return true;
 }
 
@@ -76,6 +114,26 @@ bool HashJoinExecutor::DExecute() {
         BufferRightTile(children_[1]->GetOutput());
       }
       right_child_done_ = true;
+
+      // The left side is not scanned yet
+      auto key_filter = hash_executor_->GetKeyFilter();
+      if (left_scan_ != nullptr && key_filter != nullptr) {
+        std::vector<const expression::AbstractExpression *> left_hashed_cols;
+        GetPlanNode<planner::HashJoinPlan>().GetLeftHashKeys(left_hashed_cols);
+        std::vector<oid_t> left_hashed_col_ids;
+        for (auto &hashkey : left_hashed_cols) {
+          left_hashed_col_ids.push_back(
+              reinterpret_cast<const expression::TupleValueExpression *>(
+                  hashkey)->GetColumnId());
+        }
+        left_scan_->SetKeyFilter(key_filter, left_hashed_col_ids);
+      }
+    }
+
+    auto radix_table = hash_executor_->GetRadixTable();
+    if (radix_table != nullptr) {
+      ProbeRadixTable(*radix_table);
+      continue;
     }
 
     // Get next tile from LEFT child
@@ -193,5 +251,77 @@ bool HashJoinExecutor::DExecute() {
   }
 }
 
+void HashJoinExecutor::ProbeRadixTable(const RadixJoinTable &radix_table) {
+  while (children_[0]->Execute()) {
+    BufferLeftTile(children_[0]->GetOutput());
+  }
+  left_child_done_ = true;
+
+  std::vector<const expression::AbstractExpression *> left_hashed_cols;
+  this->GetPlanNode<planner::HashJoinPlan>().GetLeftHashKeys(left_hashed_cols);
+  auto left_hashed_col_id =
+      reinterpret_cast<const expression::TupleValueExpression *>(
+          left_hashed_cols[0])->GetColumnId();
+
+  std::vector<RadixJoinTable::Row> left_rows;
+  for (size_t left_tile_itr = 0; left_tile_itr < left_result_tiles_.size();
+       left_tile_itr++) {
+    if (RadixJoinTable::GatherRows(left_result_tiles_[left_tile_itr].get(),
+                                   left_tile_itr, left_hashed_col_id,
+                                   left_rows) == false) {
+      throw ExecutorException("Hash join key of the left tiles is not an "
+                              "integer");
+    }
+  }
+
+  RadixJoinTable::MatchFilter filter;
+  if (predicate_ != nullptr) {
+    filter = [this](const RadixJoinTable::Match &match) {
+      const ContainerTuple<LogicalTile> left_tuple(
+          left_result_tiles_[match.probe_tile_offset].get(),
+          match.probe_tuple_id);
+      const ContainerTuple<LogicalTile> right_tuple(
+          right_result_tiles_[match.build_tile_offset].get(),
+          match.build_tuple_id);
+      return predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
+                 .IsFalse() == false;
+    };
+  }
+  auto matches = radix_table.Probe(std::move(left_rows), filter);
+  LOG_TRACE("Radix join matches : %lu \n", matches.size());
+
+  // A join tile per pair of left and right tiles with matches
+  std::sort(matches.begin(), matches.end(),
+            [](const RadixJoinTable::Match &lhs,
+               const RadixJoinTable::Match &rhs) {
+              return std::tie(lhs.probe_tile_offset, lhs.build_tile_offset) <
+                     std::tie(rhs.probe_tile_offset, rhs.build_tile_offset);
+            });
+  size_t match_itr = 0;
+  while (match_itr < matches.size()) {
+    oid_t left_tile_itr = matches[match_itr].probe_tile_offset;
+    oid_t right_tile_itr = matches[match_itr].build_tile_offset;
+    LogicalTile *left_tile = left_result_tiles_[left_tile_itr].get();
+    LogicalTile *right_tile = right_result_tiles_[right_tile_itr].get();
+
+    auto output_tile = BuildOutputLogicalTile(left_tile, right_tile);
+    LogicalTile::PositionListsBuilder pos_lists_builder(left_tile, right_tile);
+    pos_lists_builder.SetRightSource(&right_tile->GetPositionLists());
+    for (; match_itr < matches.size() &&
+           matches[match_itr].probe_tile_offset == left_tile_itr &&
+           matches[match_itr].build_tile_offset == right_tile_itr;
+         match_itr++) {
+      auto &match = matches[match_itr];
+      pos_lists_builder.AddRow(match.probe_tuple_id, match.build_tuple_id);
+      RecordMatchedLeftRow(left_tile_itr, match.probe_tuple_id);
+      RecordMatchedRightRow(right_tile_itr, match.build_tuple_id);
+    }
+
+    LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
+    output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+    buffered_output_tiles.push_back(output_tile.release());
+  }
+}
+
 }  // namespace executor
 }  // namespace peloton
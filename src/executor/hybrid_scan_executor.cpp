@@ -115,16 +115,26 @@ bool HybridScanExecutor::DInit() {
       current_tile_group_offset_ = START_OID;
     } else {
       current_tile_group_offset_ = indexed_tile_offset_ + 1;
-      std::shared_ptr<storage::TileGroup> tile_group;
-      if (current_tile_group_offset_ < table_tile_group_count_) {
-        tile_group = table_->GetTileGroup(current_tile_group_offset_);
-      } else {
-        tile_group = table_->GetTileGroup(table_tile_group_count_ - 1);
+      oid_t threshold_offset =
+          (current_tile_group_offset_ < table_tile_group_count_)
+              ? current_tile_group_offset_
+              : table_tile_group_count_ - 1;
+      std::shared_ptr<storage::TileGroup> tile_group =
+          table_->GetTileGroup(threshold_offset);
+      // dropped after compaction, the next live tile group bounds the scan
+      while (tile_group == nullptr &&
+             threshold_offset + 1 < table_tile_group_count_) {
+        tile_group = table_->GetTileGroup(++threshold_offset);
       }
 
-      oid_t tuple_id = 0;
-      ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
-      block_threshold = location.block;
+      if (tile_group != nullptr) {
+        oid_t tuple_id = 0;
+        ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+        block_threshold = location.block;
+      } else {
+        // no tile group is left for the sequential part
+        block_threshold = INVALID_OID;
+      }
     }
 
     result_itr_ = START_OID;
@@ -189,6 +199,9 @@ bool HybridScanExecutor::SeqScanUtil() {
   while (current_tile_group_offset_ < table_tile_group_count_) {
     LOG_TRACE("Current tile group offset : %u", current_tile_group_offset_);
     auto tile_group = table_->GetTileGroup(current_tile_group_offset_++);
+    if (tile_group == nullptr) {
+      continue;
+    }
     auto tile_group_header = tile_group->GetHeader();
 
     oid_t active_tuple_count = tile_group->GetNextTupleSlot();
@@ -281,7 +294,7 @@ bool HybridScanExecutor::IndexScanUtil() {
   return false;
 }
 
-bool HybridScanExecutor::DExecute() {
+bool HybridScanExecutor::DScan() {
   // SEQUENTIAL SCAN
   if (type_ == HybridScanType::SEQUENTIAL) {
     LOG_TRACE("Sequential Scan");
@@ -29,6 +29,7 @@
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
 #include "storage/storage_manager.h"
+#include "tuning/sample.h"
 #include "type/value.h"
 
 namespace peloton {
@@ -123,10 +124,14 @@ bool IndexScanExecutor::DInit() {
  * @brief Creates logical tile(s) after scanning index.
  * @return true on success, false otherwise.
  */
-bool IndexScanExecutor::DExecute() {
+bool IndexScanExecutor::DScan() {
   LOG_TRACE("Index Scan executor :: 0 child");
 
   if (!done_) {
+    if (table_->IsIndexSampling()) {
+      RecordIndexSample();
+    }
+
     if (index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
       auto status = ExecPrimaryIndexLookup();
       if (status == false) return false;
@@ -154,13 +159,29 @@ bool IndexScanExecutor::DExecute() {
   return false;
 }
 
+void IndexScanExecutor::RecordIndexSample() {
+  auto &key_attrs = index_->GetMetadata()->GetKeyAttrs();
+  std::vector<double> columns_accessed(key_attrs.begin(), key_attrs.end());
+
+  // anything but an equality lookup on the whole key is a range scan
+  auto &conjunctions = index_predicate_.GetConjunctionList();
+  bool point_query = key_column_ids_.size() != 0 && conjunctions.size() == 1 &&
+                     conjunctions[0].IsPointQuery();
+
+  tuning::Sample sample(columns_accessed, DEFAULT_SAMPLE_WEIGHT,
+                        tuning::SampleType::ACCESS,
+                        point_query ? tuning::SampleAccessType::POINT
+                                    : tuning::SampleAccessType::RANGE);
+  table_->RecordIndexSample(sample);
+}
+
 bool IndexScanExecutor::ExecPrimaryIndexLookup() {
   PELOTON_ASSERT(!done_);
 
   std::vector<ItemPointer *> tuple_location_ptrs;
 
   // Grab info from plan node
-//  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
+  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
 
   PELOTON_ASSERT(index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY);
 
@@ -229,9 +250,8 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
     while (true) {
       ++chain_length;
 
-//      auto visibility = transaction_manager.IsVisible(
-//          current_txn, tile_group_header, tuple_location.offset);
-      auto visibility =VisibilityType::OK;
+      auto visibility = transaction_manager.IsVisible(
+          current_txn, tile_group_header, tuple_location.offset);
       // if the tuple is deleted
       if (visibility == VisibilityType::DELETED) {
         LOG_TRACE("encounter deleted tuple: %u, %u", tuple_location.block,
@@ -243,9 +263,10 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
         LOG_TRACE("perform read: %u, %u", tuple_location.block,
                   tuple_location.offset);
 
-        bool eval = true;
+        // skip the tuples a hash join above would not join
+        bool eval = PassesKeyFilter(tile_group.get(), tuple_location.offset);
         // if having predicate, then perform evaluation.
-        if (predicate_ != nullptr) {
+        if (eval == true && predicate_ != nullptr) {
           LOG_TRACE("perform predicate evaluate");
           ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
                                                    tuple_location.offset);
@@ -255,16 +276,16 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
         // if passed evaluation, then perform write.
         if (eval == true) {
           LOG_TRACE("perform read operation");
-//          auto res = transaction_manager.PerformRead(current_txn,
-//                                                     tuple_location,
-//                                                     tile_group_header,
-//                                                     acquire_owner);
-//          if (!res) {
-//            LOG_TRACE("read nothing");
-//            transaction_manager.SetTransactionResult(current_txn,
-//                                                     ResultType::FAILURE);
-//            return res;
-//          }
+          auto res = transaction_manager.PerformRead(current_txn,
+                                                     tuple_location,
+                                                     tile_group_header,
+                                                     acquire_owner);
+          if (!res) {
+            LOG_TRACE("read nothing");
+            transaction_manager.SetTransactionResult(current_txn,
+                                                     ResultType::FAILURE);
+            return res;
+          }
           // if perform read is successful, then add to visible tuple vector.
           visible_tuple_locations.push_back(tuple_location);
         }
@@ -325,6 +346,12 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
       }
     }
     LOG_TRACE("Traverse length: %d\n", (int)chain_length);
+
+    // the parent needs no more tuples than these
+    if (CoversTupleBudget(visible_tuple_locations)) {
+      LOG_TRACE("Tuple budget of %lu covered", tuple_budget_);
+      break;
+    }
   }
   LOG_TRACE("Examined %d tuples from index %s", num_tuples_examined,
             index_->GetName().c_str());
@@ -399,7 +426,7 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   std::vector<ItemPointer *> tuple_location_ptrs;
 
   // Grab info from plan node
-//  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
+  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
 
   if (0 == key_column_ids_.size()) {
     index_->ScanAllKeys(tuple_location_ptrs);
@@ -482,9 +509,8 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
     while (true) {
       ++chain_length;
 
-//      auto visibility = transaction_manager.IsVisible(
-//          current_txn, tile_group_header, tuple_location.offset);
-      auto visibility =VisibilityType::OK;
+      auto visibility = transaction_manager.IsVisible(
+          current_txn, tile_group_header, tuple_location.offset);
       // if the tuple is deleted
       if (visibility == VisibilityType::DELETED) {
         LOG_TRACE("encounter deleted tuple: %u, %u", tuple_location.block,
@@ -514,25 +540,26 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
           break;
         }
 
-        bool eval = true;
+        // skip the tuples a hash join above would not join
+        bool eval = PassesKeyFilter(tile_group.get(), tuple_location.offset);
         // if having predicate, then perform evaluation.
-        if (predicate_ != nullptr) {
+        if (eval == true && predicate_ != nullptr) {
           eval =
               predicate_->Evaluate(&candidate_tuple, nullptr, executor_context_)
                   .IsTrue();
         }
         // if passed evaluation, then perform write.
         if (eval == true) {
-//          auto res = transaction_manager.PerformRead(current_txn,
-//                                                     tuple_location,
-//                                                     tile_group_header,
-//                                                     acquire_owner);
-//          if (!res) {
-//            transaction_manager.SetTransactionResult(current_txn,
-//                                                     ResultType::FAILURE);
-//            LOG_TRACE("passed evaluation, but txn read fails");
-//            return res;
-//          }
+          auto res = transaction_manager.PerformRead(current_txn,
+                                                     tuple_location,
+                                                     tile_group_header,
+                                                     acquire_owner);
+          if (!res) {
+            transaction_manager.SetTransactionResult(current_txn,
+                                                     ResultType::FAILURE);
+            LOG_TRACE("passed evaluation, but txn read fails");
+            return res;
+          }
           // if perform read is successful, then add to visible tuple vector.
           visible_tuple_locations.push_back(tuple_location);
           LOG_TRACE("passed evaluation, visible_tuple_locations size: %lu",
@@ -598,6 +625,12 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
       }
     }
     LOG_TRACE("Traverse length: %d\n", (int)chain_length);
+
+    // the parent needs no more tuples than these
+    if (CoversTupleBudget(visible_tuple_locations)) {
+      LOG_TRACE("Tuple budget of %lu covered", tuple_budget_);
+      break;
+    }
   }
   LOG_TRACE("Examined %d tuples from index %s [num_blocks_reused=%d]",
             num_tuples_examined, index_->GetName().c_str(), num_blocks_reused);
@@ -682,6 +715,18 @@ void IndexScanExecutor::CheckOpenRangeWithReturnedTuples(
   }
 }
 
+bool IndexScanExecutor::CoversTupleBudget(
+    const std::vector<ItemPointer> &tuple_locations) {
+  if (tuple_locations.size() < tuple_budget_) {
+    return false;
+  }
+  // the tuples pruned by an open left boundary come first, so the tuples
+  // left after pruning cover the budget if the last budget of them are kept
+  return left_open_ == false ||
+         CheckKeyConditions(
+             tuple_locations[tuple_locations.size() - tuple_budget_]);
+}
+
 bool IndexScanExecutor::CheckKeyConditions(const ItemPointer &tuple_location) {
   // The size of these three arrays must be the same
   PELOTON_ASSERT(key_column_ids_.size() == expr_types_.size());
@@ -866,6 +911,8 @@ void IndexScanExecutor::ResetState() {
 
   result_itr_ = START_OID;
 
+  num_tuples_produced_ = 0;
+
   done_ = false;
 
   const planner::IndexScanPlan &node = GetPlanNode<planner::IndexScanPlan>();
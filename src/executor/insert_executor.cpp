@@ -103,36 +103,28 @@ bool InsertExecutor::DExecute() {
     auto target_table_schema = target_table->GetSchema();
     auto column_count = target_table_schema->GetColumnCount();
 
-    std::unique_ptr<storage::Tuple> tuple(
-        new storage::Tuple(target_table_schema, true));
-
-    // Go over the logical tile
+    // Materialize the logical tile tuples
+    std::vector<std::unique_ptr<storage::Tuple>> tuples;
+    std::vector<const storage::Tuple *> batch;
     for (oid_t tuple_id : *logical_tile) {
       ContainerTuple<LogicalTile> cur_tuple(logical_tile.get(), tuple_id);
 
-      // Materialize the logical tile tuple
+      std::unique_ptr<storage::Tuple> tuple(
+          new storage::Tuple(target_table_schema, true));
       for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
         type::Value val = (cur_tuple.GetValue(column_itr));
         tuple->SetValue(column_itr, val, executor_pool);
       }
+      batch.push_back(tuple.get());
+      tuples.push_back(std::move(tuple));
+    }
 
-      // insert tuple into the table.
-      ItemPointer *index_entry_ptr = nullptr;
-      peloton::ItemPointer location =
-          target_table->InsertTuple(tuple.get(), current_txn, &index_entry_ptr);
-
-      // it is possible that some concurrent transactions have inserted the same
-      // tuple.
-      // in this case, abort the transaction.
-      if (location.block == INVALID_OID) {
-        transaction_manager.SetTransactionResult(current_txn,
-                                                 peloton::ResultType::FAILURE);
-        return false;
-      }
-
-      transaction_manager.PerformInsert(current_txn, location, index_entry_ptr);
-
-      executor_context_->num_processed += 1;  // insert one
+    // insert the tuples into the table as one batch.
+    // it is possible that some concurrent transactions have inserted the same
+    // tuple.
+    // in this case, abort the transaction.
+    if (InsertBatch(target_table, batch) == false) {
+      return false;
     }
 
     // execute after-insert-statement triggers and
@@ -182,8 +174,40 @@ bool InsertExecutor::DExecute() {
       tuple = storage_tuple.get();
     }
 
+    // Without per-row triggers the values are inserted as one batch
+    oid_t row_insert_count = bulk_insert_count;
+    if (!project_info && !HasRowTriggers(target_table->GetTriggerList())) {
+      row_insert_count = 0;
+      std::vector<std::unique_ptr<storage::Tuple>> tuples;
+      std::vector<const storage::Tuple *> batch;
+      uint32_t num_columns = schema->GetColumnCount();
+      for (oid_t insert_itr = 0; insert_itr < bulk_insert_count;
+           insert_itr++) {
+        tuple = node.GetTuple(insert_itr);
+
+        if (tuple == nullptr) {
+          std::unique_ptr<storage::Tuple> values_tuple(
+              new storage::Tuple(schema, true));
+
+          // read from values
+          for (uint32_t col_id = 0; col_id < num_columns; col_id++) {
+            auto value = node.GetValue(col_id + insert_itr * num_columns);
+            values_tuple->SetValue(col_id, value, executor_pool);
+          }
+
+          tuple = values_tuple.get();
+          tuples.push_back(std::move(values_tuple));
+        }
+        batch.push_back(tuple);
+      }
+
+      if (InsertBatch(target_table, batch) == false) {
+        return false;
+      }
+    }
+
     // Bulk Insert Mode
-    for (oid_t insert_itr = 0; insert_itr < bulk_insert_count; insert_itr++) {
+    for (oid_t insert_itr = 0; insert_itr < row_insert_count; insert_itr++) {
       // if we are doing a bulk insert from values not project_info
 
       if (!project_info) {
@@ -305,5 +329,33 @@ bool InsertExecutor::DExecute() {
   return true;
 }
 
+bool InsertExecutor::HasRowTriggers(trigger::TriggerList *trigger_list) {
+  return trigger_list != nullptr &&
+         (trigger_list->HasTriggerType(TriggerType::BEFORE_INSERT_ROW) ||
+          trigger_list->HasTriggerType(TriggerType::AFTER_INSERT_ROW) ||
+          trigger_list->HasTriggerType(TriggerType::ON_COMMIT_INSERT_ROW));
+}
+
+bool InsertExecutor::InsertBatch(
+    storage::DataTable *target_table,
+    const std::vector<const storage::Tuple *> &tuples) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+
+  std::vector<ItemPointer> locations;
+  if (target_table->InsertTuples(tuples, current_txn, locations) == false) {
+    LOG_TRACE("Failed to Insert. Set txn failure.");
+    transaction_manager.SetTransactionResult(current_txn, ResultType::FAILURE);
+    return false;
+  }
+
+  LOG_TRACE("Number of tuples in table after insert: %lu",
+            target_table->GetTupleCount());
+
+  executor_context_->num_processed += tuples.size();
+  return true;
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -15,7 +15,9 @@
 #include "planner/limit_plan.h"
 #include "common/logger.h"
 #include "common/internal_types.h"
+#include "executor/abstract_scan_executor.h"
 #include "executor/logical_tile.h"
+#include "executor/projection_executor.h"
 
 namespace peloton {
 namespace executor {
@@ -38,6 +40,19 @@ bool LimitExecutor::DInit() {
   num_skipped_ = 0;
   num_returned_ = 0;
 
+  // A scan below projections that keep its tuple count can stop once it has
+  // produced the tuples we skip and return
+  AbstractExecutor *child = children_[0];
+  while (dynamic_cast<ProjectionExecutor *>(child) != nullptr &&
+         child->GetChildren().size() == 1) {
+    child = child->GetChildren()[0];
+  }
+  auto scan_executor = dynamic_cast<AbstractScanExecutor *>(child);
+  if (scan_executor != nullptr) {
+    const planner::LimitPlan &node = GetPlanNode<planner::LimitPlan>();
+    scan_executor->SetTupleBudget(node.GetOffset() + node.GetLimit());
+  }
+
   return true;
 }
 
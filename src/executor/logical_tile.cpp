@@ -230,7 +230,7 @@ void LogicalTile::SetValue(type::Value &value UNUSED_ATTRIBUTE,
  *
  * @return Number of tuples.
  */
-size_t LogicalTile::GetTupleCount() { return visible_tuples_; }
+size_t LogicalTile::GetTupleCount() const { return visible_tuples_; }
 
 /**
  * @brief Returns the number of columns.
@@ -13,6 +13,8 @@
 
 #include "executor/materialization_executor.h"
 
+#include <cstring>
+
 #include "common/logger.h"
 #include "common/macros.h"
 #include "planner/materialization_plan.h"
@@ -39,6 +41,11 @@ void MaterializeColumnAtATime(
     const std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols,
     storage::Tile *dest_tile);
 
+// Column copy without building a Value per cell, false if the column is not
+// a fixed width or varlen column of the same type in both tiles
+bool MaterializeColumnInBulk(LogicalTile *source_tile, oid_t old_col_id,
+                             oid_t new_column_id, storage::Tile *dest_tile);
+
 /**
  * @brief Constructor for the materialization executor.
  * @param node Materialization node corresponding to this executor.
@@ -151,6 +158,16 @@ void MaterializeRowAtAtATime(
     for (oid_t old_col_id : old_column_ids) {
       auto &column_info = schema[old_col_id];
 
+      // Old to new column mapping
+      auto it = old_to_new_cols.find(old_col_id);
+      PELOTON_ASSERT(it != old_to_new_cols.end());
+
+      // Copy the column in bulk if possible, a tuple at a time otherwise
+      if (MaterializeColumnInBulk(source_tile, old_col_id, it->second,
+                                  dest_tile)) {
+        continue;
+      }
+
       // Get the position list
       old_column_position_idxs.push_back(column_info.position_list_idx);
 
@@ -166,10 +183,6 @@ void MaterializeRowAtAtATime(
       const bool old_is_inlined = old_schema->IsInlined(old_column_id);
       old_is_inlineds.push_back(old_is_inlined);
 
-      // Old to new column mapping
-      auto it = old_to_new_cols.find(old_col_id);
-      PELOTON_ASSERT(it != old_to_new_cols.end());
-
       // Get new column information
       oid_t new_column_id = it->second;
       auto new_schema = dest_tile->GetSchema();
@@ -182,7 +195,10 @@ void MaterializeRowAtAtATime(
       new_column_lengths.push_back(new_column_length);
     }
 
-    PELOTON_ASSERT(new_column_offsets.size() == old_column_ids.size());
+    PELOTON_ASSERT(new_column_offsets.size() == old_column_position_idxs.size());
+    if (old_column_position_idxs.empty()) {
+      continue;
+    }
 
     ///////////////////////////
     // EACH TUPLE
@@ -240,6 +256,16 @@ void MaterializeColumnAtATime(
     ///////////////////////////
     // Go over each column in given base physical tile
     for (oid_t old_col_id : old_column_ids) {
+      // Old to new column mapping
+      auto it = old_to_new_cols.find(old_col_id);
+      PELOTON_ASSERT(it != old_to_new_cols.end());
+      oid_t new_column_id = it->second;
+
+      if (MaterializeColumnInBulk(source_tile, old_col_id, new_column_id,
+                                  dest_tile)) {
+        continue;
+      }
+
       auto &column_info = source_tile->GetColumnInfo(old_col_id);
 
       // Amortize schema lookups once per column
@@ -252,12 +278,7 @@ void MaterializeColumnAtATime(
       const type::TypeId old_column_type = old_schema->GetType(old_column_id);
       const bool old_is_inlined = old_schema->IsInlined(old_column_id);
 
-      // Old to new column mapping
-      auto it = old_to_new_cols.find(old_col_id);
-      PELOTON_ASSERT(it != old_to_new_cols.end());
-
       // Get new column information
-      oid_t new_column_id = it->second;
       auto new_schema = dest_tile->GetSchema();
       const size_t new_column_offset = new_schema->GetOffset(new_column_id);
       const bool new_is_inlined = new_schema->IsInlined(new_column_id);
@@ -293,6 +314,137 @@ void MaterializeColumnAtATime(
   }
 }
 
+// Copies the values of the fixed width column, a field of size bytes in
+// tuples of src_stride and dest_stride bytes, a typed load and store each
+template <typename T>
+void GatherFixedWidth(const char *src, size_t src_stride, char *dest,
+                      size_t dest_stride, const oid_t *base_tuple_ids,
+                      size_t tuple_count) {
+  for (size_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    T value;
+    PELOTON_MEMCPY(&value, src + base_tuple_ids[tuple_itr] * src_stride,
+                   sizeof(T));
+    PELOTON_MEMCPY(dest + tuple_itr * dest_stride, &value, sizeof(T));
+  }
+}
+
+bool MaterializeColumnInBulk(LogicalTile *source_tile, oid_t old_col_id,
+                             oid_t new_column_id, storage::Tile *dest_tile) {
+  auto &column_info = source_tile->GetColumnInfo(old_col_id);
+  storage::Tile *old_tile = column_info.base_tile.get();
+  auto old_schema = old_tile->GetSchema();
+  oid_t old_column_id = column_info.origin_column_id;
+  auto new_schema = dest_tile->GetSchema();
+
+  // SetValueFast stores a value in its own type, so the bytes of the old
+  // column are those of the new one only if the types are the same
+  const type::TypeId column_type = old_schema->GetType(old_column_id);
+  const bool is_inlined = old_schema->IsInlined(old_column_id);
+  if (column_type != new_schema->GetType(new_column_id) ||
+      is_inlined != new_schema->IsInlined(new_column_id)) {
+    return false;
+  }
+  const bool is_varlen = column_type == type::TypeId::VARCHAR ||
+                         column_type == type::TypeId::VARBINARY;
+  if (is_varlen == is_inlined || column_type == type::TypeId::ARRAY) {
+    return false;
+  }
+
+  // The base tuple of each visible tuple, in order
+  auto &column_position_list =
+      source_tile->GetPositionList(column_info.position_list_idx);
+  std::vector<oid_t> base_tuple_ids;
+  base_tuple_ids.reserve(source_tile->GetTupleCount());
+  for (oid_t old_tuple_id : *source_tile) {
+    base_tuple_ids.push_back(column_position_list[old_tuple_id]);
+  }
+  if (base_tuple_ids.empty()) {
+    return true;
+  }
+
+  const char *src = old_tile->GetTupleLocation(0) +
+                    old_schema->GetOffset(old_column_id);
+  const size_t src_stride = old_schema->GetLength();
+  char *dest = dest_tile->GetTupleLocation(0) +
+               new_schema->GetOffset(new_column_id);
+  const size_t dest_stride = new_schema->GetLength();
+  const size_t tuple_count = base_tuple_ids.size();
+
+  if (is_varlen) {
+    // A varlen field points to its length followed by its bytes. The values
+    // of the column are copied back to back into one block of the pool of
+    // the new tile, freed with it.
+    size_t total_size = 0;
+    for (auto base_tuple_id : base_tuple_ids) {
+      auto data = *reinterpret_cast<const char *const *>(
+          src + base_tuple_id * src_stride);
+      if (data != nullptr) {
+        total_size +=
+            sizeof(uint32_t) + *reinterpret_cast<const uint32_t *>(data);
+      }
+    }
+    char *block = nullptr;
+    if (total_size > 0) {
+      block = reinterpret_cast<char *>(
+          dest_tile->GetPool()->Allocate(total_size));
+    }
+    for (size_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      auto data = *reinterpret_cast<const char *const *>(
+          src + base_tuple_ids[tuple_itr] * src_stride);
+      char *copy = nullptr;
+      if (data != nullptr) {
+        size_t size =
+            sizeof(uint32_t) + *reinterpret_cast<const uint32_t *>(data);
+        PELOTON_MEMCPY(block, data, size);
+        copy = block;
+        block += size;
+      }
+      PELOTON_MEMCPY(dest + tuple_itr * dest_stride, &copy, sizeof(char *));
+    }
+    return true;
+  }
+
+  const size_t size = type::Type::GetTypeSize(column_type);
+  if (size == src_stride && size == dest_stride) {
+    // Both tiles hold only this column: copy each run of consecutive base
+    // tuples at once
+    size_t run_begin = 0;
+    for (size_t tuple_itr = 1; tuple_itr <= tuple_count; tuple_itr++) {
+      if (tuple_itr < tuple_count &&
+          base_tuple_ids[tuple_itr] == base_tuple_ids[tuple_itr - 1] + 1) {
+        continue;
+      }
+      PELOTON_MEMCPY(dest + run_begin * size,
+                     src + base_tuple_ids[run_begin] * size,
+                     (tuple_itr - run_begin) * size);
+      run_begin = tuple_itr;
+    }
+    return true;
+  }
+
+  switch (size) {
+    case 1:
+      GatherFixedWidth<uint8_t>(src, src_stride, dest, dest_stride,
+                                base_tuple_ids.data(), tuple_count);
+      break;
+    case 2:
+      GatherFixedWidth<uint16_t>(src, src_stride, dest, dest_stride,
+                                 base_tuple_ids.data(), tuple_count);
+      break;
+    case 4:
+      GatherFixedWidth<uint32_t>(src, src_stride, dest, dest_stride,
+                                 base_tuple_ids.data(), tuple_count);
+      break;
+    case 8:
+      GatherFixedWidth<uint64_t>(src, src_stride, dest, dest_stride,
+                                 base_tuple_ids.data(), tuple_count);
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
 std::unordered_map<oid_t, oid_t> MaterializationExecutor::BuildIdentityMapping(
     const catalog::Schema *schema) {
   std::unordered_map<oid_t, oid_t> old_to_new_cols;
@@ -10,16 +10,30 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "common/internal_types.h"
 #include "common/logger.h"
+#include "executor/index_scan_executor.h"
 #include "executor/logical_tile_factory.h"
 #include "executor/merge_join_executor.h"
 #include "expression/abstract_expression.h"
 #include "common/container_tuple.h"
+#include "threadpool/parallel_for.h"
 
 namespace peloton {
 namespace executor {
 
+namespace {
+
+// # of left rows a range of keys is joined on, at least
+const size_t RANGE_ROW_COUNT = 1 << 14;
+
+// # of rows whose keys are evaluated at once
+const size_t KEY_CHUNK_SIZE = 1 << 14;
+
+}  // namespace
+
 /**
  * @brief Constructor for nested loop join executor.
  * @param node Nested loop join node corresponding to this executor.
@@ -40,6 +54,9 @@ bool MergeJoinExecutor::DInit() {
 
   if (join_clauses_ == nullptr) return false;
 
+  range_partitioned_ = IsRangePartitioned();
+  ranges_joined_ = false;
+
   return true;
 }
 
@@ -56,6 +73,20 @@ bool MergeJoinExecutor::DExecute() {
       left_start_row, left_end_row, left_child_done_, right_start_row,
       right_end_row, right_child_done_);
 
+  if (range_partitioned_) {
+    if (ranges_joined_ == false) {
+      JoinRanges();
+      ranges_joined_ = true;
+    }
+
+    if (buffered_output_tiles_.empty() == false) {
+      SetOutput(buffered_output_tiles_.front());
+      buffered_output_tiles_.pop_front();
+      return true;
+    }
+    return BuildOuterJoinOutput();
+  }
+
   // Build outer join output when done
   if (right_child_done_ && left_child_done_) {
     return BuildOuterJoinOutput();
@@ -280,5 +311,216 @@ size_t MergeJoinExecutor::Advance(LogicalTile *tile, size_t start_row,
   return end_row;
 }
 
+bool MergeJoinExecutor::IsRangePartitioned() {
+  if (children_.size() != 2 || join_clauses_->empty()) {
+    return false;
+  }
+  return dynamic_cast<IndexScanExecutor *>(children_[0]) != nullptr &&
+         dynamic_cast<IndexScanExecutor *>(children_[1]) != nullptr;
+}
+
+void MergeJoinExecutor::JoinRanges() {
+  while (children_[0]->Execute()) {
+    BufferLeftTile(children_[0]->GetOutput());
+  }
+  left_child_done_ = true;
+  while (children_[1]->Execute()) {
+    BufferRightTile(children_[1]->GetOutput());
+  }
+  right_child_done_ = true;
+
+  GatherRows(true, left_rows_, left_keys_);
+  GatherRows(false, right_rows_, right_keys_);
+  size_t key_size = join_clauses_->size();
+
+  // A range starts at a left row whose key differs from the key before it,
+  // and at the first right row whose key is not less than that key, so that
+  // the rows of a key are all joined in the same range
+  size_t range_count = std::max<size_t>(1, left_rows_.size() / RANGE_ROW_COUNT);
+  std::vector<size_t> left_bounds(1, 0);
+  std::vector<size_t> right_bounds(1, 0);
+  for (size_t range_id = 1; range_id < range_count; range_id++) {
+    size_t left_bound =
+        std::max(range_id * left_rows_.size() / range_count, left_bounds.back());
+    while (left_bound < left_rows_.size() &&
+           left_bound > left_bounds.back() &&
+           CompareKeys(&left_keys_[(left_bound - 1) * key_size],
+                       &left_keys_[left_bound * key_size]) == 0) {
+      left_bound++;
+    }
+    if (left_bound == left_bounds.back() || left_bound == left_rows_.size()) {
+      continue;
+    }
+
+    const type::Value *separator = &left_keys_[left_bound * key_size];
+    size_t low = right_bounds.back();
+    size_t high = right_rows_.size();
+    while (low < high) {
+      size_t middle = low + (high - low) / 2;
+      if (CompareKeys(&right_keys_[middle * key_size], separator) < 0) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    left_bounds.push_back(left_bound);
+    right_bounds.push_back(low);
+  }
+  left_bounds.push_back(left_rows_.size());
+  right_bounds.push_back(right_rows_.size());
+  range_count = left_bounds.size() - 1;
+  LOG_TRACE("Merge joining %lu left and %lu right rows in %lu ranges",
+            left_rows_.size(), right_rows_.size(), range_count);
+
+  std::vector<std::vector<Match>> range_matches(range_count);
+  threadpool::ParallelFor(range_count, [&](size_t range_id) {
+    MergeRange(left_bounds[range_id], left_bounds[range_id + 1],
+               right_bounds[range_id], right_bounds[range_id + 1],
+               range_matches[range_id]);
+  });
+
+  // A join tile per run of matches of the same pair of left and right
+  // tiles, in the order of the ranges
+  std::unique_ptr<LogicalTile> output_tile;
+  LogicalTile::PositionListsBuilder pos_lists_builder;
+  oid_t prev_left_tile = INVALID_OID;
+  oid_t prev_right_tile = INVALID_OID;
+  for (auto &matches : range_matches) {
+    for (auto &match : matches) {
+      const Row &left_row = left_rows_[match.left_row];
+      const Row &right_row = right_rows_[match.right_row];
+      if (left_row.tile_offset != prev_left_tile ||
+          right_row.tile_offset != prev_right_tile) {
+        if (pos_lists_builder.Size() > 0) {
+          output_tile->SetPositionListsAndVisibility(
+              pos_lists_builder.Release());
+          buffered_output_tiles_.push_back(output_tile.release());
+        }
+
+        LogicalTile *left_tile =
+            left_result_tiles_[left_row.tile_offset].get();
+        LogicalTile *right_tile =
+            right_result_tiles_[right_row.tile_offset].get();
+        output_tile = BuildOutputLogicalTile(left_tile, right_tile);
+        pos_lists_builder =
+            LogicalTile::PositionListsBuilder(left_tile, right_tile);
+        prev_left_tile = left_row.tile_offset;
+        prev_right_tile = right_row.tile_offset;
+      }
+
+      pos_lists_builder.AddRow(left_row.tuple_id, right_row.tuple_id);
+      RecordMatchedLeftRow(left_row.tile_offset, left_row.tuple_id);
+      RecordMatchedRightRow(right_row.tile_offset, right_row.tuple_id);
+    }
+  }
+  if (pos_lists_builder.Size() > 0) {
+    output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+    buffered_output_tiles_.push_back(output_tile.release());
+  }
+
+  left_keys_.clear();
+  right_keys_.clear();
+}
+
+void MergeJoinExecutor::GatherRows(bool is_left, std::vector<Row> &rows,
+                                   std::vector<type::Value> &keys) {
+  auto &tiles = is_left ? left_result_tiles_ : right_result_tiles_;
+  rows.clear();
+  for (size_t tile_offset = 0; tile_offset < tiles.size(); tile_offset++) {
+    for (oid_t tuple_id : *tiles[tile_offset]) {
+      rows.push_back(Row{static_cast<oid_t>(tile_offset), tuple_id});
+    }
+  }
+
+  // The keys are evaluated as Advance evaluates them
+  size_t key_size = join_clauses_->size();
+  keys.clear();
+  keys.resize(rows.size() * key_size);
+  size_t chunk_count = (rows.size() + KEY_CHUNK_SIZE - 1) / KEY_CHUNK_SIZE;
+  threadpool::ParallelFor(chunk_count, [&](size_t chunk_id) {
+    size_t end = std::min(rows.size(), (chunk_id + 1) * KEY_CHUNK_SIZE);
+    for (size_t i = chunk_id * KEY_CHUNK_SIZE; i < end; i++) {
+      ContainerTuple<LogicalTile> tuple(tiles[rows[i].tile_offset].get(),
+                                        rows[i].tuple_id);
+      for (size_t clause_itr = 0; clause_itr < key_size; clause_itr++) {
+        auto &clause = (*join_clauses_)[clause_itr];
+        auto expr = is_left ? clause.left_.get() : clause.right_.get();
+        keys[i * key_size + clause_itr] =
+            expr->Evaluate(&tuple, &tuple, executor_context_);
+      }
+    }
+  });
+}
+
+int MergeJoinExecutor::CompareKeys(const type::Value *a,
+                                   const type::Value *b) const {
+  for (size_t clause_itr = 0; clause_itr < join_clauses_->size();
+       clause_itr++) {
+    if (a[clause_itr].CompareLessThan(b[clause_itr]) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (a[clause_itr].CompareGreaterThan(b[clause_itr]) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+void MergeJoinExecutor::MergeRange(size_t left_begin, size_t left_end,
+                                   size_t right_begin, size_t right_end,
+                                   std::vector<Match> &matches) {
+  size_t key_size = join_clauses_->size();
+  size_t left_itr = left_begin;
+  size_t right_itr = right_begin;
+  while (left_itr < left_end && right_itr < right_end) {
+    const type::Value *left_key = &left_keys_[left_itr * key_size];
+    int cmp = CompareKeys(left_key, &right_keys_[right_itr * key_size]);
+    if (cmp < 0) {
+      left_itr++;
+      continue;
+    }
+    if (cmp > 0) {
+      right_itr++;
+      continue;
+    }
+
+    // The rows of the key on both sides
+    size_t left_group_end = left_itr + 1;
+    while (left_group_end < left_end &&
+           CompareKeys(left_key, &left_keys_[left_group_end * key_size]) ==
+               0) {
+      left_group_end++;
+    }
+    size_t right_group_end = right_itr + 1;
+    while (right_group_end < right_end &&
+           CompareKeys(left_key, &right_keys_[right_group_end * key_size]) ==
+               0) {
+      right_group_end++;
+    }
+
+    for (size_t left_row = left_itr; left_row < left_group_end; left_row++) {
+      for (size_t right_row = right_itr; right_row < right_group_end;
+           right_row++) {
+        if (predicate_ != nullptr) {
+          ContainerTuple<LogicalTile> left_tuple(
+              left_result_tiles_[left_rows_[left_row].tile_offset].get(),
+              left_rows_[left_row].tuple_id);
+          ContainerTuple<LogicalTile> right_tuple(
+              right_result_tiles_[right_rows_[right_row].tile_offset].get(),
+              right_rows_[right_row].tuple_id);
+          if (predicate_->Evaluate(&left_tuple, &right_tuple,
+                                   executor_context_).IsFalse()) {
+            continue;
+          }
+        }
+        matches.push_back(Match{left_row, right_row});
+      }
+    }
+
+    left_itr = left_group_end;
+    right_itr = right_group_end;
+  }
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <limits>
 
 #include "common/logger.h"
 #include "executor/logical_tile.h"
@@ -19,6 +20,7 @@
 #include "executor/executor_context.h"
 
 #include "planner/order_by_plan.h"
+#include "settings/settings_manager.h"
 #include "storage/tile.h"
 
 namespace peloton {
@@ -39,6 +41,8 @@ bool OrderByExecutor::DInit() {
 
   sort_done_ = false;
   num_tuples_returned_ = 0;
+  num_tuples_get_ = 0;
+  sorter_.reset();
 
   // Grab info from plan node and check it
   const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
@@ -60,35 +64,33 @@ bool OrderByExecutor::DExecute() {
 
   if (!sort_done_) DoSort();
 
-  if (!(num_tuples_returned_ < sort_buffer_.size())) {
+  if (sorter_ == nullptr ||
+      !(num_tuples_returned_ < sorter_->GetRowCount())) {
     return false;
   }
 
   PELOTON_ASSERT(sort_done_);
   PELOTON_ASSERT(output_schema_.get());
-  PELOTON_ASSERT(input_tiles_.size() > 0);
 
   // Returned tiles must be newly created physical tiles.
   // NOTE: the schema of these tiles might not match the input tiles when some
   // of the order by columns are not be part of the output schema
 
   size_t tile_size = std::min(size_t(TEST_TUPLES_PER_TILEGROUP),
-                              sort_buffer_.size() - num_tuples_returned_);
+                              sorter_->GetRowCount() - num_tuples_returned_);
 
   std::shared_ptr<storage::Tile> ptile(storage::TileFactory::GetTile(
       BackendType::MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
       nullptr, *output_schema_, nullptr, tile_size));
 
+  std::vector<type::Value> values;
   for (size_t id = 0; id < tile_size; id++) {
-    oid_t source_tile_id =
-        sort_buffer_[num_tuples_returned_ + id].item_pointer.block;
-    oid_t source_tuple_id =
-        sort_buffer_[num_tuples_returned_ + id].item_pointer.offset;
+    const char *row = sorter_->Next();
+    PELOTON_ASSERT(row != nullptr);
+    sorter_->GetOutputValues(row, values);
     // Insert a physical tuple into physical tile
     for (oid_t i = 0; i < output_schema_->GetColumnCount(); i++) {
-      type::Value val =
-          (input_tiles_[source_tile_id]->GetValue(source_tuple_id, output_column_ids_[i]));
-      ptile.get()->SetValue(val, id, i);
+      ptile.get()->SetValue(values[i], id, i);
     }
   }
 
@@ -101,7 +103,7 @@ bool OrderByExecutor::DExecute() {
 
   num_tuples_returned_ += tile_size;
 
-  PELOTON_ASSERT(num_tuples_returned_ <= sort_buffer_.size());
+  PELOTON_ASSERT(num_tuples_returned_ <= sorter_->GetRowCount());
 
   return true;
 }
@@ -112,110 +114,54 @@ bool OrderByExecutor::DoSort() {
   PELOTON_ASSERT(!sort_done_);
   PELOTON_ASSERT(executor_context_ != nullptr);
 
-  // Extract all data from child
-  while (children_[0]->Execute()) {
-    input_tiles_.emplace_back(children_[0]->GetOutput());
-
-    // increase the counter
-    num_tuples_get_ += input_tiles_.back()->GetTupleCount();
-
-    // Optimization for ordered output
-    if (limit_) {
-      // We already get enough tuples, break while
-      if (num_tuples_get_ >= (limit_offset_ + limit_number_)) {
-        LOG_TRACE("num_tuples_get_ (%lu) are enough", num_tuples_get_);
-        break;
-      }
-    }
-  }
-
-  /** Number of valid tuples to be sorted. */
-  size_t count = 0;
-  for (auto &tile : input_tiles_) {
-    count += tile->GetTupleCount();
-  }
-
-  if (count == 0) return true;
-
   // Grab data from plan node
   const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
   descend_flags_ = node.GetDescendFlags();
-
-  // Extract the schema for sort keys.
-
-  std::unique_ptr<catalog::Schema> physical_schema;
-  physical_schema.reset(input_tiles_[0]->GetPhysicalSchema());
-  std::vector<catalog::Column> sort_key_columns;
-  std::vector<catalog::Column> output_key_columns;
-  for (auto id : node.GetSortKeys()) {
-    sort_key_columns.push_back(physical_schema->GetColumn(id));
-  }
-  for (auto id : node.GetOutputColumnIds()) {
-    output_key_columns.push_back(physical_schema->GetColumn(id));
-  }
   output_column_ids_ = node.GetOutputColumnIds();
-  sort_key_tuple_schema_.reset(new catalog::Schema(sort_key_columns));
-  output_schema_.reset(new catalog::Schema(output_key_columns));
-  auto executor_pool = executor_context_->GetPool();
-
-  // Extract all valid tuples into a single std::vector (the sort buffer)
-  sort_buffer_.reserve(count);
-  for (oid_t tile_id = 0; tile_id < input_tiles_.size(); tile_id++) {
-    for (oid_t tuple_id : *input_tiles_[tile_id]) {
-      // Extract the sort key tuple
-      std::unique_ptr<storage::Tuple> tuple(
-          new storage::Tuple(sort_key_tuple_schema_.get(), true));
-      for (oid_t id = 0; id < node.GetSortKeys().size(); id++) {
-        type::Value val =
-            (input_tiles_[tile_id]->GetValue(tuple_id, node.GetSortKeys()[id]));
-        tuple->SetValue(id, val, executor_pool);
-      }
-      // Inert the sort key tuple into sort buffer
-      sort_buffer_.emplace_back(sort_buffer_entry_t(
-          ItemPointer(tile_id, tuple_id), std::move(tuple)));
-    }
+
+  // Only the first (limit + offset) tuples in sort order are returned, all
+  // input tuples must be seen to find them
+  size_t max_row_count = std::numeric_limits<size_t>::max();
+  if (limit_) {
+    max_row_count = limit_offset_ + limit_number_;
   }
 
-  PELOTON_ASSERT(count == sort_buffer_.size());
-
-  // Prepare the compare function
-  // Note: This is a less-than comparer, NOT an equality comparer.
-  struct TupleComparer {
-    TupleComparer(std::vector<bool> &_descend_flags)
-        : descend_flags(_descend_flags) {}
-
-    bool operator()(const storage::Tuple *ta, const storage::Tuple *tb) {
-      for (oid_t id = 0; id < descend_flags.size(); id++) {
-        type::Value va = (ta->GetValue(id));
-        type::Value vb = (tb->GetValue(id));
-        if (!descend_flags[id]) {
-          if (va.CompareLessThan(vb) == CmpBool::CmpTrue)
-            return true;
-          else {
-            if (va.CompareGreaterThan(vb) == CmpBool::CmpTrue) return false;
-          }
-        } else {
-          if (vb.CompareLessThan(va) == CmpBool::CmpTrue)
-            return true;
-          else {
-            if (vb.CompareGreaterThan(va) == CmpBool::CmpTrue) return false;
-          }
-        }
+  // Extract all data from child
+  while (children_[0]->Execute()) {
+    std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
+
+    // increase the counter
+    num_tuples_get_ += tile->GetTupleCount();
+
+    if (sorter_ == nullptr) {
+      // Extract the schema for sort keys and output columns
+      std::unique_ptr<catalog::Schema> physical_schema(
+          tile->GetPhysicalSchema());
+      std::vector<type::TypeId> key_types;
+      std::vector<type::TypeId> output_types;
+      std::vector<catalog::Column> output_key_columns;
+      for (auto id : node.GetSortKeys()) {
+        key_types.push_back(physical_schema->GetType(id));
       }
-      return false;  // Will return false if all keys equal
-    }
+      for (auto id : output_column_ids_) {
+        output_key_columns.push_back(physical_schema->GetColumn(id));
+        output_types.push_back(physical_schema->GetType(id));
+      }
+      output_schema_.reset(new catalog::Schema(output_key_columns));
 
-    std::vector<bool> descend_flags;
-  };
+      sorter_.reset(new TupleSorter(
+          node.GetSortKeys(), key_types, descend_flags_, output_column_ids_,
+          output_types, max_row_count,
+          settings::SettingsManager::GetDouble(
+              settings::SettingId::sort_memory_limit)));
+    }
 
-  TupleComparer comp(descend_flags_);
+    sorter_->AddTile(tile.get());
+  }
 
-  // Finally ... sort it !
-  std::sort(
-      sort_buffer_.begin(), sort_buffer_.end(),
-      [&comp](const sort_buffer_entry_t &a, const sort_buffer_entry_t &b) {
-        return comp(a.tuple.get(), b.tuple.get());
-      });
+  if (sorter_ != nullptr) {
+    sorter_->Finish();
+  }
 
   sort_done_ = true;
 
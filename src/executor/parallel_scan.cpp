@@ -0,0 +1,197 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parallel_scan.cpp
+//
+// Identification: src/executor/parallel_scan.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/parallel_scan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+#include "common/logger.h"
+#include "executor/logical_tile.h"
+#include "threadpool/mono_queue_pool.h"
+
+namespace peloton {
+namespace executor {
+
+const oid_t ParallelScan::MORSEL_SIZE;
+
+struct ParallelScan::State {
+  State(oid_t tile_group_count, ScanFunction scan_function)
+      : tile_group_count(tile_group_count),
+        scan_function(std::move(scan_function)) {}
+
+  const oid_t tile_group_count;
+
+  // only called while the scan waits for the morsels in flight
+  const ScanFunction scan_function;
+
+  // offset of the first tile group of the next morsel
+  std::atomic<oid_t> cursor{0};
+
+  // # of logical tiles the exchange queue holds before workers wait
+  size_t capacity = 0;
+
+  std::mutex mutex;
+
+  // signalled when a tile is pushed or a morsel is done
+  std::condition_variable tile_pushed;
+
+  // signalled when a tile is pulled or the scan stops
+  std::condition_variable tile_pulled;
+
+  // the exchange queue
+  std::deque<std::unique_ptr<LogicalTile>> tiles;
+
+  // # of morsels being scanned
+  size_t busy_count = 0;
+
+  bool stopped = false;
+
+  // the first exception thrown by a worker
+  std::exception_ptr error;
+};
+
+ParallelScan::ParallelScan(oid_t tile_group_count, ScanFunction scan_function)
+    : state_(std::make_shared<State>(tile_group_count,
+                                     std::move(scan_function))) {}
+
+ParallelScan::~ParallelScan() {
+  // workers queued on the pool may start long after this, e.g. when every
+  // thread of the pool waits on another scan, they only hold on to state_
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  state_->stopped = true;
+  state_->tile_pulled.notify_all();
+  state_->tile_pushed.wait(lock, [this] { return state_->busy_count == 0; });
+}
+
+void ParallelScan::Start() {
+  started_ = true;
+
+  auto &worker_pool = threadpool::MonoQueuePool::GetExecutionInstance();
+  oid_t tile_group_count = state_->tile_group_count;
+  oid_t morsel_count = (tile_group_count + MORSEL_SIZE - 1) / MORSEL_SIZE;
+  size_t num_workers =
+      std::min<size_t>(worker_pool.NumWorkers(), morsel_count);
+  state_->capacity = 2 * std::max<size_t>(num_workers, 1);
+  LOG_TRACE("Scanning %u tile groups with %lu workers", tile_group_count,
+            num_workers);
+
+  auto state = state_;
+  for (size_t i = 0; i < num_workers; i++) {
+    worker_pool.SubmitTask([state] { Work(*state); });
+  }
+}
+
+LogicalTile *ParallelScan::Next() {
+  if (started_ == false) {
+    Start();
+  }
+
+  State &state = *state_;
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      if (state.error != nullptr) {
+        std::rethrow_exception(state.error);
+      }
+      if (state.tiles.empty() == false) {
+        auto logical_tile = state.tiles.front().release();
+        state.tiles.pop_front();
+        state.tile_pulled.notify_one();
+        return logical_tile;
+      }
+    }
+
+    // rather than wait for the workers, scan a morsel here. this thread
+    // is the one pulling tiles, so it must not wait for room.
+    if (ScanMorsel(state, false)) {
+      continue;
+    }
+
+    // every morsel is taken, wait for those still being scanned
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.tile_pushed.wait(lock, [&state] {
+      return state.tiles.empty() == false || state.busy_count == 0 ||
+             state.error != nullptr;
+    });
+    if (state.tiles.empty() && state.busy_count == 0 &&
+        state.error == nullptr) {
+      return nullptr;
+    }
+  }
+}
+
+void ParallelScan::Work(State &state) {
+  try {
+    while (ScanMorsel(state, true)) {
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.error == nullptr) {
+      state.error = std::current_exception();
+    }
+    state.stopped = true;
+    state.tile_pulled.notify_all();
+  }
+}
+
+bool ParallelScan::ScanMorsel(State &state, bool wait_for_room) {
+  // counted as busy before taking a morsel, so that the executor never
+  // sees no morsel left and none busy while one is being taken
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.stopped) {
+      return false;
+    }
+    state.busy_count++;
+  }
+
+  oid_t begin = state.cursor.fetch_add(MORSEL_SIZE);
+  oid_t end = std::min<oid_t>(begin + MORSEL_SIZE, state.tile_group_count);
+  try {
+    for (oid_t offset = begin; offset < end; offset++) {
+      std::unique_ptr<LogicalTile> logical_tile(state.scan_function(offset));
+      if (logical_tile == nullptr) {
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(state.mutex);
+      if (wait_for_room) {
+        state.tile_pulled.wait(lock, [&state] {
+          return state.tiles.size() < state.capacity || state.stopped;
+        });
+      }
+      if (state.stopped) {
+        break;
+      }
+      state.tiles.push_back(std::move(logical_tile));
+      state.tile_pushed.notify_all();
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.busy_count--;
+    state.tile_pushed.notify_all();
+    throw;
+  }
+
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.busy_count--;
+  state.tile_pushed.notify_all();
+  return begin < end;
+}
+
+}  // namespace executor
+}  // namespace peloton
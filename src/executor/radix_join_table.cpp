@@ -0,0 +1,278 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// radix_join_table.cpp
+//
+// Identification: src/executor/radix_join_table.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/radix_join_table.h"
+
+#include <cstring>
+
+#include "executor/logical_tile.h"
+#include "storage/tile.h"
+#include "threadpool/parallel_for.h"
+#include "type/limits.h"
+#include "util/hash_util.h"
+
+namespace peloton {
+namespace executor {
+
+const size_t RadixJoinTable::MIN_BUILD_ROW_COUNT;
+
+namespace {
+
+// # of build rows a partition is sized for. with two slots per row, its
+// table and locations take about 160KB.
+const size_t ROWS_PER_PARTITION = 4096;
+
+const size_t MAX_PARTITION_BITS = 10;
+
+// # of rows a thread scatters at a time
+const size_t SCATTER_CHUNK_SIZE = 1 << 16;
+
+template <typename T>
+void GatherKeys(const char *column, size_t stride,
+                const LogicalTile::PositionList &position_list,
+                LogicalTile *tile, oid_t tile_offset, T null_value,
+                std::vector<RadixJoinTable::Row> &rows) {
+  for (oid_t tuple_id : *tile) {
+    oid_t base_tuple_id = position_list[tuple_id];
+    // the NULL row of an outer join
+    if (base_tuple_id == NULL_OID) {
+      continue;
+    }
+    T key;
+    std::memcpy(&key, column + base_tuple_id * stride, sizeof(T));
+    if (key != null_value) {
+      rows.push_back({key, tile_offset, tuple_id});
+    }
+  }
+}
+
+}  // namespace
+
+bool RadixJoinTable::IsKeyType(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool RadixJoinTable::GatherRows(LogicalTile *tile, oid_t tile_offset,
+                                oid_t key_column_id, std::vector<Row> &rows) {
+  auto &column_info = tile->GetColumnInfo(key_column_id);
+  auto base_tile = column_info.base_tile.get();
+  auto schema = base_tile->GetSchema();
+  auto type_id = schema->GetType(column_info.origin_column_id);
+  if (IsKeyType(type_id) == false) {
+    return false;
+  }
+
+  auto &position_list = tile->GetPositionList(column_info.position_list_idx);
+  const char *column = base_tile->GetTupleLocation(0) +
+                       schema->GetOffset(column_info.origin_column_id);
+  size_t stride = schema->GetLength();
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+      GatherKeys<int8_t>(column, stride, position_list, tile, tile_offset,
+                         type::PELOTON_INT8_NULL, rows);
+      break;
+    case type::TypeId::SMALLINT:
+      GatherKeys<int16_t>(column, stride, position_list, tile, tile_offset,
+                          type::PELOTON_INT16_NULL, rows);
+      break;
+    case type::TypeId::INTEGER:
+      GatherKeys<int32_t>(column, stride, position_list, tile, tile_offset,
+                          type::PELOTON_INT32_NULL, rows);
+      break;
+    default:
+      GatherKeys<int64_t>(column, stride, position_list, tile, tile_offset,
+                          type::PELOTON_INT64_NULL, rows);
+      break;
+  }
+  return true;
+}
+
+RadixJoinTable::RadixJoinTable(std::vector<Row> &&rows)
+    : row_count_(rows.size()), partition_bits_(0) {
+  while (partition_bits_ < MAX_PARTITION_BITS &&
+         (ROWS_PER_PARTITION << partition_bits_) < row_count_) {
+    partition_bits_++;
+  }
+  partitions_.resize(1 << partition_bits_);
+
+  std::vector<Row> scattered;
+  std::vector<size_t> begins;
+  Scatter(rows, scattered, begins);
+  rows.clear();
+  rows.shrink_to_fit();
+
+  threadpool::ParallelFor(partitions_.size(), [&](size_t partition_id) {
+    BuildPartition(partitions_[partition_id],
+                   scattered.data() + begins[partition_id],
+                   begins[partition_id + 1] - begins[partition_id]);
+  });
+}
+
+std::vector<RadixJoinTable::Row> RadixJoinTable::GetDuplicateRows() const {
+  std::vector<Row> duplicate_rows;
+  for (auto &partition : partitions_) {
+    for (auto &slot : partition.slots) {
+      for (uint32_t i = 1; i < slot.count; i++) {
+        auto &location = partition.locations[slot.begin + i];
+        duplicate_rows.push_back(
+            {slot.key, location.tile_offset, location.tuple_id});
+      }
+    }
+  }
+  return duplicate_rows;
+}
+
+std::vector<RadixJoinTable::Match> RadixJoinTable::Probe(
+    std::vector<Row> &&probe_rows, const MatchFilter &filter) const {
+  std::vector<Row> scattered;
+  std::vector<size_t> begins;
+  Scatter(probe_rows, scattered, begins);
+  probe_rows.clear();
+  probe_rows.shrink_to_fit();
+
+  std::vector<std::vector<Match>> partition_matches(partitions_.size());
+  threadpool::ParallelFor(partitions_.size(), [&](size_t partition_id) {
+    auto &partition = partitions_[partition_id];
+    auto &matches = partition_matches[partition_id];
+    for (size_t i = begins[partition_id]; i < begins[partition_id + 1]; i++) {
+      auto &probe_row = scattered[i];
+      auto &slot = partition.slots[FindSlot(partition, probe_row.key,
+                                            Hash(probe_row.key))];
+      for (uint32_t j = 0; j < slot.count; j++) {
+        auto &location = partition.locations[slot.begin + j];
+        Match match{probe_row.tile_offset, probe_row.tuple_id,
+                    location.tile_offset, location.tuple_id};
+        if (filter == nullptr || filter(match)) {
+          matches.push_back(match);
+        }
+      }
+    }
+  });
+
+  size_t match_count = 0;
+  for (auto &matches : partition_matches) {
+    match_count += matches.size();
+  }
+  std::vector<Match> all_matches;
+  all_matches.reserve(match_count);
+  for (auto &matches : partition_matches) {
+    all_matches.insert(all_matches.end(), matches.begin(), matches.end());
+  }
+  return all_matches;
+}
+
+uint64_t RadixJoinTable::Hash(int64_t key) {
+  // both the high bits the partition is chosen on and the low bits the slot
+  // is chosen on depend on every bit of the key
+  return HashUtil::MixBits(static_cast<uint64_t>(key));
+}
+
+size_t RadixJoinTable::FindSlot(const Partition &partition, int64_t key,
+                                uint64_t hash) {
+  size_t mask = partition.slots.size() - 1;
+  size_t slot_id = hash & mask;
+  while (partition.slots[slot_id].count != 0 &&
+         partition.slots[slot_id].key != key) {
+    slot_id = (slot_id + 1) & mask;
+  }
+  return slot_id;
+}
+
+void RadixJoinTable::Scatter(const std::vector<Row> &rows,
+                             std::vector<Row> &scattered,
+                             std::vector<size_t> &begins) const {
+  size_t partition_count = partitions_.size();
+  size_t chunk_count =
+      (rows.size() + SCATTER_CHUNK_SIZE - 1) / SCATTER_CHUNK_SIZE;
+
+  // the # of rows of each chunk that go to each partition
+  std::vector<std::vector<size_t>> histograms(
+      chunk_count, std::vector<size_t>(partition_count, 0));
+  threadpool::ParallelFor(chunk_count, [&](size_t chunk_id) {
+    size_t end = std::min(rows.size(), (chunk_id + 1) * SCATTER_CHUNK_SIZE);
+    auto &histogram = histograms[chunk_id];
+    for (size_t i = chunk_id * SCATTER_CHUNK_SIZE; i < end; i++) {
+      histogram[GetPartitionId(Hash(rows[i].key))]++;
+    }
+  });
+
+  // each chunk writes its rows of a partition after those of the chunks
+  // before it, the histograms become the offsets the chunks write at
+  begins.assign(partition_count + 1, 0);
+  size_t offset = 0;
+  for (size_t partition_id = 0; partition_id < partition_count;
+       partition_id++) {
+    begins[partition_id] = offset;
+    for (auto &histogram : histograms) {
+      size_t count = histogram[partition_id];
+      histogram[partition_id] = offset;
+      offset += count;
+    }
+  }
+  begins[partition_count] = offset;
+
+  scattered.resize(rows.size());
+  threadpool::ParallelFor(chunk_count, [&](size_t chunk_id) {
+    size_t end = std::min(rows.size(), (chunk_id + 1) * SCATTER_CHUNK_SIZE);
+    auto &offsets = histograms[chunk_id];
+    for (size_t i = chunk_id * SCATTER_CHUNK_SIZE; i < end; i++) {
+      scattered[offsets[GetPartitionId(Hash(rows[i].key))]++] = rows[i];
+    }
+  });
+}
+
+void RadixJoinTable::BuildPartition(Partition &partition, const Row *rows,
+                                    size_t row_count) {
+  // at most half of the slots are taken
+  size_t slot_count = 2;
+  while (slot_count < 2 * row_count) {
+    slot_count <<= 1;
+  }
+  partition.slots.assign(slot_count, Slot{0, 0, 0});
+
+  // count the rows of each key
+  for (size_t i = 0; i < row_count; i++) {
+    auto &slot = partition.slots[FindSlot(partition, rows[i].key,
+                                          Hash(rows[i].key))];
+    slot.key = rows[i].key;
+    slot.count++;
+  }
+
+  // give each key its range of locations, begin points past its end until
+  // the range is filled
+  uint32_t end = 0;
+  for (auto &slot : partition.slots) {
+    end += slot.count;
+    slot.begin = end;
+  }
+
+  // fill the ranges back to front, so that the rows of a key keep the
+  // order they were added in
+  partition.locations.resize(row_count);
+  for (size_t i = row_count; i-- > 0;) {
+    auto &slot = partition.slots[FindSlot(partition, rows[i].key,
+                                          Hash(rows[i].key))];
+    partition.locations[--slot.begin] = {rows[i].tile_offset,
+                                         rows[i].tuple_id};
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
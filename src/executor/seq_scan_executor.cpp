@@ -12,6 +12,8 @@
 
 #include "executor/seq_scan_executor.h"
 
+#include <algorithm>
+
 #include <include/storage/tuple_iterator.h>
 
 
@@ -22,15 +24,18 @@
 #include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
+#include "executor/vectorized_predicate.h"
 #include "expression/abstract_expression.h"
 #include "expression/comparison_expression.h"
 #include "expression/conjunction_expression.h"
 #include "expression/constant_value_expression.h"
 #include "expression/tuple_value_expression.h"
 #include "planner/create_plan.h"
+#include "storage/compressed_tile_group.h"
 #include "storage/data_table.h"
 #include "storage/storage_manager.h"
 #include "storage/tile.h"
+#include "storage/tile_group_header.h"
 #include "type/value_factory.h"
 #include "expression/parameter_value_expression.h"
 
@@ -64,6 +69,8 @@ bool SeqScanExecutor::DInit() {
   target_table_ = node.GetTable();
 
   current_tile_group_offset_ = START_OID;
+  parallel_scan_.reset();
+  read_failed_ = false;
 
   old_predicate_ = predicate_;
 
@@ -75,6 +82,9 @@ bool SeqScanExecutor::DInit() {
       std::iota(column_ids_.begin(), column_ids_.end(), 0);
     }
   }
+  PrunePartitions();
+  FindClusteredPages();
+  VectorizePredicate();
   table_id = target_table_->GetOid();
   table_name = target_table_->GetName();
   database_id = target_table_->GetDatabaseOid();
@@ -133,7 +143,7 @@ bool SeqScanExecutor::DInit() {
  * @brief Creates logical tile from tile group and applies scan predicate.
  * @return true on success, false otherwise.
  */
-bool SeqScanExecutor::DExecute() {
+bool SeqScanExecutor::DScan() {
 
   // Scanning over a logical tile.
   if (children_.size() == 1 &&
@@ -202,64 +212,82 @@ bool SeqScanExecutor::DExecute() {
       index_done_ = true;
     }
 
-//    concurrency::TransactionManager &transaction_manager =
-//        concurrency::TransactionManagerFactory::GetInstance();
+    concurrency::TransactionManager &transaction_manager =
+        concurrency::TransactionManagerFactory::GetInstance();
 
-//    bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
-//    auto current_txn = executor_context_->GetTransaction();
+    auto current_txn = executor_context_->GetTransaction();
 
+    // the tile groups of a large table are scanned on the execution pool
+    if (IsParallelScan()) {
+      if (parallel_scan_ == nullptr) {
+        parallel_scan_.reset(new ParallelScan(
+            table_tile_group_count_, [this](oid_t tile_group_offset) {
+              return ScanTileGroup(tile_group_offset);
+            }));
+      }
+      std::unique_ptr<LogicalTile> logical_tile(parallel_scan_->Next());
+      if (read_failed_) {
+        transaction_manager.SetTransactionResult(current_txn,
+                                                 ResultType::FAILURE);
+        return false;
+      }
+      if (logical_tile == nullptr) {
+        return false;
+      }
+      SetOutput(logical_tile.release());
+      return true;
+    }
+
+    // a clustered table is scanned page by page in key order, skipping the
+    // pages whose keys the predicate rules out
+    if (target_table_->IsClustered()) {
+      while (current_page_offset_ < scan_pages_.size()) {
+        auto tile_group = target_table_->GetTileGroupById(
+            scan_pages_[current_page_offset_++]);
+        oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+
+        std::vector<oid_t> position_list;
+        if (BuildPositionList(tile_group.get(), active_tuple_count,
+                              position_list) == false) {
+          transaction_manager.SetTransactionResult(current_txn,
+                                                   ResultType::FAILURE);
+          return false;
+        }
+
+        // Don't return empty tiles
+        if (position_list.size() == 0) {
+          continue;
+        }
+
+        std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+        logical_tile->AddColumns(tile_group, column_ids_);
+        logical_tile->AddPositionList(std::move(position_list));
+        SetOutput(logical_tile.release());
+        return true;
+      }
+      return false;
+    }
 
     if(seq_scan_type == SeqScanType::HEAPARRAYSCAN){
       // Retrieve next tile group.
       while (current_tile_group_offset_ < table_tile_group_count_) {
         auto tile_group =
             target_table_->GetTileGroup(current_tile_group_offset_++);
-//        auto tile_group_header = tile_group->GetHeader();
-
+        // dropped after compaction
+        if (tile_group == nullptr ||
+            IsPrunedTileGroup(tile_group->GetTileGroupId())) {
+          continue;
+        }
         oid_t active_tuple_count = tile_group->GetNextTupleSlot();
 
         // Construct position list by looping through tile group
         // and applying the predicate.
         std::vector<oid_t> position_list;
-        for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-//          ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
-
-//          auto visibility = transaction_manager.IsVisible(
-//              current_txn, tile_group_header, tuple_id);
-
-          // check transaction visibility
-//          if (visibility == VisibilityType::OK) {
-            // if the tuple is visible, then perform predicate evaluation.
-            if (predicate_ == nullptr) {
-              position_list.push_back(tuple_id);
-//              auto res = transaction_manager.PerformRead(
-//                  current_txn, location, tile_group_header, acquire_owner);
-//              if (!res) {
-//                transaction_manager.SetTransactionResult(current_txn,
-//                                                         ResultType::FAILURE);
-//                return res;
-//              }
-            } else {
-              ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                       tuple_id);
-              LOG_TRACE("Evaluate predicate for a tuple");
-              auto eval =
-                  predicate_->Evaluate(&tuple, nullptr, executor_context_);
-              LOG_TRACE("Evaluation result: %s", eval.GetInfo().c_str());
-              if (eval.IsTrue()) {
-                position_list.push_back(tuple_id);
-//                auto res = transaction_manager.PerformRead(
-//                    current_txn, location, tile_group_header, acquire_owner);
-//                if (!res) {
-//                  transaction_manager.SetTransactionResult(current_txn,
-//                                                           ResultType::FAILURE);
-//                  return res;
-//                } else {
-//                  LOG_TRACE("Sequential Scan Predicate Satisfied");
-//                }
-              }
-            }
-//          }
+        if (BuildPositionList(tile_group.get(), active_tuple_count,
+                              position_list) == false) {
+          transaction_manager.SetTransactionResult(current_txn,
+                                                   ResultType::FAILURE);
+          return false;
         }
 
         // Don't return empty tiles
@@ -280,50 +308,21 @@ bool SeqScanExecutor::DExecute() {
       while (current_tile_group_offset_ < table_tile_group_count_) {
         auto tile_group = target_table_->GetTileGroupBTree(table_id,current_tile_group_offset_++);;
 //        current_tile_group_offset_++;
+        if (tile_group == nullptr ||
+            IsPrunedTileGroup(tile_group->GetTileGroupId())) {
+          continue;
+        }
 
         oid_t active_tuple_count = tile_group->GetNextTupleSlot();
 
         // Construct position list by looping through tile group
         // and applying the predicate.
         std::vector<oid_t> position_list;
-        for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-//          ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
-
-//          auto visibility = transaction_manager.IsVisible(
-//              current_txn, tile_group_header, tuple_id);
-
-          // check transaction visibility
-//          if (visibility == VisibilityType::OK) {
-          // if the tuple is visible, then perform predicate evaluation.
-          if (predicate_ == nullptr) {
-            position_list.push_back(tuple_id);
-//              auto res = transaction_manager.PerformRead(
-//                  current_txn, location, tile_group_header, acquire_owner);
-//              if (!res) {
-//                transaction_manager.SetTransactionResult(current_txn,
-//                                                         ResultType::FAILURE);
-//                return res;
-//              }
-          } else {
-            ContainerTuple<storage::TileGroup> tuple(tile_group, tuple_id);
-            LOG_TRACE("Evaluate predicate for a tuple");
-            auto eval =
-                predicate_->Evaluate(&tuple, nullptr, executor_context_);
-            LOG_TRACE("Evaluation result: %s", eval.GetInfo().c_str());
-            if (eval.IsTrue()) {
-              position_list.push_back(tuple_id);
-//                auto res = transaction_manager.PerformRead(
-//                    current_txn, location, tile_group_header, acquire_owner);
-//                if (!res) {
-//                  transaction_manager.SetTransactionResult(current_txn,
-//                                                           ResultType::FAILURE);
-//                  return res;
-//                } else {
-//                  LOG_TRACE("Sequential Scan Predicate Satisfied");
-//                }
-            }
-          }
-//          }
+        if (BuildPositionList(tile_group, active_tuple_count, position_list) ==
+            false) {
+          transaction_manager.SetTransactionResult(current_txn,
+                                                   ResultType::FAILURE);
+          return false;
         }
 
         // Don't return empty tiles
@@ -367,35 +366,31 @@ bool SeqScanExecutor::DExecute() {
 //        auto tile_group = tile_groups_[current_tile_group_offset_];
 //        current_tile_group_offset_++;
         auto tile_group = target_table_->GetTileGroupBTree(table_id,current_tile_group_offset_++);;
+        if (tile_group == nullptr ||
+            IsPrunedTileGroup(tile_group->GetTileGroupId())) {
+          continue;
+        }
 
         oid_t active_tuple_count = tile_group->GetNextTupleSlot();
         // Construct position list by looping through tile group
         // and applying the predicate.
         std::vector<oid_t> position_list;
 
-        if(predicate_ != nullptr){
-          std::pair<type::Value,type::Value> min_max;
-          index_.Find(current_tile_group_offset_,min_max) ;
+        std::pair<type::Value,type::Value> min_max;
+        if(predicate_ != nullptr &&
+           index_.Find(tile_group->GetTileGroupId(),min_max) == true){
           if((_point == true) && ((min.CompareLessThan(min_max.first)==CmpBool::CmpTrue) || (min.CompareGreaterThan(min_max.second)==CmpBool::CmpTrue))){
             continue;
           }
           if((_point == false) && ((min.CompareGreaterThan(min_max.second)==CmpBool::CmpTrue) || (max.CompareLessThan(min_max.first) == CmpBool::CmpTrue))){
             continue;
           }
-          for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-            ContainerTuple<storage::TileGroup> tuple(tile_group, tuple_id);
-            LOG_TRACE("Evaluate predicate for a tuple");
-            auto eval =
-                predicate_->Evaluate(&tuple, nullptr, executor_context_);
-            LOG_TRACE("Evaluation result: %s", eval.GetInfo().c_str());
-            if (eval.IsTrue()) {
-              position_list.push_back(tuple_id);
-            }
-          }
-        }else{
-          for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-              position_list.push_back(tuple_id);
-          }
+        }
+        if (BuildPositionList(tile_group, active_tuple_count, position_list) ==
+            false) {
+          transaction_manager.SetTransactionResult(current_txn,
+                                                   ResultType::FAILURE);
+          return false;
         }
 
         // Don't return empty tiles
@@ -490,6 +485,9 @@ bool SeqScanExecutor::DExecute() {
 // this is used in the NLJoin executor
 void SeqScanExecutor::UpdatePredicate(const std::vector<oid_t> &column_ids,
                                       const std::vector<type::Value> &values) {
+  // the workers of a running scan read the predicate
+  parallel_scan_.reset();
+
   std::vector<oid_t> predicate_column_ids;
 
   PELOTON_ASSERT(column_ids.size() <= column_ids_.size());
@@ -519,6 +517,252 @@ void SeqScanExecutor::UpdatePredicate(const std::vector<oid_t> &column_ids,
   // we should eventually make prediate_ a unique_ptr
   new_predicate_.reset(new_predicate);
   predicate_ = new_predicate;
+
+  PrunePartitions();
+  FindClusteredPages();
+  VectorizePredicate();
+}
+
+void SeqScanExecutor::PrunePartitions() {
+  scan_partitions_.clear();
+  if (target_table_ == nullptr || target_table_->IsPartitioned() == false ||
+      predicate_ == nullptr) {
+    return;
+  }
+
+  auto scan_partitions = target_table_->GetPartitionScheme()->Prune(
+      predicate_, &executor_context_->GetParamValues());
+  if (std::find(scan_partitions.begin(), scan_partitions.end(), false) !=
+      scan_partitions.end()) {
+    scan_partitions_ = std::move(scan_partitions);
+  }
+}
+
+bool SeqScanExecutor::IsPrunedTileGroup(const oid_t &tile_group_id) const {
+  return scan_partitions_.empty() == false &&
+         scan_partitions_[target_table_->GetTileGroupPartition(
+             tile_group_id)] == false;
+}
+
+void SeqScanExecutor::FindClusteredPages() {
+  scan_pages_.clear();
+  current_page_offset_ = 0;
+  if (target_table_ == nullptr || target_table_->IsClustered() == false) {
+    return;
+  }
+
+  scan_pages_ = target_table_->GetClusteredDirectory()->GetPages(
+      predicate_, &executor_context_->GetParamValues());
+}
+
+bool SeqScanExecutor::IsParallelScan() {
+  // reads that acquire ownership add to the read write set of the
+  // transaction, which is not safe to do from several threads
+  if (GetPlanNode<planner::SeqScanPlan>().IsParallel() == false ||
+      GetPlanNode<planner::AbstractScan>().IsForUpdate() ||
+      target_table_->IsClustered()) {
+    return false;
+  }
+  // a scan under a LIMIT reads only as many tile groups as it needs, in
+  // order
+  if (tuple_budget_ != std::numeric_limits<size_t>::max()) {
+    return false;
+  }
+  switch (seq_scan_type) {
+    case SeqScanType::HEAPARRAYSCAN:
+    case SeqScanType::HEAPTREESCAN:
+    case SeqScanType::HEAPTREESCANINDEX:
+      return true;
+    default:
+      return false;
+  }
+}
+
+LogicalTile *SeqScanExecutor::ScanTileGroup(oid_t tile_group_offset) {
+  std::shared_ptr<storage::TileGroup> tile_group_ref;
+  storage::TileGroup *tile_group = nullptr;
+  if (seq_scan_type == SeqScanType::HEAPARRAYSCAN) {
+    tile_group_ref = target_table_->GetTileGroup(tile_group_offset);
+    tile_group = tile_group_ref.get();
+  } else {
+    tile_group = target_table_->GetTileGroupBTree(table_id, tile_group_offset);
+  }
+  // dropped after compaction
+  if (tile_group == nullptr ||
+      IsPrunedTileGroup(tile_group->GetTileGroupId()) || read_failed_) {
+    return nullptr;
+  }
+
+  std::vector<oid_t> position_list;
+  if (BuildPositionList(tile_group, tile_group->GetNextTupleSlot(),
+                        position_list) == false) {
+    read_failed_ = true;
+    return nullptr;
+  }
+  if (position_list.size() == 0) {
+    return nullptr;
+  }
+
+  std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+  if (tile_group_ref != nullptr) {
+    logical_tile->AddColumns(tile_group_ref, column_ids_);
+  } else {
+    logical_tile->AddColumns(tile_group, column_ids_);
+  }
+  logical_tile->AddPositionList(std::move(position_list));
+  return logical_tile.release();
+}
+
+void SeqScanExecutor::VectorizePredicate() {
+  vectorized_predicate_.reset();
+  if (target_table_ == nullptr || predicate_ == nullptr) {
+    return;
+  }
+
+  vectorized_predicate_ = VectorizedPredicate::Create(
+      predicate_, target_table_->GetSchema(),
+      executor_context_->GetParamValues());
+}
+
+bool SeqScanExecutor::BuildPositionList(storage::TileGroup *tile_group,
+                                        oid_t active_tuple_count,
+                                        std::vector<oid_t> &position_list) {
+  bool exact = false;
+  if (FilterCompressed(tile_group, active_tuple_count, position_list,
+                       exact) == false) {
+    position_list.resize(active_tuple_count);
+    std::iota(position_list.begin(), position_list.end(), 0);
+  }
+
+  // the predicate is only evaluated on the versions visible to the
+  // transaction, others, e.g. deleted or uncommitted ones, must not make it
+  // fail
+  FilterVisible(tile_group, position_list);
+
+  if (predicate_ != nullptr && exact == false) {
+    if (vectorized_predicate_ != nullptr) {
+      vectorized_predicate_->Filter(tile_group, position_list);
+    } else {
+      // the predicate has expressions with no vectorized form, evaluate it
+      // a tuple at a time
+      size_t match_count = 0;
+      for (auto tuple_id : position_list) {
+        ContainerTuple<storage::TileGroup> tuple(tile_group, tuple_id);
+        LOG_TRACE("Evaluate predicate for a tuple");
+        auto eval = predicate_->Evaluate(&tuple, nullptr, executor_context_);
+        LOG_TRACE("Evaluation result: %s", eval.GetInfo().c_str());
+        if (eval.IsTrue()) {
+          position_list[match_count++] = tuple_id;
+        }
+      }
+      position_list.resize(match_count);
+    }
+  }
+
+  // tuples a hash join above would not join
+  FilterKeys(tile_group, position_list);
+
+  return ReadVisible(tile_group, position_list);
+}
+
+void SeqScanExecutor::FilterVisible(storage::TileGroup *tile_group,
+                                    std::vector<oid_t> &position_list) {
+  concurrency::TransactionManager &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+  auto tile_group_header = tile_group->GetHeader();
+
+  // the tuples below visible_count are committed versions no transaction
+  // owns, that began at or before visible_cid
+  oid_t visible_count = 0;
+  bool all_visible =
+      tile_group_header->GetAllVisibleCommitId(visible_count) <=
+      current_txn->GetReadId();
+  if (all_visible &&
+      (position_list.empty() || position_list.back() < visible_count)) {
+    return;
+  }
+
+  size_t visible_tuple_count = 0;
+  for (auto tuple_id : position_list) {
+    bool is_covered = all_visible && tuple_id < visible_count;
+    if (is_covered ||
+        transaction_manager.IsVisible(current_txn, tile_group_header,
+                                      tuple_id) == VisibilityType::OK) {
+      position_list[visible_tuple_count++] = tuple_id;
+    }
+  }
+  position_list.resize(visible_tuple_count);
+}
+
+bool SeqScanExecutor::ReadVisible(storage::TileGroup *tile_group,
+                                  const std::vector<oid_t> &position_list) {
+  concurrency::TransactionManager &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+  auto tile_group_header = tile_group->GetHeader();
+  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
+
+  // reading a version covered by the all visible mark is a no-op, unless
+  // the read acquires ownership or records the last reader of the version
+  oid_t visible_count = 0;
+  auto isolation_level = current_txn->GetIsolationLevel();
+  bool skip_read = tile_group_header->GetAllVisibleCommitId(visible_count) <=
+                       current_txn->GetReadId() &&
+                   acquire_owner == false &&
+                   isolation_level != IsolationLevelType::SERIALIZABLE &&
+                   isolation_level != IsolationLevelType::REPEATABLE_READS;
+  if (skip_read == false) {
+    visible_count = 0;
+  }
+  if (position_list.empty() || position_list.back() < visible_count) {
+    return true;
+  }
+
+  for (auto tuple_id : position_list) {
+    if (tuple_id < visible_count) {
+      continue;
+    }
+    ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+    if (transaction_manager.PerformRead(current_txn, location,
+                                        tile_group_header,
+                                        acquire_owner) == false) {
+      LOG_TRACE("Transaction read failed: %u, %u", location.block,
+                location.offset);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SeqScanExecutor::FilterCompressed(storage::TileGroup *tile_group,
+                                       oid_t active_tuple_count,
+                                       std::vector<oid_t> &position_list,
+                                       bool &exact) {
+  if (predicate_ == nullptr || tile_group->GetHeader()->IsFrozen() == false) {
+    return false;
+  }
+  auto compressed_columns = tile_group->GetCompressedColumns();
+  if (compressed_columns == nullptr ||
+      compressed_columns->GetTupleCount() != active_tuple_count) {
+    return false;
+  }
+
+  std::vector<uint64_t> matches;
+  if (compressed_columns->Filter(predicate_,
+                                 &executor_context_->GetParamValues(),
+                                 matches, exact) == false) {
+    return false;
+  }
+
+  for (size_t word_id = 0; word_id < matches.size(); word_id++) {
+    uint64_t word = matches[word_id];
+    while (word != 0) {
+      position_list.push_back(word_id * 64 + __builtin_ctzll(word));
+      word &= word - 1;
+    }
+  }
+  return true;
 }
 
 // Transfer a list of equality predicate
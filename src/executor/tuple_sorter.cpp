@@ -0,0 +1,520 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tuple_sorter.cpp
+//
+// Identification: src/executor/tuple_sorter.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/tuple_sorter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "executor/logical_tile.h"
+#include "threadpool/mono_queue_pool.h"
+#include "threadpool/parallel_for.h"
+#include "type/type_util.h"
+
+namespace peloton {
+namespace executor {
+
+const size_t TupleSorter::MAX_HEAP_ROW_COUNT;
+
+namespace {
+
+// # of bytes of a varlen key that are normalized, a byte of its length
+// follows them
+const size_t VARLEN_PREFIX_SIZE = 8;
+
+// # of rows below which a run is not worth a thread
+const size_t MIN_RUN_SIZE = 1 << 14;
+
+// # of bytes the normalized value of a type takes, after its NULL marker
+size_t GetNormalizedSize(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+      return 1;
+    case type::TypeId::SMALLINT:
+      return 2;
+    case type::TypeId::INTEGER:
+    case type::TypeId::DATE:
+      return 4;
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+    case type::TypeId::TIMESTAMP:
+      return 8;
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY:
+      return VARLEN_PREFIX_SIZE + 1;
+    default:
+      return 0;
+  }
+}
+
+inline bool IsVarlen(type::TypeId type_id) {
+  return type_id == type::TypeId::VARCHAR ||
+         type_id == type::TypeId::VARBINARY;
+}
+
+// reads a varlen value serialized into a row, nullptr if NULL
+inline const char *ReadVarlen(ReferenceSerializeInput &input,
+                              uint32_t &length) {
+  length = static_cast<uint32_t>(input.ReadInt());
+  if (length == type::PELOTON_VALUE_NULL) {
+    return nullptr;
+  }
+  return static_cast<const char *>(input.getRawPointer(length));
+}
+
+inline void WriteBigEndian(uint64_t value, size_t size, char *out) {
+  for (size_t i = 0; i < size; i++) {
+    out[i] = static_cast<char>(value >> (8 * (size - 1 - i)));
+  }
+}
+
+/**
+ * Normalizes the value into a NULL marker and size bytes that compare with
+ * memcmp in ascending order: integers with their sign bit flipped, doubles
+ * with their sign bit flipped if positive and every bit flipped if
+ * negative, all big endian. Varlen values as their first bytes padded with
+ * zeros, then their length capped at one past the prefix: values whose
+ * bytes tie are equal unless both are longer than the prefix. NULL comes
+ * after every value.
+ */
+void Normalize(const type::Value &value, type::TypeId type_id, size_t size,
+               char *out) {
+  if (value.IsNull()) {
+    out[0] = 1;
+    std::memset(out + 1, 0, size);
+    return;
+  }
+  out[0] = 0;
+  char *data = out + 1;
+  switch (type_id) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+      WriteBigEndian(static_cast<uint8_t>(value.GetAs<int8_t>()) ^ 0x80, 1,
+                     data);
+      break;
+    case type::TypeId::SMALLINT:
+      WriteBigEndian(static_cast<uint16_t>(value.GetAs<int16_t>()) ^ 0x8000,
+                     2, data);
+      break;
+    case type::TypeId::INTEGER:
+      WriteBigEndian(
+          static_cast<uint32_t>(value.GetAs<int32_t>()) ^ 0x80000000U, 4,
+          data);
+      break;
+    case type::TypeId::BIGINT:
+      WriteBigEndian(
+          static_cast<uint64_t>(value.GetAs<int64_t>()) ^ (1ULL << 63), 8,
+          data);
+      break;
+    case type::TypeId::DATE:
+      WriteBigEndian(value.GetAs<uint32_t>(), 4, data);
+      break;
+    case type::TypeId::TIMESTAMP:
+      WriteBigEndian(value.GetAs<uint64_t>(), 8, data);
+      break;
+    case type::TypeId::DECIMAL: {
+      double decimal = value.GetAs<double>();
+      // -0.0 equals 0.0
+      if (decimal == 0) {
+        decimal = 0;
+      }
+      uint64_t bits;
+      std::memcpy(&bits, &decimal, sizeof(bits));
+      bits = (bits >> 63) ? ~bits : bits | (1ULL << 63);
+      WriteBigEndian(bits, 8, data);
+      break;
+    }
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY: {
+      size_t prefix_size = size - 1;
+      size_t length = std::min<size_t>(value.GetLength(), prefix_size);
+      std::memcpy(data, value.GetData(), length);
+      std::memset(data + length, 0, prefix_size - length);
+      data[prefix_size] = static_cast<char>(
+          std::min<size_t>(value.GetLength(), prefix_size + 1));
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+}  // namespace
+
+TupleSorter::TupleSorter(const std::vector<oid_t> &key_column_ids,
+                         const std::vector<type::TypeId> &key_types,
+                         const std::vector<bool> &descend_flags,
+                         const std::vector<oid_t> &output_column_ids,
+                         const std::vector<type::TypeId> &output_types,
+                         size_t max_row_count, double memory_limit)
+    : key_column_ids_(key_column_ids),
+      key_types_(key_types),
+      descend_flags_(descend_flags),
+      output_column_ids_(output_column_ids),
+      output_types_(output_types),
+      max_row_count_(max_row_count),
+      memory_limit_(memory_limit) {
+  // a size and the normalized keys lead a row
+  key_size_ = sizeof(uint32_t);
+  for (size_t i = 0; i < key_types_.size(); i++) {
+    key_offsets_.push_back(key_size_);
+    key_size_ += 1 + GetNormalizedSize(key_types_[i]);
+    if (IsVarlen(key_types_[i])) {
+      varlen_key_ids_.push_back(i);
+      varlen_key_ends_.push_back(key_size_ - sizeof(uint32_t));
+    }
+  }
+  key_size_ -= sizeof(uint32_t);
+
+  // the heap frees the rows it drops
+  use_heap_ = max_row_count_ <= MAX_HEAP_ROW_COUNT;
+  pool_.reset(new type::ArenaPool(use_heap_));
+  key_buffer_.resize(sizeof(uint32_t) + key_size_);
+}
+
+void TupleSorter::AddTile(LogicalTile *tile) {
+  if (max_row_count_ == 0) {
+    return;
+  }
+
+  auto less = [this](const SortEntry &a, const SortEntry &b) {
+    return Less(a, b);
+  };
+  for (oid_t tuple_id : *tile) {
+    BuildKey(tile, tuple_id);
+
+    if (use_heap_ == false) {
+      BuildRow(tile, tuple_id);
+      entries_.push_back(MakeEntry(CopyRow()));
+      if (pool_->GetChunkSize() + entries_.capacity() * sizeof(SortEntry) >
+          memory_limit_) {
+        SpillRun();
+      }
+      continue;
+    }
+
+    if (entries_.size() < max_row_count_) {
+      BuildRow(tile, tuple_id);
+      entries_.push_back(MakeEntry(CopyRow()));
+      std::push_heap(entries_.begin(), entries_.end(), less);
+      continue;
+    }
+
+    // most rows come after the greatest kept, tell without serializing
+    // their values unless a varlen key ties on values longer than its prefix
+    auto &greatest = entries_.front();
+    size_t varlen_id = 0;
+    int cmp = CompareNormalizedKeys(key_buffer_.data() + sizeof(uint32_t),
+                                    greatest.row + sizeof(uint32_t),
+                                    varlen_id);
+    bool settled = cmp != 0 || varlen_id == varlen_key_ids_.size();
+    if (settled && cmp >= 0) {
+      continue;
+    }
+    BuildRow(tile, tuple_id);
+    if (settled == false &&
+        Less(MakeEntry(row_buffer_.Data()), greatest) == false) {
+      continue;
+    }
+
+    std::pop_heap(entries_.begin(), entries_.end(), less);
+    pool_->Free(const_cast<char *>(entries_.back().row));
+    entries_.back() = MakeEntry(CopyRow());
+    std::push_heap(entries_.begin(), entries_.end(), less);
+  }
+}
+
+void TupleSorter::Finish() {
+  if (use_heap_) {
+    std::sort_heap(entries_.begin(), entries_.end(),
+                   [this](const SortEntry &a, const SortEntry &b) {
+                     return Less(a, b);
+                   });
+    row_count_ = entries_.size();
+    return;
+  }
+
+  if (run_files_.empty()) {
+    Sort(entries_);
+    row_count_ = std::min(entries_.size(), max_row_count_);
+    return;
+  }
+
+  if (entries_.empty() == false) {
+    SpillRun();
+  }
+  row_count_ = std::min(spilled_row_count_, max_row_count_);
+
+  cursors_.resize(run_files_.size());
+  for (size_t run_id = 0; run_id < run_files_.size(); run_id++) {
+    cursors_[run_id].file = run_files_[run_id].get();
+    std::rewind(cursors_[run_id].file);
+    if (ReadRow(cursors_[run_id])) {
+      cursor_heap_.push_back(run_id);
+    }
+  }
+  std::make_heap(cursor_heap_.begin(), cursor_heap_.end(),
+                 [this](size_t a, size_t b) {
+                   return Less(MakeEntry(cursors_[b].row.data()),
+                               MakeEntry(cursors_[a].row.data()));
+                 });
+}
+
+const char *TupleSorter::Next() {
+  if (next_row_ == row_count_) {
+    return nullptr;
+  }
+  next_row_++;
+  if (run_files_.empty()) {
+    return entries_[next_row_ - 1].row;
+  }
+
+  // the runs are merged on a min heap of their current rows
+  auto greater = [this](size_t a, size_t b) {
+    return Less(MakeEntry(cursors_[b].row.data()),
+                MakeEntry(cursors_[a].row.data()));
+  };
+  if (advance_cursor_) {
+    if (ReadRow(cursors_[cursor_heap_.back()])) {
+      std::push_heap(cursor_heap_.begin(), cursor_heap_.end(), greater);
+    } else {
+      cursor_heap_.pop_back();
+    }
+  }
+  std::pop_heap(cursor_heap_.begin(), cursor_heap_.end(), greater);
+  advance_cursor_ = true;
+  return cursors_[cursor_heap_.back()].row.data();
+}
+
+void TupleSorter::GetOutputValues(const char *row,
+                                  std::vector<type::Value> &values) const {
+  uint32_t size;
+  std::memcpy(&size, row, sizeof(size));
+  size_t values_offset = sizeof(uint32_t) + key_size_;
+  ReferenceSerializeInput input(row + values_offset, size - values_offset);
+
+  // the values of the varlen keys come first
+  for (auto type_id : key_types_) {
+    if (IsVarlen(type_id)) {
+      type::Value::DeserializeFrom(input, type_id, nullptr);
+    }
+  }
+
+  values.clear();
+  for (auto type_id : output_types_) {
+    values.push_back(type::Value::DeserializeFrom(input, type_id, nullptr));
+  }
+}
+
+void TupleSorter::BuildKey(LogicalTile *tile, oid_t tuple_id) {
+  for (size_t i = 0; i < key_column_ids_.size(); i++) {
+    char *key = key_buffer_.data() + key_offsets_[i];
+    size_t size = GetNormalizedSize(key_types_[i]);
+    Normalize(tile->GetValue(tuple_id, key_column_ids_[i]), key_types_[i],
+              size, key);
+    if (descend_flags_[i]) {
+      for (size_t j = 0; j <= size; j++) {
+        key[j] = ~key[j];
+      }
+    }
+  }
+}
+
+void TupleSorter::BuildRow(LogicalTile *tile, oid_t tuple_id) {
+  row_buffer_.Reset();
+  row_buffer_.WriteBytes(key_buffer_.data(), key_buffer_.size());
+  for (size_t i = 0; i < key_column_ids_.size(); i++) {
+    if (IsVarlen(key_types_[i])) {
+      tile->GetValue(tuple_id, key_column_ids_[i]).SerializeTo(row_buffer_);
+    }
+  }
+  for (oid_t column_id : output_column_ids_) {
+    tile->GetValue(tuple_id, column_id).SerializeTo(row_buffer_);
+  }
+  row_buffer_.WriteIntAt(0, static_cast<int32_t>(row_buffer_.Size()));
+}
+
+const char *TupleSorter::CopyRow() {
+  char *row = static_cast<char *>(pool_->Allocate(row_buffer_.Size()));
+  std::memcpy(row, row_buffer_.Data(), row_buffer_.Size());
+  return row;
+}
+
+TupleSorter::SortEntry TupleSorter::MakeEntry(const char *row) const {
+  const char *key = row + sizeof(uint32_t);
+  size_t size = std::min<size_t>(key_size_, sizeof(uint64_t));
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); i++) {
+    prefix = (prefix << 8) | (i < size ? static_cast<uint8_t>(key[i]) : 0);
+  }
+  return {prefix, row};
+}
+
+bool TupleSorter::Less(const SortEntry &a, const SortEntry &b) const {
+  if (a.prefix != b.prefix) {
+    return a.prefix < b.prefix;
+  }
+  return CompareKeys(a.row, b.row) < 0;
+}
+
+int TupleSorter::CompareKeys(const char *a, const char *b) const {
+  const char *key_a = a + sizeof(uint32_t);
+  const char *key_b = b + sizeof(uint32_t);
+  size_t varlen_id = 0;
+  int cmp = CompareNormalizedKeys(key_a, key_b, varlen_id);
+  if (cmp != 0 || varlen_id == varlen_key_ids_.size()) {
+    return cmp;
+  }
+
+  // a varlen key ties on long values, compare them on the values of the
+  // varlen keys the rows keep, in key order
+  uint32_t size_a, size_b;
+  std::memcpy(&size_a, a, sizeof(size_a));
+  std::memcpy(&size_b, b, sizeof(size_b));
+  size_t values_offset = sizeof(uint32_t) + key_size_;
+  ReferenceSerializeInput input_a(a + values_offset,
+                                  size_a - values_offset);
+  ReferenceSerializeInput input_b(b + values_offset,
+                                  size_b - values_offset);
+  size_t read_count = 0;
+  while (cmp == 0 && varlen_id < varlen_key_ids_.size()) {
+    uint32_t length_a, length_b;
+    const char *data_a, *data_b;
+    do {
+      data_a = ReadVarlen(input_a, length_a);
+      data_b = ReadVarlen(input_b, length_b);
+    } while (read_count++ < varlen_id);
+
+    cmp = type::TypeUtil::CompareStrings(data_a, length_a, data_b, length_b);
+    if (cmp != 0) {
+      return descend_flags_[varlen_key_ids_[varlen_id]] ? -cmp : cmp;
+    }
+    varlen_id++;
+    cmp = CompareNormalizedKeys(key_a, key_b, varlen_id);
+  }
+  return cmp;
+}
+
+int TupleSorter::CompareNormalizedKeys(const char *a, const char *b,
+                                       size_t &varlen_id) const {
+  size_t begin = varlen_id == 0 ? 0 : varlen_key_ends_[varlen_id - 1];
+  for (; varlen_id < varlen_key_ids_.size(); varlen_id++) {
+    size_t end = varlen_key_ends_[varlen_id];
+    int cmp = std::memcmp(a + begin, b + begin, end - begin);
+    if (cmp != 0) {
+      return cmp;
+    }
+    begin = end;
+
+    // the length byte ends the normalized key
+    uint8_t length = static_cast<uint8_t>(a[end - 1]);
+    if (descend_flags_[varlen_key_ids_[varlen_id]]) {
+      length = ~length;
+    }
+    if (length > VARLEN_PREFIX_SIZE) {
+      return 0;
+    }
+  }
+  return std::memcmp(a + begin, b + begin, key_size_ - begin);
+}
+
+void TupleSorter::Sort(std::vector<SortEntry> &entries) const {
+  auto less = [this](const SortEntry &a, const SortEntry &b) {
+    return Less(a, b);
+  };
+  auto &worker_pool = threadpool::MonoQueuePool::GetExecutionInstance();
+  size_t run_count = std::min<size_t>(worker_pool.NumWorkers() + 1,
+                                      entries.size() / MIN_RUN_SIZE);
+  if (run_count <= 1) {
+    std::sort(entries.begin(), entries.end(), less);
+    return;
+  }
+
+  // sort runs on their own threads
+  std::vector<size_t> bounds;
+  for (size_t run_id = 0; run_id <= run_count; run_id++) {
+    bounds.push_back(run_id * entries.size() / run_count);
+  }
+  threadpool::ParallelFor(run_count, [&](size_t run_id) {
+    std::sort(entries.begin() + bounds[run_id],
+              entries.begin() + bounds[run_id + 1], less);
+  });
+
+  // then merge pairs of them until one is left
+  std::vector<SortEntry> merged(entries.size());
+  while (bounds.size() > 2) {
+    size_t runs = bounds.size() - 1;
+    threadpool::ParallelFor((runs + 1) / 2, [&](size_t pair_id) {
+      size_t begin = bounds[2 * pair_id];
+      size_t middle = bounds[std::min(2 * pair_id + 1, runs)];
+      size_t end = bounds[std::min(2 * pair_id + 2, runs)];
+      std::merge(entries.begin() + begin, entries.begin() + middle,
+                 entries.begin() + middle, entries.begin() + end,
+                 merged.begin() + begin, less);
+    });
+    entries.swap(merged);
+
+    std::vector<size_t> merged_bounds;
+    for (size_t run_id = 0; run_id < runs; run_id += 2) {
+      merged_bounds.push_back(bounds[run_id]);
+    }
+    merged_bounds.push_back(bounds[runs]);
+    bounds.swap(merged_bounds);
+  }
+}
+
+void TupleSorter::SpillRun() {
+  Sort(entries_);
+
+  std::unique_ptr<std::FILE, FileCloser> file(std::tmpfile());
+  if (file == nullptr) {
+    throw ExecutorException("Failed to create a file to spill sorted rows to");
+  }
+  // rows past the first max_row_count of a run are never returned
+  size_t row_count = std::min(entries_.size(), max_row_count_);
+  for (size_t i = 0; i < row_count; i++) {
+    uint32_t size;
+    std::memcpy(&size, entries_[i].row, sizeof(size));
+    if (std::fwrite(entries_[i].row, size, 1, file.get()) != 1) {
+      throw ExecutorException("Failed to spill sorted rows");
+    }
+  }
+  LOG_TRACE("Spilled a run of %lu rows", row_count);
+
+  spilled_row_count_ += row_count;
+  run_files_.push_back(std::move(file));
+  entries_.clear();
+  pool_.reset(new type::ArenaPool(false));
+}
+
+bool TupleSorter::ReadRow(RunCursor &cursor) const {
+  uint32_t size;
+  if (std::fread(&size, sizeof(size), 1, cursor.file) != 1) {
+    if (std::ferror(cursor.file)) {
+      throw ExecutorException("Failed to read spilled sorted rows");
+    }
+    return false;
+  }
+  cursor.row.resize(size);
+  std::memcpy(cursor.row.data(), &size, sizeof(size));
+  if (std::fread(cursor.row.data() + sizeof(size), size - sizeof(size), 1,
+                 cursor.file) != 1) {
+    throw ExecutorException("Failed to read spilled sorted rows");
+  }
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
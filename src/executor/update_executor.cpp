@@ -70,7 +70,8 @@ bool UpdateExecutor::PerformUpdatePrimaryKey(
   ///////////////////////////////////////
   // Delete tuple/version chain
   ///////////////////////////////////////
-  ItemPointer new_location = target_table_->InsertEmptyVersion();
+  ItemPointer new_location =
+      target_table_->InsertEmptyVersion(old_location);
 
   // PerformUpdate() will not be executed if the insertion failed.
   // There is a write lock acquired, but since it is not in the write
@@ -318,7 +319,8 @@ bool UpdateExecutor::DExecute() {
           // insert a new version.
 
           // acquire a version slot from the table.
-          ItemPointer new_location = target_table_->AcquireVersion();
+          ItemPointer new_location =
+              target_table_->AcquireVersion(old_location);
 
           auto storage_manager = storage::StorageManager::GetInstance();
           auto new_tile_group = storage_manager->GetTileGroup(new_location.block);
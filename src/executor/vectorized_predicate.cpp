@@ -0,0 +1,732 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// vectorized_predicate.cpp
+//
+// Identification: src/executor/vectorized_predicate.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/vectorized_predicate.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "expression/abstract_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "storage/tile_group.h"
+#include "storage/tile.h"
+#include "type/limits.h"
+
+namespace peloton {
+namespace executor {
+
+const size_t VectorizedPredicate::VECTOR_SIZE;
+
+namespace {
+
+// where the values of a column start in the tiles of a tile group, and how
+// far apart the values of consecutive tuples are
+struct ColumnData {
+  const char *base;
+  size_t stride;
+};
+
+// the values of an operand for a vector of tuples, as 64-bit integers or
+// doubles. a constant vector holds a single value standing for every tuple.
+struct NumberVector {
+  bool is_decimal = false;
+  bool is_constant = false;
+  std::vector<int64_t> integers;
+  std::vector<double> decimals;
+  std::vector<uint8_t> nulls;
+
+  void Reset(bool decimal, bool constant, size_t count) {
+    is_decimal = decimal;
+    is_constant = constant;
+    size_t size = constant ? 1 : count;
+    if (is_decimal) {
+      decimals.resize(size);
+    } else {
+      integers.resize(size);
+    }
+    nulls.resize(size);
+  }
+
+  void ToDecimal() {
+    if (is_decimal) {
+      return;
+    }
+    decimals.resize(integers.size());
+    for (size_t i = 0; i < integers.size(); i++) {
+      decimals[i] = static_cast<double>(integers[i]);
+    }
+    is_decimal = true;
+  }
+};
+
+bool IsIntegerType(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsNumericType(type::TypeId type_id) {
+  return IsIntegerType(type_id) || type_id == type::TypeId::DECIMAL;
+}
+
+// the lowest value of an integer type is its NULL
+int64_t GetIntegerNull(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+      return type::PELOTON_INT8_NULL;
+    case type::TypeId::SMALLINT:
+      return type::PELOTON_INT16_NULL;
+    case type::TypeId::INTEGER:
+      return type::PELOTON_INT32_NULL;
+    default:
+      return type::PELOTON_INT64_NULL;
+  }
+}
+
+int64_t GetIntegerMax(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+      return type::PELOTON_INT8_MAX;
+    case type::TypeId::SMALLINT:
+      return type::PELOTON_INT16_MAX;
+    case type::TypeId::INTEGER:
+      return type::PELOTON_INT32_MAX;
+    default:
+      return type::PELOTON_INT64_MAX;
+  }
+}
+
+// calls function(i, left index, right index) for the count results of an
+// operation on two vectors, a constant side always being at index 0. each
+// case is a loop of its own that the compiler can vectorize.
+template <typename Function>
+void ForEach(const NumberVector &left, const NumberVector &right,
+             size_t count, Function function) {
+  if (left.is_constant && right.is_constant) {
+    function(0, 0, 0);
+  } else if (left.is_constant) {
+    for (size_t i = 0; i < count; i++) {
+      function(i, 0, i);
+    }
+  } else if (right.is_constant) {
+    for (size_t i = 0; i < count; i++) {
+      function(i, i, 0);
+    }
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      function(i, i, i);
+    }
+  }
+}
+
+// copies the values of a column out of the tiles
+template <typename T, typename V>
+void Gather(const ColumnData &column, const oid_t *ids, size_t count,
+            T null_value, std::vector<V> &values,
+            std::vector<uint8_t> &nulls) {
+  for (size_t i = 0; i < count; i++) {
+    T value;
+    std::memcpy(&value, column.base + ids[i] * column.stride, sizeof(T));
+    values[i] = value;
+    nulls[i] = (value == null_value);
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Operands
+//===--------------------------------------------------------------------===//
+
+class VectorOperand {
+ public:
+  explicit VectorOperand(type::TypeId type_id) : type_id_(type_id) {}
+
+  virtual ~VectorOperand() {}
+
+  // an integer type or DECIMAL
+  type::TypeId GetTypeId() const { return type_id_; }
+
+  bool IsDecimal() const { return type_id_ == type::TypeId::DECIMAL; }
+
+  // the values of the operand for the count tuples of ids
+  virtual void Evaluate(const std::vector<ColumnData> &columns,
+                        const oid_t *ids, size_t count,
+                        NumberVector &result) const = 0;
+
+ protected:
+  const type::TypeId type_id_;
+};
+
+class ColumnOperand : public VectorOperand {
+ public:
+  // column_offset is the offset of the column in the columns evaluated on
+  ColumnOperand(type::TypeId type_id, size_t column_offset)
+      : VectorOperand(type_id), column_offset_(column_offset) {}
+
+  void Evaluate(const std::vector<ColumnData> &columns, const oid_t *ids,
+                size_t count, NumberVector &result) const override {
+    auto &column = columns[column_offset_];
+    result.Reset(IsDecimal(), false, count);
+    switch (type_id_) {
+      case type::TypeId::TINYINT:
+        Gather<int8_t>(column, ids, count, type::PELOTON_INT8_NULL,
+                       result.integers, result.nulls);
+        break;
+      case type::TypeId::SMALLINT:
+        Gather<int16_t>(column, ids, count, type::PELOTON_INT16_NULL,
+                        result.integers, result.nulls);
+        break;
+      case type::TypeId::INTEGER:
+        Gather<int32_t>(column, ids, count, type::PELOTON_INT32_NULL,
+                        result.integers, result.nulls);
+        break;
+      case type::TypeId::BIGINT:
+        Gather<int64_t>(column, ids, count, type::PELOTON_INT64_NULL,
+                        result.integers, result.nulls);
+        break;
+      default:
+        Gather<double>(column, ids, count, type::PELOTON_DECIMAL_NULL,
+                       result.decimals, result.nulls);
+        break;
+    }
+  }
+
+ private:
+  const size_t column_offset_;
+};
+
+class ConstantOperand : public VectorOperand {
+ public:
+  explicit ConstantOperand(const type::Value &value)
+      : VectorOperand(value.GetTypeId()) {
+    value_.Reset(IsDecimal(), true, 1);
+    value_.nulls[0] = value.IsNull();
+    if (value.IsNull()) {
+      return;
+    }
+    switch (type_id_) {
+      case type::TypeId::TINYINT:
+        value_.integers[0] = value.GetAs<int8_t>();
+        break;
+      case type::TypeId::SMALLINT:
+        value_.integers[0] = value.GetAs<int16_t>();
+        break;
+      case type::TypeId::INTEGER:
+        value_.integers[0] = value.GetAs<int32_t>();
+        break;
+      case type::TypeId::BIGINT:
+        value_.integers[0] = value.GetAs<int64_t>();
+        break;
+      default:
+        value_.decimals[0] = value.GetAs<double>();
+        break;
+    }
+  }
+
+  void Evaluate(UNUSED_ATTRIBUTE const std::vector<ColumnData> &columns,
+                UNUSED_ATTRIBUTE const oid_t *ids,
+                UNUSED_ATTRIBUTE size_t count,
+                NumberVector &result) const override {
+    result = value_;
+  }
+
+ private:
+  NumberVector value_;
+};
+
+class ArithmeticOperand : public VectorOperand {
+ public:
+  ArithmeticOperand(ExpressionType operation,
+                    std::unique_ptr<VectorOperand> left,
+                    std::unique_ptr<VectorOperand> right)
+      : VectorOperand(GetResultType(*left, *right)),
+        operation_(operation),
+        left_(std::move(left)),
+        right_(std::move(right)) {}
+
+  void Evaluate(const std::vector<ColumnData> &columns, const oid_t *ids,
+                size_t count, NumberVector &result) const override {
+    NumberVector left;
+    NumberVector right;
+    left_->Evaluate(columns, ids, count, left);
+    right_->Evaluate(columns, ids, count, right);
+    result.Reset(IsDecimal(), left.is_constant && right.is_constant, count);
+    if (IsDecimal()) {
+      left.ToDecimal();
+      right.ToDecimal();
+      EvaluateDecimals(left, right, count, result);
+    } else {
+      EvaluateIntegers(left, right, count, result);
+    }
+  }
+
+ private:
+  // integers operate in the wider of their types (integer TypeIds are in
+  // order of width), anything with a decimal is a decimal
+  static type::TypeId GetResultType(const VectorOperand &left,
+                                    const VectorOperand &right) {
+    if (left.IsDecimal() || right.IsDecimal()) {
+      return type::TypeId::DECIMAL;
+    }
+    return std::max(left.GetTypeId(), right.GetTypeId());
+  }
+
+  void EvaluateIntegers(const NumberVector &left, const NumberVector &right,
+                        size_t count, NumberVector &result) const {
+    // results out of the range of the type overflow, those at its lowest
+    // value are NULL
+    const int64_t null_value = GetIntegerNull(type_id_);
+    const int64_t max_value = GetIntegerMax(type_id_);
+    auto &x = left.integers;
+    auto &y = right.integers;
+    bool overflow = false;
+    bool division_by_zero = false;
+
+    auto set_result = [&](size_t i, bool is_null, bool out_of_range,
+                          int64_t value) {
+      out_of_range = out_of_range || value < null_value || value > max_value;
+      overflow |= out_of_range && !is_null;
+      result.integers[i] = value;
+      result.nulls[i] = is_null || value == null_value;
+    };
+
+    switch (operation_) {
+      case ExpressionType::OPERATOR_PLUS:
+        ForEach(left, right, count, [&](size_t i, size_t l, size_t r) {
+          int64_t value;
+          bool out_of_range = __builtin_add_overflow(x[l], y[r], &value);
+          set_result(i, left.nulls[l] | right.nulls[r], out_of_range, value);
+        });
+        break;
+      case ExpressionType::OPERATOR_MINUS:
+        ForEach(left, right, count, [&](size_t i, size_t l, size_t r) {
+          int64_t value;
+          bool out_of_range = __builtin_sub_overflow(x[l], y[r], &value);
+          set_result(i, left.nulls[l] | right.nulls[r], out_of_range, value);
+        });
+        break;
+      case ExpressionType::OPERATOR_MULTIPLY:
+        ForEach(left, right, count, [&](size_t i, size_t l, size_t r) {
+          int64_t value;
+          bool out_of_range = __builtin_mul_overflow(x[l], y[r], &value);
+          set_result(i, left.nulls[l] | right.nulls[r], out_of_range, value);
+        });
+        break;
+      default:
+        ForEach(left, right, count, [&](size_t i, size_t l, size_t r) {
+          bool is_null = left.nulls[l] | right.nulls[r];
+          bool is_zero = (y[r] == 0);
+          bool out_of_range = (x[l] == type::PELOTON_INT64_NULL && y[r] == -1);
+          division_by_zero |= is_zero && !is_null;
+          int64_t divisor = (is_zero || out_of_range) ? 1 : y[r];
+          set_result(i, is_null, out_of_range, x[l] / divisor);
+        });
+        break;
+    }
+
+    if (division_by_zero) {
+      throw Exception(ExceptionType::DIVIDE_BY_ZERO,
+                      "Division by zero on right-hand side");
+    }
+    if (overflow) {
+      throw Exception(ExceptionType::OUT_OF_RANGE,
+                      "Numeric value out of range.");
+    }
+  }
+
+  void EvaluateDecimals(const NumberVector &left, const NumberVector &right,
+                        size_t count, NumberVector &result) const {
+    auto &x = left.decimals;
+    auto &y = right.decimals;
+    bool division_by_zero = false;
+
+    auto set_result = [&](size_t i, bool is_null, double value) {
+      result.decimals[i] = value;
+      result.nulls[i] = is_null || value == type::PELOTON_DECIMAL_NULL;
+    };
+
+    switch (operation_) {
+      case ExpressionType::OPERATOR_PLUS:
+        ForEach(left, right, count, [&](size_t i, size_t l, size_t r) {
+          set_result(i, left.nulls[l] | right.nulls[r], x[l] + y[r]);
+        });
+        break;
+      case ExpressionType::OPERATOR_MINUS:
+        ForEach(left, right, count, [&](size_t i, size_t l, size_t r) {
+          set_result(i, left.nulls[l] | right.nulls[r], x[l] - y[r]);
+        });
+        break;
+      case ExpressionType::OPERATOR_MULTIPLY:
+        ForEach(left, right, count, [&](size_t i, size_t l, size_t r) {
+          set_result(i, left.nulls[l] | right.nulls[r], x[l] * y[r]);
+        });
+        break;
+      default:
+        ForEach(left, right, count, [&](size_t i, size_t l, size_t r) {
+          bool is_null = left.nulls[l] | right.nulls[r];
+          bool is_zero = (y[r] == 0);
+          division_by_zero |= is_zero && !is_null;
+          set_result(i, is_null, x[l] / (is_zero ? 1 : y[r]));
+        });
+        break;
+    }
+
+    if (division_by_zero) {
+      throw Exception(ExceptionType::DIVIDE_BY_ZERO,
+                      "Division by zero on right-hand side");
+    }
+  }
+
+  const ExpressionType operation_;
+
+  std::unique_ptr<VectorOperand> left_;
+
+  std::unique_ptr<VectorOperand> right_;
+};
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Conditions
+//===--------------------------------------------------------------------===//
+
+class VectorCondition {
+ public:
+  virtual ~VectorCondition() {}
+
+  /**
+   * Writes to selected the ids, among the count ids, of the tuples that
+   * satisfy the condition, keeping their order, and returns their #.
+   * selected may be ids.
+   */
+  virtual size_t Select(const std::vector<ColumnData> &columns,
+                        const oid_t *ids, size_t count,
+                        oid_t *selected) const = 0;
+};
+
+namespace {
+
+class ComparisonCondition : public VectorCondition {
+ public:
+  ComparisonCondition(ExpressionType comparison,
+                      std::unique_ptr<VectorOperand> left,
+                      std::unique_ptr<VectorOperand> right)
+      : comparison_(comparison),
+        left_(std::move(left)),
+        right_(std::move(right)) {}
+
+  size_t Select(const std::vector<ColumnData> &columns, const oid_t *ids,
+                size_t count, oid_t *selected) const override {
+    NumberVector left;
+    NumberVector right;
+    left_->Evaluate(columns, ids, count, left);
+    right_->Evaluate(columns, ids, count, right);
+    if (left.is_decimal || right.is_decimal) {
+      left.ToDecimal();
+      right.ToDecimal();
+      return Compare(left, left.decimals, right, right.decimals, ids, count,
+                     selected);
+    }
+    return Compare(left, left.integers, right, right.integers, ids, count,
+                   selected);
+  }
+
+ private:
+  template <typename T>
+  size_t Compare(const NumberVector &left, const std::vector<T> &x,
+                 const NumberVector &right, const std::vector<T> &y,
+                 const oid_t *ids, size_t count, oid_t *selected) const {
+    switch (comparison_) {
+      case ExpressionType::COMPARE_EQUAL:
+        return SelectWhere(left, right, ids, count, selected,
+                           [&](size_t l, size_t r) { return x[l] == y[r]; });
+      case ExpressionType::COMPARE_NOTEQUAL:
+        return SelectWhere(left, right, ids, count, selected,
+                           [&](size_t l, size_t r) { return x[l] != y[r]; });
+      case ExpressionType::COMPARE_LESSTHAN:
+        return SelectWhere(left, right, ids, count, selected,
+                           [&](size_t l, size_t r) { return x[l] < y[r]; });
+      case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        return SelectWhere(left, right, ids, count, selected,
+                           [&](size_t l, size_t r) { return x[l] <= y[r]; });
+      case ExpressionType::COMPARE_GREATERTHAN:
+        return SelectWhere(left, right, ids, count, selected,
+                           [&](size_t l, size_t r) { return x[l] > y[r]; });
+      default:
+        return SelectWhere(left, right, ids, count, selected,
+                           [&](size_t l, size_t r) { return x[l] >= y[r]; });
+    }
+  }
+
+  // a comparison with NULL is never true. every id is written, but only
+  // those satisfying the comparison are kept, so that the loop has no
+  // branch.
+  template <typename Function>
+  static size_t SelectWhere(const NumberVector &left,
+                            const NumberVector &right, const oid_t *ids,
+                            size_t count, oid_t *selected, Function compare) {
+    if (left.is_constant && right.is_constant) {
+      if (compare(0, 0) == false || left.nulls[0] || right.nulls[0]) {
+        return 0;
+      }
+      if (selected != ids) {
+        std::copy(ids, ids + count, selected);
+      }
+      return count;
+    }
+
+    size_t selected_count = 0;
+    ForEach(left, right, count, [&](size_t i, size_t l, size_t r) {
+      oid_t id = ids[i];
+      selected[selected_count] = id;
+      selected_count += compare(l, r) & !(left.nulls[l] | right.nulls[r]);
+    });
+    return selected_count;
+  }
+
+  const ExpressionType comparison_;
+
+  std::unique_ptr<VectorOperand> left_;
+
+  std::unique_ptr<VectorOperand> right_;
+};
+
+class ConjunctionCondition : public VectorCondition {
+ public:
+  ConjunctionCondition(ExpressionType conjunction,
+                       std::unique_ptr<VectorCondition> left,
+                       std::unique_ptr<VectorCondition> right)
+      : conjunction_(conjunction),
+        left_(std::move(left)),
+        right_(std::move(right)) {}
+
+  size_t Select(const std::vector<ColumnData> &columns, const oid_t *ids,
+                size_t count, oid_t *selected) const override {
+    if (conjunction_ == ExpressionType::CONJUNCTION_AND) {
+      count = left_->Select(columns, ids, count, selected);
+      return right_->Select(columns, selected, count, selected);
+    }
+
+    // the right side is only evaluated on the tuples the left side did not
+    // select, then the two selections are merged back in order
+    std::vector<oid_t> input(ids, ids + count);
+    std::vector<oid_t> left_selected(count);
+    size_t left_count =
+        left_->Select(columns, input.data(), count, left_selected.data());
+
+    std::vector<oid_t> rest;
+    rest.reserve(count - left_count);
+    size_t next_left = 0;
+    for (auto id : input) {
+      if (next_left < left_count && left_selected[next_left] == id) {
+        next_left++;
+      } else {
+        rest.push_back(id);
+      }
+    }
+    size_t right_count =
+        right_->Select(columns, rest.data(), rest.size(), rest.data());
+
+    return std::merge(left_selected.begin(),
+                      left_selected.begin() + left_count, rest.begin(),
+                      rest.begin() + right_count, selected) -
+           selected;
+  }
+
+ private:
+  const ExpressionType conjunction_;
+
+  std::unique_ptr<VectorCondition> left_;
+
+  std::unique_ptr<VectorCondition> right_;
+};
+
+//===--------------------------------------------------------------------===//
+// Compilation
+//===--------------------------------------------------------------------===//
+
+// nullptr if the expression cannot be vectorized. column_ids collects the
+// columns read.
+std::unique_ptr<VectorOperand> CompileOperand(
+    const expression::AbstractExpression *expr, const catalog::Schema *schema,
+    const std::vector<type::Value> &params, std::vector<oid_t> &column_ids) {
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::VALUE_TUPLE: {
+      auto tuple_expr =
+          static_cast<const expression::TupleValueExpression *>(expr);
+      auto column_id = tuple_expr->GetColumnId();
+      if (tuple_expr->GetTupleId() != 0 || column_id < 0 ||
+          static_cast<oid_t>(column_id) >= schema->GetColumnCount()) {
+        return nullptr;
+      }
+      auto type_id = schema->GetType(column_id);
+      if (IsNumericType(type_id) == false) {
+        return nullptr;
+      }
+      auto column_itr =
+          std::find(column_ids.begin(), column_ids.end(), column_id);
+      if (column_itr == column_ids.end()) {
+        column_itr = column_ids.insert(column_ids.end(), column_id);
+      }
+      return std::unique_ptr<VectorOperand>(
+          new ColumnOperand(type_id, column_itr - column_ids.begin()));
+    }
+    case ExpressionType::VALUE_CONSTANT: {
+      auto value =
+          static_cast<const expression::ConstantValueExpression *>(expr)
+              ->GetValue();
+      if (IsNumericType(value.GetTypeId()) == false) {
+        return nullptr;
+      }
+      return std::unique_ptr<VectorOperand>(new ConstantOperand(value));
+    }
+    case ExpressionType::VALUE_PARAMETER: {
+      auto value_idx =
+          static_cast<const expression::ParameterValueExpression *>(expr)
+              ->GetValueIdx();
+      if (value_idx < 0 || static_cast<size_t>(value_idx) >= params.size() ||
+          IsNumericType(params[value_idx].GetTypeId()) == false) {
+        return nullptr;
+      }
+      return std::unique_ptr<VectorOperand>(
+          new ConstantOperand(params[value_idx]));
+    }
+    case ExpressionType::OPERATOR_PLUS:
+    case ExpressionType::OPERATOR_MINUS:
+    case ExpressionType::OPERATOR_MULTIPLY:
+    case ExpressionType::OPERATOR_DIVIDE: {
+      if (expr->GetChildrenSize() != 2) {
+        return nullptr;
+      }
+      auto left = CompileOperand(expr->GetChild(0), schema, params, column_ids);
+      auto right =
+          CompileOperand(expr->GetChild(1), schema, params, column_ids);
+      if (left == nullptr || right == nullptr) {
+        return nullptr;
+      }
+      return std::unique_ptr<VectorOperand>(new ArithmeticOperand(
+          expr->GetExpressionType(), std::move(left), std::move(right)));
+    }
+    default:
+      return nullptr;
+  }
+}
+
+std::unique_ptr<VectorCondition> CompileCondition(
+    const expression::AbstractExpression *expr, const catalog::Schema *schema,
+    const std::vector<type::Value> &params, std::vector<oid_t> &column_ids) {
+  if (expr->GetChildrenSize() != 2) {
+    return nullptr;
+  }
+
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND:
+    case ExpressionType::CONJUNCTION_OR: {
+      auto left =
+          CompileCondition(expr->GetChild(0), schema, params, column_ids);
+      auto right =
+          CompileCondition(expr->GetChild(1), schema, params, column_ids);
+      if (left == nullptr || right == nullptr) {
+        return nullptr;
+      }
+      return std::unique_ptr<VectorCondition>(new ConjunctionCondition(
+          expr->GetExpressionType(), std::move(left), std::move(right)));
+    }
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO: {
+      auto left = CompileOperand(expr->GetChild(0), schema, params, column_ids);
+      auto right =
+          CompileOperand(expr->GetChild(1), schema, params, column_ids);
+      if (left == nullptr || right == nullptr) {
+        return nullptr;
+      }
+      return std::unique_ptr<VectorCondition>(new ComparisonCondition(
+          expr->GetExpressionType(), std::move(left), std::move(right)));
+    }
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Vectorized Predicate
+//===--------------------------------------------------------------------===//
+
+std::unique_ptr<VectorizedPredicate> VectorizedPredicate::Create(
+    const expression::AbstractExpression *predicate,
+    const catalog::Schema *schema, const std::vector<type::Value> &params) {
+  if (predicate == nullptr || schema == nullptr) {
+    return nullptr;
+  }
+
+  std::vector<oid_t> column_ids;
+  auto condition = CompileCondition(predicate, schema, params, column_ids);
+  if (condition == nullptr) {
+    return nullptr;
+  }
+  return std::unique_ptr<VectorizedPredicate>(
+      new VectorizedPredicate(std::move(condition), std::move(column_ids)));
+}
+
+VectorizedPredicate::VectorizedPredicate(
+    std::unique_ptr<VectorCondition> condition, std::vector<oid_t> column_ids)
+    : condition_(std::move(condition)), column_ids_(std::move(column_ids)) {}
+
+VectorizedPredicate::~VectorizedPredicate() {}
+
+void VectorizedPredicate::Filter(storage::TileGroup *tile_group,
+                                 std::vector<oid_t> &position_list) const {
+  std::vector<ColumnData> columns;
+  for (auto column_id : column_ids_) {
+    oid_t tile_offset, tile_column_id;
+    tile_group->GetLayout().LocateTileAndColumn(column_id, tile_offset,
+                                                tile_column_id);
+    auto tile = tile_group->GetTile(tile_offset);
+    auto tile_schema = tile->GetSchema();
+    columns.push_back(
+        ColumnData{tile->GetTupleLocation(0) +
+                       tile_schema->GetOffset(tile_column_id),
+                   tile_schema->GetLength()});
+  }
+
+  // the tuples selected from each vector are moved up to the front of the
+  // list
+  size_t match_count = 0;
+  for (size_t begin = 0; begin < position_list.size(); begin += VECTOR_SIZE) {
+    size_t count = std::min(VECTOR_SIZE, position_list.size() - begin);
+    auto ids = position_list.data() + begin;
+    count = condition_->Select(columns, ids, count, ids);
+    if (match_count != begin) {
+      std::copy(ids, ids + count, position_list.data() + match_count);
+    }
+    match_count += count;
+  }
+  position_list.resize(match_count);
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -19,6 +19,7 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "index/index.h"
 #include "settings/settings_manager.h"
+#include "storage/compressed_tile_group.h"
 #include "storage/database.h"
 #include "storage/storage_manager.h"
 #include "storage/tile_group.h"
@@ -53,6 +54,12 @@ bool TransactionLevelGCManager::ResetTuple(const ItemPointer &location) {
 void TransactionLevelGCManager::Running(const int &thread_id) {
   PELOTON_ASSERT(is_running_ == true);
   uint32_t backoff_shifts = 0;
+  auto last_index_gc = std::chrono::steady_clock::now();
+  auto last_freeze = last_index_gc;
+  auto last_compaction = last_index_gc;
+  auto last_all_visible = last_index_gc;
+  // epoch that was current at the last index GC pass
+  eid_t index_gc_eid = 0;
   while (true) {
     auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
 
@@ -67,6 +74,40 @@ void TransactionLevelGCManager::Running(const int &thread_id) {
     int reclaimed_count = Reclaim(thread_id, expired_eid);
     int unlinked_count = Unlink(thread_id, expired_eid);
 
+    // Index GC is driven by a single GC thread, which also keeps
+    // single-threaded index GC routines (e.g. BwTree's) safe. A pass only
+    // runs once every transaction that was active at the previous pass has
+    // left its epoch, so none of them still holds an index node unlinked
+    // before it.
+    if (thread_id == 0) {
+      auto now = std::chrono::steady_clock::now();
+      if (expired_eid >= index_gc_eid &&
+          now - last_index_gc >=
+              std::chrono::microseconds(INDEX_GC_INTERVAL)) {
+        index_gc_eid = epoch_manager.GetCurrentEpochId();
+        PerformIndexGC();
+        last_index_gc = now;
+      }
+      if (now - last_freeze >= std::chrono::microseconds(FREEZE_INTERVAL) &&
+          settings::SettingsManager::GetBool(
+              settings::SettingId::tile_group_freezing)) {
+        FreezeTileGroups(expired_eid);
+        last_freeze = now;
+      }
+      if (now - last_compaction >=
+              std::chrono::microseconds(COMPACTION_INTERVAL) &&
+          settings::SettingsManager::GetBool(
+              settings::SettingId::tile_group_compaction)) {
+        CompactTileGroups(expired_eid);
+        last_compaction = now;
+      }
+      if (now - last_all_visible >=
+          std::chrono::microseconds(ALL_VISIBLE_INTERVAL)) {
+        MarkAllVisibleTileGroups();
+        last_all_visible = now;
+      }
+    }
+
     if (is_running_ == false) {
       return;
     }
@@ -235,6 +276,14 @@ void TransactionLevelGCManager::AddToRecycleMap(
     PELOTON_ASSERT(tile_group_header != nullptr);
     bool immutable = tile_group_header->GetImmutability();
 
+    // the slots go to the queue of the partition of their tile group
+    std::shared_ptr<LockFreeQueue<ItemPointer>> recycle_queue;
+    auto recycle_queues = GetRecycleQueues(table_id);
+    size_t partition = table->GetTileGroupPartition(entry.first);
+    if (recycle_queues != nullptr && partition < recycle_queues->size()) {
+      recycle_queue = recycle_queues->at(partition);
+    }
+
     for (auto &element : entry.second) {
       // as this transaction has been committed, we should reclaim older
       // versions.
@@ -245,9 +294,13 @@ void TransactionLevelGCManager::AddToRecycleMap(
         continue;
       }
       // if immutable is false and the entry for table_id exists.
-      if ((!immutable) &&
-          recycle_queue_map_.find(table_id) != recycle_queue_map_.end()) {
-        recycle_queue_map_[table_id]->Enqueue(location);
+      // slots of a clustered table go back to their page.
+      if ((!immutable) && recycle_queue != nullptr) {
+        if (table->IsClustered() == true) {
+          table->RecycleClusteredTupleSlot(location);
+        } else {
+          recycle_queue->Enqueue(location);
+        }
       }
     }
   }
@@ -280,16 +333,270 @@ void TransactionLevelGCManager::AddToRecycleMap(
   delete txn_ctx;
 }
 
-// this function returns a free tuple slot, if one exists
+int TransactionLevelGCManager::PerformIndexGC() {
+  int gc_count = 0;
+  auto storage_manager = storage::StorageManager::GetInstance();
+  for (oid_t db_offset = 0; db_offset < storage_manager->GetDatabaseCount();
+       db_offset++) {
+    auto database = storage_manager->GetDatabaseWithOffset(db_offset);
+    if (database == nullptr) continue;
+    for (oid_t table_offset = 0; table_offset < database->GetTableCount();
+         table_offset++) {
+      auto table = database->GetTable(table_offset);
+      if (table == nullptr) continue;
+      for (oid_t index_offset = 0; index_offset < table->GetIndexCount();
+           index_offset++) {
+        auto index = table->GetIndex(index_offset);
+        if (index == nullptr || index->NeedGC() == false) continue;
+        index->PerformGC();
+        gc_count++;
+      }
+    }
+  }
+  LOG_TRACE("Performed GC on %d indexes", gc_count);
+  return gc_count;
+}
+
+int TransactionLevelGCManager::FreezeTileGroups(const eid_t &expired_eid) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto storage_manager = storage::StorageManager::GetInstance();
+  eid_t current_eid = epoch_manager.GetCurrentEpochId();
+  // versions that began at or before this cid are visible to every active
+  // and future transaction
+  cid_t visible_cid = epoch_manager.GetExpiredCid();
+
+  // no transaction can still be reading these headers
+  auto retired_entry = retired_tuple_headers_.begin();
+  while (retired_entry != retired_tuple_headers_.end() &&
+         retired_entry->first <= expired_eid) {
+    retired_entry = retired_tuple_headers_.erase(retired_entry);
+  }
+
+  // no transaction that began before these tile groups began freezing is
+  // still active, so every write now goes through the freezing check
+  int frozen_count = 0;
+  bool compress = settings::SettingsManager::GetBool(
+      settings::SettingId::tile_group_compression);
+  auto freezing_entry = freezing_tile_groups_.begin();
+  while (freezing_entry != freezing_tile_groups_.end() &&
+         freezing_entry->first <= expired_eid) {
+    storage::RetiredTupleHeaders retired;
+    auto &tile_group = freezing_entry->second;
+    if (tile_group->GetHeader()->FinishFreeze(visible_cid, retired)) {
+      retired_tuple_headers_.emplace(current_eid, std::move(retired));
+      frozen_count++;
+      if (compress) {
+        tile_group->SetCompressedColumns(
+            std::make_shared<const storage::CompressedTileGroup>(
+                tile_group.get()));
+      }
+    }
+    freezing_entry = freezing_tile_groups_.erase(freezing_entry);
+  }
+
+  // move on to the next tile groups
+  oid_t last_tile_group_id = storage_manager->GetCurrentTileGroupId();
+  for (size_t i = 0; i < FREEZE_BATCH_SIZE && last_tile_group_id > 0; i++) {
+    freeze_cursor_ = (freeze_cursor_ % last_tile_group_id) + 1;
+    auto tile_group = storage_manager->GetTileGroup(freeze_cursor_);
+    if (tile_group == nullptr ||
+        tile_group->GetHeader()->BeginFreeze(visible_cid) == false) {
+      continue;
+    }
+    // the columns compressed when the tile group last froze may have been
+    // written since
+    tile_group->SetCompressedColumns(nullptr);
+    freezing_tile_groups_.emplace_back(current_eid, tile_group);
+  }
+
+  LOG_TRACE("Froze %d tile groups, %lu freezing", frozen_count,
+            freezing_tile_groups_.size());
+  return frozen_count;
+}
+
+int TransactionLevelGCManager::MarkAllVisibleTileGroups() {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  oid_t last_tile_group_id = storage_manager->GetCurrentTileGroupId();
+  int marked_count = 0;
+  for (size_t i = 0; i < ALL_VISIBLE_BATCH_SIZE && last_tile_group_id > 0;
+       i++) {
+    all_visible_cursor_ = (all_visible_cursor_ % last_tile_group_id) + 1;
+    auto tile_group = storage_manager->GetTileGroup(all_visible_cursor_);
+    if (tile_group != nullptr && tile_group->GetHeader()->MarkAllVisible()) {
+      marked_count++;
+    }
+  }
+
+  LOG_TRACE("Marked %d tile groups all visible", marked_count);
+  return marked_count;
+}
+
+// A tile group is compacted in three steps, each waiting for the
+// transactions of the previous one to end:
+// 1. its freed slots stop being recycled (SetImmutability), inserts also
+//    skip the slots of it that were recycled already;
+// 2. once no transaction that may have taken such a slot is active, its
+//    live tuples are moved; the indirections then point to the new
+//    versions, and the old versions are forwarded to them by the version
+//    chain until the GC reclaims them;
+// 3. once every slot has been reclaimed, it is dropped from its table and
+//    the storage manager, and released once no transaction may still be
+//    reading it.
+int TransactionLevelGCManager::CompactTileGroups(const eid_t &expired_eid) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto storage_manager = storage::StorageManager::GetInstance();
+  eid_t current_eid = epoch_manager.GetCurrentEpochId();
+
+  // no transaction can still be reading these tile groups
+  auto dropped_entry = dropped_tile_groups_.begin();
+  while (dropped_entry != dropped_tile_groups_.end() &&
+         dropped_entry->first <= expired_eid) {
+    dropped_entry = dropped_tile_groups_.erase(dropped_entry);
+  }
+
+  int dropped_count = 0;
+  auto compacting_entry = compacting_tile_groups_.begin();
+  while (compacting_entry != compacting_tile_groups_.end() &&
+         compacting_entry->first <= expired_eid) {
+    auto tile_group = compacting_entry->second;
+    oid_t tile_group_id = tile_group->GetTileGroupId();
+
+    // the table was dropped in the meantime
+    if (storage_manager->GetTileGroup(tile_group_id) == nullptr) {
+      compacting_entry = compacting_tile_groups_.erase(compacting_entry);
+      continue;
+    }
+
+    storage::DataTable *table =
+        dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+    PELOTON_ASSERT(table != nullptr);
+
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t slot_count = tile_group->GetAllocatedTupleCount();
+    oid_t used_slot_count = 0;
+    for (oid_t tuple_id = 0; tuple_id < slot_count; tuple_id++) {
+      if (tile_group_header->GetTransactionId(tuple_id) != INVALID_TXN_ID) {
+        used_slot_count++;
+      }
+    }
+
+    if (used_slot_count == 0) {
+      if (table->DropCompactedTileGroup(tile_group_id) == true) {
+        dropped_tile_groups_.emplace(current_eid, tile_group);
+        dropped_count++;
+      } else {
+        tile_group_header->ResetImmutability();
+      }
+      compacting_entry = compacting_tile_groups_.erase(compacting_entry);
+      continue;
+    }
+
+    // versions that are not live yet or any more are left to their writers
+    // and the GC, the tile group is looked at again on the next pass
+    MoveTuples(table, tile_group.get());
+    ++compacting_entry;
+  }
+
+  // move on to the next tile groups. tables that are not registered do not
+  // recycle slots and are not compacted.
+  oid_t last_tile_group_id = storage_manager->GetCurrentTileGroupId();
+  oid_t threshold = settings::SettingsManager::GetInt(
+      settings::SettingId::tile_group_compaction_threshold);
+  for (size_t i = 0; i < COMPACTION_BATCH_SIZE && last_tile_group_id > 0;
+       i++) {
+    compaction_cursor_ = (compaction_cursor_ % last_tile_group_id) + 1;
+    auto tile_group = storage_manager->GetTileGroup(compaction_cursor_);
+    if (tile_group == nullptr ||
+        recycle_queue_map_.find(tile_group->GetTableId()) ==
+            recycle_queue_map_.end()) {
+      continue;
+    }
+
+    // rows of partitioned and clustered tables are moved to the tail of the
+    // table, not of their partition or page.
+    storage::DataTable *table =
+        dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+    if (table == nullptr || table->IsPlacedByKey() == true) {
+      continue;
+    }
+
+    // only full tile groups, the others still take inserts
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t slot_count = tile_group->GetAllocatedTupleCount();
+    if (tile_group_header->GetCurrentNextTupleSlot() < slot_count ||
+        tile_group_header->GetImmutability() == true) {
+      continue;
+    }
+
+    oid_t live_count = 0;
+    for (oid_t tuple_id = 0; tuple_id < slot_count; tuple_id++) {
+      if (tile_group_header->GetTransactionId(tuple_id) != INVALID_TXN_ID) {
+        live_count++;
+      }
+    }
+    if (live_count * 100 >= slot_count * threshold ||
+        tile_group_header->SetImmutability() == false) {
+      continue;
+    }
+    compacting_tile_groups_.emplace_back(current_eid, tile_group);
+  }
+
+  LOG_TRACE("Dropped %d compacted tile groups, %lu compacting", dropped_count,
+            compacting_tile_groups_.size());
+  return dropped_count;
+}
+
+oid_t TransactionLevelGCManager::MoveTuples(storage::DataTable *table,
+                                            storage::TileGroup *tile_group) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  oid_t slot_count = tile_group->GetAllocatedTupleCount();
+  oid_t column_count = table->GetSchema()->GetColumnCount();
+
+  auto txn = txn_manager.BeginTransaction();
+  oid_t moved_count = 0;
+  for (oid_t tuple_id = 0; tuple_id < slot_count; tuple_id++) {
+    // a row being written is moved on a later pass
+    if (txn_manager.IsOwnable(txn, tile_group_header, tuple_id) == false ||
+        txn_manager.AcquireOwnership(txn, tile_group_header, tuple_id) ==
+            false) {
+      continue;
+    }
+
+    ItemPointer old_location(tile_group_id, tuple_id);
+    ContainerTuple<storage::TileGroup> old_tuple(tile_group, tuple_id);
+    ItemPointer new_location = table->AcquireMovedVersion(&old_tuple);
+    auto new_tile_group = storage_manager->GetTileGroup(new_location.block);
+
+    ContainerTuple<storage::TileGroup> new_tuple(new_tile_group.get(),
+                                                 new_location.offset);
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      new_tuple.SetValue(column_id, old_tuple.GetValue(column_id));
+    }
+
+    txn_manager.PerformUpdate(txn, old_location, new_location);
+    moved_count++;
+  }
+  txn_manager.CommitTransaction(txn);
+
+  LOG_TRACE("Moved %u tuples out of tile group %u", moved_count,
+            tile_group_id);
+  return moved_count;
+}
+
+// this function returns a free tuple slot of the partition, if one exists
 // called by data_table.
-ItemPointer TransactionLevelGCManager::ReturnFreeSlot(const oid_t &table_id) {
+ItemPointer TransactionLevelGCManager::ReturnFreeSlot(const oid_t &table_id,
+                                                      const size_t &partition) {
   // for catalog tables, we directly return invalid item pointer.
-  if (recycle_queue_map_.find(table_id) == recycle_queue_map_.end()) {
+  auto recycle_queues = GetRecycleQueues(table_id);
+  if (recycle_queues == nullptr || partition >= recycle_queues->size()) {
     return INVALID_ITEMPOINTER;
   }
   ItemPointer location;
-  PELOTON_ASSERT(recycle_queue_map_.find(table_id) != recycle_queue_map_.end());
-  auto recycle_queue = recycle_queue_map_[table_id];
+  auto &recycle_queue = recycle_queues->at(partition);
 
   if (recycle_queue->Dequeue(location) == true) {
     LOG_TRACE("Reuse tuple(%u, %u) in table %u", location.block,
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_bench_configuration.h
+//
+// Identification: src/include/benchmark/index_bench/index_bench_configuration.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common/internal_types.h"
+
+namespace peloton {
+namespace benchmark {
+namespace index_bench {
+
+enum class KeyDistribution {
+  UNIFORM = 0,
+  ZIPFIAN = 1,
+};
+
+enum class OperationMix {
+  INSERT_ONLY = 0,  // 100% inserts of new keys
+  READ_ONLY = 1,    // 100% point lookups
+  READ_MOSTLY = 2,  // 95% point lookups, 5% inserts
+  SCAN_HEAVY = 3,   // 95% range scans, 5% inserts
+};
+
+struct configuration {
+  // index structures to compare
+  std::vector<IndexType> index_types;
+
+  // thread counts to run each index with
+  std::vector<int> backend_counts;
+
+  // # of BIGINT key columns, selects CompactIntsKey<1..4>
+  int key_column_count;
+
+  // width of a VARCHAR key in characters, selects a GenericKey instead of
+  // a CompactIntsKey when non-zero
+  int generic_key_size;
+
+  // # of keys loaded before the timed phase
+  size_t key_count;
+
+  // # of operations per thread in the timed phase
+  size_t operation_count;
+
+  // # of keys covered by a range scan
+  size_t scan_length;
+
+  // key access distribution
+  KeyDistribution distribution;
+
+  // skew of the zipfian distribution
+  double zipf_theta;
+
+  // operation mix
+  OperationMix operation_mix;
+
+  // check the lookups of every index, including a long run of duplicates,
+  // before timing it
+  bool verify;
+};
+
+extern configuration state;
+
+void Usage(FILE *out);
+
+void ParseArguments(int argc, char *argv[], configuration &state);
+
+std::string KeyDistributionToString(KeyDistribution distribution);
+
+std::string OperationMixToString(OperationMix operation_mix);
+
+}  // namespace index_bench
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_bench_workload.h
+//
+// Identification: src/include/benchmark/index_bench/index_bench_workload.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+#include "benchmark/index_bench/index_bench_configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace index_bench {
+
+/**
+ * Zipfian distribution over [0, n), following Gray et al., "Quickly
+ * Generating Billion-Record Synthetic Databases" (SIGMOD '94). Numbers are
+ * scrambled with FNV so that the hot keys are spread across the key space
+ * instead of clustering at the low end, as in YCSB.
+ */
+class ZipfDistribution {
+ public:
+  ZipfDistribution(uint64_t n, double theta);
+
+  uint64_t GetNextNumber(std::mt19937_64 &rng);
+
+ private:
+  static double Zeta(uint64_t n, double theta);
+
+  const uint64_t n_;
+
+  const double theta_;
+
+  double alpha_;
+
+  double zetan_;
+
+  double eta_;
+
+  std::uniform_real_distribution<double> uniform_;
+};
+
+/**
+ * Result of running one index with one thread count
+ */
+struct IndexBenchResult {
+  // operations per second while loading the initial keys
+  double load_throughput;
+
+  // operations per second in the timed phase
+  double throughput;
+
+  // latency percentiles of the timed phase in microseconds
+  double latency_p50;
+  double latency_p90;
+  double latency_p99;
+  double latency_p999;
+
+  // bytes used by the index after the timed phase
+  size_t memory_footprint;
+};
+
+void RunBenchmark();
+
+}  // namespace index_bench
+}  // namespace benchmark
+}  // namespace peloton
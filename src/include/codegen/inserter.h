@@ -61,7 +61,11 @@ class Inserter {
 
  private:
   // No external constructor
-  Inserter(): table_(nullptr), executor_context_(nullptr), tile_(nullptr) {}
+  Inserter()
+      : table_(nullptr),
+        executor_context_(nullptr),
+        tile_(nullptr),
+        scratch_tuple_(nullptr) {}
 
  private:
   // Provided by its insert translator
@@ -72,6 +76,10 @@ class Inserter {
   std::shared_ptr<storage::Tile> tile_;
   ItemPointer location_;
 
+  // Tuples of partitioned and clustered tables are stored here before being
+  // routed to their partition or page
+  storage::Tuple *scratch_tuple_;
+
  private:
   DISALLOW_COPY_AND_MOVE(Inserter);
 };
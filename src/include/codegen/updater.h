@@ -28,6 +28,7 @@ class ExecutorContext;
 namespace storage {
 class DataTable;
 class Tile;
+class Tuple;
 }  // namespace storage
 
 namespace type {
@@ -66,7 +67,8 @@ class Updater {
  private:
   // No external constructor
   Updater(): table_(nullptr), executor_context_(nullptr), target_list_(nullptr),
-             is_owner_(false), acquired_ownership_(false), tile_(nullptr) {}
+             is_owner_(false), acquired_ownership_(false), tile_(nullptr),
+             scratch_tuple_(nullptr) {}
 
   char *GetDataPtr(uint32_t tile_group_id, uint32_t tuple_offset);
 
@@ -109,6 +111,10 @@ class Updater {
   // Tile info used for retrieving the tuple location
   std::shared_ptr<storage::Tile> tile_;
 
+  // New rows of partitioned and clustered tables are stored here by
+  // PreparePK() before being routed to their partition or page
+  storage::Tuple *scratch_tuple_;
+
  private:
   DISALLOW_COPY_AND_MOVE(Updater);
 };
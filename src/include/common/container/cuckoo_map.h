@@ -55,6 +55,13 @@ class CuckooMap {
   // Upsert operations always succeed
   void Upsert(const KeyType &key, ValueType value);
 
+  // Inserts the item if not present, applies update_fn to the value
+  // otherwise. The update is atomic with respect to other operations on key
+  template <typename UpdateFn>
+  void Upsert(const KeyType &key, UpdateFn update_fn, ValueType value) {
+    cuckoo_map.upsert(key, update_fn, value);
+  }
+
   // Extracts item with high priority
   bool Update(const KeyType &key, ValueType value);
 
@@ -474,12 +474,26 @@ enum class BackendType {
   MM = 1,                     // on volatile memory
   NVM = 2,                    // on non-volatile memory
   SSD = 3,                    // on ssd
-  HDD = 4                     // on hdd
+  HDD = 4,                    // on hdd
+  HUGE_PAGE = 5               // on volatile memory, in huge page arenas
 };
 std::string BackendTypeToString(BackendType type);
 BackendType StringToBackendType(const std::string &str);
 std::ostream &operator<<(std::ostream &os, const BackendType &type);
 
+//===--------------------------------------------------------------------===//
+// Partition Types
+//===--------------------------------------------------------------------===//
+
+enum class PartitionType {
+  INVALID = INVALID_TYPE_ID,  // not partitioned
+  RANGE = 1,                  // by ranges of the partition key
+  HASH = 2                    // by the hash of the partition key
+};
+std::string PartitionTypeToString(PartitionType type);
+PartitionType StringToPartitionType(const std::string &str);
+std::ostream &operator<<(std::ostream &os, const PartitionType &type);
+
 //===--------------------------------------------------------------------===//
 // Index Types
 //===--------------------------------------------------------------------===//
@@ -490,6 +504,7 @@ enum class IndexType {
   HASH = 2,                   // hash
   SKIPLIST = 3,               // skiplist
   ART = 4,                    // ART
+  BPLUSTREE = 5,              // B+tree with optimistic lock coupling
 };
 std::string IndexTypeToString(IndexType type);
 IndexType StringToIndexType(const std::string &str);
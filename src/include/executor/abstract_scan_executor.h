@@ -12,13 +12,22 @@
 
 #pragma once
 
+#include <limits>
+
 #include "executor/abstract_executor.h"
 #include "planner/abstract_scan_plan.h"
 #include "common/internal_types.h"
 
 namespace peloton {
+
+namespace storage {
+class TileGroup;
+}
+
 namespace executor {
 
+class BlockedBloomFilter;
+
 /**
  * Super class for different kinds of scan executor.
  * It provides common codes for all kinds of scan:
@@ -45,10 +54,36 @@ class AbstractScanExecutor : public AbstractExecutor {
 
   virtual void ResetState() {}
 
+  /**
+   * @brief Lets the scan stop once it has produced tuple_budget tuples, as
+   * its parent needs no more of them, e.g. a LIMIT right above it.
+   */
+  void SetTupleBudget(size_t tuple_budget) { tuple_budget_ = tuple_budget; }
+
+  /**
+   * @brief Lets the scan drop the tuples whose key, the values of the output
+   * columns key_column_ids, the filter rules out, e.g. tuples a hash join
+   * above it would not join. The filter must outlive the scan, nullptr
+   * drops nothing.
+   */
+  void SetKeyFilter(const BlockedBloomFilter *key_filter,
+                    const std::vector<oid_t> &key_column_ids);
+
  protected:
   bool DInit();
 
-  virtual bool DExecute() = 0;
+  /** @brief Scans with DScan until the tuple budget is spent. */
+  bool DExecute() final;
+
+  /** @brief Produces the next logical tile of the scan. */
+  virtual bool DScan() = 0;
+
+  /** @brief Whether the key filter may contain the key of the tuple. */
+  bool PassesKeyFilter(storage::TileGroup *tile_group, oid_t tuple_id) const;
+
+  /** @brief Removes the tuples the key filter rules out. */
+  void FilterKeys(storage::TileGroup *tile_group,
+                  std::vector<oid_t> &position_list) const;
 
  protected:
   //===--------------------------------------------------------------------===//
@@ -60,6 +95,18 @@ class AbstractScanExecutor : public AbstractExecutor {
 
   /** @brief Columns from tile group to be added to logical tile output. */
   std::vector<oid_t> column_ids_;
+
+  /** @brief # of tuples the parent needs at most. */
+  size_t tuple_budget_ = std::numeric_limits<size_t>::max();
+
+  /** @brief # of tuples produced since DInit. */
+  size_t num_tuples_produced_ = 0;
+
+  /** @brief Filter on the keys of the tuples, nullptr if none. */
+  const BlockedBloomFilter *key_filter_ = nullptr;
+
+  /** @brief Table columns of the key the filter is on. */
+  std::vector<oid_t> key_filter_column_ids_;
 };
 
 }  // namespace executor
@@ -0,0 +1,242 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// aggregation_hash_table.h
+//
+// Identification: src/include/executor/aggregation_hash_table.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "type/arena_pool.h"
+#include "type/value.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace planner {
+class AggregatePlan;
+}
+
+namespace executor {
+
+class ExecutorContext;
+
+//===--------------------------------------------------------------------===//
+// Aggregation Hash Table
+//===--------------------------------------------------------------------===//
+
+/**
+ * Hash table of the groups of a hash aggregation whose input columns are
+ * all fixed width.
+ *
+ * A group is a fixed size entry allocated from an arena: the hash of its
+ * key, its group-by values serialized back to back, the first tuple of the
+ * group serialized the same way, and the state of each aggregate, a count
+ * and an integer or double. Entries are found through an open addressing
+ * table of (hash, entry) slots, and kept in the order they were added, so
+ * that merging tables of consecutive parts of the input keeps the first
+ * tuple of each group.
+ *
+ * An entry holds no pointers, the table spills its entries to files as
+ * they are and merges them back from there.
+ *
+ * The values a DISTINCT aggregate has seen in each group are kept in the
+ * arena as well, in a table of their own, an aggregate only advances on the
+ * first of equal values. They are spilled to the file of their group, and
+ * a DISTINCT aggregate is advanced again on them when groups are merged,
+ * so that a group spilled and merged back is not advanced twice by the
+ * same value.
+ */
+class AggregationHashTable {
+ public:
+  /**
+   * Whether the input of the aggregation, of which tuple is the first, can
+   * be aggregated on this table. If so, sets input_types to the types of
+   * its columns.
+   */
+  static bool IsSupported(const planner::AggregatePlan *node,
+                          const AbstractTuple *tuple, size_t num_input_columns,
+                          std::vector<type::TypeId> &input_types);
+
+  AggregationHashTable(const planner::AggregatePlan *node,
+                       const std::vector<type::TypeId> &input_types,
+                       ExecutorContext *executor_context);
+
+  // whether an aggregate is DISTINCT
+  bool HasDistinct() const { return has_distinct_; }
+
+  // advances the aggregates of the group of the tuple, adding the group if
+  // it is new
+  void Advance(const AbstractTuple *tuple);
+
+  // merges the groups of a table of the same aggregation, in the order they
+  // were added there
+  void Merge(const AggregationHashTable &other);
+
+  // the entries of the groups, in the order they were added
+  const std::vector<char *> &GetEntries() const { return entries_; }
+
+  // # of bytes the groups and the values DISTINCT aggregates have seen take
+  size_t GetMemoryUsage() const {
+    return pool_->GetChunkSize() +
+           (slots_.size() + distinct_slots_.size()) * sizeof(Slot);
+  }
+
+  // the first tuple of the group of an entry
+  void GetFirstTuple(const char *entry,
+                     std::vector<type::Value> &values) const;
+
+  // the final value of each aggregate of the group of an entry
+  void GetAggregateValues(const char *entry,
+                          std::vector<type::Value> &values) const;
+
+  /**
+   * Appends each entry to one of the files, chosen on its hash, and clears
+   * the groups. The entries of a group, and the values its DISTINCT
+   * aggregates have seen, always go to the same file.
+   */
+  void Spill(const std::vector<std::FILE *> &files);
+
+  // merges the entries of a file the groups were spilled to
+  void Load(std::FILE *file);
+
+  // removes the groups and the values DISTINCT aggregates have seen
+  void Clear();
+
+ private:
+  // the state of an aggregate of a group. count is the # of values it has
+  // advanced on, the type is that of the aggregate value so far.
+  struct AggregateState {
+    int64_t count;
+    union {
+      int64_t integer;
+      double decimal;
+    };
+    type::TypeId type_id;
+  };
+
+  // an empty slot has no entry
+  struct Slot {
+    uint64_t hash;
+    char *entry;
+  };
+
+  static uint64_t Hash(const char *key, size_t size);
+
+  // the state of a single value
+  static AggregateState MakeState(ExpressionType agg_type,
+                                  const type::Value &value);
+
+  // advances state on the values other has advanced on
+  static void CombineState(ExpressionType agg_type, AggregateState &state,
+                           const AggregateState &other);
+
+  static type::Value FinalizeState(ExpressionType agg_type,
+                                   const AggregateState &state);
+
+  inline uint64_t GetHash(const char *entry) const {
+    return *reinterpret_cast<const uint64_t *>(entry);
+  }
+
+  inline AggregateState *GetStates(char *entry) const {
+    return reinterpret_cast<AggregateState *>(entry + states_offset_);
+  }
+
+  inline const AggregateState *GetStates(const char *entry) const {
+    return reinterpret_cast<const AggregateState *>(entry + states_offset_);
+  }
+
+  // the slot holding the entry with the key, which follows the hash, or the
+  // empty slot it would go to
+  Slot &FindSlot(std::vector<Slot> &slots, uint64_t hash, const char *key,
+                 size_t key_size);
+
+  // the entry of the group of the key, a new entry with the key and no
+  // aggregate advanced if there is none. added tells which.
+  char *FindOrAddEntry(uint64_t hash, const char *key, bool &added);
+
+  // merges an entry of the same aggregation into its group here. DISTINCT
+  // aggregates are left alone, they advance on the merged distinct values.
+  void MergeEntry(const char *other_entry);
+
+  // whether the DISTINCT aggregate has not seen the value in the group of
+  // the key yet, it has from now on
+  bool AddDistinctValue(const char *key, oid_t aggno,
+                        const type::Value &value);
+
+  // adds a distinct value, the record that follows the hash, unless it is
+  // there already. false if it is.
+  bool AddDistinctRecord(uint64_t hash, const char *record);
+
+  // advances the DISTINCT aggregate of a distinct value of the same
+  // aggregation on it, unless it has seen the value. the group must be here.
+  void MergeDistinctValue(const char *other_distinct_value);
+
+  // doubles the slots, which index the entries
+  void Grow(std::vector<Slot> &slots, const std::vector<char *> &entries);
+
+  const planner::AggregatePlan *node_;
+
+  ExecutorContext *executor_context_;
+
+  const std::vector<type::TypeId> input_types_;
+
+  // offset of each input column within a serialized tuple
+  std::vector<size_t> column_offsets_;
+
+  // offset of each group-by value within a key
+  std::vector<size_t> key_offsets_;
+
+  size_t key_size_;
+
+  size_t tuple_size_;
+
+  // the key, then the first tuple, follow the hash
+  size_t tuple_offset_;
+
+  size_t states_offset_;
+
+  size_t entry_size_;
+
+  // a distinct value is the hash, then a record of the key, the aggregate,
+  // the type and the serialized value. offsets are within the record.
+  size_t distinct_type_offset_;
+
+  size_t distinct_data_offset_;
+
+  size_t distinct_record_size_;
+
+  bool has_distinct_ = false;
+
+  std::unique_ptr<type::ArenaPool> pool_;
+
+  // the # of slots is a power of two, at most half of them are taken
+  std::vector<Slot> slots_;
+
+  std::vector<char *> entries_;
+
+  // the key of the tuple being advanced
+  std::vector<char> key_buffer_;
+
+  // the values DISTINCT aggregates have seen, slots as with the entries
+  std::vector<Slot> distinct_slots_;
+
+  std::vector<char *> distinct_values_;
+
+  // the distinct value being added, without its hash
+  std::vector<char> distinct_buffer_;
+};
+
+}  // namespace executor
+}  // namespace peloton
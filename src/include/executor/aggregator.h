@@ -12,11 +12,14 @@
 
 #pragma once
 
+#include <cstdio>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "common/container_tuple.h"
 #include "executor/abstract_executor.h"
+#include "executor/aggregation_hash_table.h"
 #include "planner/aggregate_plan.h"
 #include "type/value_factory.h"
 #include "type/value_peeker.h"
@@ -245,6 +248,9 @@ class AbstractAggregator {
 
   virtual bool Advance(AbstractTuple *next_tuple) = 0;
 
+  /** @brief Advance on every visible tuple of a logical tile */
+  virtual bool AdvanceTile(std::unique_ptr<LogicalTile> tile);
+
   virtual bool Finalize() = 0;
 
   virtual ~AbstractAggregator() {}
@@ -263,6 +269,13 @@ class AbstractAggregator {
 /**
  * @brief Used when input is NOT sorted.
  * Will maintain an internal hash table.
+ *
+ * When every input column is fixed width, groups are kept in an
+ * AggregationHashTable. Tiles are then buffered and pre-aggregated in
+ * batches, each part of a batch into a table of its own on a thread of the
+ * execution pool, and the tables merged in input order. Past
+ * hash_aggregation_memory_limit, groups are spilled to partition files and
+ * each partition is merged back and output on its own in Finalize.
  */
 class HashAggregator : public AbstractAggregator {
  public:
@@ -272,13 +285,54 @@ class HashAggregator : public AbstractAggregator {
 
   bool Advance(AbstractTuple *next_tuple) override;
 
+  bool AdvanceTile(std::unique_ptr<LogicalTile> tile) override;
+
   bool Finalize() override;
 
   ~HashAggregator();
 
  private:
+  // # of buffered tuples that are aggregated as a batch
+  static const size_t BATCH_SIZE = 1 << 16;
+
+  // # of files spilled groups are partitioned into
+  static const size_t SPILL_PARTITION_COUNT = 16;
+
+  struct FileCloser {
+    void operator()(std::FILE *file) const { std::fclose(file); }
+  };
+
+  // aggregates on a table if the input is fixed width
+  void Initialize(const AbstractTuple *first_tuple);
+
+  // aggregates the buffered tiles
+  void AdvancePendingTiles();
+
+  // spills the groups if they take more than the memory limit
+  void CheckMemoryUsage();
+
+  // outputs the groups of the table
+  bool OutputGroups();
+
   const size_t num_input_columns;
 
+  /** @brief Whether the first tuple has been seen */
+  bool initialized_ = false;
+
+  /** @brief Types of the input columns, if the input is fixed width */
+  std::vector<type::TypeId> input_types_;
+
+  /** @brief Groups, if the input is fixed width */
+  std::unique_ptr<AggregationHashTable> table_;
+
+  std::vector<std::unique_ptr<LogicalTile>> pending_tiles_;
+
+  size_t pending_tuple_count_ = 0;
+
+  double memory_limit_;
+
+  std::vector<std::unique_ptr<std::FILE, FileCloser>> spill_files_;
+
   /** List of aggregates for a specific group. */
   struct AggregateList {
     // Keep a deep copy of the first tuple we met of this group
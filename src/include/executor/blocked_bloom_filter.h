@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// blocked_bloom_filter.h
+//
+// Identification: src/include/executor/blocked_bloom_filter.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "util/hash_util.h"
+
+namespace peloton {
+namespace executor {
+
+//===--------------------------------------------------------------------===//
+// Blocked Bloom Filter
+//===--------------------------------------------------------------------===//
+
+/**
+ * Bloom filter on the hashes of the keys of the build side of a hash join,
+ * probed by the scan of its probe side to drop the tuples that join
+ * nothing before they are materialized.
+ *
+ * The bits are split in cache line sized blocks of eight words. A key
+ * picks a block on the high bits of its mixed hash, and sets one bit in
+ * each of its words on the bits of the hash mixed again, so that adding or
+ * probing a key touches a single cache line. With sixteen bits per key,
+ * about one key in a thousand not added passes.
+ */
+class BlockedBloomFilter {
+ public:
+  // # of words in a block
+  static const size_t BLOCK_WORD_COUNT = 8;
+
+  // # of bits per key the filter is sized on
+  static const size_t BITS_PER_KEY = 16;
+
+  // sizes the filter for key_count keys
+  explicit BlockedBloomFilter(size_t key_count);
+
+  void Add(uint64_t hash);
+
+  inline bool MayContain(uint64_t hash) const {
+    hash = HashUtil::MixBits(hash);
+    const uint64_t *block = &words_[GetBlockOffset(hash)];
+    uint64_t bits = HashUtil::MixBits(hash);
+    for (size_t word = 0; word < BLOCK_WORD_COUNT; word++) {
+      if ((block[word] & (1ull << ((bits >> (word * 6)) & 63))) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // # of bytes the bits take
+  size_t GetSize() const { return words_.size() * sizeof(uint64_t); }
+
+ private:
+  // the offset of the first word of the block of a mixed hash
+  inline size_t GetBlockOffset(uint64_t hash) const {
+    size_t block_id = block_bits_ == 0 ? 0 : hash >> (64 - block_bits_);
+    return block_id * BLOCK_WORD_COUNT;
+  }
+
+  // the # of blocks is 1 << block_bits_
+  size_t block_bits_ = 0;
+
+  std::vector<uint64_t> words_;
+};
+
+}  // namespace executor
+}  // namespace peloton
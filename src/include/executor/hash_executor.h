@@ -16,7 +16,9 @@
 
 #include "common/internal_types.h"
 #include "executor/abstract_executor.h"
+#include "executor/blocked_bloom_filter.h"
 #include "executor/logical_tile.h"
+#include "executor/radix_join_table.h"
 #include "common/container_tuple.h"
 
 #include <boost/functional/hash.hpp>
@@ -55,15 +57,56 @@ class HashExecutor : public AbstractExecutor {
     return this->column_ids_;
   }
 
+  /**
+   * @brief Build a radix partitioned hash table instead of the hash table,
+   * if the input is large enough and hashed on a single integer column.
+   * Set by a hash join whose probe side is hashed on an integer too.
+   */
+  inline void SetRadixJoin(bool radix_join) { radix_join_ = radix_join; }
+
+  /** @brief The radix partitioned hash table, nullptr if not built */
+  inline const RadixJoinTable *GetRadixTable() const {
+    return radix_table_.get();
+  }
+
+  /**
+   * @brief Build a Bloom filter on the hash keys of the input too, for a
+   * hash join to push into its probe side.
+   */
+  inline void SetBuildKeyFilter(bool build_key_filter) {
+    build_key_filter_ = build_key_filter;
+  }
+
+  /** @brief The Bloom filter on the hash keys, nullptr if not built */
+  inline const BlockedBloomFilter *GetKeyFilter() const {
+    return key_filter_.get();
+  }
+
  protected:
   bool DInit();
 
   bool DExecute();
 
  private:
+  // builds the radix partitioned hash table, false if the input is too
+  // small or its key is not an integer
+  bool BuildRadixTable();
+
+  // adds the hash keys of the visible tuples of the output tiles to a new
+  // Bloom filter
+  void BuildKeyFilter();
+
   /** @brief Hash table */
   HashMapType hash_table_;
 
+  bool radix_join_ = false;
+
+  std::unique_ptr<RadixJoinTable> radix_table_;
+
+  bool build_key_filter_ = false;
+
+  std::unique_ptr<BlockedBloomFilter> key_filter_;
+
   /** @brief Input tiles from child node */
   std::vector<std::unique_ptr<LogicalTile>> child_tiles_;
 
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "executor/abstract_join_executor.h"
+#include "executor/abstract_scan_executor.h"
 #include "planner/hash_join_plan.h"
 #include "executor/hash_executor.h"
 
@@ -40,8 +41,16 @@ class HashJoinExecutor : public AbstractJoinExecutor {
   bool DExecute();
 
  private:
+  // probes the radix partitioned hash table with every left tile at once,
+  // buffering the join tiles
+  void ProbeRadixTable(const RadixJoinTable &radix_table);
+
   HashExecutor *hash_executor_ = nullptr;
 
+  // the scan of the left side, that drops the tuples whose key is not in
+  // the Bloom filter of the right side, nullptr if there is none
+  AbstractScanExecutor *left_scan_ = nullptr;
+
   bool hashed_ = false;
 
   std::deque<LogicalTile *> buffered_output_tiles;
@@ -33,7 +33,7 @@ class HybridScanExecutor : public AbstractScanExecutor {
  protected:
   bool DInit();
 
-  bool DExecute();
+  bool DScan();
 
  private:
   std::shared_ptr<index::Index> index_;
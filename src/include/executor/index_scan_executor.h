@@ -52,7 +52,7 @@ class IndexScanExecutor : public AbstractScanExecutor {
  protected:
   bool DInit();
 
-  bool DExecute();
+  bool DScan();
 
  private:
   //===--------------------------------------------------------------------===//
@@ -72,6 +72,14 @@ class IndexScanExecutor : public AbstractScanExecutor {
   // conditions on key columns
   bool CheckKeyConditions(const ItemPointer &tuple_location);
 
+  // Check whether the tuples found so far leave at least as many tuples as
+  // the tuple budget once the open left boundary is pruned
+  bool CoversTupleBudget(const std::vector<ItemPointer> &tuple_locations);
+
+  // Record the columns and the access type (point lookup or range scan) of
+  // the scan for the index tuner
+  void RecordIndexSample();
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -12,9 +12,21 @@
 
 #pragma once
 
+#include <vector>
+
 #include "executor/abstract_executor.h"
 
 namespace peloton {
+
+namespace storage {
+class DataTable;
+class Tuple;
+}  // namespace storage
+
+namespace trigger {
+class TriggerList;
+}  // namespace trigger
+
 namespace executor {
 
 /**
@@ -38,6 +50,13 @@ class InsertExecutor : public AbstractExecutor {
   bool DExecute();
 
  private:
+  // whether per-row triggers force the tuples to be inserted one at a time
+  static bool HasRowTriggers(trigger::TriggerList *trigger_list);
+
+  // insert the tuples as one batch, fails the transaction on a violation
+  bool InsertBatch(storage::DataTable *target_table,
+                   const std::vector<const storage::Tuple *> &tuples);
+
   bool done_ = false;
 };
 
@@ -100,7 +100,7 @@ class LogicalTile : public Printable {
 
   void SetValue(type::Value &value, oid_t tuple_id, oid_t column_id);
 
-  size_t GetTupleCount();
+  size_t GetTupleCount() const;
 
   size_t GetColumnCount();
   size_t GetKColumnCount();
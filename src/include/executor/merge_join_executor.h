@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <deque>
+#include <vector>
+
 #include "executor/abstract_join_executor.h"
 #include "planner/merge_join_plan.h"
 
@@ -39,6 +42,42 @@ class MergeJoinExecutor : public AbstractJoinExecutor {
  private:
   size_t Advance(LogicalTile *tile, size_t start_row, bool is_left);
 
+  // a visible row of a buffered tile
+  struct Row {
+    oid_t tile_offset;
+    oid_t tuple_id;
+  };
+
+  // a pair of joined rows, offsets into left_rows_ and right_rows_
+  struct Match {
+    size_t left_row;
+    size_t right_row;
+  };
+
+  // whether both children are index scans on the join key, whose rows come
+  // in key order, so that they can be joined in ranges of keys at once
+  bool IsRangePartitioned();
+
+  /**
+   * Buffers every tile of both children, splits the keys in ranges on keys
+   * of the left rows, joins the ranges on the threads of the execution
+   * pool, and buffers the join tiles in key order.
+   */
+  void JoinRanges();
+
+  // the visible rows of the buffered tiles of a side, and the values of
+  // their join keys, a value per join clause
+  void GatherRows(bool is_left, std::vector<Row> &rows,
+                  std::vector<type::Value> &keys);
+
+  // -1, 0 or 1 as key a is less than, equal to or greater than key b
+  int CompareKeys(const type::Value *a, const type::Value *b) const;
+
+  // merges the left rows [left_begin, left_end) with the right rows
+  // [right_begin, right_end)
+  void MergeRange(size_t left_begin, size_t left_end, size_t right_begin,
+                  size_t right_end, std::vector<Match> &matches);
+
   /** @brief a vector of join clauses
    * Get this from plan node during initialization */
   const std::vector<planner::MergeJoinPlan::JoinClause> *join_clauses_;
@@ -48,6 +87,18 @@ class MergeJoinExecutor : public AbstractJoinExecutor {
 
   size_t left_end_row = 0;
   size_t right_end_row = 0;
+
+  bool range_partitioned_ = false;
+
+  bool ranges_joined_ = false;
+
+  std::vector<Row> left_rows_;
+  std::vector<Row> right_rows_;
+
+  std::vector<type::Value> left_keys_;
+  std::vector<type::Value> right_keys_;
+
+  std::deque<LogicalTile *> buffered_output_tiles_;
 };
 
 }  // namespace executor
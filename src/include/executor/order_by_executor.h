@@ -14,6 +14,7 @@
 
 #include "common/internal_types.h"
 #include "executor/abstract_executor.h"
+#include "executor/tuple_sorter.h"
 #include "storage/tuple.h"
 
 namespace peloton {
@@ -22,10 +23,9 @@ namespace executor {
 /**
  * @warning This is a pipeline breaker and a materialization point.
  *
- * TODO Currently, we store all input tiles and sort result in memory
- * until this executor is destroyed, which is sometimes necessary.
- * But can we let it release the RAM earlier as long as the executor
- * is not needed any more (e.g., with a LIMIT sitting on top)?
+ * The output columns of the input tuples are copied into a TupleSorter,
+ * which keeps only the first limit + offset of them under a LIMIT and
+ * spills to disk past sort_memory_limit.
  *
  * 2018-01-07: This is <b>deprecated</b>. Do not modify these classes.
  * The old interpreted engine will be removed.
@@ -53,46 +53,14 @@ class OrderByExecutor : public AbstractExecutor {
 
   bool sort_done_ = false;
 
-  /**
-   * IMPORTANT This type must be move-constructible and move-assignable
-   * in order to be correctly sorted by STL sort
-   */
-  struct sort_buffer_entry_t {
-    ItemPointer item_pointer;
-    std::unique_ptr<storage::Tuple> tuple;
-
-    sort_buffer_entry_t(ItemPointer ipt, std::unique_ptr<storage::Tuple> &&tp)
-        : item_pointer(ipt), tuple(std::move(tp)) {}
-
-    sort_buffer_entry_t(sort_buffer_entry_t &&rhs) {
-      item_pointer = rhs.item_pointer;
-      tuple = std::move(rhs.tuple);
-    }
-
-    sort_buffer_entry_t &operator=(sort_buffer_entry_t &&rhs) {
-      item_pointer = rhs.item_pointer;
-      tuple = std::move(rhs.tuple);
-      return *this;
-    }
-
-    sort_buffer_entry_t(const sort_buffer_entry_t &) = delete;
-    sort_buffer_entry_t &operator=(const sort_buffer_entry_t &) = delete;
-  };
-
-  /** All tiles returned by child. */
-  std::vector<std::unique_ptr<LogicalTile>> input_tiles_;
-
   /** Physical (not logical) schema of output tiles */
   std::unique_ptr<catalog::Schema> output_schema_;
   
   /** Projected output column ids corresponding to input schema */
   std::vector<oid_t> output_column_ids_;
 
-  /** All valid tuples in sorted order */
-  std::vector<sort_buffer_entry_t> sort_buffer_;
-
-  /** Tuples in sort_buffer only contains the sort keys */
-  std::unique_ptr<catalog::Schema> sort_key_tuple_schema_;
+  /** Sorts the input tuples, created on the first input tile */
+  std::unique_ptr<TupleSorter> sorter_;
 
   std::vector<bool> descend_flags_;
 
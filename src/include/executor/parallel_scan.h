@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parallel_scan.h
+//
+// Identification: src/include/executor/parallel_scan.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "common/internal_types.h"
+
+namespace peloton {
+namespace executor {
+
+class LogicalTile;
+
+//===--------------------------------------------------------------------===//
+// Parallel Scan
+//===--------------------------------------------------------------------===//
+
+/**
+ * Morsel driven parallel scan of the tile groups of a table.
+ *
+ * Threads of the execution pool take morsels, ranges of MORSEL_SIZE tile
+ * group offsets, from a shared cursor and scan them, pushing the logical
+ * tiles they produce into a bounded exchange queue that the executor pulls
+ * from. Workers wait while the queue is full. The executor thread scans
+ * morsels itself while the queue is empty, so the scan makes progress even
+ * when every thread of the pool is busy, e.g. with the workers of another
+ * scan of the same query.
+ *
+ * Logical tiles come out in no particular order.
+ */
+class ParallelScan {
+ public:
+  // # of tile groups in a morsel
+  static const oid_t MORSEL_SIZE = 4;
+
+  // produces the logical tile of the tile group at an offset, nullptr if
+  // none of its tuples qualify. called from several threads at once.
+  typedef std::function<LogicalTile *(oid_t tile_group_offset)> ScanFunction;
+
+  ParallelScan(oid_t tile_group_count, ScanFunction scan_function);
+
+  // stops the scan and waits for the morsels being scanned. workers that
+  // have not started yet find the scan stopped and leave.
+  ~ParallelScan();
+
+  /**
+   * The next logical tile, nullptr once every tile group has been scanned.
+   * Starts the workers on the first call. Rethrows an exception thrown by
+   * the scan function on any thread.
+   */
+  LogicalTile *Next();
+
+ private:
+  // the state shared with the workers, which may only get to run once the
+  // scan is gone
+  struct State;
+
+  void Start();
+
+  // scans morsels until there are none left or the scan stops
+  static void Work(State &state);
+
+  // scans the next morsel on the calling thread, false if none is left or
+  // the scan stopped. workers wait for room in the exchange queue before
+  // pushing a tile.
+  static bool ScanMorsel(State &state, bool wait_for_room);
+
+  std::shared_ptr<State> state_;
+
+  bool started_ = false;
+};
+
+}  // namespace executor
+}  // namespace peloton
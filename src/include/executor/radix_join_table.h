@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// radix_join_table.h
+//
+// Identification: src/include/executor/radix_join_table.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "type/type_id.h"
+
+namespace peloton {
+namespace executor {
+
+class LogicalTile;
+
+//===--------------------------------------------------------------------===//
+// Radix Join Table
+//===--------------------------------------------------------------------===//
+
+/**
+ * Hash table of a hash join on a single integer key, partitioned on the
+ * radix of the hash of the key.
+ *
+ * The rows of the build side are scattered into partitions on the high
+ * bits of the hash of their key, enough partitions for the table of each
+ * to fit in the L2 cache. The table of a partition is an open addressing
+ * table of compact slots, a key and the range of the locations of the rows
+ * with that key, in the order the rows were added. The rows of the probe
+ * side are scattered the same way, so that each partition is probed by its
+ * own rows only, while its table is in the cache. Scattering, building and
+ * probing run on the threads of the execution pool, a partition or a chunk
+ * of rows at a time.
+ *
+ * Rows with a NULL key are left out, as NULL joins nothing.
+ */
+class RadixJoinTable {
+ public:
+  // fewer build rows than this are joined on HashExecutor's hash table
+  static const size_t MIN_BUILD_ROW_COUNT = 16384;
+
+  // a visible row of a logical tile, with its key
+  struct Row {
+    int64_t key;
+    oid_t tile_offset;
+    oid_t tuple_id;
+  };
+
+  // a probe row with a build row of the same key
+  struct Match {
+    oid_t probe_tile_offset;
+    oid_t probe_tuple_id;
+    oid_t build_tile_offset;
+    oid_t build_tuple_id;
+  };
+
+  // whether a match joins, the matches of a partition are filtered on the
+  // thread probing it
+  typedef std::function<bool(const Match &)> MatchFilter;
+
+  static bool IsKeyType(type::TypeId type_id);
+
+  /**
+   * Appends to rows the visible rows of the logical tile whose key, the
+   * value of the column key_column_id, is not NULL. Returns false if the
+   * column does not hold integers.
+   */
+  static bool GatherRows(LogicalTile *tile, oid_t tile_offset,
+                         oid_t key_column_id, std::vector<Row> &rows);
+
+  // builds the table of the build rows
+  explicit RadixJoinTable(std::vector<Row> &&rows);
+
+  size_t GetRowCount() const { return row_count_; }
+
+  size_t GetPartitionCount() const { return partitions_.size(); }
+
+  /**
+   * The build rows whose key is the key of a row added before them.
+   */
+  std::vector<Row> GetDuplicateRows() const;
+
+  /**
+   * The matches of the probe rows that pass the filter, if any.
+   */
+  std::vector<Match> Probe(std::vector<Row> &&probe_rows,
+                           const MatchFilter &filter) const;
+
+ private:
+  // the location of a build row
+  struct Location {
+    oid_t tile_offset;
+    oid_t tuple_id;
+  };
+
+  // the build rows of a key, count is 0 for an empty slot
+  struct Slot {
+    int64_t key;
+    uint32_t begin;
+    uint32_t count;
+  };
+
+  struct Partition {
+    std::vector<Slot> slots;
+
+    std::vector<Location> locations;
+  };
+
+  static uint64_t Hash(int64_t key);
+
+  inline size_t GetPartitionId(uint64_t hash) const {
+    return partition_bits_ == 0 ? 0 : hash >> (64 - partition_bits_);
+  }
+
+  // the slot of the key in the partition, the empty slot it goes to if it
+  // is not there
+  static size_t FindSlot(const Partition &partition, int64_t key,
+                         uint64_t hash);
+
+  // scatters the rows into partitions, keeping their order within each.
+  // the rows of partition i end up at [begins[i], begins[i + 1]).
+  void Scatter(const std::vector<Row> &rows, std::vector<Row> &scattered,
+               std::vector<size_t> &begins) const;
+
+  void BuildPartition(Partition &partition, const Row *rows,
+                      size_t row_count);
+
+  size_t row_count_;
+
+  // # of hash bits the partition of a row is chosen on
+  size_t partition_bits_;
+
+  std::vector<Partition> partitions_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -13,6 +13,8 @@
 #pragma once
 
 #include "executor/abstract_scan_executor.h"
+#include "executor/parallel_scan.h"
+#include "executor/vectorized_predicate.h"
 #include "planner/seq_scan_plan.h"
 #include "common/container/cuckoo_map.h"
 
@@ -42,12 +44,18 @@ class SeqScanExecutor : public AbstractScanExecutor {
   void UpdatePredicate(const std::vector<oid_t> &column_ids,
                        const std::vector<type::Value> &values) override;
 
-  void ResetState() override { current_tile_group_offset_ = START_OID; }
+  void ResetState() override {
+    current_tile_group_offset_ = START_OID;
+    current_page_offset_ = 0;
+    parallel_scan_.reset();
+    read_failed_ = false;
+    num_tuples_produced_ = 0;
+  }
   static std::vector<std::vector<bool>> tile_tuple_visible;
  protected:
   bool DInit() override ;
 
-  bool DExecute() override ;
+  bool DScan() override;
 
  private:
   //===--------------------------------------------------------------------===//
@@ -66,6 +74,53 @@ class SeqScanExecutor : public AbstractScanExecutor {
       std::vector<Predicate_Inf> &infos,
       const expression::AbstractExpression *expr);
 
+  // rule out the partitions of a partitioned table the predicate cannot
+  // hold in
+  void PrunePartitions();
+
+  // whether the tile group belongs to a partition ruled out by the predicate
+  bool IsPrunedTileGroup(const oid_t &tile_group_id) const;
+
+  // find the pages of a clustered table the predicate may hold in
+  void FindClusteredPages();
+
+  // compile the predicate into a vectorized one, if it can be
+  void VectorizePredicate();
+
+  // whether the tile groups of the table are scanned on the execution pool
+  bool IsParallelScan();
+
+  // the logical tile of the tuples of the tile group at an offset that
+  // satisfy the predicate and are visible, nullptr if none is. safe to call
+  // from several threads at once.
+  LogicalTile *ScanTileGroup(oid_t tile_group_offset);
+
+  // the ids of the first active_tuple_count tuples of the tile group that
+  // satisfy the predicate and are visible to the transaction. false if
+  // reading one of them fails, the transaction must then abort.
+  bool BuildPositionList(storage::TileGroup *tile_group,
+                         oid_t active_tuple_count,
+                         std::vector<oid_t> &position_list);
+
+  // keep the tuples of the position list visible to the transaction. the
+  // tuples of a tile group marked all visible skip the visibility check.
+  void FilterVisible(storage::TileGroup *tile_group,
+                     std::vector<oid_t> &position_list);
+
+  // read the visible tuples of the position list, which is a no-op for
+  // those marked all visible unless the read acquires ownership or records
+  // the reader. false if reading one of them fails.
+  bool ReadVisible(storage::TileGroup *tile_group,
+                   const std::vector<oid_t> &position_list);
+
+  // the ids of the tuples of a frozen tile group that may satisfy the
+  // predicate, found on its compressed columns, and whether they do
+  // satisfy it. false if the tile group has no compressed columns, or the
+  // predicate compares none of them with a constant.
+  bool FilterCompressed(storage::TileGroup *tile_group,
+                        oid_t active_tuple_count,
+                        std::vector<oid_t> &position_list, bool &exact);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -76,6 +131,18 @@ class SeqScanExecutor : public AbstractScanExecutor {
   /** @brief Keeps track of the number of tile groups to scan. */
   oid_t table_tile_group_count_ = INVALID_OID;
 
+  /** @brief Partitions left to scan, empty if every partition is. */
+  std::vector<bool> scan_partitions_;
+
+  /** @brief Pages of a clustered table left to scan, in key order. */
+  std::vector<oid_t> scan_pages_;
+
+  /** @brief Keeps track of the next page of scan_pages_ to scan. */
+  size_t current_page_offset_ = 0;
+
+  /** @brief The predicate evaluated a vector at a time, if it can be. */
+  std::unique_ptr<VectorizedPredicate> vectorized_predicate_;
+
   //===--------------------------------------------------------------------===//
   // Plan Info
   //===--------------------------------------------------------------------===//
@@ -117,6 +184,13 @@ class SeqScanExecutor : public AbstractScanExecutor {
   std::string table_name;
   oid_t current_tile_group_offset;
 //  CuckooMap<oid_t,oid_t> tile_map;
+
+  // whether reading a tuple failed on a thread of a parallel scan
+  std::atomic<bool> read_failed_{false};
+
+  // the scan of a parallel plan, started on its first DScan. destroyed
+  // first, as its workers read the rest of the executor.
+  std::unique_ptr<ParallelScan> parallel_scan_;
 };
 
 }  // namespace executor
@@ -0,0 +1,193 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tuple_sorter.h
+//
+// Identification: src/include/executor/tuple_sorter.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "type/arena_pool.h"
+#include "type/serializeio.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace executor {
+
+class LogicalTile;
+
+//===--------------------------------------------------------------------===//
+// Tuple Sorter
+//===--------------------------------------------------------------------===//
+
+/**
+ * Sorts the rows of logical tiles on some of their columns and hands back
+ * others, at most max_row_count of the first rows in sort order.
+ *
+ * Each row is kept as a record: its sort keys normalized into bytes that
+ * compare with memcmp in sort order, then its values serialized. Integer,
+ * decimal, date and timestamp keys normalize exactly, NULLs after every
+ * value in ascending order, varlen keys to a prefix of their bytes and
+ * their length up to one past the prefix. Keys are compared in order, and
+ * a varlen key whose normalized bytes tie on values longer than the prefix
+ * is settled on those values, which the record keeps too, before the keys
+ * after it.
+ *
+ * With few enough rows to keep, they are kept in a bounded heap, a row
+ * only taking the place of the greatest kept. Otherwise every row is kept,
+ * sorted in runs on the threads of the execution pool and merged. Past the
+ * memory limit, the sorted rows are spilled to a run file, and the run
+ * files are merged in the end.
+ */
+class TupleSorter {
+ public:
+  // # of rows up to which the rows to keep are kept in a heap
+  static const size_t MAX_HEAP_ROW_COUNT = 1 << 16;
+
+  TupleSorter(const std::vector<oid_t> &key_column_ids,
+              const std::vector<type::TypeId> &key_types,
+              const std::vector<bool> &descend_flags,
+              const std::vector<oid_t> &output_column_ids,
+              const std::vector<type::TypeId> &output_types,
+              size_t max_row_count, double memory_limit);
+
+  // adds the visible rows of the tile
+  void AddTile(LogicalTile *tile);
+
+  // sorts the rows, none can be added after
+  void Finish();
+
+  // # of rows Next returns
+  size_t GetRowCount() const { return row_count_; }
+
+  /**
+   * The next row in sort order, nullptr after the last. The row is valid
+   * until the next call.
+   */
+  const char *Next();
+
+  // the values of the output columns of a row, those of varlen columns
+  // are valid as long as the row
+  void GetOutputValues(const char *row, std::vector<type::Value> &values) const;
+
+ private:
+  // a row with the first bytes of its normalized keys, read big endian so
+  // that they compare as an integer
+  struct SortEntry {
+    uint64_t prefix;
+    const char *row;
+  };
+
+  // a run file being merged, and its current row
+  struct RunCursor {
+    std::FILE *file;
+    std::vector<char> row;
+  };
+
+  struct FileCloser {
+    void operator()(std::FILE *file) const { std::fclose(file); }
+  };
+
+  // normalizes the keys of a row of the tile into key_buffer_
+  void BuildKey(LogicalTile *tile, oid_t tuple_id);
+
+  // serializes the row of the tile whose keys are in key_buffer_ into
+  // row_buffer_
+  void BuildRow(LogicalTile *tile, oid_t tuple_id);
+
+  // copies row_buffer_ into a row of the pool
+  const char *CopyRow();
+
+  SortEntry MakeEntry(const char *row) const;
+
+  bool Less(const SortEntry &a, const SortEntry &b) const;
+
+  // compares the keys of two rows
+  int CompareKeys(const char *a, const char *b) const;
+
+  /**
+   * Compares two normalized keys from the varlen key varlen_id on, up to
+   * the first varlen key whose bytes tie on values longer than the prefix.
+   * Returns 0 with varlen_id set to that key if there is one, and to the #
+   * of varlen keys otherwise.
+   */
+  int CompareNormalizedKeys(const char *a, const char *b,
+                            size_t &varlen_id) const;
+
+  void Sort(std::vector<SortEntry> &entries) const;
+
+  // sorts the rows and writes them to a new run file
+  void SpillRun();
+
+  // reads the next row of the run, false at its end
+  bool ReadRow(RunCursor &cursor) const;
+
+  const std::vector<oid_t> key_column_ids_;
+
+  const std::vector<type::TypeId> key_types_;
+
+  const std::vector<bool> descend_flags_;
+
+  const std::vector<oid_t> output_column_ids_;
+
+  const std::vector<type::TypeId> output_types_;
+
+  const size_t max_row_count_;
+
+  const double memory_limit_;
+
+  // offset of the normalized key of each sort column
+  std::vector<size_t> key_offsets_;
+
+  // the normalized keys follow the size of the row
+  size_t key_size_ = 0;
+
+  // the sort columns of the varlen keys, and the end of each of their
+  // normalized keys
+  std::vector<size_t> varlen_key_ids_;
+
+  std::vector<size_t> varlen_key_ends_;
+
+  bool use_heap_;
+
+  std::unique_ptr<type::ArenaPool> pool_;
+
+  // the rows kept, a max heap if use_heap_, the rows in sort order once
+  // finished
+  std::vector<SortEntry> entries_;
+
+  // the size of a row, then its normalized keys
+  std::vector<char> key_buffer_;
+
+  CopySerializeOutput row_buffer_;
+
+  std::vector<std::unique_ptr<std::FILE, FileCloser>> run_files_;
+
+  // # of rows spilled
+  size_t spilled_row_count_ = 0;
+
+  // the runs being merged, as a min heap on their current row
+  std::vector<RunCursor> cursors_;
+
+  std::vector<size_t> cursor_heap_;
+
+  // the run of the row Next returned last, advanced on the next call
+  bool advance_cursor_ = false;
+
+  size_t row_count_ = 0;
+
+  size_t next_row_ = 0;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// vectorized_predicate.h
+//
+// Identification: src/include/executor/vectorized_predicate.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace catalog {
+class Schema;
+}  // namespace catalog
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace storage {
+class TileGroup;
+}  // namespace storage
+
+namespace executor {
+
+class VectorCondition;
+
+//===--------------------------------------------------------------------===//
+// Vectorized Predicate
+//===--------------------------------------------------------------------===//
+
+/**
+ * A scan predicate evaluated a vector of tuples at a time instead of a
+ * tuple at a time.
+ *
+ * The values of the columns the predicate reads are copied straight out of
+ * the tiles into typed vectors (64-bit integers or doubles), without boxing
+ * them into type::Values. Arithmetic and comparison kernels then run over
+ * whole vectors, and each comparison narrows a selection vector, the ids of
+ * the tuples that still satisfy the predicate. A conjunction narrows the
+ * selection of its left side with its right side; a disjunction evaluates
+ * its right side on the tuples its left side did not select.
+ *
+ * Handles comparisons, AND, OR and + - * / over integer and decimal
+ * columns, constants and parameters, with the NULL, overflow and division
+ * by zero semantics of type::Value. Other predicates are left to
+ * AbstractExpression::Evaluate.
+ */
+class VectorizedPredicate {
+ public:
+  // # of tuples evaluated at a time
+  static const size_t VECTOR_SIZE = 1024;
+
+  /**
+   * Compiles a predicate over tuples of the schema, taking the values of
+   * its parameters from params. Returns nullptr if the predicate has an
+   * expression that cannot be vectorized.
+   */
+  static std::unique_ptr<VectorizedPredicate> Create(
+      const expression::AbstractExpression *predicate,
+      const catalog::Schema *schema, const std::vector<type::Value> &params);
+
+  ~VectorizedPredicate();
+
+  /**
+   * Keeps in position_list, a list of tuple ids of the tile group in
+   * ascending order, the tuples that satisfy the predicate.
+   */
+  void Filter(storage::TileGroup *tile_group,
+              std::vector<oid_t> &position_list) const;
+
+ private:
+  VectorizedPredicate(std::unique_ptr<VectorCondition> condition,
+                      std::vector<oid_t> column_ids);
+
+  std::unique_ptr<VectorCondition> condition_;
+
+  // the columns the predicate reads
+  std::vector<oid_t> column_ids_;
+};
+
+}  // namespace executor
+}  // namespace peloton
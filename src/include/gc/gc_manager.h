@@ -65,12 +65,18 @@ class GCManager {
 
   virtual void StopGC() {}
 
-  virtual ItemPointer ReturnFreeSlot(const oid_t &table_id UNUSED_ATTRIBUTE) {
+  virtual ItemPointer ReturnFreeSlot(
+      const oid_t &table_id UNUSED_ATTRIBUTE,
+      const size_t &partition UNUSED_ATTRIBUTE) {
     return INVALID_ITEMPOINTER;
   }
 
   virtual void RegisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) {}
 
+  virtual void RegisterPartitions(
+      const oid_t &table_id UNUSED_ATTRIBUTE,
+      const size_t &partition_count UNUSED_ATTRIBUTE) {}
+
   virtual void DeregisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) {}
 
   virtual size_t GetTableCount() { return 0; }
@@ -14,6 +14,7 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -24,16 +25,35 @@
 #include "concurrency/transaction_context.h"
 #include "gc/gc_manager.h"
 #include "common/internal_types.h"
+#include "storage/tile_group_header.h"
 
 #include "common/container/lock_free_queue.h"
 
 namespace peloton {
+
+namespace storage {
+class DataTable;
+}  // namespace storage
+
 namespace gc {
 
 #define MAX_QUEUE_LENGTH 100000
 #define MAX_ATTEMPT_COUNT 100000
+// Minimal time between two passes of index garbage collection (microseconds);
+// a pass also waits for the epoch of the previous one to expire
+#define INDEX_GC_INTERVAL 100000
+#define FREEZE_INTERVAL 100000
+#define FREEZE_BATCH_SIZE 64
+#define COMPACTION_INTERVAL 100000
+#define COMPACTION_BATCH_SIZE 64
+#define ALL_VISIBLE_INTERVAL 100000
+#define ALL_VISIBLE_BATCH_SIZE 256
 
 class TransactionLevelGCManager : public GCManager {
+  // the recycle queues of a table, one per partition
+  typedef std::vector<std::shared_ptr<peloton::LockFreeQueue<ItemPointer>>>
+      RecycleQueues;
+
  public:
   TransactionLevelGCManager(const int thread_count)
       : gc_thread_count_(thread_count), reclaim_maps_(thread_count) {
@@ -67,6 +87,16 @@ class TransactionLevelGCManager : public GCManager {
     reclaim_maps_.resize(gc_thread_count_);
     recycle_queue_map_.clear();
 
+    freezing_tile_groups_.clear();
+    retired_tuple_headers_.clear();
+    freeze_cursor_ = 0;
+
+    compacting_tile_groups_.clear();
+    dropped_tile_groups_.clear();
+    compaction_cursor_ = 0;
+
+    all_visible_cursor_ = 0;
+
     is_running_ = false;
   }
 
@@ -105,17 +135,37 @@ class TransactionLevelGCManager : public GCManager {
   virtual void RecycleTransaction(
       concurrency::TransactionContext *txn) override;
 
-  virtual ItemPointer ReturnFreeSlot(const oid_t &table_id) override;
+  virtual ItemPointer ReturnFreeSlot(const oid_t &table_id,
+                                     const size_t &partition) override;
 
   virtual void RegisterTable(const oid_t &table_id) override {
     // Insert a new entry for the table
     if (recycle_queue_map_.find(table_id) == recycle_queue_map_.end()) {
-      std::shared_ptr<LockFreeQueue<ItemPointer>> recycle_queue(
+      std::shared_ptr<RecycleQueues> recycle_queues(new RecycleQueues());
+      recycle_queues->emplace_back(
           new LockFreeQueue<ItemPointer>(MAX_QUEUE_LENGTH));
-      recycle_queue_map_[table_id] = recycle_queue;
+      recycle_queue_map_[table_id] = recycle_queues;
     }
   }
 
+  // A partitioned table gets a queue per partition, the queue of the table
+  // becomes that of partition 0. The queues are swapped in as a whole, GC
+  // threads may be reclaiming slots of the table.
+  virtual void RegisterPartitions(const oid_t &table_id,
+                                  const size_t &partition_count) override {
+    auto recycle_queue_itr = recycle_queue_map_.find(table_id);
+    if (recycle_queue_itr == recycle_queue_map_.end()) {
+      return;
+    }
+    std::shared_ptr<RecycleQueues> recycle_queues(
+        new RecycleQueues(*std::atomic_load(&recycle_queue_itr->second)));
+    while (recycle_queues->size() < partition_count) {
+      recycle_queues->emplace_back(
+          new LockFreeQueue<ItemPointer>(MAX_QUEUE_LENGTH));
+    }
+    std::atomic_store(&recycle_queue_itr->second, recycle_queues);
+  }
+
   virtual void DeregisterTable(const oid_t &table_id) override {
     // Remove dropped tables
     if (recycle_queue_map_.find(table_id) != recycle_queue_map_.end()) {
@@ -129,11 +179,58 @@ class TransactionLevelGCManager : public GCManager {
 
   int Reclaim(const int &thread_id, const eid_t &expired_eid);
 
+  /**
+   * @brief Give every index that asks for it (Index::NeedGC()) the chance to
+   * reclaim memory of its internal structure, e.g. unlinked BwTree delta
+   * nodes or ART nodes.
+   *
+   * @return The number of indexes that performed GC.
+   */
+  int PerformIndexGC();
+
+  /**
+   * @brief Begin freezing the next batch of tile groups, finish freezing the
+   * tile groups no transaction may still write through their full tuple
+   * headers, and release the headers no transaction may still read.
+   *
+   * @return The number of tile groups frozen.
+   */
+  int FreezeTileGroups(const eid_t &expired_eid);
+
+  /**
+   * @brief Stop recycling the slots of the next batch of full tile groups
+   * with few live tuples, move the live tuples of the tile groups no
+   * transaction may still take a recycled slot of into the tail of their
+   * table, and drop the tile groups whose moved versions have all been
+   * reclaimed.
+   *
+   * @return The number of tile groups dropped.
+   */
+  int CompactTileGroups(const eid_t &expired_eid);
+
+  /**
+   * @brief Mark the next batch of tile groups as all visible, so that scans
+   * skip the per-tuple visibility checks of their tuples.
+   *
+   * @return The number of tile groups marked.
+   */
+  int MarkAllVisibleTileGroups();
+
  private:
   inline unsigned int HashToThread(const size_t &thread_id) {
     return (unsigned int)thread_id % gc_thread_count_;
   }
 
+  // the recycle queues of the table, nullptr if it is not registered
+  inline std::shared_ptr<RecycleQueues> GetRecycleQueues(
+      const oid_t &table_id) {
+    auto recycle_queue_itr = recycle_queue_map_.find(table_id);
+    if (recycle_queue_itr == recycle_queue_map_.end()) {
+      return nullptr;
+    }
+    return std::atomic_load(&recycle_queue_itr->second);
+  }
+
   /**
    * @brief Unlink and reclaim the tuples remained in a garbage collection
    * thread when the Garbage Collector stops.
@@ -156,6 +253,11 @@ class TransactionLevelGCManager : public GCManager {
   // this function unlinks a specified version from the index.
   void UnlinkVersion(const ItemPointer location, const GCVersionType type);
 
+  // move the latest committed versions in the tile group into new slots of
+  // the table, as updates by a transaction of their own. returns the # of
+  // versions moved.
+  oid_t MoveTuples(storage::DataTable *table, storage::TileGroup *tile_group);
+
  private:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -181,11 +283,37 @@ class TransactionLevelGCManager : public GCManager {
   std::vector<std::multimap<cid_t, concurrency::TransactionContext* >>
       reclaim_maps_;
 
-  // queues for to-be-reused tuples.
+  // queues for to-be-reused tuples, one per partition of a table.
   // # recycle_queue_maps == # tables
-  std::unordered_map<oid_t,
-                     std::shared_ptr<peloton::LockFreeQueue<ItemPointer>>>
+  std::unordered_map<oid_t, std::shared_ptr<RecycleQueues>>
       recycle_queue_map_;
+
+  // tile groups that began freezing, with the epoch they began in.
+  // only accessed by GC thread 0.
+  std::list<std::pair<eid_t, std::shared_ptr<storage::TileGroup>>>
+      freezing_tile_groups_;
+
+  // headers of frozen tile groups, with the epoch they were retired in
+  std::multimap<eid_t, storage::RetiredTupleHeaders> retired_tuple_headers_;
+
+  // id of the last tile group a freeze was considered for
+  oid_t freeze_cursor_ = 0;
+
+  // tile groups being compacted, with the epoch their slots stopped being
+  // recycled in. only accessed by GC thread 0.
+  std::list<std::pair<eid_t, std::shared_ptr<storage::TileGroup>>>
+      compacting_tile_groups_;
+
+  // compacted tile groups dropped from their table, with the epoch they
+  // were dropped in
+  std::multimap<eid_t, std::shared_ptr<storage::TileGroup>>
+      dropped_tile_groups_;
+
+  // id of the last tile group a compaction was considered for
+  oid_t compaction_cursor_ = 0;
+
+  // id of the last tile group the all visible mark was considered for
+  oid_t all_visible_cursor_ = 0;
 };
 }
 }  // namespace peloton
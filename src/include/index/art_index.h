@@ -94,11 +94,11 @@ class ArtIndex : public Index {
   // TODO(pmenon): Implement me
   size_t GetMemoryFootprint() override { return 0; }
 
-  // TODO(pmenon): Implement me
-  bool NeedGC() override { return false; }
+  /// Nodes unlinked by concurrent modifications are waiting to be freed
+  bool NeedGC() override { return container_.needGC(); }
 
-  // TODO(pmenon): Implement me
-  void PerformGC() override {}
+  /// Free all unlinked nodes no in-flight tree operation can still observe
+  void PerformGC() override;
 
   /**
    * Configure the load-key function for this index. The load-key function
@@ -126,6 +126,10 @@ class ArtIndex : public Index {
   void ScanRange(const art::Key &start, const art::Key &end,
                  std::vector<ItemPointer *> &result);
 
+  // Same as above, but stops once max_results values have been collected
+  void ScanRange(const art::Key &start, const art::Key &end,
+                 std::vector<ItemPointer *> &result, size_t max_results);
+
   //===--------------------------------------------------------------------===//
   //
   // Helper class to construct an art::Key from a Peloton key.
@@ -161,9 +165,21 @@ class ArtIndex : public Index {
     template <typename NativeType>
     static void WriteValue(uint8_t *data, NativeType val);
 
-    // Write a specified number of ASCII characters into the output buffer
-    static void WriteAsciiString(uint8_t *data, const char *val, uint32_t len);
+    // Write an unsigned integral value in big-endian order
+    static void WriteUnsigned(uint8_t *data, uint64_t val);
+
+    // Write a double such that the byte order matches the numeric order
+    static void WriteDouble(uint8_t *data, double val);
+
+    // Number of bytes WriteString() produces for the given input
+    static uint32_t EncodedStringLength(const char *val, uint32_t len);
+
+    // Write a variable-length value in an escaped, terminated, byte-comparable
+    // form, returning the number of bytes written
+    static uint32_t WriteString(uint8_t *data, const char *val, uint32_t len);
 
+    // Number of payload bytes of a varlen value used for comparison
+    static uint32_t ComparableLength(const type::Value &val);
    private:
     // The index's key schema
     const catalog::Schema &key_schema_;
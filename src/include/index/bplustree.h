@@ -0,0 +1,898 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bplustree.h
+//
+// Identification: src/include/index/bplustree.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/platform.h"
+
+namespace peloton {
+namespace index {
+
+/*
+ * BPLUSTREE_TEMPLATE_ARGUMENTS - Save some key strokes
+ */
+#define BPLUSTREE_TEMPLATE_ARGUMENTS                                      \
+  template <typename KeyType, typename ValueType, typename KeyComparator, \
+            typename KeyEqualityChecker, typename ValueEqualityChecker>
+
+// The number of bytes we target for a single tree node. The fan-out of inner
+// and leaf nodes is derived from this and the size of the key/value types
+#define BPLUSTREE_NODE_SIZE ((size_t)4096)
+
+// Lower bound on the fan-out for very wide keys (e.g. GenericKey<256>)
+#define BPLUSTREE_MIN_FANOUT ((size_t)8)
+
+/*
+ * BPlusTreeFanout() - Number of entries that fit into a node of
+ *                     BPLUSTREE_NODE_SIZE bytes after the header and the
+ *                     extra child/sibling pointer
+ */
+constexpr size_t BPlusTreeFanout(size_t header_size, size_t entry_size) {
+  return (BPLUSTREE_NODE_SIZE - header_size - sizeof(void *)) / entry_size <
+                 BPLUSTREE_MIN_FANOUT
+             ? BPLUSTREE_MIN_FANOUT
+             : (BPLUSTREE_NODE_SIZE - header_size - sizeof(void *)) /
+                   entry_size;
+}
+
+/*
+ * class OptimisticLatch - Version counter used for optimistic lock coupling
+ *
+ * Readers never write to the latch. They remember the version they observed
+ * before reading a node and validate it afterwards; if the version changed
+ * (or a writer held the latch) the reader restarts. Writers lock the latch
+ * by setting the lock bit with CAS, and bump the version on unlock.
+ *
+ * Bit 1 is the lock bit and the remaining upper bits are the version counter,
+ * so locking adds 0b10 and unlocking adds another 0b10 which carries into the
+ * version.
+ */
+class OptimisticLatch {
+ public:
+  OptimisticLatch() : version_{0b100} {}
+
+  /*
+   * ReadLockOrRestart() - Returns the current version if not locked
+   */
+  inline uint64_t ReadLockOrRestart(bool &need_restart) const {
+    uint64_t version = version_.load(std::memory_order_acquire);
+    if (IsLocked(version)) {
+      _mm_pause();
+      need_restart = true;
+    }
+    return version;
+  }
+
+  /*
+   * ReadUnlockOrRestart() - Validates that nothing changed since the version
+   *                         was taken
+   */
+  inline void ReadUnlockOrRestart(uint64_t start_version,
+                                  bool &need_restart) const {
+    // Loads from the node must not be reordered after the version check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (start_version != version_.load(std::memory_order_relaxed)) {
+      need_restart = true;
+    }
+  }
+
+  inline void CheckOrRestart(uint64_t start_version, bool &need_restart) const {
+    ReadUnlockOrRestart(start_version, need_restart);
+  }
+
+  /*
+   * UpgradeToWriteLockOrRestart() - Atomically turns a validated read into
+   *                                 an exclusive lock
+   */
+  inline void UpgradeToWriteLockOrRestart(uint64_t &version,
+                                          bool &need_restart) {
+    if (version_.compare_exchange_strong(version, version + 0b10,
+                                         std::memory_order_acquire)) {
+      version = version + 0b10;
+    } else {
+      _mm_pause();
+      need_restart = true;
+    }
+  }
+
+  inline void WriteLockOrRestart(bool &need_restart) {
+    uint64_t version = ReadLockOrRestart(need_restart);
+    if (need_restart) return;
+
+    UpgradeToWriteLockOrRestart(version, need_restart);
+  }
+
+  /*
+   * WriteLock() - Spins until the latch is acquired exclusively
+   *
+   * Only used when the caller already holds the latch of a node to the left
+   * on the same level, which keeps the lock order deadlock free
+   */
+  inline void WriteLock() {
+    while (true) {
+      bool need_restart = false;
+      WriteLockOrRestart(need_restart);
+      if (need_restart == false) return;
+    }
+  }
+
+  inline void WriteUnlock() {
+    version_.fetch_add(0b10, std::memory_order_release);
+  }
+
+ private:
+  static inline bool IsLocked(uint64_t version) {
+    return ((version & 0b10) == 0b10);
+  }
+
+  std::atomic<uint64_t> version_;
+};
+
+/*
+ * class BPlusTree - B+Tree synchronized with optimistic lock coupling
+ *
+ * Unlike BwTree there is no mapping table and no delta chain: inner nodes hold
+ * raw child pointers and all modifications are done in place under a
+ * per-node version latch. Readers traverse without writing to shared memory
+ * and validate the version of every node they have read, so lookups never
+ * write to shared cache lines and pay one pointer dereference per level.
+ *
+ * The tree is a multimap. Entries with equal keys are stored adjacent to each
+ * other ordered by insertion; leaf splits prefer a key boundary so that all
+ * values for a key usually live in the same leaf. When one key fills an entire
+ * leaf the run is split and continues in the right sibling, which all lookup
+ * paths handle by following the leaf chain.
+ *
+ * Nodes are never merged or freed while the tree is alive. Deleting leaves
+ * underfull nodes behind, which is the usual trade-off for optimistic
+ * lock coupling without an epoch-based reclamation scheme: a reader can
+ * never dereference freed memory, and no GC is necessary.
+ *
+ * NOTE: Keys and values are read optimistically (i.e. possibly while a writer
+ * is modifying them) and must therefore be plain data whose torn copies are
+ * harmless until validation. CompactIntsKey and GenericKey satisfy this,
+ * TupleKey does not since it holds pointers into tuples.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator,
+          typename KeyEqualityChecker, typename ValueEqualityChecker>
+class BPlusTree {
+ public:
+  enum class NodeType : uint8_t { INNER = 0, LEAF = 1 };
+
+  /*
+   * class BaseNode - Common header of inner and leaf nodes
+   */
+  class BaseNode {
+   public:
+    BaseNode(NodeType p_type) : type{p_type}, count{0} {}
+
+    inline bool IsLeaf() const { return type == NodeType::LEAF; }
+
+    OptimisticLatch latch;
+    const NodeType type;
+    // Number of keys in the node. This is read optimistically, so always
+    // clamp it to the capacity before using it as an array bound
+    uint32_t count;
+  };
+
+  static constexpr size_t INNER_CAPACITY =
+      BPlusTreeFanout(sizeof(BaseNode), sizeof(KeyType) + sizeof(BaseNode *));
+  static constexpr size_t LEAF_CAPACITY =
+      BPlusTreeFanout(sizeof(BaseNode), sizeof(KeyType) + sizeof(ValueType));
+
+  /*
+   * class InnerNode - Separator keys and child pointers
+   *
+   * children[i] holds keys k with keys[i - 1] < k <= keys[i]. Since equal
+   * keys may span leaves, keys equal to a separator can also appear at the
+   * beginning of children[i + 1]
+   */
+  class InnerNode : public BaseNode {
+   public:
+    InnerNode() : BaseNode{NodeType::INNER} {}
+
+    inline bool IsFull() const { return this->count == INNER_CAPACITY; }
+
+    KeyType keys[INNER_CAPACITY];
+    BaseNode *children[INNER_CAPACITY + 1];
+  };
+
+  /*
+   * class LeafNode - Sorted key-value pairs and the right sibling link
+   */
+  class LeafNode : public BaseNode {
+   public:
+    LeafNode() : BaseNode{NodeType::LEAF}, next{nullptr} {}
+
+    inline bool IsFull() const { return this->count == LEAF_CAPACITY; }
+
+    // Written only under the node latch, read optimistically
+    LeafNode *next;
+    KeyType keys[LEAF_CAPACITY];
+    ValueType values[LEAF_CAPACITY];
+  };
+
+ public:
+  BPlusTree(KeyComparator p_key_cmp_obj = KeyComparator{},
+            KeyEqualityChecker p_key_eq_obj = KeyEqualityChecker{},
+            ValueEqualityChecker p_value_eq_obj = ValueEqualityChecker{})
+      : key_cmp_obj{p_key_cmp_obj},
+        key_eq_obj{p_key_eq_obj},
+        value_eq_obj{p_value_eq_obj},
+        inner_node_count{0},
+        leaf_node_count{0} {
+    LeafNode *leaf_p = AllocateLeaf();
+    first_leaf_p = leaf_p;
+    root.store(leaf_p);
+    all_nodes.push_back(leaf_p);
+  }
+
+  ~BPlusTree() {
+    for (BaseNode *node_p : all_nodes) {
+      if (node_p->IsLeaf()) {
+        delete static_cast<LeafNode *>(node_p);
+      } else {
+        delete static_cast<InnerNode *>(node_p);
+      }
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(BPlusTree);
+
+  ///////////////////////////////////////////////////////////////////
+  // Key comparison
+  ///////////////////////////////////////////////////////////////////
+
+  inline bool KeyCmpLess(const KeyType &key1, const KeyType &key2) const {
+    return key_cmp_obj(key1, key2);
+  }
+
+  inline bool KeyCmpEqual(const KeyType &key1, const KeyType &key2) const {
+    return key_eq_obj(key1, key2);
+  }
+
+  inline bool KeyCmpLessEqual(const KeyType &key1, const KeyType &key2) const {
+    return !KeyCmpLess(key2, key1);
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Modification
+  ///////////////////////////////////////////////////////////////////
+
+  /*
+   * Insert() - Insert a key-value pair
+   *
+   * Returns false if the exact key-value pair already exists, or, when
+   * unique_key is set, if any value exists for the key
+   */
+  bool Insert(const KeyType &key, const ValueType &value,
+              bool unique_key = false) {
+    return InsertInternal(key, value, unique_key, nullptr, nullptr);
+  }
+
+  /*
+   * ConditionalInsert() - Insert a key-value pair only if a given
+   *                       predicate fails for all values with a key
+   *
+   * The check and the insert are atomic with respect to other writers on
+   * the same key, since all leaves holding the key are latched during both
+   */
+  bool ConditionalInsert(const KeyType &key, const ValueType &value,
+                         std::function<bool(const void *)> predicate,
+                         bool *predicate_satisfied) {
+    *predicate_satisfied = false;
+    return InsertInternal(key, value, false, &predicate, predicate_satisfied);
+  }
+
+  /*
+   * Delete() - Remove a key-value pair
+   *
+   * Returns false if the pair does not exist. Nodes are never merged
+   */
+  bool Delete(const KeyType &key, const ValueType &value) {
+    while (true) {
+      bool need_restart = false;
+      uint64_t version;
+      LeafNode *leaf_p = FindLeaf(key, &version, need_restart);
+      if (need_restart) continue;
+
+      leaf_p->latch.UpgradeToWriteLockOrRestart(version, need_restart);
+      if (need_restart) continue;
+
+      // Walk the run of equal keys, possibly across leaves, coupling latches
+      // from left to right
+      uint32_t pos = LowerBound(leaf_p, key);
+      while (true) {
+        for (; pos < leaf_p->count && KeyCmpEqual(leaf_p->keys[pos], key);
+             pos++) {
+          if (value_eq_obj(leaf_p->values[pos], value)) {
+            RemoveFromLeaf(leaf_p, pos);
+            leaf_p->latch.WriteUnlock();
+            return true;
+          }
+        }
+
+        LeafNode *next_p = leaf_p->next;
+        if (pos < leaf_p->count || next_p == nullptr) break;
+
+        next_p->latch.WriteLock();
+        leaf_p->latch.WriteUnlock();
+        leaf_p = next_p;
+        pos = 0;
+        if (leaf_p->count == 0 || !KeyCmpEqual(leaf_p->keys[0], key)) break;
+      }
+
+      leaf_p->latch.WriteUnlock();
+      return false;
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Lookup
+  ///////////////////////////////////////////////////////////////////
+
+  /*
+   * GetValue() - Append all values mapped by the search key
+   */
+  void GetValue(const KeyType &search_key, std::vector<ValueType> &value_list) {
+    // Values are collected per leaf and only published once the leaf
+    // validates, so a restart never leaves partial results behind
+    std::vector<ValueType> leaf_values;
+    while (true) {
+      bool need_restart = false;
+      uint64_t version;
+      LeafNode *leaf_p = FindLeaf(search_key, &version, need_restart);
+      if (need_restart) continue;
+
+      size_t committed = value_list.size();
+      bool done = false;
+      while (done == false) {
+        leaf_values.clear();
+        uint32_t count = ClampCount(leaf_p->count, LEAF_CAPACITY);
+        uint32_t pos = LowerBound(leaf_p, search_key, count);
+        for (; pos < count && KeyCmpEqual(leaf_p->keys[pos], search_key);
+             pos++) {
+          leaf_values.push_back(leaf_p->values[pos]);
+        }
+        LeafNode *next_p = leaf_p->next;
+        leaf_p->latch.ReadUnlockOrRestart(version, need_restart);
+        if (need_restart) break;
+
+        value_list.insert(value_list.end(), leaf_values.begin(),
+                          leaf_values.end());
+
+        // The run may continue in the right sibling only if it reached the
+        // end of this leaf
+        if (pos < count || next_p == nullptr) {
+          done = true;
+        } else {
+          leaf_p = next_p;
+          version = leaf_p->latch.ReadLockOrRestart(need_restart);
+          if (need_restart) break;
+        }
+      }
+
+      if (done) return;
+
+      value_list.resize(committed);
+    }
+  }
+
+  /*
+   * ScanForward() - Feed all entries with key >= start_key (or all entries if
+   *                 start_key is nullptr) to the callback in key order
+   *
+   * The callback returns false to stop the scan. Each leaf is copied and
+   * validated before its entries are handed out, so the callback observes a
+   * consistent snapshot of every leaf. Splits only move entries into a new
+   * right sibling of the leaf being split, therefore continuing from a
+   * validated next pointer never skips or repeats entries.
+   */
+  void ScanForward(const KeyType *start_key,
+                   std::function<bool(const KeyType &, const ValueType &)>
+                       callback) {
+    std::vector<std::pair<KeyType, ValueType>> buffer;
+    buffer.reserve(LEAF_CAPACITY);
+
+    LeafNode *leaf_p = nullptr;
+    uint64_t version = 0;
+    while (leaf_p == nullptr) {
+      bool need_restart = false;
+      if (start_key == nullptr) {
+        leaf_p = first_leaf_p;
+        version = leaf_p->latch.ReadLockOrRestart(need_restart);
+      } else {
+        leaf_p = FindLeaf(*start_key, &version, need_restart);
+      }
+      if (need_restart) leaf_p = nullptr;
+    }
+
+    bool first_leaf = (start_key != nullptr);
+    while (leaf_p != nullptr) {
+      bool need_restart = false;
+      buffer.clear();
+      uint32_t count = ClampCount(leaf_p->count, LEAF_CAPACITY);
+      uint32_t pos = first_leaf ? LowerBound(leaf_p, *start_key, count) : 0;
+      for (; pos < count; pos++) {
+        buffer.emplace_back(leaf_p->keys[pos], leaf_p->values[pos]);
+      }
+      LeafNode *next_p = leaf_p->next;
+      leaf_p->latch.ReadUnlockOrRestart(version, need_restart);
+      if (need_restart) {
+        version = WaitForVersion(leaf_p);
+        continue;
+      }
+
+      for (const auto &item : buffer) {
+        if (callback(item.first, item.second) == false) return;
+      }
+
+      first_leaf = false;
+      leaf_p = next_p;
+      if (leaf_p != nullptr) version = WaitForVersion(leaf_p);
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Statistics
+  ///////////////////////////////////////////////////////////////////
+
+  size_t GetMemoryFootprint() const {
+    return inner_node_count.load() * sizeof(InnerNode) +
+           leaf_node_count.load() * sizeof(LeafNode) + sizeof(*this);
+  }
+
+ private:
+  ///////////////////////////////////////////////////////////////////
+  // Node helpers
+  ///////////////////////////////////////////////////////////////////
+
+  static inline uint32_t ClampCount(uint32_t count, size_t capacity) {
+    return std::min(count, static_cast<uint32_t>(capacity));
+  }
+
+  /*
+   * WaitForVersion() - Spin until the node is not write latched and return
+   *                    its version
+   */
+  static inline uint64_t WaitForVersion(const BaseNode *node_p) {
+    while (true) {
+      bool need_restart = false;
+      uint64_t version = node_p->latch.ReadLockOrRestart(need_restart);
+      if (need_restart == false) return version;
+    }
+  }
+
+  LeafNode *AllocateLeaf() {
+    leaf_node_count.fetch_add(1);
+    return new LeafNode{};
+  }
+
+  InnerNode *AllocateInner() {
+    inner_node_count.fetch_add(1);
+    return new InnerNode{};
+  }
+
+  /*
+   * RememberNode() - Keeps track of every allocated node so that the
+   *                  destructor can free them. Called under node latches only
+   *                  during splits, hence the dedicated latch
+   */
+  void RememberNode(BaseNode *node_p) {
+    node_list_latch.WriteLock();
+    all_nodes.push_back(node_p);
+    node_list_latch.WriteUnlock();
+  }
+
+  /*
+   * LowerBound() - Index of the first key >= key in the node
+   */
+  template <typename Node>
+  inline uint32_t LowerBound(const Node *node_p, const KeyType &key,
+                             uint32_t count) const {
+    uint32_t lo = 0;
+    uint32_t hi = count;
+    while (lo < hi) {
+      uint32_t mid = lo + ((hi - lo) >> 1);
+      if (KeyCmpLess(node_p->keys[mid], key)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  inline uint32_t LowerBound(const LeafNode *leaf_p,
+                             const KeyType &key) const {
+    return LowerBound(leaf_p, key, leaf_p->count);
+  }
+
+  /*
+   * UpperBound() - Index of the first key > key in the node
+   */
+  inline uint32_t UpperBound(const LeafNode *leaf_p, const KeyType &key) const {
+    uint32_t lo = 0;
+    uint32_t hi = leaf_p->count;
+    while (lo < hi) {
+      uint32_t mid = lo + ((hi - lo) >> 1);
+      if (KeyCmpLess(key, leaf_p->keys[mid])) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    return lo;
+  }
+
+  void RemoveFromLeaf(LeafNode *leaf_p, uint32_t pos) {
+    for (uint32_t i = pos + 1; i < leaf_p->count; i++) {
+      leaf_p->keys[i - 1] = leaf_p->keys[i];
+      leaf_p->values[i - 1] = leaf_p->values[i];
+    }
+    leaf_p->count--;
+  }
+
+  void InsertIntoLeaf(LeafNode *leaf_p, uint32_t pos, const KeyType &key,
+                      const ValueType &value) {
+    PELOTON_ASSERT(leaf_p->count < LEAF_CAPACITY);
+    for (uint32_t i = leaf_p->count; i > pos; i--) {
+      leaf_p->keys[i] = leaf_p->keys[i - 1];
+      leaf_p->values[i] = leaf_p->values[i - 1];
+    }
+    leaf_p->keys[pos] = key;
+    leaf_p->values[pos] = value;
+    leaf_p->count++;
+  }
+
+  /*
+   * InsertIntoInner() - Insert a separator and the child to its right
+   *                     right after the child at slot pos that was split
+   *
+   * The position must not be searched by key: when a run of equal keys is
+   * split, the separator equals the separators of earlier slots and a key
+   * search would put the new sibling left of the node it was split from
+   */
+  void InsertIntoInner(InnerNode *inner_p, uint32_t pos, const KeyType &key,
+                       BaseNode *child_p) {
+    PELOTON_ASSERT(inner_p->count < INNER_CAPACITY);
+    PELOTON_ASSERT(pos <= inner_p->count);
+    for (uint32_t i = inner_p->count; i > pos; i--) {
+      inner_p->keys[i] = inner_p->keys[i - 1];
+      inner_p->children[i + 1] = inner_p->children[i];
+    }
+    inner_p->keys[pos] = key;
+    inner_p->children[pos + 1] = child_p;
+    inner_p->count++;
+  }
+
+  /*
+   * SplitLeaf() - Move the upper half of a latched leaf into a new sibling
+   *
+   * Prefers a split point at a key boundary close to the middle so that a
+   * run of equal keys stays in one leaf. The separator is the last key of
+   * the left half
+   */
+  LeafNode *SplitLeaf(LeafNode *leaf_p, KeyType *separator_p) {
+    uint32_t count = leaf_p->count;
+    uint32_t mid = count / 2;
+    uint32_t split = mid;
+
+    // Search outwards from the middle for the nearest key boundary
+    for (uint32_t d = 0; d < mid; d++) {
+      if (mid + d < count &&
+          !KeyCmpEqual(leaf_p->keys[mid + d - 1], leaf_p->keys[mid + d])) {
+        split = mid + d;
+        break;
+      }
+      if (mid - d > 1 &&
+          !KeyCmpEqual(leaf_p->keys[mid - d - 1], leaf_p->keys[mid - d])) {
+        split = mid - d;
+        break;
+      }
+    }
+
+    LeafNode *new_leaf_p = AllocateLeaf();
+    for (uint32_t i = split; i < count; i++) {
+      new_leaf_p->keys[i - split] = leaf_p->keys[i];
+      new_leaf_p->values[i - split] = leaf_p->values[i];
+    }
+    new_leaf_p->count = count - split;
+    new_leaf_p->next = leaf_p->next;
+
+    // The new node is fully initialized before it becomes reachable
+    leaf_p->count = split;
+    leaf_p->next = new_leaf_p;
+
+    *separator_p = leaf_p->keys[split - 1];
+    RememberNode(new_leaf_p);
+    return new_leaf_p;
+  }
+
+  /*
+   * SplitInner() - Move the upper half of a latched inner node into a new
+   *                sibling and push the middle key up
+   */
+  InnerNode *SplitInner(InnerNode *inner_p, KeyType *separator_p) {
+    uint32_t count = inner_p->count;
+    uint32_t mid = count / 2;
+
+    InnerNode *new_inner_p = AllocateInner();
+    for (uint32_t i = mid + 1; i < count; i++) {
+      new_inner_p->keys[i - mid - 1] = inner_p->keys[i];
+    }
+    for (uint32_t i = mid + 1; i <= count; i++) {
+      new_inner_p->children[i - mid - 1] = inner_p->children[i];
+    }
+    new_inner_p->count = count - mid - 1;
+
+    *separator_p = inner_p->keys[mid];
+    inner_p->count = mid;
+
+    RememberNode(new_inner_p);
+    return new_inner_p;
+  }
+
+  /*
+   * MakeRoot() - Install a new root above a node that was just split
+   *
+   * Caller holds the latch of the old root, which serializes root changes
+   */
+  void MakeRoot(BaseNode *left_p, const KeyType &separator, BaseNode *right_p) {
+    InnerNode *new_root_p = AllocateInner();
+    new_root_p->count = 1;
+    new_root_p->keys[0] = separator;
+    new_root_p->children[0] = left_p;
+    new_root_p->children[1] = right_p;
+    RememberNode(new_root_p);
+    root.store(new_root_p);
+  }
+
+  /*
+   * FindLeaf() - Optimistically descend to the leftmost leaf that may contain
+   *              the key
+   *
+   * On success the leaf is returned together with the version read from it;
+   * the caller must validate or upgrade that version before trusting the
+   * leaf's content
+   */
+  LeafNode *FindLeaf(const KeyType &key, uint64_t *version_p,
+                     bool &need_restart) {
+    BaseNode *node_p = root.load();
+    uint64_t version = node_p->latch.ReadLockOrRestart(need_restart);
+    if (need_restart || node_p != root.load()) {
+      need_restart = true;
+      return nullptr;
+    }
+
+    while (node_p->IsLeaf() == false) {
+      InnerNode *inner_p = static_cast<InnerNode *>(node_p);
+      uint32_t count = ClampCount(inner_p->count, INNER_CAPACITY);
+      BaseNode *child_p = inner_p->children[LowerBound(inner_p, key, count)];
+      inner_p->latch.CheckOrRestart(version, need_restart);
+      if (need_restart) return nullptr;
+
+      node_p = child_p;
+      version = node_p->latch.ReadLockOrRestart(need_restart);
+      if (need_restart) return nullptr;
+    }
+
+    *version_p = version;
+    return static_cast<LeafNode *>(node_p);
+  }
+
+  /*
+   * InsertInternal() - Shared body of Insert() and ConditionalInsert()
+   *
+   * Full nodes met on the way down are split eagerly (latching only the node
+   * and its parent) and the operation restarts from the root, so a split
+   * never has to propagate more than one level
+   */
+  bool InsertInternal(const KeyType &key, const ValueType &value,
+                      bool unique_key,
+                      std::function<bool(const void *)> *predicate_p,
+                      bool *predicate_satisfied) {
+    while (true) {
+      bool need_restart = false;
+
+      BaseNode *node_p = root.load();
+      uint64_t version = node_p->latch.ReadLockOrRestart(need_restart);
+      if (need_restart || node_p != root.load()) continue;
+
+      InnerNode *parent_p = nullptr;
+      uint64_t parent_version = 0;
+      // Slot of node_p in parent_p
+      uint32_t parent_slot = 0;
+
+      while (node_p->IsLeaf() == false) {
+        InnerNode *inner_p = static_cast<InnerNode *>(node_p);
+
+        if (inner_p->IsFull()) {
+          SplitAndUnlock(parent_p, parent_version, parent_slot, inner_p,
+                         version, need_restart);
+          // Always restart after a split attempt
+          need_restart = true;
+          break;
+        }
+
+        if (parent_p != nullptr) {
+          parent_p->latch.ReadUnlockOrRestart(parent_version, need_restart);
+          if (need_restart) break;
+        }
+
+        parent_p = inner_p;
+        parent_version = version;
+
+        uint32_t count = ClampCount(inner_p->count, INNER_CAPACITY);
+        parent_slot = LowerBound(inner_p, key, count);
+        node_p = inner_p->children[parent_slot];
+        inner_p->latch.CheckOrRestart(version, need_restart);
+        if (need_restart) break;
+
+        version = node_p->latch.ReadLockOrRestart(need_restart);
+        if (need_restart) break;
+      }
+      if (need_restart) continue;
+
+      LeafNode *leaf_p = static_cast<LeafNode *>(node_p);
+      if (leaf_p->IsFull()) {
+        SplitAndUnlock(parent_p, parent_version, parent_slot, leaf_p, version,
+                       need_restart);
+        continue;
+      }
+
+      leaf_p->latch.UpgradeToWriteLockOrRestart(version, need_restart);
+      if (need_restart) continue;
+
+      if (parent_p != nullptr) {
+        parent_p->latch.ReadUnlockOrRestart(parent_version, need_restart);
+        if (need_restart) {
+          leaf_p->latch.WriteUnlock();
+          continue;
+        }
+      }
+
+      return InsertIntoLockedLeaf(leaf_p, key, value, unique_key, predicate_p,
+                                  predicate_satisfied);
+    }
+  }
+
+  /*
+   * InsertIntoLockedLeaf() - Duplicate/predicate check and insert
+   *
+   * The run of existing values for the key is checked under latches, walking
+   * into right siblings if the run reaches the end of a leaf. All latches are
+   * held until the decision is made so that the check is atomic
+   */
+  bool InsertIntoLockedLeaf(LeafNode *leaf_p, const KeyType &key,
+                            const ValueType &value, bool unique_key,
+                            std::function<bool(const void *)> *predicate_p,
+                            bool *predicate_satisfied) {
+    std::vector<LeafNode *> locked_list{leaf_p};
+    bool ok = true;
+
+    LeafNode *cur_p = leaf_p;
+    uint32_t pos = LowerBound(cur_p, key);
+    while (ok) {
+      for (; pos < cur_p->count && KeyCmpEqual(cur_p->keys[pos], key); pos++) {
+        if (predicate_p != nullptr &&
+            (*predicate_p)(cur_p->values[pos]) == true) {
+          *predicate_satisfied = true;
+          ok = false;
+          break;
+        }
+        if (unique_key || value_eq_obj(cur_p->values[pos], value)) {
+          ok = false;
+          break;
+        }
+      }
+
+      LeafNode *next_p = cur_p->next;
+      if (ok == false || pos < cur_p->count || next_p == nullptr) break;
+
+      next_p->latch.WriteLock();
+      locked_list.push_back(next_p);
+      cur_p = next_p;
+      pos = 0;
+    }
+
+    if (ok) {
+      // New values go after the existing run in the first leaf
+      InsertIntoLeaf(leaf_p, UpperBound(leaf_p, key), key, value);
+    }
+
+    for (LeafNode *locked_p : locked_list) {
+      locked_p->latch.WriteUnlock();
+    }
+    return ok;
+  }
+
+  /*
+   * SplitAndUnlock() - Split a full node whose read version is known
+   *
+   * Latches the parent (or verifies that the node is the root) and the node,
+   * splits, links the new sibling and releases everything. parent_slot was
+   * read together with parent_version, so it is valid once the parent latch
+   * is upgraded. The caller restarts regardless of the outcome
+   */
+  template <typename Node>
+  void SplitAndUnlock(InnerNode *parent_p, uint64_t parent_version,
+                      uint32_t parent_slot, Node *node_p, uint64_t version,
+                      bool &need_restart) {
+    if (parent_p != nullptr) {
+      // A full parent will be split on the next descent
+      if (parent_p->IsFull()) return;
+
+      parent_p->latch.UpgradeToWriteLockOrRestart(parent_version,
+                                                  need_restart);
+      if (need_restart) return;
+    }
+
+    node_p->latch.UpgradeToWriteLockOrRestart(version, need_restart);
+    if (need_restart) {
+      if (parent_p != nullptr) parent_p->latch.WriteUnlock();
+      return;
+    }
+
+    if (parent_p == nullptr && node_p != root.load()) {
+      node_p->latch.WriteUnlock();
+      return;
+    }
+
+    KeyType separator;
+    BaseNode *new_node_p = Split(node_p, &separator);
+    if (parent_p != nullptr) {
+      PELOTON_ASSERT(parent_p->children[parent_slot] == node_p);
+      InsertIntoInner(parent_p, parent_slot, separator, new_node_p);
+    } else {
+      MakeRoot(node_p, separator, new_node_p);
+    }
+
+    node_p->latch.WriteUnlock();
+    if (parent_p != nullptr) parent_p->latch.WriteUnlock();
+  }
+
+  inline BaseNode *Split(LeafNode *leaf_p, KeyType *separator_p) {
+    return SplitLeaf(leaf_p, separator_p);
+  }
+
+  inline BaseNode *Split(InnerNode *inner_p, KeyType *separator_p) {
+    return SplitInner(inner_p, separator_p);
+  }
+
+ private:
+  KeyComparator key_cmp_obj;
+  KeyEqualityChecker key_eq_obj;
+  ValueEqualityChecker value_eq_obj;
+
+  std::atomic<BaseNode *> root;
+
+  // The leftmost leaf never changes since splits only create right siblings
+  LeafNode *first_leaf_p;
+
+  std::atomic<size_t> inner_node_count;
+  std::atomic<size_t> leaf_node_count;
+
+  // Every node ever allocated; only used for destruction
+  OptimisticLatch node_list_latch;
+  std::vector<BaseNode *> all_nodes;
+};
+
+}  // namespace index
+}  // namespace peloton
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bplustree_index.h
+//
+// Identification: src/include/index/bplustree_index.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <map>
+
+#include "catalog/manager.h"
+#include "common/platform.h"
+#include "common/internal_types.h"
+#include "index/index.h"
+
+#include "index/bplustree.h"
+
+#define BPLUSTREE_INDEX_TYPE                                             \
+  BPlusTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker, \
+                 ValueEqualityChecker>
+
+namespace peloton {
+namespace index {
+
+/**
+ * B+Tree index with optimistic lock coupling.
+ *
+ * Takes the same key templates as BWTreeIndex (minus the hash functions,
+ * which only BwTree's delta chain needs). Reads do not write to shared
+ * memory and there is no mapping table indirection, which makes this the
+ * lower latency choice for read-mostly workloads; BwTree remains the
+ * better choice under heavy concurrent writes to the same leaves.
+ *
+ * @see Index
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator,
+          typename KeyEqualityChecker, typename ValueEqualityChecker>
+class BPlusTreeIndex : public Index {
+  friend class IndexFactory;
+
+  using MapType = BPlusTree<KeyType, ValueType, KeyComparator,
+                            KeyEqualityChecker, ValueEqualityChecker>;
+
+ public:
+  BPlusTreeIndex(IndexMetadata *metadata);
+
+  ~BPlusTreeIndex();
+
+  bool InsertEntry(const storage::Tuple *key, ItemPointer *value) override;
+
+  bool DeleteEntry(const storage::Tuple *key, ItemPointer *value) override;
+
+  bool CondInsertEntry(const storage::Tuple *key,
+                       ItemPointer *value,
+                       std::function<bool(const void *)> predicate) override;
+
+  void Scan(const std::vector<type::Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &expr_types,
+            ScanDirectionType scan_direction,
+            std::vector<ValueType> &result,
+            const ConjunctionScanPredicate *csp_p) override;
+
+  void ScanLimit(const std::vector<type::Value> &values,
+                 const std::vector<oid_t> &key_column_ids,
+                 const std::vector<ExpressionType> &expr_types,
+                 ScanDirectionType scan_direction,
+                 std::vector<ValueType> &result,
+                 const ConjunctionScanPredicate *csp_p,
+                 uint64_t limit,
+                 uint64_t offset) override;
+
+  void ScanAllKeys(std::vector<ValueType> &result) override;
+
+  void ScanKey(const storage::Tuple *key,
+               std::vector<ValueType> &result) override;
+
+  std::string GetTypeName() const override;
+
+  size_t GetMemoryFootprint() override {
+    return container.GetMemoryFootprint();
+  }
+
+  // Nodes are never unlinked, so there is nothing to reclaim
+  bool NeedGC() override { return false; }
+
+  void PerformGC() override {}
+
+ protected:
+  // equality checker and comparator
+  KeyComparator comparator;
+  KeyEqualityChecker equals;
+
+  // container
+  MapType container;
+};
+
+}  // namespace index
+}  // namespace peloton
@@ -106,7 +106,7 @@ class BWTreeIndex : public Index {
   }
 
   void PerformGC() override {
-    LOG_INFO("Bw-Tree Garbage Collection!");
+    LOG_TRACE("Bw-Tree Garbage Collection!");
     container.PerformGarbageCollection();
     
     return;
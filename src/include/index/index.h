@@ -22,6 +22,7 @@
 #include "common/item_pointer.h"
 #include "common/logger.h"
 #include "common/printable.h"
+#include "statistics/index_access_stats.h"
 #include "type/value.h"
 
 namespace peloton {
@@ -453,6 +454,9 @@ class Index : public Printable {
 
   oid_t index_oid = INVALID_OID;
 
+  // statistics hooks
+  stats::IndexAccessStats access_stats;
+
   // access counters
   int lookup_counter;
   int insert_counter;
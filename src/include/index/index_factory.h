@@ -40,6 +40,10 @@ class IndexFactory {
   /// SkipList factory methods
   static Index *GetSkipListIntsKeyIndex(IndexMetadata *metadata);
   static Index *GetSkipListGenericKeyIndex(IndexMetadata *metadata);
+
+  /// B+Tree (optimistic lock coupling) factory methods
+  static Index *GetBPlusTreeIntsKeyIndex(IndexMetadata *metadata);
+  static Index *GetBPlusTreeGenericKeyIndex(IndexMetadata *metadata);
 };
 
 }  // namespace index
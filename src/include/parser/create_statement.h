@@ -252,6 +252,16 @@ class CreateStatement : public TableRefStatement {
   std::unique_ptr<expression::AbstractExpression> trigger_when;
   int16_t trigger_type;  // information about row, timing, events, access by
                          // pg_trigger
+
+  // WITH (partition_by = 'range' | 'hash', partition_key = 'col',
+  //       partition_bounds = '10,20', partitions = 4)
+  PartitionType partition_type = PartitionType::INVALID;
+  std::string partition_key;
+  std::vector<std::string> partition_bounds;
+  size_t partition_count = 0;
+
+  // WITH (cluster_key = 'col')
+  std::string cluster_key;
 };
 
 }  // namespace parser
@@ -169,6 +169,10 @@ class PostgresParser {
   // transform helper for table column definitions
   static void ColumnDefTransform(ColumnDef* root, parser::CreateStatement* stmt);
 
+  // transform helper for the partitioning and clustering options of a table
+  static void StorageOptionsTransform(List *options,
+                                      parser::CreateStatement *stmt);
+
   // transform helper for create statements
   static parser::SQLStatement *CreateTransform(CreateStmt *root);
 
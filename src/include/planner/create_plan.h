@@ -139,6 +139,22 @@ class CreatePlan : public AbstractPlan {
 
   int16_t GetTriggerType() const { return trigger_type; }
 
+  // interfaces for partitioning
+
+  PartitionType GetPartitionType() const { return partition_type; }
+
+  std::string GetPartitionKey() const { return partition_key; }
+
+  std::vector<std::string> GetPartitionBounds() const {
+    return partition_bounds;
+  }
+
+  size_t GetPartitionCount() const { return partition_count; }
+
+  // interfaces for clustering
+
+  std::string GetClusterKey() const { return cluster_key; }
+
  protected:
   // These following protected function are a helper method for extracting
   // Multi-column constraint information and storing it in an internal struct.
@@ -193,6 +209,15 @@ class CreatePlan : public AbstractPlan {
   int16_t trigger_type;  // information about row, timing, events, access by
                          // pg_trigger
 
+  // Partitioning of the table, INVALID if it is not partitioned
+  PartitionType partition_type = PartitionType::INVALID;
+  std::string partition_key;
+  std::vector<std::string> partition_bounds;
+  size_t partition_count = 0;
+
+  // Key column the table is clustered on, empty if it is not clustered
+  std::string cluster_key;
+
  private:
   DISALLOW_COPY_AND_MOVE(CreatePlan);
 };
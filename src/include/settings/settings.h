@@ -89,6 +89,20 @@ SETTING_double(bnlj_buffer_size,
              1.0 * 1024.0 * 1024.0 * 1024,
              true, true)
 
+SETTING_double(hash_aggregation_memory_limit,
+             "The memory a hash aggregation keeps its groups in before spilling them to disk (default: 256 MB)",
+             256.0 * 1024.0 * 1024.0,
+             1.0 * 1024.0 * 1024.0,
+             1024.0 * 1024.0 * 1024.0 * 1024,
+             true, true)
+
+SETTING_double(sort_memory_limit,
+             "The memory a sort keeps its rows in before spilling sorted runs of them to disk (default: 256 MB)",
+             256.0 * 1024.0 * 1024.0,
+             1.0 * 1024.0 * 1024.0,
+             1024.0 * 1024.0 * 1024.0 * 1024,
+             true, true)
+
 // Size of the MonoQueue task queue
 SETTING_int(monoqueue_task_queue_size,
             "MonoQueue Task Queue Size (default: 32)",
@@ -110,12 +124,59 @@ SETTING_int(connection_thread_count,
             1, 64,
             false, false)
 
+// Allocate tile memory from huge page arenas
+SETTING_bool(tile_huge_pages,
+             "Allocate tile memory from 2MB huge page arenas (default: false)",
+             false,
+             false, false)
+
+// Keep tile data in a memory-mapped file
+SETTING_string(data_file_directory,
+               "Directory of the memory-mapped data file that holds tile data, "
+               "recreated at startup, tiles are kept in memory if empty "
+               "(default: empty)",
+               "",
+               false, false)
+
+SETTING_int(data_file_size,
+            "Size of a new data file in MB, it grows when full (default: 512)",
+            512,
+            1, 1048576,
+            false, false)
+
 SETTING_int(gc_num_threads,
             "The number of Garbage collection threads to run",
             1,
             1, 128,
             true, true)
 
+// Let the garbage collector freeze tile groups whose tuples all transactions
+// see, replacing their tuple headers with compact ones
+SETTING_bool(tile_group_freezing,
+             "Keep compact tuple headers for read-only tile groups (default: false)",
+             false,
+             true, true)
+
+// Let the garbage collector compress the columns of the tile groups it
+// freezes, so that scans evaluate their predicates on the compressed columns
+SETTING_bool(tile_group_compression,
+             "Compress the columns of frozen tile groups (default: false)",
+             false,
+             true, true)
+
+// Let the garbage collector move the live tuples of full tile groups with
+// few of them into the tail of the table, and drop the emptied tile groups
+SETTING_bool(tile_group_compaction,
+             "Compact tile groups left sparse by updates and deletes (default: false)",
+             false,
+             true, true)
+
+SETTING_int(tile_group_compaction_threshold,
+            "Percentage of live tuples below which a full tile group is compacted (default: 30)",
+            30,
+            1, 100,
+            true, true)
+
 SETTING_bool(parallel_execution,
              "Enable parallel execution of queries (default: true)",
              false,
@@ -223,7 +284,7 @@ SETTING_bool(predicate_push_down,
              true, true)
 
 SETTING_bool(hash_join_bloom_filter,
-             "Enable bloom filter for hash join in codegen (default: false)",
+             "Enable bloom filter for hash join (default: false)",
              false,
              true, true)
 
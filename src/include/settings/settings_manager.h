@@ -13,7 +13,10 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 #include "common/internal_types.h"
 #include "type/value.h"
 #include "common/exception.h"
@@ -38,6 +41,11 @@ class SettingsManager : public Printable {
   static void SetString(SettingId id, const std::string &value);
   static SettingsManager &GetInstance();
 
+  // Callback invoked after the value of a setting changes, so that hot paths
+  // can cache a setting instead of looking it up on every call
+  typedef std::function<void(SettingId)> SettingCallback;
+  static void RegisterCallback(SettingId id, SettingCallback callback);
+
   // Call this method in Catalog->Bootstrap
   // to store information into pg_settings
   void InitializeCatalog();
@@ -72,6 +80,12 @@ class SettingsManager : public Printable {
   };
   std::unordered_map<SettingId, Param, EnumClassHash> settings_;
 
+  // change callbacks, guarded by callbacks_mutex_
+  std::unordered_map<SettingId, std::vector<SettingCallback>, EnumClassHash>
+      callbacks_;
+
+  std::mutex callbacks_mutex_;
+
   std::unique_ptr<type::AbstractPool> pool_;
 
   bool catalog_initialized_;
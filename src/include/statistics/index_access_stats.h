@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_access_stats.h
+//
+// Identification: src/include/statistics/index_access_stats.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "statistics/access_metric.h"
+
+namespace peloton {
+
+namespace index {
+class IndexMetadata;
+}  // namespace index
+
+namespace stats {
+
+/**
+ * Access counters of a single index, used by all index wrappers.
+ *
+ * The stats mode is cached and refreshed through a settings-change callback,
+ * so with stats disabled a hook costs one relaxed load. With stats enabled,
+ * each thread resolves the index's metric in its own BackendStatsContext on
+ * first use and caches it in a thread-local slot assigned to the index at
+ * construction. Afterwards an operation bumps a counter owned by the calling
+ * thread without touching the settings map, the stats context maps, or any
+ * cache line shared with other threads. The slot of a destroyed index is
+ * handed to a later one, so the thread-local slots grow with the # of live
+ * indexes only.
+ */
+class IndexAccessStats {
+ public:
+  explicit IndexAccessStats(index::IndexMetadata *metadata);
+
+  ~IndexAccessStats();
+
+  IndexAccessStats(const IndexAccessStats &) = delete;
+  IndexAccessStats &operator=(const IndexAccessStats &) = delete;
+
+  /**
+   * @brief Whether statistics collection is enabled
+   */
+  static inline bool IsEnabled() {
+    auto stats_mode = stats_mode_.load(std::memory_order_relaxed);
+    if (stats_mode == STATS_MODE_UNKNOWN) {
+      stats_mode = RefreshStatsMode();
+    }
+    return static_cast<StatsType>(stats_mode) != StatsType::INVALID;
+  }
+
+  inline void IncrementReads(size_t read_count) {
+    if (IsEnabled()) GetAccessMetric().IncrementReads(read_count);
+  }
+
+  inline void IncrementInserts() {
+    if (IsEnabled()) GetAccessMetric().IncrementInserts();
+  }
+
+  inline void IncrementUpdates() {
+    if (IsEnabled()) GetAccessMetric().IncrementUpdates();
+  }
+
+  inline void IncrementDeletes(size_t delete_count) {
+    if (IsEnabled()) GetAccessMetric().IncrementDeletes(delete_count);
+  }
+
+ private:
+  // Stats mode before the settings have been read
+  static constexpr int STATS_MODE_UNKNOWN = -1;
+
+  // Reload the cached stats mode from the settings
+  static int RefreshStatsMode();
+
+  // A metric cached by a thread, valid for the index with the instance id.
+  // A slot is reused by a later index, which has another instance id.
+  struct ThreadSlot {
+    uint64_t instance_id;
+    AccessMetric *metric;
+  };
+
+  // The calling thread's metrics, indexed by slot
+  static inline std::vector<ThreadSlot> &GetThreadSlots() {
+    static thread_local std::vector<ThreadSlot> thread_slots;
+    return thread_slots;
+  }
+
+  inline AccessMetric &GetAccessMetric() {
+    auto &thread_slots = GetThreadSlots();
+    if (slot_ < thread_slots.size() &&
+        thread_slots[slot_].instance_id == instance_id_) {
+      return *thread_slots[slot_].metric;
+    }
+    return ResolveAccessMetric();
+  }
+
+  // A slot no live index has
+  static size_t AcquireSlot();
+
+  static void ReleaseSlot(size_t slot);
+
+  // Look up the metric in the calling thread's stats context and cache it
+  AccessMetric &ResolveAccessMetric();
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  const oid_t database_oid_;
+
+  const oid_t table_oid_;
+
+  const oid_t index_oid_;
+
+  // Unique across all indexes ever created, 0 marks an empty thread slot
+  const uint64_t instance_id_;
+
+  // Thread-local slot of this index, reused once it is destroyed
+  const size_t slot_;
+
+  static std::atomic<int> stats_mode_;
+
+  static std::atomic<uint64_t> next_instance_id_;
+};
+
+}  // namespace stats
+}  // namespace peloton
@@ -12,7 +12,11 @@
 
 #pragma once
 
+#include <map>
 #include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "common/synchronization/spin_latch.h"
 #include "common/internal_types.h"
@@ -46,10 +50,25 @@ class BackendManager {
 
   void *Allocate(BackendType type, size_t size);
 
-  void Release(BackendType type, void *address);
+  // size is required by HUGE_PAGE, which recycles blocks by size
+  void Release(BackendType type, void *address, size_t size = 0);
 
   void Sync(BackendType type, void *address, size_t length);
 
+  //===--------------------------------------------------------------------===//
+  // Data file
+  //===--------------------------------------------------------------------===//
+
+  // create and map the data file in directory that backs SSD and HDD
+  // allocations, starting with length bytes. the file is scratch space for
+  // tiles that do not fit in memory; it is recreated on every open and
+  // nothing in it survives a restart.
+  void OpenDataFile(const std::string &directory, size_t length);
+
+  void CloseDataFile();
+
+  bool IsDataFileOpen() const { return data_file_address != nullptr; }
+
   size_t GetMsyncCount() const { return msync_count; }
 
   size_t GetClflushCount() const { return clflush_count; }
@@ -57,17 +76,49 @@ class BackendManager {
   size_t GetAllocationCount() const { return allocation_count; }
 
  private:
-  // data file address
+  // allocate a page aligned extent of the data file, growing it when no
+  // free extent is large enough
+  void *AllocateExtent(size_t size);
+
+  void ReleaseExtent(void *address);
+
+  // extend the data file by at least length bytes and map the new range as
+  // a segment of its own, the segments mapped before do not move. false if
+  // the file system is full
+  bool GrowDataFile(size_t length);
+
+  // offset of an address in the data file, data_file_spinlock must be held
+  size_t GetDataFileOffset(void *address) const;
+
+  // write a range of the data file back to it, throws if that fails
+  void SyncDataFile(void *address, size_t length);
+
+  // data file name
+  std::string data_file_name;
+
+  // data file address, the first segment
   void *data_file_address;
 
-  // data file lock
+  // data file descriptor, kept open to grow the file
+  int data_file_fd = -1;
+
+  // data file lock, also protects the segments and the extents
   common::synchronization::SpinLatch data_file_spinlock;
 
   // data file len
   size_t data_file_len;
 
-  // data offset
-  size_t data_file_offset;
+  // mapped segments of the data file, offset -> <address, length>
+  std::map<size_t, std::pair<char *, size_t>> data_file_segments;
+
+  // whether the data file is mapped with MAP_SYNC
+  bool data_file_sync_mapped = false;
+
+  // free extents, offset -> length
+  std::map<size_t, size_t> free_extents;
+
+  // allocated extents, offset -> length
+  std::map<size_t, size_t> allocated_extents;
 
   // stats
   size_t msync_count = 0;
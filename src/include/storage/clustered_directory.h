@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// clustered_directory.h
+//
+// Identification: src/include/storage/clustered_directory.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/synchronization/readwrite_latch.h"
+#include "common/synchronization/spin_latch.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace storage {
+
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Clustered Directory
+//===--------------------------------------------------------------------===//
+
+/**
+ * The pages of a table clustered on a key column, in key order.
+ *
+ * A page is a tile group that takes the inserts of a range of keys, the
+ * ranges of consecutive pages being adjacent. When a page fills up, its
+ * range is split and the keys on one side of the split go to a new page.
+ * Tuples are never moved out of a page (their location is referenced by
+ * indirections, version chains and the GC), so the keys a page actually
+ * holds may stray out of its current range; scans go by the lowest and
+ * highest key each page holds instead.
+ */
+class ClusteredDirectory {
+ public:
+  ClusteredDirectory(oid_t key_column_id,
+                     std::shared_ptr<TileGroup> first_page);
+
+  oid_t GetKeyColumnId() const { return key_column_id_; }
+
+  size_t GetPageCount() const;
+
+  // the page whose range holds the key, NULL keys go to the first page
+  TileGroup *GetPage(const type::Value &key) const;
+
+  // widen the key bounds of the page to the key of a tuple inserted into it
+  void RecordKey(const oid_t &tile_group_id, const type::Value &key);
+
+  // hand a slot freed by the GC back to its page, false if the tile group
+  // is not a page
+  bool AddFreeSlot(const oid_t &tile_group_id, const oid_t &tuple_slot);
+
+  // take a freed slot of the page, INVALID_OID if it has none
+  oid_t TakeFreeSlot(const oid_t &tile_group_id);
+
+  /**
+   * Split the range of a full page at a key it holds, handing one side of
+   * the range to new_page. Keys above those of the page open a range of
+   * their own, keys below them take over the range below the page.
+   * Does nothing if the key no longer goes to the page.
+   */
+  void SplitPage(TileGroup *page, const type::Value &key,
+                 std::shared_ptr<TileGroup> new_page);
+
+  /**
+   * The ids of the pages, in key order, that may hold tuples satisfying the
+   * predicate. Equality and range comparisons between the key column and a
+   * constant or parameter, and their conjunctions and disjunctions, are
+   * used; any other predicate keeps every page.
+   */
+  std::vector<oid_t> GetPages(const expression::AbstractExpression *predicate,
+                              const std::vector<type::Value> *params) const;
+
+  const std::string GetInfo() const;
+
+ private:
+  struct Page {
+    std::shared_ptr<TileGroup> tile_group;
+
+    // the lowest key routed to the page, NULL for the first page
+    type::Value low_key;
+
+    // the lowest and highest key in the page, NULL while it is empty
+    common::synchronization::SpinLatch bounds_latch;
+    type::Value min_key;
+    type::Value max_key;
+
+    // the slots of the page freed by the GC
+    common::synchronization::SpinLatch free_slot_latch;
+    std::vector<oid_t> free_slots;
+  };
+
+  // index of the page whose range holds the key, the caller holds latch_
+  size_t FindPage(const type::Value &key) const;
+
+  std::vector<bool> MatchPages(const expression::AbstractExpression *predicate,
+                               const std::vector<type::Value> *params) const;
+
+  std::vector<bool> MatchComparison(
+      const expression::AbstractExpression *predicate,
+      const std::vector<type::Value> *params) const;
+
+  const oid_t key_column_id_;
+
+  // readers route keys and scan pages, writers split pages
+  common::synchronization::ReadWriteLatch latch_;
+
+  // ordered by low key
+  std::vector<std::unique_ptr<Page>> pages_;
+
+  // tile group id -> page
+  std::unordered_map<oid_t, Page *> pages_by_id_;
+};
+
+}  // namespace storage
+}  // namespace peloton
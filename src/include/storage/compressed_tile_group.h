@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_tile_group.h
+//
+// Identification: src/include/storage/compressed_tile_group.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace storage {
+
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Compressed Column
+//===--------------------------------------------------------------------===//
+
+/**
+ * A column of a frozen tile group, encoded so that comparisons with a
+ * constant can be evaluated without decoding values:
+ *
+ * - BIT_PACKED: integers stored as their offset from the lowest value of the
+ *   column, in as few bits as the highest offset needs
+ * - RUN_LENGTH: sorted integers without NULLs, stored as (value, end) runs
+ * - DICTIONARY: strings with few distinct values, stored as bit packed codes
+ *   into a sorted dictionary, so that codes compare like the strings
+ */
+class CompressedColumn {
+ public:
+  enum class Encoding { BIT_PACKED, RUN_LENGTH, DICTIONARY };
+
+  /**
+   * Encodes the column of the first tuple_count tuples of the tile group.
+   * Returns nullptr if no encoding fits the type or values of the column,
+   * or if the encoded values would not take at most half of the raw ones.
+   */
+  static std::unique_ptr<CompressedColumn> Compress(TileGroup *tile_group,
+                                                    oid_t column_id,
+                                                    oid_t tuple_count);
+
+  Encoding GetEncoding() const { return encoding_; }
+
+  // # of bytes taken by the encoded values
+  size_t GetSize() const;
+
+  /**
+   * Clears the bits of matches, one per tuple, of the tuples whose value
+   * does not satisfy (value <comparison> constant). Returns false, leaving
+   * matches as is, if the constant does not compare with the encoded values.
+   */
+  bool Filter(ExpressionType comparison, const type::Value &constant,
+              std::vector<uint64_t> &matches) const;
+
+ private:
+  CompressedColumn(Encoding encoding, oid_t tuple_count)
+      : encoding_(encoding), tuple_count_(tuple_count) {}
+
+  static std::unique_ptr<CompressedColumn> CompressIntegers(
+      TileGroup *tile_group, oid_t column_id, oid_t tuple_count);
+
+  static std::unique_ptr<CompressedColumn> CompressStrings(
+      TileGroup *tile_group, oid_t column_id, oid_t tuple_count);
+
+  // pack value (of bit_width_ bits) as the tuple_id'th value of packed_
+  void Pack(oid_t tuple_id, uint64_t value);
+
+  inline uint64_t Unpack(oid_t tuple_id) const;
+
+  // clears the bits of the tuples whose packed value is outside [low, high]
+  void FilterPacked(uint64_t low, uint64_t high,
+                    std::vector<uint64_t> &matches) const;
+
+  // clears the bits of the tuples whose value is outside [low, high]
+  void FilterRuns(int64_t low, int64_t high,
+                  std::vector<uint64_t> &matches) const;
+
+  const Encoding encoding_;
+
+  const oid_t tuple_count_;
+
+  // one bit per tuple, set for NULLs; empty if the column has none
+  std::vector<uint64_t> nulls_;
+
+  // BIT_PACKED and DICTIONARY
+  uint32_t bit_width_ = 0;
+  std::vector<uint64_t> packed_;
+
+  // BIT_PACKED, the lowest value of the column
+  int64_t base_ = 0;
+
+  // RUN_LENGTH, the value of each run and the tuple id it ends before
+  std::vector<int64_t> run_values_;
+  std::vector<oid_t> run_ends_;
+
+  // DICTIONARY, the distinct values of the column in sorted order
+  std::vector<std::string> dictionary_;
+};
+
+//===--------------------------------------------------------------------===//
+// Compressed Tile Group
+//===--------------------------------------------------------------------===//
+
+/**
+ * The compressed columns of a frozen tile group, built by the GC once the
+ * tile group freezes. The compressed columns let scans evaluate their
+ * predicate on much less data. They are only valid while the tile group
+ * stays frozen.
+ *
+ * The tiles of the tile group are kept, and remain what tuples are
+ * materialized from: codegen and the storage layer read tuples straight
+ * from the tiles, and a write thaws the tile group and updates them in
+ * place. A compressed column therefore costs memory on top of the raw one,
+ * and is only kept when it takes at most half of its size.
+ */
+class CompressedTileGroup {
+ public:
+  explicit CompressedTileGroup(TileGroup *tile_group);
+
+  oid_t GetTupleCount() const { return tuple_count_; }
+
+  // # of columns that could be compressed
+  size_t GetCompressedColumnCount() const;
+
+  // # of bytes taken by the compressed columns
+  size_t GetSize() const;
+
+  /**
+   * Evaluates, on the compressed columns, the comparisons between a
+   * compressed column and a constant or parameter in the top level
+   * conjunction of the predicate. matches gets one bit per tuple, set for
+   * the tuples that may satisfy the predicate; exact is set when every
+   * conjunct was evaluated, so that those tuples do satisfy it.
+   * Returns false if no conjunct could be evaluated.
+   */
+  bool Filter(const expression::AbstractExpression *predicate,
+              const std::vector<type::Value> *params,
+              std::vector<uint64_t> &matches, bool &exact) const;
+
+  const std::string GetInfo() const;
+
+ private:
+  // returns whether the conjunct was evaluated into matches
+  bool FilterConjunct(const expression::AbstractExpression *predicate,
+                      const std::vector<type::Value> *params,
+                      std::vector<uint64_t> &matches, bool &exact) const;
+
+  const oid_t tile_group_id_;
+
+  const oid_t tuple_count_;
+
+  // per column, nullptr for the columns left uncompressed
+  std::vector<std::unique_ptr<CompressedColumn>> columns_;
+};
+
+}  // namespace storage
+}  // namespace peloton
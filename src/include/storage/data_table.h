@@ -14,6 +14,7 @@
 
 #include <include/index/index_key.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -23,10 +24,13 @@
 #include "common/container/lock_free_array.h"
 #include "common/item_pointer.h"
 #include "common/platform.h"
+#include "common/synchronization/spin_latch.h"
 #include "index/index.h"
 #include "storage/abstract_table.h"
+#include "storage/clustered_directory.h"
 #include "storage/indirection_array.h"
 #include "storage/layout.h"
+#include "storage/partition_scheme.h"
 #include "trigger/trigger.h"
 #include "common/container/cuckoo_map.h"
 
@@ -132,7 +136,10 @@ class DataTable : public AbstractTable {
   // TUPLE OPERATIONS
   //===--------------------------------------------------------------------===//
   // insert an empty version in table. designed for delete operation.
-  ItemPointer InsertEmptyVersion();
+  // in a partitioned table the version goes to the partition of
+  // old_location, in a clustered table to the page of old_location.
+  ItemPointer InsertEmptyVersion(
+      const ItemPointer &old_location = INVALID_ITEMPOINTER);
 
   // these two functions are designed for reducing memory allocation by
   // performing in-place update.
@@ -141,7 +148,15 @@ class DataTable : public AbstractTable {
   // copy the content into the version. after that, we need to check constraints
   // and then install the version
   // into all the corresponding indexes.
-  ItemPointer AcquireVersion();
+  // in a partitioned table the version goes to the partition of
+  // old_location, in a clustered table to the page of old_location.
+  ItemPointer AcquireVersion(
+      const ItemPointer &old_location = INVALID_ITEMPOINTER);
+
+  // acquire a version slot for a tuple moved out of a tile group being
+  // compacted. recycled slots are never used, they may lie in such tile
+  // groups. the sparse index range of the new tile group covers the tuple.
+  ItemPointer AcquireMovedVersion(const AbstractTuple *tuple);
 
   // install an version in table. designed for update operation.
   // as we implement logical-pointer indexing mechanism, targets_ptr is
@@ -164,6 +179,16 @@ class DataTable : public AbstractTable {
   bool InsertTuple(const AbstractTuple *tuple, ItemPointer location,
                    concurrency::TransactionContext *transaction,
                    ItemPointer **index_entry_ptr, bool check_fk = true);
+
+  // insert a batch of tuples. slots are reserved in runs of consecutive
+  // slots, constraints are checked a column at a time and every index
+  // receives the batch sorted by its key. unlike InsertTuple, the inserts
+  // are also performed in the transaction. locations receives the location
+  // of every tuple inserted so far; on false the transaction must abort.
+  bool InsertTuples(const std::vector<const storage::Tuple *> &tuples,
+                    concurrency::TransactionContext *transaction,
+                    std::vector<ItemPointer> &locations,
+                    bool check_fk = true);
 //  void InsertTupleToMap(const storage::Tuple *tuple);
 
   //===--------------------------------------------------------------------===//
@@ -191,6 +216,9 @@ class DataTable : public AbstractTable {
   std::vector<storage::TileGroup *> GetTileGroupList(oid_t tile_group_count) const;
   std::vector<storage::TileGroup *> GetTileGroupsBTree(oid_t table_id,oid_t tile_group_count) const;
   storage::TileGroup *GetTileGroupBTree(oid_t table_id,oid_t tile_group_offset) const;
+
+  // Whether the table keeps the per tile group min/max sparse index
+  bool IsSparseIndexed();
 //  std::vector<ItemPointer*> GetTileGroupBwTree(oid_t table_id,
 //                                                type::Value low_,
 //                                                type::Value high_,
@@ -199,6 +227,65 @@ class DataTable : public AbstractTable {
 
 //  oid_t GetTileGroupIdByOffset(const std::size_t &tile_group_offset) const;
 
+  //===--------------------------------------------------------------------===//
+  // PARTITIONS
+  //===--------------------------------------------------------------------===//
+
+  // Partition the table. Every partition inserts into tile groups of its
+  // own; the indexes cover all partitions. Must be called before the table
+  // is used, the table must be empty.
+  void SetPartitionScheme(std::unique_ptr<PartitionScheme> partition_scheme);
+
+  // nullptr unless the table is partitioned
+  const PartitionScheme *GetPartitionScheme() const {
+    return partition_scheme_.get();
+  }
+
+  bool IsPartitioned() const { return partition_scheme_ != nullptr; }
+
+  size_t GetPartitionCount() const {
+    return IsPartitioned() ? partition_scheme_->GetPartitionCount() : 1;
+  }
+
+  // the partition the tile group belongs to, 0 unless partitioned
+  size_t GetTileGroupPartition(const oid_t &tile_group_id) const;
+
+  //===--------------------------------------------------------------------===//
+  // COMPACTION
+  //===--------------------------------------------------------------------===//
+
+  // Drop a tile group emptied by compaction from the table, the storage
+  // manager and the sparse index. False if the tile group still takes
+  // inserts.
+  bool DropCompactedTileGroup(const oid_t &tile_group_id);
+
+  //===--------------------------------------------------------------------===//
+  // CLUSTERING
+  //===--------------------------------------------------------------------===//
+
+  // Cluster the table on a key column: tuples are inserted into pages of
+  // adjacent key ranges, see ClusteredDirectory. Must be called before the
+  // table is used, the table must be empty and not partitioned.
+  void SetClusterKey(const oid_t &key_column_id);
+
+  // nullptr unless the table is clustered
+  const ClusteredDirectory *GetClusteredDirectory() const {
+    return clustered_directory_.get();
+  }
+
+  bool IsClustered() const { return clustered_directory_ != nullptr; }
+
+  // hand a slot of a clustered table freed by the GC back to its page, the
+  // next insert or version routed to the page takes it
+  void RecycleClusteredTupleSlot(const ItemPointer &location);
+
+  // whether the tile group of a tuple depends on the value of the column,
+  // i.e. the column is the partition key or the cluster key
+  bool IsPlacementColumn(const oid_t &column_id) const;
+
+  // whether the tile group of a tuple depends on its values
+  bool IsPlacedByKey() const { return IsPartitioned() || IsClustered(); }
+
   //===--------------------------------------------------------------------===//
   // TRIGGER
   //===--------------------------------------------------------------------===//
@@ -308,6 +395,14 @@ class DataTable : public AbstractTable {
 
   void ClearIndexSamples();
 
+  // whether the index tuner tunes the indexes of the table, index scans
+  // only record samples then
+  void SetIndexSampling(bool index_sampling) {
+    index_sampling_ = index_sampling;
+  }
+
+  bool IsIndexSampling() const { return index_sampling_; }
+
   //===--------------------------------------------------------------------===//
   // UTILITIES
   //===--------------------------------------------------------------------===//
@@ -368,12 +463,29 @@ class DataTable : public AbstractTable {
 
   bool CheckConstraints(const AbstractTuple *tuple) const;
 
+  // check the constraints of a batch, a column at a time
+  bool CheckConstraints(const std::vector<const storage::Tuple *> &tuples) const;
+
+  // check that the multi-column constraints of the schema are supported
+  bool CheckSchemaConstraints() const;
+
+  // a tuple whose first column is INT_MAX - 1 requests the tile groups to be
+  // moved to the key-value store. returns true if it did.
+  bool HandleKVStoreRequest(const storage::Tuple *tuple);
+
   // add a tile group to the table
   oid_t AddDefaultTileGroup();
   // add a tile group to the table. replace the active_tile_group_id-th active
   // tile group.
   oid_t AddDefaultTileGroup(const size_t &active_tile_group_id);
 
+  // same as above, the caller must hold data_table_mutex_
+  oid_t InstallDefaultTileGroup(const size_t &active_tile_group_id);
+
+  // create a tile group of the partition and register it with the table,
+  // the caller must hold data_table_mutex_
+  std::shared_ptr<TileGroup> CreateDefaultTileGroup(const size_t &partition);
+
   oid_t AddDefaultIndirectionArray(const size_t &active_indirection_array_id);
 
   // Drop all tile groups of the table. Used by recovery
@@ -388,6 +500,14 @@ class DataTable : public AbstractTable {
                                 concurrency::TransactionContext *transaction,
                                 ItemPointer *index_entry_ptr);
 
+  // insert a batch into all indexes, each index in key order
+  bool InsertInIndexes(const std::vector<const storage::Tuple *> &tuples,
+                       const std::vector<ItemPointer *> &index_entry_ptrs,
+                       concurrency::TransactionContext *transaction);
+
+  // allocate the indirection of a new tuple and point it at location
+  ItemPointer *AllocateIndirection(const ItemPointer &location);
+
   // check the foreign key constraints
   bool CheckForeignKeyConstraints(const AbstractTuple *tuple,
                                   concurrency::TransactionContext *transaction);
@@ -405,6 +525,48 @@ class DataTable : public AbstractTable {
   // and returns the incremented value.
   oid_t GetNextLayoutOid() { return ++current_layout_oid_; }
 
+  //===--------------------------------------------------------------------===//
+  // INSERT LANE HELPERS
+  //===--------------------------------------------------------------------===//
+
+  // The active tile group the calling thread inserts into
+  size_t GetInsertLane();
+
+  // Returns the active tile group of the lane, opening the lane on first use
+  TileGroup *GetLaneTileGroup(const size_t &lane);
+
+  // Returns a slot recycled by the GC from the free list of the calling
+  // thread's lane of the partition
+  ItemPointer GetRecycledTupleSlot(const size_t &partition);
+
+  // Claim a recycled slot of the partition for the tuple, INVALID_ITEMPOINTER
+  // if there is none
+  ItemPointer ClaimRecycledTupleSlot(const storage::Tuple *tuple,
+                                     const size_t &partition);
+
+  // Claim a new tuple slot in a tile group of the partition
+  ItemPointer ClaimTupleSlot(const storage::Tuple *tuple,
+                             const size_t &partition);
+
+  // Claim a new tuple slot for a key of a clustered table, in tile_group if
+  // it is not nullptr and has room, otherwise in the page of the key. freed
+  // slots of the page are taken first.
+  ItemPointer ClaimClusteredTupleSlot(const storage::Tuple *tuple,
+                                      const type::Value &key,
+                                      storage::TileGroup *tile_group);
+
+  // Claim the slot of a new version, see AcquireVersion()
+  ItemPointer ClaimVersionSlot(const ItemPointer &old_location);
+
+  // add a page to take over part of the range of a full page
+  void SplitClusteredPage(storage::TileGroup *page, const type::Value &key);
+
+  // Widen the range of the tile group in the sparse index to cover
+  // [min_value, max_value]
+  void UpdateSparseIndex(const oid_t &tile_group_id,
+                         const type::Value &min_value,
+                         const type::Value &max_value);
+
  private:
   //===--------------------------------------------------------------------===//
   // STATIC MEMBERS
@@ -434,13 +596,50 @@ class DataTable : public AbstractTable {
   bool is_catalog_ = false;
   std::vector<storage::TileGroup *> tile_group_array_;
 //  CuckooMap<oid_t,std::vector<storage::Tile *>> column_tiles_;
-  //tilegreoup,min,max key
+  // tile group id -> min and max value of the first column
   CuckooMap<oid_t, std::pair<type::Value,type::Value>> sparse_index;
 
+  // owns the active tile groups, only modified under data_table_mutex_
   std::vector<std::shared_ptr<storage::TileGroup>> active_tile_groups_;
 
+  // An insert lane publishes the active tile group of active_tile_groups_
+  // to the threads inserting into it, and keeps the slots recycled by the
+  // GC that they take from it in batches. The slots stay with the table
+  // when a thread stops inserting, the other threads of the lane reuse them.
+  struct InsertLaneState {
+    std::atomic<storage::TileGroup *> tile_group;
+
+    // recycled slots, guarded by free_slot_latch
+    common::synchronization::SpinLatch free_slot_latch;
+    std::vector<ItemPointer> free_slots;
+
+    // # of inserts that do not ask the GC for recycled slots, after it had
+    // none
+    uint32_t skipped_polls = 0;
+  };
+
+  // Lanes are padded to a cache line so that threads on different lanes do
+  // not share one
+  struct InsertLane : public InsertLaneState {
+    char padding[CACHELINE_SIZE - sizeof(InsertLaneState) % CACHELINE_SIZE];
+  };
+
+  std::unique_ptr<InsertLane[]> insert_lanes_;
+
   std::atomic<size_t> tile_group_count_ = ATOMIC_VAR_INIT(0);
 
+  // PARTITIONS
+  // every partition has active_tilegroup_count_ insert lanes, the lanes of
+  // partition p start at p * active_tilegroup_count_
+  std::unique_ptr<PartitionScheme> partition_scheme_;
+
+  // tile group id -> partition, tile groups of partition 0 are left out
+  CuckooMap<oid_t, oid_t> tile_group_partitions_;
+
+  // CLUSTERING
+  // the pages of a clustered table, which does not use the insert lanes
+  std::unique_ptr<ClusteredDirectory> clustered_directory_;
+
   // INDIRECTIONS
   std::vector<std::shared_ptr<storage::IndirectionArray>>
       active_indirection_arrays_;
@@ -458,6 +657,9 @@ class DataTable : public AbstractTable {
   // concurrently.
   std::atomic<size_t> number_of_tuples_ = ATOMIC_VAR_INIT(0);
 
+  // whether the table keeps the sparse index, -1 while unknown
+  std::atomic<int> sparse_indexed_;
+
   // dirty flag. for detecting whether the tile group has been used.
   bool dirty_ = false;
 
@@ -484,6 +686,8 @@ class DataTable : public AbstractTable {
   // index samples mutex
   std::mutex index_samples_mutex_;
 
+  std::atomic<bool> index_sampling_{false};
+
   static oid_t invalid_tile_group_id;
 
   // trigger list
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partition_scheme.h
+//
+// Identification: src/include/storage/partition_scheme.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Partition Scheme
+//===--------------------------------------------------------------------===//
+
+/**
+ * Maps the tuples of a partitioned table to its partitions.
+ *
+ * A RANGE scheme with bounds b_0 < b_1 < ... < b_n-1 has n + 1 partitions,
+ * partition i holding the keys in [b_i-1, b_i). A HASH scheme puts a key
+ * into partition (hash of the key % partition count). Tuples whose key is
+ * NULL go to partition 0.
+ */
+class PartitionScheme {
+ public:
+  // bounds are cast to the type of the key column and sorted
+  PartitionScheme(PartitionType partition_type, oid_t key_column_id,
+                  type::TypeId key_type, size_t partition_count,
+                  std::vector<type::Value> range_bounds);
+
+  PartitionType GetPartitionType() const { return partition_type_; }
+
+  oid_t GetKeyColumnId() const { return key_column_id_; }
+
+  size_t GetPartitionCount() const { return partition_count_; }
+
+  const std::vector<type::Value> &GetRangeBounds() const {
+    return range_bounds_;
+  }
+
+  // the partition holding the key
+  size_t GetPartition(const type::Value &key) const;
+
+  // the partition holding the tuple
+  size_t GetPartition(const AbstractTuple *tuple) const;
+
+  /**
+   * Partition pruning. Returns, per partition, whether it may hold tuples
+   * satisfying the predicate. Equality and range comparisons between the
+   * key column and a constant or parameter, and their conjunctions and
+   * disjunctions, are used; any other predicate keeps every partition.
+   */
+  std::vector<bool> Prune(const expression::AbstractExpression *predicate,
+                          const std::vector<type::Value> *params) const;
+
+  const std::string GetInfo() const;
+
+  /**
+   * Splits a comparison between the key column and a constant or parameter
+   * into the comparison type, with the key column on the left, and the
+   * value compared with. False for any other predicate.
+   */
+  static bool GetKeyComparison(const expression::AbstractExpression *predicate,
+                               oid_t key_column_id,
+                               const std::vector<type::Value> *params,
+                               ExpressionType &comparison, type::Value &value);
+
+ private:
+  std::vector<bool> PruneComparison(
+      const expression::AbstractExpression *predicate,
+      const std::vector<type::Value> *params) const;
+
+  // the value of a constant or parameter expression, false if the
+  // expression is neither
+  static bool GetKeyValue(const expression::AbstractExpression *expr,
+                          const std::vector<type::Value> *params,
+                          type::Value &value);
+
+  const PartitionType partition_type_;
+
+  const oid_t key_column_id_;
+
+  const type::TypeId key_type_;
+
+  const size_t partition_count_;
+
+  // sorted, RANGE only
+  std::vector<type::Value> range_bounds_;
+};
+
+}  // namespace storage
+}  // namespace peloton
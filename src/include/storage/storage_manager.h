@@ -307,6 +307,11 @@ class StorageManager {
 
   void DropTileGroup(const oid_t oid);
 
+  // drop the tile group of a table at an offset from the tile group tree and
+  // list as well, see DataTable::DropCompactedTileGroup()
+  void DropTileGroup(oid_t table_id, oid_t tile_group_offset,
+                     oid_t tile_group_id);
+
   std::shared_ptr<storage::TileGroup> GetTileGroup(const oid_t oid);
 
   void ClearTileGroup(void);
@@ -315,6 +320,7 @@ class StorageManager {
   std::vector<storage::TileGroup *> GetTileGroupByList(std::shared_ptr<storage::TileGroup> tile_group_pre,
                                           oid_t current_);
   std::vector<storage::TileGroup *> GetTileGroupsByBTree(oid_t table_id, oid_t tile_group_count);
+  // nullptr if the tile group was dropped
   storage::TileGroup *GetTileGroupByBTree(oid_t table_id, oid_t tile_group_offset);
 //  std::vector<ItemPointer *> GetTileGroupByBwTree(oid_t table_id,
 //                                                  type::Value low_,
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_arena.h
+//
+// Identification: src/include/storage/tile_arena.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "common/synchronization/spin_latch.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Tile Arena
+//===--------------------------------------------------------------------===//
+
+/**
+ * Hands out tile memory for BackendType::HUGE_PAGE.
+ *
+ * Memory is carved from large regions backed by 2MB pages, explicit
+ * (MAP_HUGETLB) pages when the system has them reserved, and transparent
+ * huge pages (madvise) otherwise. Requests are rounded up to a power of two
+ * size class between 4KB and 2MB; released blocks are kept in a free list
+ * per size class and reused by later tiles instead of being returned to
+ * the system. Requests above 2MB get a mapping of their own.
+ */
+class TileArena {
+ public:
+  // global singleton
+  static TileArena &GetInstance();
+
+  void *Allocate(size_t size);
+
+  // size must be the size the block was allocated with
+  void Release(void *address, size_t size);
+
+  // # of bytes mapped by the arena
+  size_t GetMappedSize() const { return mapped_size_; }
+
+  // # of bytes handed out and not yet released
+  size_t GetAllocatedSize() const { return allocated_size_; }
+
+ private:
+  TileArena();
+
+  // index of the size class that holds size bytes
+  static size_t GetSizeClass(size_t size);
+
+  static size_t GetSizeClassSize(size_t size_class);
+
+  // map size bytes aligned to a huge page
+  void *Map(size_t size);
+
+  void Unmap(void *address, size_t size);
+
+  // carve a block of a size class from the current region
+  void *Carve(size_t size_class);
+
+  static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  static const size_t MIN_BLOCK_SIZE = 4 * 1024;
+
+  // 4KB, 8KB, ... 2MB
+  static const size_t SIZE_CLASS_COUNT = 10;
+
+  static const size_t REGION_SIZE = 32 * HUGE_PAGE_SIZE;
+
+  struct SizeClassPool {
+    common::synchronization::SpinLatch latch;
+    std::vector<void *> free_blocks;
+  };
+
+  SizeClassPool pools_[SIZE_CLASS_COUNT];
+
+  // regions are only carved, never unmapped
+  common::synchronization::SpinLatch region_latch_;
+
+  std::vector<char *> regions_;
+
+  char *region_cursor_ = nullptr;
+
+  char *region_end_ = nullptr;
+
+  // whether MAP_HUGETLB mappings can still be attempted
+  std::atomic<bool> use_hugetlb_;
+
+  std::atomic<size_t> mapped_size_;
+
+  std::atomic<size_t> allocated_size_;
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -50,6 +50,7 @@ namespace storage {
 class Tuple;
 class Tile;
 class TileGroupHeader;
+class CompressedTileGroup;
 class AbstractTable;
 class TileGroupIterator;
 class RollbackSegment;
@@ -88,6 +89,13 @@ class TileGroup : public Printable {
   // insert tuple at next available slot in tile if a slot exists
   oid_t InsertTuple(const Tuple *tuple);
 
+  // insert tuple_count tuples starting at tuples[offset] into consecutive
+  // slots, a column at a time. fewer tuples are inserted if the tile group
+  // fills up, tuple_count is set to the # inserted. returns the first slot
+  // or INVALID_OID if the tile group is full.
+  oid_t InsertTuples(const std::vector<const Tuple *> &tuples,
+                     const size_t &offset, oid_t &tuple_count);
+
   // insert tuple at specific tuple slot
   // used by recovery mode
   oid_t InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
@@ -163,6 +171,17 @@ class TileGroup : public Printable {
   // Get the layout of the TileGroup. Used to locate columns.
   const storage::Layout &GetLayout() const { return *tile_group_layout_; }
 
+  // the compressed columns of the tile group, nullptr if it was not
+  // compressed. only valid while the tile group is frozen.
+  std::shared_ptr<const CompressedTileGroup> GetCompressedColumns() const {
+    return std::atomic_load(&compressed_columns_);
+  }
+
+  void SetCompressedColumns(
+      std::shared_ptr<const CompressedTileGroup> compressed_columns) {
+    std::atomic_store(&compressed_columns_, std::move(compressed_columns));
+  }
+
 
  protected:
   //===--------------------------------------------------------------------===//
@@ -196,6 +215,9 @@ class TileGroup : public Printable {
 
   // Refernce to the layout of the TileGroup
   std::shared_ptr<const Layout> tile_group_layout_;
+
+  // built by the GC when the tile group freezes, see CompressedTileGroup
+  std::shared_ptr<const CompressedTileGroup> compressed_columns_;
 };
 
 }  // namespace storage
@@ -34,6 +34,18 @@ class TileGroupFactory {
                                  const std::vector<catalog::Schema> &schemas,
                                  std::shared_ptr<const Layout> layout,
                                  int tuple_count);
+
+  inline static BackendType GetDefaultBackendType() {
+    return default_backend_type_;
+  }
+
+  // backend of the tiles of new tile groups, MM or HUGE_PAGE
+  static void SetDefaultBackendType(const BackendType backend_type) {
+    default_backend_type_ = backend_type;
+  }
+
+ private:
+  static BackendType default_backend_type_;
 };
 
 }  // namespace storage
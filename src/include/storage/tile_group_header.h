@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <cstring>
+#include <memory>
 
 #include "common/item_pointer.h"
 #include "common/macros.h"
@@ -33,30 +34,56 @@ class TileGroup;
 //===--------------------------------------------------------------------===//
 
 struct TupleHeader {
-  common::synchronization::SpinLatch latch;
   std::atomic<txn_id_t> txn_id;
   cid_t read_ts;
   cid_t begin_ts;
   cid_t end_ts;
   ItemPointer next;
   ItemPointer prev;
-  ItemPointer *indirection;
 } __attribute__(());
 //} __attribute__((aligned(64)));
 
 /**
  *  FIELD DESCRIPTIONS:
  *  ===================
- *  latch: Tuple header latch used to acquire ownership or update read_ts
  *  txn_id: serve as a write lock on the tuple version
  *  read_ts: the last txn to read this tuple
  *  begin_ts: the lower bound of the version visibility range.
  *  end_ts: the upper bound of the version visibility range.
  *  next: the pointer pointing to the next (older) version in the version chain.
  *  prev: the pointer pointing to the prev (newer) version in the version chain.
- *  indirection: the pointer pointing to the index entry that holds the address of the version chain header.
+ *
+ *  The latch used to acquire ownership or update read_ts, and the
+ *  indirection pointing to the index entry that holds the address of the
+ *  version chain header, are kept apart from the tuple header, as they
+ *  outlive it when the tile group is frozen.
 */
 
+//===--------------------------------------------------------------------===//
+// Compact Tuple Headers
+//===--------------------------------------------------------------------===//
+
+/**
+ * Tuple headers of a frozen tile group, whose tuples are all committed
+ * versions that every transaction can see. The tuples share a single begin
+ * timestamp, and a bitmap marks the deleted slots, i.e. slots whose version
+ * has been garbage collected.
+ */
+struct CompactTupleHeaders {
+  cid_t begin_ts;
+  std::unique_ptr<uint64_t[]> deleted;
+};
+
+/**
+ * Memory a tile group header no longer uses once it is frozen. Concurrent
+ * transactions may still be reading it, so it must only be released once
+ * they have all ended.
+ */
+struct RetiredTupleHeaders {
+  std::unique_ptr<TupleHeader[]> tuple_headers;
+  std::unique_ptr<CompactTupleHeaders> compact_headers;
+};
+
 //===--------------------------------------------------------------------===//
 // Tile Group Header
 //===--------------------------------------------------------------------===//
@@ -66,6 +93,19 @@ struct TupleHeader {
  * This contains information related to MVCC.
  * It is shared by all tiles in a tile group.
  *
+ * A tile group that is full and whose tuples are visible to every
+ * transaction can be frozen (BeginFreeze, then FinishFreeze once the
+ * transactions active at BeginFreeze have ended). A frozen tile group keeps
+ * compact tuple headers instead of full ones; the first write to any of its
+ * tuples thaws it, i.e. rebuilds the full tuple headers. Reads do not thaw
+ * a frozen tile group: their read_ts is tracked for the whole tile group.
+ *
+ * Independently, the GC marks a tile group whose tuples are all committed
+ * versions no transaction owns as all visible to every transaction whose
+ * read id is at or after the newest begin timestamp among them. Scans of
+ * such a tile group skip the per-tuple visibility checks. Any write to the
+ * tuple headers clears the mark.
+ *
  *  STATUS:
  *  ===================
  *  TxnID == INITIAL_TXN_ID, BeginTS == MAX_CID, EndTS == MAX_CID --> empty version
@@ -108,7 +148,7 @@ class TileGroupHeader : public Printable {
     return *this;
   }
 
-  ~TileGroupHeader() = default;
+  ~TileGroupHeader();
 
   oid_t GetNextEmptyTupleSlot() {
     if (next_tuple_slot >= num_tuple_slots) {
@@ -125,6 +165,26 @@ class TileGroupHeader : public Printable {
     }
   }
 
+  // Reserve up to tuple_count consecutive slots with a single atomic step.
+  // Returns the first reserved slot and sets tuple_count to the # of slots
+  // reserved, or INVALID_OID if there are no slots left.
+  oid_t GetNextEmptyTupleSlots(oid_t &tuple_count) {
+    if (next_tuple_slot >= num_tuple_slots) {
+      return INVALID_OID;
+    }
+
+    oid_t tuple_slot_id =
+        next_tuple_slot.fetch_add(tuple_count, std::memory_order_relaxed);
+
+    if (tuple_slot_id >= num_tuple_slots) {
+      return INVALID_OID;
+    }
+    if (tuple_slot_id + tuple_count > num_tuple_slots) {
+      tuple_count = num_tuple_slots - tuple_slot_id;
+    }
+    return tuple_slot_id;
+  }
+
   /**
    * Used by logging
    */
@@ -167,35 +227,64 @@ class TileGroupHeader : public Printable {
 
   inline common::synchronization::SpinLatch &GetSpinLatch(
       const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].latch;
+    return tuple_latches_[tuple_slot_id];
   }
 
   inline txn_id_t GetTransactionId(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].txn_id;
+    auto tuple_headers = tuple_headers_.load(std::memory_order_acquire);
+    if (likely_branch(tuple_headers != nullptr)) {
+      return tuple_headers[tuple_slot_id].txn_id;
+    }
+    return IsFrozenTupleDeleted(tuple_slot_id) ? INVALID_TXN_ID
+                                               : INITIAL_TXN_ID;
   }
 
   inline cid_t GetLastReaderCommitId(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].read_ts;
+    cid_t read_ts = frozen_read_ts_.load(std::memory_order_acquire);
+    auto tuple_headers = tuple_headers_.load(std::memory_order_acquire);
+    if (likely_branch(tuple_headers != nullptr) &&
+        tuple_headers[tuple_slot_id].read_ts > read_ts) {
+      return tuple_headers[tuple_slot_id].read_ts;
+    }
+    return read_ts;
   }
 
   inline cid_t GetBeginCommitId(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].begin_ts;
+    auto tuple_headers = tuple_headers_.load(std::memory_order_acquire);
+    if (likely_branch(tuple_headers != nullptr)) {
+      return tuple_headers[tuple_slot_id].begin_ts;
+    }
+    return IsFrozenTupleDeleted(tuple_slot_id)
+               ? MAX_CID
+               : compact_headers_.load(std::memory_order_acquire)->begin_ts;
   }
 
   inline cid_t GetEndCommitId(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].end_ts;
+    auto tuple_headers = tuple_headers_.load(std::memory_order_acquire);
+    if (likely_branch(tuple_headers != nullptr)) {
+      return tuple_headers[tuple_slot_id].end_ts;
+    }
+    return MAX_CID;
   }
 
   inline ItemPointer GetNextItemPointer(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].next;
+    auto tuple_headers = tuple_headers_.load(std::memory_order_acquire);
+    if (likely_branch(tuple_headers != nullptr)) {
+      return tuple_headers[tuple_slot_id].next;
+    }
+    return INVALID_ITEMPOINTER;
   }
 
   inline ItemPointer GetPrevItemPointer(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].prev;
+    auto tuple_headers = tuple_headers_.load(std::memory_order_acquire);
+    if (likely_branch(tuple_headers != nullptr)) {
+      return tuple_headers[tuple_slot_id].prev;
+    }
+    return INVALID_ITEMPOINTER;
   }
 
   inline ItemPointer *GetIndirection(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].indirection;
+    return tuple_indirections_[tuple_slot_id];
   }
 
   // Setters
@@ -206,44 +295,118 @@ class TileGroupHeader : public Printable {
 
   inline void SetTransactionId(const oid_t &tuple_slot_id,
                                const txn_id_t &transaction_id) const {
-    tuple_headers_[tuple_slot_id].txn_id = transaction_id;
+    GetWritableTupleHeaders()[tuple_slot_id].txn_id = transaction_id;
+    ClearAllVisible();
   }
 
   inline void SetLastReaderCommitId(const oid_t &tuple_slot_id,
                                     const cid_t &read_cid) const {
-    tuple_headers_[tuple_slot_id].read_ts = read_cid;
+    if (likely_branch(header_mode_.load(std::memory_order_acquire) ==
+                      HeaderMode::FULL)) {
+      tuple_headers_.load(std::memory_order_relaxed)[tuple_slot_id].read_ts =
+          read_cid;
+      return;
+    }
+    // a read does not thaw a frozen tile group
+    RaiseFrozenReadCommitId(read_cid);
   }
 
   inline void SetBeginCommitId(const oid_t &tuple_slot_id,
                                const cid_t &begin_cid) {
-    tuple_headers_[tuple_slot_id].begin_ts = begin_cid;
+    GetWritableTupleHeaders()[tuple_slot_id].begin_ts = begin_cid;
+    ClearAllVisible();
   }
 
   inline void SetEndCommitId(const oid_t &tuple_slot_id,
                              const cid_t &end_cid) const {
-    tuple_headers_[tuple_slot_id].end_ts = end_cid;
+    GetWritableTupleHeaders()[tuple_slot_id].end_ts = end_cid;
+    ClearAllVisible();
   }
 
   inline void SetNextItemPointer(const oid_t &tuple_slot_id,
                                  const ItemPointer &item) const {
-    tuple_headers_[tuple_slot_id].next = item;
+    GetWritableTupleHeaders()[tuple_slot_id].next = item;
   }
 
   inline void SetPrevItemPointer(const oid_t &tuple_slot_id,
                                  const ItemPointer &item) const {
-    tuple_headers_[tuple_slot_id].prev = item;
+    GetWritableTupleHeaders()[tuple_slot_id].prev = item;
   }
 
   inline void SetIndirection(const oid_t &tuple_slot_id,
                              ItemPointer *indirection) const {
-    tuple_headers_[tuple_slot_id].indirection = indirection;
+    tuple_indirections_[tuple_slot_id] = indirection;
   }
 
   inline bool SetAtomicTransactionId(const oid_t &tuple_slot_id,
                                      const txn_id_t &transaction_id) const {
     auto old_val = INITIAL_TXN_ID;
-    return tuple_headers_[tuple_slot_id].txn_id.compare_exchange_strong(
-        old_val, transaction_id);
+    if (GetWritableTupleHeaders()[tuple_slot_id]
+            .txn_id.compare_exchange_strong(old_val, transaction_id)) {
+      ClearAllVisible();
+      return true;
+    }
+    return false;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // All visible mark
+  //===--------------------------------------------------------------------===//
+
+  /**
+   * @brief Mark the tile group as all visible if its tuples up to the next
+   * tuple slot are all committed versions that no transaction owns and
+   * that have not been deleted. Called by the GC.
+   *
+   * @return true if the tile group was marked.
+   */
+  bool MarkAllVisible();
+
+  /**
+   * @brief The newest begin timestamp among the tuples of a tile group
+   * marked as all visible, MAX_CID if it is not marked. A transaction whose
+   * read id is at or after it sees every tuple below tuple_count, and no
+   * transaction owns them.
+   */
+  inline cid_t GetAllVisibleCommitId(oid_t &tuple_count) const {
+    cid_t visible_cid = all_visible_cid_.load(std::memory_order_acquire);
+    if (visible_cid == MAX_CID || visible_cid == INVALID_CID) {
+      return MAX_CID;
+    }
+    tuple_count = all_visible_count_.load(std::memory_order_acquire);
+    // the mark may have been cleared and set again meanwhile
+    if (all_visible_cid_.load(std::memory_order_acquire) != visible_cid) {
+      return MAX_CID;
+    }
+    return visible_cid;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Freezing
+  //===--------------------------------------------------------------------===//
+
+  /**
+   * @brief Start freezing the tile group if it is full and all its tuples
+   * are committed versions that began at or before visible_cid, or empty
+   * slots. Any write to the tile group cancels the freeze.
+   *
+   * @return true if freezing started.
+   */
+  bool BeginFreeze(const cid_t &visible_cid);
+
+  /**
+   * @brief Replace the tuple headers with compact ones, unless the freeze
+   * was cancelled. Must only be called once every transaction that was
+   * active when BeginFreeze was called has ended, and with a visible_cid
+   * below the commit id of every active transaction.
+   *
+   * @return true if the tile group was frozen; retired then holds the
+   * memory to release once the transactions active now have ended.
+   */
+  bool FinishFreeze(const cid_t &visible_cid, RetiredTupleHeaders &retired);
+
+  inline bool IsFrozen() const {
+    return header_mode_.load(std::memory_order_acquire) == HeaderMode::COMPACT;
   }
 
   /*
@@ -277,6 +440,48 @@ class TileGroupHeader : public Printable {
   const std::string GetInfo() const;
 
  private:
+  enum class HeaderMode {
+    FULL,      // tuple_headers_ hold the tuple headers
+    FREEZING,  // like FULL, the tile group waits for FinishFreeze
+    COMPACT    // the tile group is frozen, compact_headers_ hold the headers
+  };
+
+  inline bool IsFrozenTupleDeleted(const oid_t &tuple_slot_id) const {
+    auto compact_headers = compact_headers_.load(std::memory_order_acquire);
+    return (compact_headers->deleted[tuple_slot_id / 64] >>
+            (tuple_slot_id % 64)) & 1;
+  }
+
+  // tuple headers a write may go to
+  inline TupleHeader *GetWritableTupleHeaders() const {
+    if (likely_branch(header_mode_.load(std::memory_order_acquire) ==
+                      HeaderMode::FULL)) {
+      return tuple_headers_.load(std::memory_order_relaxed);
+    }
+    return Thaw();
+  }
+
+  // cancel a freeze in progress, or rebuild the full tuple headers of a
+  // frozen tile group
+  TupleHeader *Thaw() const;
+
+  void RaiseFrozenReadCommitId(const cid_t &read_cid) const;
+
+  // called after a write to a tuple header. the write must be ordered
+  // before the load of the mark, or the GC may mark the tile group without
+  // seeing the write.
+  inline void ClearAllVisible() const {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (unlikely_branch(all_visible_cid_.load(std::memory_order_relaxed) !=
+                        MAX_CID)) {
+      all_visible_cid_.store(MAX_CID, std::memory_order_relaxed);
+    }
+  }
+
+  // whether a tuple header may be frozen
+  static bool IsFreezable(const TupleHeader &tuple_header,
+                          ItemPointer *indirection, const cid_t &visible_cid);
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -287,7 +492,27 @@ class TileGroupHeader : public Printable {
   // Associated tile_group
   TileGroup *tile_group;
 
-  std::unique_ptr<TupleHeader[]> tuple_headers_;
+  // full tuple headers, nullptr while the tile group is frozen
+  mutable std::atomic<TupleHeader *> tuple_headers_;
+
+  // compact tuple headers of the last freeze
+  std::atomic<CompactTupleHeaders *> compact_headers_;
+
+  mutable std::atomic<HeaderMode> header_mode_;
+
+  // newest reader of any tuple since the tile group was last frozen
+  mutable std::atomic<cid_t> frozen_read_ts_;
+
+  // newest begin timestamp of the tuples of an all visible tile group,
+  // MAX_CID if it is not marked, INVALID_CID while the GC is marking it
+  mutable std::atomic<cid_t> all_visible_cid_;
+
+  // # of tuple slots the all visible mark covers
+  std::atomic<oid_t> all_visible_count_;
+
+  std::unique_ptr<common::synchronization::SpinLatch[]> tuple_latches_;
+
+  std::unique_ptr<ItemPointer *[]> tuple_indirections_;
 
   // number of tuple slots allocated
   oid_t num_tuple_slots;
@@ -297,7 +522,11 @@ class TileGroupHeader : public Printable {
   // IT MAY OUT OF BOUNDARY! ALWAYS CHECK IF IT EXCEEDS num_tuple_slots
   std::atomic<oid_t> next_tuple_slot;
 
-  common::synchronization::SpinLatch tile_header_lock;
+  mutable common::synchronization::SpinLatch tile_header_lock;
+
+  // serializes FinishFreeze and Thaw. tile_header_lock is held by callers
+  // of the setters, e.g. recovery, that may have to thaw the tile group.
+  mutable common::synchronization::SpinLatch freeze_latch_;
 
   // Immmutable Flag. Should be set by the indextuner to be true.
   // By default it will be set to false.
@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parallel_for.h
+//
+// Identification: src/include/threadpool/parallel_for.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace peloton {
+namespace threadpool {
+
+/**
+ * @brief Run task(0) ... task(task_count - 1) on the threads of the
+ * execution pool and the calling thread, and return once they have all
+ * run. Tasks run in no particular order, several at once.
+ *
+ * The calling thread runs tasks too, and only waits for the tasks that
+ * are running, so this makes progress even when every thread of the pool
+ * is busy. Rethrows the first exception thrown by a task, once every task
+ * has run.
+ */
+void ParallelFor(size_t task_count, const std::function<void(size_t)> &task);
+
+}  // namespace threadpool
+}  // namespace peloton
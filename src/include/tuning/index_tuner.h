@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <map>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -21,6 +22,10 @@
 
 namespace peloton {
 
+namespace catalog {
+class Schema;
+}
+
 namespace index {
 class Index;
 }
@@ -161,6 +166,62 @@ class IndexTuner {
     write_ratio_threshold = write_ratio_threshold_;
   }
 
+  /**
+   * @brief      Enable or disable workload-aware index type selection.
+   *
+   * @param[in]  index_type_selection_  Whether to select index types
+   */
+  void SetIndexTypeSelection(const bool &index_type_selection_) {
+    index_type_selection = index_type_selection_;
+  }
+
+  /**
+   * @brief      Sets the write ratio above which a latch-free index is used.
+   *
+   * @param[in]  index_type_write_ratio_threshold_  The write ratio threshold
+   */
+  void SetIndexTypeWriteRatioThreshold(
+      const double &index_type_write_ratio_threshold_) {
+    index_type_write_ratio_threshold = index_type_write_ratio_threshold_;
+  }
+
+  /**
+   * @brief      Sets the range ratio above which a scan-friendly index is
+   *             used.
+   *
+   * @param[in]  range_ratio_threshold_  The range ratio threshold
+   */
+  void SetRangeRatioThreshold(const double &range_ratio_threshold_) {
+    range_ratio_threshold = range_ratio_threshold_;
+  }
+
+  /**
+   * @brief      Sets the number of consecutive analyses that must agree on a
+   *             new index type before the index is rebuilt.
+   *
+   * @param[in]  index_type_switch_threshold_  The switch threshold
+   */
+  void SetIndexTypeSwitchThreshold(const oid_t &index_type_switch_threshold_) {
+    index_type_switch_threshold = index_type_switch_threshold_;
+  }
+
+  /**
+   * Choose the index structure that best fits the observed workload on a
+   * set of key attributes.
+   *
+   * Write-heavy keys go to the latch-free BwTree, range-heavy read-mostly keys
+   * to the B+tree and point-lookup-heavy read-mostly keys to ART. Keys that
+   * do not fit in a GenericKey, and attributes without access type
+   * information, keep the BwTree.
+   *
+   * @param[in]  key_schema  The key schema
+   * @param[in]  samples     The samples
+   *
+   * @return     The index type.
+   */
+  IndexType ChooseIndexType(const catalog::Schema *key_schema,
+                            const std::vector<tuning::Sample> &samples) const;
+
   /**
    * Get # of indexes in managed tables
    *
@@ -191,7 +252,19 @@ class IndexTuner {
    * @param[in]  suggested_indices  The suggested indices
    */
   void AddIndexes(storage::DataTable *table,
-                  const std::vector<std::vector<double>> &suggested_indices);
+                  const std::vector<std::vector<double>> &suggested_indices,
+                  const std::vector<tuning::Sample> &samples);
+
+  /**
+   * Start an online rebuild of every ad-hoc index whose structure no longer
+   * fits the workload. The replacement is built in the background by
+   * BuildIndices and swapped in once it covers the whole table.
+   *
+   * @param      table    The table
+   * @param[in]  samples  The samples
+   */
+  void RebuildIndexes(storage::DataTable *table,
+                      const std::vector<tuning::Sample> &samples);
 
   // Index tuning helper
   //
@@ -291,6 +364,29 @@ class IndexTuner {
 
   /** visibility mode */
   bool visibility_mode_ = false;
+
+  //===--------------------------------------------------------------------===//
+  // Index Type Selection
+  //===--------------------------------------------------------------------===//
+
+  /** choose index types based on the workload */
+  bool index_type_selection = true;
+
+  /** write ratio above which the latch-free BwTree is preferred */
+  double index_type_write_ratio_threshold = 0.5;
+
+  /** range ratio above which the B+tree is preferred over ART */
+  double range_ratio_threshold = 0.5;
+
+  /** # of consecutive analyses that must agree before a rebuild */
+  oid_t index_type_switch_threshold = 3;
+
+  /** (table oid, index oid) -> (preferred index type, consecutive votes) */
+  std::map<std::pair<oid_t, oid_t>, std::pair<IndexType, oid_t>>
+      index_type_votes_;
+
+  /** (table oid, replacement index oid) -> index oid being replaced */
+  std::map<std::pair<oid_t, oid_t>, oid_t> pending_rebuilds_;
 };
 
 }  // namespace indextuner
@@ -34,6 +34,15 @@ enum class SampleType {
   UPDATE = 2   /**< updated attributes */
 };
 
+/**
+ * @brief      Class for sample access type.
+ */
+enum class SampleAccessType {
+  INVALID = 0, /**< access pattern not recorded */
+  POINT = 1,   /**< equality lookup on the attributes */
+  RANGE = 2    /**< range or ordered scan on the attributes */
+};
+
 //===--------------------------------------------------------------------===//
 // Sample
 //===--------------------------------------------------------------------===//
@@ -47,7 +56,8 @@ class Sample : public Printable {
       : columns_accessed_(
             std::vector<double>(column_count, DEFAULT_COLUMN_VALUE)),
         weight_(DEFAULT_SAMPLE_WEIGHT),
-        sample_type_(SampleType::ACCESS) {}
+        sample_type_(SampleType::ACCESS),
+        access_type_(SampleAccessType::INVALID) {}
 
   /**
    * @brief      The constructor
@@ -55,13 +65,16 @@ class Sample : public Printable {
    * @param[in]  columns_accessed  The columns accessed
    * @param[in]  weight            The weight
    * @param[in]  sample_type       The sample type
+   * @param[in]  access_type       The access type
    */
   Sample(const std::vector<double> &columns_accessed,
          double weight = DEFAULT_SAMPLE_WEIGHT,
-         SampleType sample_type = SampleType::ACCESS)
+         SampleType sample_type = SampleType::ACCESS,
+         SampleAccessType access_type = SampleAccessType::INVALID)
       : columns_accessed_(columns_accessed),
         weight_(weight),
-        sample_type_(sample_type) {}
+        sample_type_(sample_type),
+        access_type_(access_type) {}
 
   /**
    * get the distance from other sample
@@ -113,6 +126,13 @@ class Sample : public Printable {
    */
   inline SampleType GetSampleType() const { return (sample_type_); }
 
+  /**
+   * Get the access type (point lookup or range scan)
+   *
+   * @return     The access type.
+   */
+  inline SampleAccessType GetAccessType() const { return (access_type_); }
+
   /**
    * @brief      Gets the columns accessed.
    *
@@ -168,6 +188,9 @@ class Sample : public Printable {
   /** type of sample */
   SampleType sample_type_;
 
+  /** access type of sample, not part of the sample identity */
+  SampleAccessType access_type_;
+
 };
 
 }  // namespace indextuner
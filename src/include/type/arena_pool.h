@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena_pool.h
+//
+// Identification: src/include/type/arena_pool.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/synchronization/spin_latch.h"
+#include "type/abstract_pool.h"
+
+namespace peloton {
+namespace type {
+
+//===----------------------------------------------------------------------===//
+//
+// A memory pool that bump allocates from chunks of growing size. Allocation
+// only takes a lock to add a chunk. Memory is released in bulk when the
+// pool is destroyed; freed blocks of up to 4KB may be reused by later
+// allocations of the same size class unless reuse is turned off. Larger
+// blocks are allocated on their own and always released by Free.
+//
+//===----------------------------------------------------------------------===//
+class ArenaPool : public AbstractPool {
+ public:
+  explicit ArenaPool(bool reuse_freed_blocks = true);
+
+  ~ArenaPool();
+
+  void *Allocate(size_t size) override;
+
+  void Free(void *ptr) override;
+
+  // # of bytes held in chunks and large blocks
+  size_t GetChunkSize() const { return chunk_size_; }
+
+ private:
+  struct Chunk {
+    Chunk(Chunk *next, size_t capacity)
+        : next(next), capacity(capacity), used(0) {}
+
+    char *GetData() { return reinterpret_cast<char *>(this + 1); }
+
+    Chunk *next;
+    const size_t capacity;
+    std::atomic<size_t> used;
+  };
+
+  // precedes the header of a block above 4KB, links the large blocks that
+  // are not freed yet
+  struct LargeBlock {
+    LargeBlock(LargeBlock *next, size_t size)
+        : prev(nullptr), next(next), size(size) {}
+
+    LargeBlock *prev;
+    LargeBlock *next;
+    const size_t size;
+  };
+
+  // precedes every block, records what Free may do with it
+  struct BlockHeader {
+    uint32_t size_class;
+    uint32_t padding;
+  };
+
+  struct FreeList {
+    common::synchronization::SpinLatch latch;
+    std::vector<char *> blocks;
+    std::atomic<size_t> block_count;
+  };
+
+  static const size_t MIN_BLOCK_SIZE = 16;
+
+  // 16B, 32B, ... 4KB
+  static const uint32_t SIZE_CLASS_COUNT = 9;
+
+  // size class of large blocks, which are not reused but released
+  static const uint32_t NO_SIZE_CLASS = SIZE_CLASS_COUNT;
+
+  static const size_t MIN_CHUNK_SIZE = 4 * 1024;
+
+  static const size_t MAX_CHUNK_SIZE = 1024 * 1024;
+
+  static uint32_t GetSizeClass(size_t size);
+
+  // take a block from the free list of the size class, if there is one
+  char *TakeFreeBlock(uint32_t size_class);
+
+  // add a chunk with room for at least block_size bytes, unless some other
+  // thread already replaced the full chunk
+  void Grow(Chunk *full_chunk, size_t block_size);
+
+  // memory of its own for a block above 4KB
+  char *AllocateLarge(size_t block_size);
+
+  void FreeLarge(char *block);
+
+  const bool reuse_freed_blocks_;
+
+  // the chunk blocks are carved from
+  std::atomic<Chunk *> current_chunk_;
+
+  // all chunks, protected by chunk_latch_
+  Chunk *chunks_ = nullptr;
+
+  common::synchronization::SpinLatch chunk_latch_;
+
+  // all large blocks, protected by large_block_latch_
+  LargeBlock *large_blocks_ = nullptr;
+
+  common::synchronization::SpinLatch large_block_latch_;
+
+  std::atomic<size_t> chunk_size_;
+
+  FreeList free_lists_[SIZE_CLASS_COUNT];
+};
+
+}  // namespace type
+}  // namespace peloton
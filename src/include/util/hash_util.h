@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstdlib>
 #include <algorithm>
 #include <string>
@@ -53,6 +54,20 @@ class HashUtil {
     return HashBytes((char *) ptr, sizeof(T));
   }
 
+  /**
+   * The finalizer of MurmurHash3: spreads every bit of a 64-bit hash (or of
+   * an integer key) over the whole word, so that both its high and its low
+   * bits can be used to pick a partition, block or slot.
+   */
+  static inline uint64_t MixBits(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
   template<typename T>
   static inline hash_t HashPtr(const T *ptr) {
     return HashBytes((char *) &ptr, sizeof(void *));
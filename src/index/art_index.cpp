@@ -12,10 +12,11 @@
 
 #include "index/art_index.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "common/container_tuple.h"
 #include "index/scan_optimizer.h"
-#include "settings/settings_manager.h"
-#include "statistics/backend_stats_context.h"
 #include "storage/data_table.h"
 #include "storage/storage_manager.h"
 #include "util/portable_endian.h"
@@ -65,11 +66,7 @@ bool ArtIndex::InsertEntry(const storage::Tuple *key, ItemPointer *value) {
   auto thread_info = container_.getThreadInfo();
   container_.insert(tree_key, reinterpret_cast<TID>(value), thread_info);
 
-  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
-          settings::SettingId::stats_mode)) != StatsType::INVALID) {
-    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(
-        GetMetadata());
-  }
+  access_stats.IncrementInserts();
 
   // Update stats
   IncreaseNumberOfTuplesBy(1);
@@ -90,11 +87,7 @@ bool ArtIndex::DeleteEntry(const storage::Tuple *key, ItemPointer *value) {
   if (removed) {
     // Update stats
     DecreaseNumberOfTuplesBy(1);
-    if (static_cast<StatsType>(settings::SettingsManager::GetInt(
-            settings::SettingId::stats_mode)) != StatsType::INVALID) {
-      stats::BackendStatsContext::GetInstance()->IncrementIndexDeletes(
-          1, GetMetadata());
-    }
+    access_stats.IncrementDeletes(1);
   }
 
   return removed;
@@ -114,11 +107,7 @@ bool ArtIndex::CondInsertEntry(const storage::Tuple *key, ItemPointer *value,
   if (inserted) {
     // Update stats
     IncreaseNumberOfTuplesBy(1);
-    if (static_cast<StatsType>(settings::SettingsManager::GetInt(
-            settings::SettingId::stats_mode)) != StatsType::INVALID) {
-      stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(
-          GetMetadata());
-    }
+    access_stats.IncrementInserts();
   }
 
   return inserted;
@@ -135,13 +124,27 @@ void ArtIndex::ScanRange(const storage::Tuple *start, const storage::Tuple *end,
   ScanRange(start_key, end_key, result);
 }
 
+/*
+ * Scan() - Scan the index with the conjunctive scan predicate
+ *
+ * As in BWTreeIndex, only the key range of the scan predicate is used; the
+ * values, key columns and expression types it was built from are ignored.
+ * Conjuncts on non-prefix columns are not filtered here: they would need the
+ * key of every scanned entry loaded back from the table, and the index scan
+ * executor evaluates the full predicate on each visible tuple anyway
+ */
 void ArtIndex::Scan(
     UNUSED_ATTRIBUTE const std::vector<type::Value> &values,
     UNUSED_ATTRIBUTE const std::vector<oid_t> &key_column_ids,
     UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_types,
-    UNUSED_ATTRIBUTE ScanDirectionType scan_direction,
-    std::vector<ItemPointer *> &result,
+    ScanDirectionType scan_direction, std::vector<ItemPointer *> &result,
     const ConjunctionScanPredicate *scan_predicate) {
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  const auto start_size = result.size();
+
   // Perform the appropriate scan based on the scan predicate
   if (scan_predicate->IsFullIndexScan()) {
     ScanAllKeys(result);
@@ -152,14 +155,23 @@ void ArtIndex::Scan(
               result);
   }
 
-  // Update stats
-  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
-          settings::SettingId::stats_mode)) != StatsType::INVALID) {
-    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
-        result.size(), GetMetadata());
+  // The tree only iterates in key order. A backward scan reverses the
+  // qualifying range, which keeps equal keys grouped together.
+  if (scan_direction == ScanDirectionType::BACKWARD) {
+    std::reverse(result.begin() + start_size, result.end());
   }
+
+  // Update stats
+  access_stats.IncrementReads(result.size());
 }
 
+/*
+ * ScanLimit() - Scan the index with predicate and limit/offset
+ *
+ * As in BWTreeIndex, only the "min" case (limit = 1, offset = 0, forward) is
+ * answered directly by the tree; the index cannot check version visibility,
+ * so any other limit/offset is left to the executor after a full Scan()
+ */
 void ArtIndex::ScanLimit(const std::vector<type::Value> &values,
                          const std::vector<oid_t> &key_column_ids,
                          const std::vector<ExpressionType> &expr_types,
@@ -167,15 +179,20 @@ void ArtIndex::ScanLimit(const std::vector<type::Value> &values,
                          std::vector<ItemPointer *> &result,
                          const ConjunctionScanPredicate *scan_predicate,
                          uint64_t limit, uint64_t offset) {
-  (void)values;
-  (void)key_column_ids;
-  (void)expr_types;
-  (void)scan_direction;
-  (void)result;
-  (void)scan_predicate;
-  (void)limit;
-  (void)offset;
-  // This fucking function takes seven fucking arguments ... The fuck?
+  if (scan_predicate->IsPointQuery() == false && limit == 1 && offset == 0 &&
+      scan_direction == ScanDirectionType::FORWARD) {
+    art::Key start_key, end_key;
+    if (scan_predicate->IsFullIndexScan()) {
+      key_constructor_.ConstructMinMaxKey(start_key, end_key);
+    } else {
+      ConstructArtKey(*scan_predicate->GetLowKey(), start_key);
+      ConstructArtKey(*scan_predicate->GetHighKey(), end_key);
+    }
+    ScanRange(start_key, end_key, result, 1);
+  } else {
+    Scan(values, key_column_ids, expr_types, scan_direction, result,
+         scan_predicate);
+  }
 }
 
 void ArtIndex::ScanAllKeys(std::vector<ItemPointer *> &result) {
@@ -202,21 +219,31 @@ void ArtIndex::ScanKey(const storage::Tuple *key,
 
 void ArtIndex::ScanRange(const art::Key &start, const art::Key &end,
                          std::vector<ItemPointer *> &result) {
-  const uint32_t batch_size = 1000;
+  ScanRange(start, end, result, std::numeric_limits<size_t>::max());
+}
+
+void ArtIndex::ScanRange(const art::Key &start, const art::Key &end,
+                         std::vector<ItemPointer *> &result,
+                         size_t max_results) {
+  const uint32_t batch_size =
+      static_cast<uint32_t>(std::min<size_t>(max_results, 1000));
+  const auto start_size = result.size();
   std::vector<TID> tmp_result;
 
   art::Key start_key;
   start_key.setFrom(start);
 
   bool has_more = true;
-  while (has_more) {
+  while (has_more && result.size() - start_size < max_results) {
     art::Key next_start_key;
+    tmp_result.clear();
     auto thread_info = container_.getThreadInfo();
     has_more = container_.lookupRange(start_key, end, next_start_key,
                                       tmp_result, batch_size, thread_info);
 
     // Copy the results to the vector
     for (const auto &tid : tmp_result) {
+      if (result.size() - start_size == max_results) break;
       result.push_back(reinterpret_cast<ItemPointer *>(tid));
     }
 
@@ -225,11 +252,13 @@ void ArtIndex::ScanRange(const art::Key &start, const art::Key &end,
   }
 
   // Update stats
-  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
-          settings::SettingId::stats_mode)) != StatsType::INVALID) {
-    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
-        result.size(), GetMetadata());
-  }
+  access_stats.IncrementReads(result.size() - start_size);
+}
+
+void ArtIndex::PerformGC() {
+  auto freed = container_.performGC();
+  LOG_TRACE("ART index %s reclaimed %zu nodes", GetName().c_str(), freed);
+  (void)freed;
 }
 
 void ArtIndex::SetLoadKeyFunc(art::Tree::LoadKeyFunction load_func, void *ctx) {
@@ -276,39 +305,94 @@ void ArtIndex::KeyConstructor::WriteValue(uint8_t *data, NativeType val) {
   *casted_data = ToBigEndian(FlipSign(val));
 }
 
-// This is specialized for ASCII strings ...
-void ArtIndex::KeyConstructor::WriteAsciiString(uint8_t *data, const char *val,
-                                                uint32_t len) {
-  // Write out the main payload, then tack on the NULL byte terminator
-  PELOTON_MEMCPY(data, val, len);
-  data[len] = '\0';
+void ArtIndex::KeyConstructor::WriteUnsigned(uint8_t *data, uint64_t val) {
+  auto *casted_data = reinterpret_cast<uint64_t *>(data);
+  *casted_data = htobe64(val);
+}
+
+// IEEE-754 doubles compare like sign-magnitude integers: flipping the sign
+// bit orders positive values after negative ones, and flipping all bits of a
+// negative value reverses the magnitude order among negatives
+void ArtIndex::KeyConstructor::WriteDouble(uint8_t *data, double val) {
+  uint64_t bits;
+  PELOTON_MEMCPY(&bits, &val, sizeof(bits));
+  if ((bits >> 63) != 0) {
+    bits = ~bits;
+  } else {
+    bits ^= (1ull << 63);
+  }
+  WriteUnsigned(data, bits);
+}
+
+// Strings are written byte-for-byte, except that every 0x00 byte is escaped
+// as {0x00, 0xFF}. The string is terminated with {0x00, 0x00}, which sorts
+// before any escaped or regular byte, so a string sorts before all strings
+// it is a prefix of. The encoding is therefore byte-comparable for arbitrary
+// binary content (including UTF-8, whose byte order is code point order),
+// and prefix-free, so further key columns can follow it.
+uint32_t ArtIndex::KeyConstructor::EncodedStringLength(const char *val,
+                                                       uint32_t len) {
+  uint32_t encoded_len = len + 2;
+  for (uint32_t i = 0; i < len; i++) {
+    if (val[i] == '\0') encoded_len++;
+  }
+  return encoded_len;
+}
+
+uint32_t ArtIndex::KeyConstructor::WriteString(uint8_t *data, const char *val,
+                                               uint32_t len) {
+  uint32_t offset = 0;
+  for (uint32_t i = 0; i < len; i++) {
+    data[offset++] = static_cast<uint8_t>(val[i]);
+    if (val[i] == '\0') data[offset++] = 0xFF;
+  }
+  data[offset++] = 0x00;
+  data[offset++] = 0x00;
+  return offset;
+}
+
+// VARCHAR lengths include the trailing NULL character, which does not take
+// part in comparisons (see VarlenType)
+uint32_t ArtIndex::KeyConstructor::ComparableLength(const type::Value &val) {
+  uint32_t len = val.GetLength();
+  if (val.GetTypeId() == type::TypeId::VARCHAR && len > 0) len--;
+  return len;
 }
 
 // Constructing an ART tree key from a Peloton input key involves converting it
-// to a binary-comparable format. This method handles the conversion process.
-//   1. For fixed-width integral types, we need to flip the sign and convert to
-//      big-endian format. If the host system is big-endian, the conversion is
-//      elided entirely.
-//   2. For variable length strings, we write out the string and append a NULL
-//      byte indicating the end of the string. The assumption is that NULL
-//      cannot appear in normal strings. True for ASCII, not so for UTF-8.
-//      TODO(pmenon): For UTF-8 strings, we need a third-party library to
-//      generate sort-able text from UTF-8 string.
-//   3. Floats/doubles are more complicated, not done here.
-//   4. NULL is handled using special values.
+// to a binary-comparable format where every column is prefix-free, so that
+// multi-column keys compare column by column. This method handles the
+// conversion process.
+//   1. For fixed-width signed integral types, we need to flip the sign and
+//      convert to big-endian format. If the host system is big-endian, the
+//      conversion is elided entirely. Peloton represents NULL integers with
+//      the type's minimum value, so NULLs sort first.
+//   2. Timestamps are unsigned and are only converted to big-endian.
+//   3. Decimals (doubles) are converted with WriteDouble().
+//   4. For variable length values, we write a NULL indicator byte (0 for
+//      NULL, 1 otherwise) followed by the escaped, terminated payload (see
+//      WriteString()).
 void ArtIndex::KeyConstructor::ConstructKey(const AbstractTuple &input_key,
                                             art::Key &tree_key) const {
+  const uint32_t num_cols = key_schema_.GetColumnCount();
+
   // First calculate length of this key
   uint32_t key_len = 0;
-  for (uint32_t i = 0; i < key_schema_.GetColumnCount(); i++) {
-    auto col_info = key_schema_.GetColumn(i);
-    if (col_info.IsInlined()) {
-      key_len += col_info.GetFixedLength();
-    } else {
-      key_len += input_key.GetValue(i).GetLength();
-      if (col_info.GetType() == type::TypeId::VARCHAR) {
-        // Need to append NULL character
-        key_len++;
+  for (uint32_t i = 0; i < num_cols; i++) {
+    const auto &col_info = key_schema_.GetColumn(i);
+    switch (col_info.GetType()) {
+      case type::TypeId::VARCHAR:
+      case type::TypeId::VARBINARY: {
+        auto val = input_key.GetValue(i);
+        key_len += 1;
+        if (!val.IsNull()) {
+          key_len += EncodedStringLength(val.GetData(), ComparableLength(val));
+        }
+        break;
+      }
+      default: {
+        key_len += col_info.GetFixedLength();
+        break;
       }
     }
   }
@@ -318,8 +402,8 @@ void ArtIndex::KeyConstructor::ConstructKey(const AbstractTuple &input_key,
   uint8_t *data = &tree_key[0];
 
   uint32_t offset = 0;
-  for (uint32_t i = 0; i < key_schema_.GetColumnCount(); i++) {
-    auto column = key_schema_.GetColumn(i);
+  for (uint32_t i = 0; i < num_cols; i++) {
+    const auto &column = key_schema_.GetColumn(i);
     switch (column.GetType()) {
       case type::TypeId::BOOLEAN:
       case type::TypeId::TINYINT: {
@@ -341,19 +425,34 @@ void ArtIndex::KeyConstructor::ConstructKey(const AbstractTuple &input_key,
         offset += sizeof(int32_t);
         break;
       }
-      case type::TypeId::TIMESTAMP:
       case type::TypeId::BIGINT: {
         auto raw = type::ValuePeeker::PeekBigInt(input_key.GetValue(i));
         WriteValue<int64_t>(data + offset, raw);
         offset += sizeof(int64_t);
         break;
       }
-      case type::TypeId::VARCHAR: {
-        auto varchar_val = input_key.GetValue(i);
-        auto raw = type::ValuePeeker::PeekVarchar(varchar_val);
-        auto raw_len = varchar_val.GetLength();
-        WriteAsciiString(data + offset, raw, raw_len);
-        offset += raw_len;
+      case type::TypeId::TIMESTAMP: {
+        auto raw = type::ValuePeeker::PeekTimestamp(input_key.GetValue(i));
+        WriteUnsigned(data + offset, raw);
+        offset += sizeof(uint64_t);
+        break;
+      }
+      case type::TypeId::DECIMAL: {
+        auto raw = type::ValuePeeker::PeekDouble(input_key.GetValue(i));
+        WriteDouble(data + offset, raw);
+        offset += sizeof(double);
+        break;
+      }
+      case type::TypeId::VARCHAR:
+      case type::TypeId::VARBINARY: {
+        auto varlen_val = input_key.GetValue(i);
+        if (varlen_val.IsNull()) {
+          data[offset++] = 0x00;
+        } else {
+          data[offset++] = 0x01;
+          offset += WriteString(data + offset, varlen_val.GetData(),
+                                ComparableLength(varlen_val));
+        }
         break;
       }
       default: {
@@ -365,6 +464,7 @@ void ArtIndex::KeyConstructor::ConstructKey(const AbstractTuple &input_key,
       }
     }
   }
+  PELOTON_ASSERT(offset == key_len);
 }
 
 void ArtIndex::KeyConstructor::ConstructMinMaxKey(art::Key &min_key,
@@ -0,0 +1,280 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bplustree_index.cpp
+//
+// Identification: src/index/bplustree_index.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "index/bplustree_index.h"
+
+#include "index/index_key.h"
+#include "index/scan_optimizer.h"
+#include "statistics/stats_aggregator.h"
+
+namespace peloton {
+namespace index {
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(IndexMetadata *metadata)
+    :  // Base class
+      Index{metadata},
+      // Key "less than" relation comparator
+      comparator{},
+      // Key equality checker
+      equals{},
+      container{comparator, equals} {
+  return;
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+BPLUSTREE_INDEX_TYPE::~BPlusTreeIndex() {}
+
+/*
+ * InsertEntry() - insert a key-value pair into the map
+ *
+ * If the key value pair already exists in the map, just return false
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::InsertEntry(const storage::Tuple *key,
+                                       ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = container.Insert(index_key, value, HasUniqueKeys());
+
+  access_stats.IncrementInserts();
+
+  LOG_TRACE("InsertEntry(key=%s, val=%s) [%s]",
+            key->GetInfo().c_str(),
+            IndexUtil::GetInfo(value).c_str(),
+            (ret ? "SUCCESS" : "FAIL"));
+
+  return ret;
+}
+
+/*
+ * DeleteEntry() - Removes a key-value pair
+ *
+ * If the key-value pair does not exists yet in the map return false
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::DeleteEntry(const storage::Tuple *key,
+                                       ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = container.Delete(index_key, value);
+
+  access_stats.IncrementDeletes(ret ? 1 : 0);
+
+  LOG_TRACE("DeleteEntry(key=%s, val=%s) [%s]",
+            key->GetInfo().c_str(),
+            IndexUtil::GetInfo(value).c_str(),
+            (ret ? "SUCCESS" : "FAIL"));
+
+  return ret;
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::CondInsertEntry(
+    const storage::Tuple *key, ItemPointer *value,
+    std::function<bool(const void *)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool predicate_satisfied = false;
+
+  // The predicate check and the insert happen under the same leaf latches
+  bool ret = container.ConditionalInsert(index_key, value, predicate,
+                                         &predicate_satisfied);
+
+  if (predicate_satisfied == true) {
+    PELOTON_ASSERT(ret == false);
+  }
+
+  access_stats.IncrementInserts();
+
+  return ret;
+}
+
+/*
+ * Scan() - Scans a range inside the index using index scan optimizer
+ *
+ * The scan optimizer specifies whether a scan is point query, full scan
+ * or interval scan. For all of these cases the corresponding functions from
+ * the index is called, and all elements are returned in result vector
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::Scan(
+    UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
+    UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
+    UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p) {
+  // Same as BwTree - we do not support backward scan
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  LOG_TRACE("Scan() Point Query = %d; Full Scan = %d ", csp_p->IsPointQuery(),
+            csp_p->IsFullIndexScan());
+
+  if (csp_p->IsPointQuery() == true) {
+    const storage::Tuple *point_query_key_p = csp_p->GetPointQueryKey();
+
+    KeyType point_query_key;
+    point_query_key.SetFromKey(point_query_key_p);
+
+    container.GetValue(point_query_key, result);
+  } else if (csp_p->IsFullIndexScan() == true) {
+    container.ScanForward(nullptr,
+                          [&result](const KeyType &, const ValueType &value) {
+                            result.push_back(value);
+                            return true;
+                          });
+  } else {
+    const storage::Tuple *low_key_p = csp_p->GetLowKey();
+    const storage::Tuple *high_key_p = csp_p->GetHighKey();
+
+    LOG_TRACE("Partial scan low key: %s\n high key: %s",
+              low_key_p->GetInfo().c_str(), high_key_p->GetInfo().c_str());
+
+    KeyType index_low_key;
+    KeyType index_high_key;
+    index_low_key.SetFromKey(low_key_p);
+    index_high_key.SetFromKey(high_key_p);
+
+    // Start at the lower bound and stop at the first key above the high key
+    container.ScanForward(
+        &index_low_key,
+        [this, &result, &index_high_key](const KeyType &key,
+                                         const ValueType &value) {
+          if (container.KeyCmpLessEqual(key, index_high_key) == false) {
+            return false;
+          }
+          result.push_back(value);
+          return true;
+        });
+  }  // if is full scan
+
+  access_stats.IncrementReads(result.size());
+
+  return;
+}
+
+/*
+ * ScanLimit() - Scan the index with predicate and limit/offset
+ *
+ * Mirrors BWTreeIndex::ScanLimit(): only the "min" case (limit = 1,
+ * offset = 0, forward) is answered directly from the index. All other cases
+ * fall back to Scan() since the index cannot check version visibility and
+ * therefore cannot apply offset itself
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanLimit(
+    const std::vector<type::Value> &value_list,
+    const std::vector<oid_t> &tuple_column_id_list,
+    const std::vector<ExpressionType> &expr_list,
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p, uint64_t limit, uint64_t offset) {
+  if (csp_p->IsPointQuery() == false && limit == 1 && offset == 0 &&
+      scan_direction == ScanDirectionType::FORWARD) {
+    const storage::Tuple *low_key_p = csp_p->GetLowKey();
+    const storage::Tuple *high_key_p = csp_p->GetHighKey();
+
+    LOG_TRACE("ScanLimit() special case (limit = 1; offset = 0; ASCENDING): %s",
+              low_key_p->GetInfo().c_str());
+
+    KeyType index_low_key;
+    KeyType index_high_key;
+    index_low_key.SetFromKey(low_key_p);
+    index_high_key.SetFromKey(high_key_p);
+
+    container.ScanForward(
+        &index_low_key,
+        [this, &result, &index_high_key](const KeyType &key,
+                                         const ValueType &value) {
+          if (container.KeyCmpLessEqual(key, index_high_key) == true) {
+            result.push_back(value);
+          }
+          return false;
+        });
+  } else {
+    Scan(value_list, tuple_column_id_list, expr_list, scan_direction, result,
+         csp_p);
+  }
+
+  return;
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanAllKeys(std::vector<ValueType> &result) {
+  container.ScanForward(nullptr,
+                        [&result](const KeyType &, const ValueType &value) {
+                          result.push_back(value);
+                          return true;
+                        });
+
+  access_stats.IncrementReads(result.size());
+  return;
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKey(const storage::Tuple *key,
+                                   std::vector<ValueType> &result) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container.GetValue(index_key, result);
+
+  access_stats.IncrementReads(result.size());
+
+  return;
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+std::string BPLUSTREE_INDEX_TYPE::GetTypeName() const { return "BPlusTree"; }
+
+// IMPORTANT: Make sure you don't exceed CompactIntegerKey_MAX_SLOTS
+
+template class BPlusTreeIndex<
+    CompactIntsKey<1>, ItemPointer *, CompactIntsComparator<1>,
+    CompactIntsEqualityChecker<1>, ItemPointerComparator>;
+template class BPlusTreeIndex<
+    CompactIntsKey<2>, ItemPointer *, CompactIntsComparator<2>,
+    CompactIntsEqualityChecker<2>, ItemPointerComparator>;
+template class BPlusTreeIndex<
+    CompactIntsKey<3>, ItemPointer *, CompactIntsComparator<3>,
+    CompactIntsEqualityChecker<3>, ItemPointerComparator>;
+template class BPlusTreeIndex<
+    CompactIntsKey<4>, ItemPointer *, CompactIntsComparator<4>,
+    CompactIntsEqualityChecker<4>, ItemPointerComparator>;
+
+// Generic key
+template class BPlusTreeIndex<GenericKey<4>, ItemPointer *,
+                              FastGenericComparator<4>,
+                              GenericEqualityChecker<4>, ItemPointerComparator>;
+template class BPlusTreeIndex<GenericKey<8>, ItemPointer *,
+                              FastGenericComparator<8>,
+                              GenericEqualityChecker<8>, ItemPointerComparator>;
+template class BPlusTreeIndex<
+    GenericKey<16>, ItemPointer *, FastGenericComparator<16>,
+    GenericEqualityChecker<16>, ItemPointerComparator>;
+template class BPlusTreeIndex<
+    GenericKey<64>, ItemPointer *, FastGenericComparator<64>,
+    GenericEqualityChecker<64>, ItemPointerComparator>;
+template class BPlusTreeIndex<
+    GenericKey<256>, ItemPointer *, FastGenericComparator<256>,
+    GenericEqualityChecker<256>, ItemPointerComparator>;
+
+// NOTE: There is no TupleKey instantiation. TupleKey holds pointers that
+// optimistic readers could dereference while torn; the factory falls back to
+// BwTree for keys wider than GenericKey<256>
+
+}  // namespace index
+}  // namespace peloton
@@ -15,7 +15,6 @@
 #include "index/index_key.h"
 #include "index/scan_optimizer.h"
 #include "statistics/stats_aggregator.h"
-#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace index {
@@ -60,9 +59,7 @@ bool BWTREE_INDEX_TYPE::InsertEntry(const storage::Tuple *key,
     ret = container.Insert(index_key, value, false);
   }
 
-  if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) != StatsType::INVALID) {
-    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
-  }
+  access_stats.IncrementInserts();
 
   // NOTE: If I use index_key.GetInfo() here, I always get an empty key?
   LOG_TRACE("InsertEntry(key=%s, val=%s) [%s]",
@@ -90,10 +87,7 @@ bool BWTREE_INDEX_TYPE::DeleteEntry(const storage::Tuple *key,
   // it is unnecessary for us to allocate memory
   bool ret = container.Delete(index_key, value);
 
-  if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) != StatsType::INVALID) {
-    stats::BackendStatsContext::GetInstance()->IncrementIndexDeletes(
-        delete_count, metadata);
-  }
+  access_stats.IncrementDeletes(delete_count);
 
   LOG_TRACE("DeleteEntry(key=%s, val=%s) [%s]",
             key->GetInfo().c_str(),
@@ -126,9 +120,7 @@ bool BWTREE_INDEX_TYPE::CondInsertEntry(
     assert(ret == false);
   }
 
-  if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) != StatsType::INVALID) {
-    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
-  }
+  access_stats.IncrementInserts();
 
   return ret;
 }
@@ -200,10 +192,7 @@ void BWTREE_INDEX_TYPE::Scan(
     }
   }  // if is full scan
 
-  if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) != StatsType::INVALID) {
-    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
-        result.size(), metadata);
-  }
+  access_stats.IncrementReads(result.size());
 
   return;
 }
@@ -267,10 +256,7 @@ void BWTREE_INDEX_TYPE::ScanAllKeys(std::vector<ValueType> &result) {
     it++;
   }
 
-  if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) != StatsType::INVALID) {
-    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
-        result.size(), metadata);
-  }
+  access_stats.IncrementReads(result.size());
   return;
 }
 
@@ -283,10 +269,7 @@ void BWTREE_INDEX_TYPE::ScanKey(const storage::Tuple *key,
   // This function in BwTree fills a given vector
   container.GetValue(index_key, result);
 
-  if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) != StatsType::INVALID) {
-    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
-        result.size(), metadata);
-  }
+  access_stats.IncrementReads(result.size());
 
   return;
 }
@@ -120,7 +120,9 @@ const std::string IndexMetadata::GetInfo() const {
 // caller, the Index object owns that metadata and is responsible for
 // destructing the metadata object on its own destruction
 Index::Index(IndexMetadata *metadata)
-    : metadata(metadata), indexed_tile_group_offset(0) {
+    : metadata(metadata),
+      access_stats(metadata),
+      indexed_tile_group_offset(0) {
   // This is redundant
   index_oid = metadata->GetOid();
 
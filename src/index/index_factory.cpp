@@ -17,6 +17,7 @@
 #include "common/logger.h"
 #include "common/macros.h"
 #include "index/art_index.h"
+#include "index/bplustree_index.h"
 #include "index/bwtree_index.h"
 #include "index/index_key.h"
 #include "index/skiplist_index.h"
@@ -83,6 +84,16 @@ Index *IndexFactory::GetIndex(IndexMetadata *metadata) {
   } else if (index_type == IndexType::ART) {
     index = new ArtIndex(metadata);
 
+    // -----------------------
+    // B+TREE (OLC)
+    // -----------------------
+  } else if (index_type == IndexType::BPLUSTREE) {
+    if (ints_only) {
+      index = IndexFactory::GetBPlusTreeIntsKeyIndex(metadata);
+    } else {
+      index = IndexFactory::GetBPlusTreeGenericKeyIndex(metadata);
+    }
+
     // -----------------------
     // ERROR
     // -----------------------
@@ -353,6 +364,128 @@ Index *IndexFactory::GetSkipListGenericKeyIndex(IndexMetadata *metadata) {
   return index;
 }
 
+Index *IndexFactory::GetBPlusTreeIntsKeyIndex(IndexMetadata *metadata) {
+  // Our new Index!
+  Index *index = nullptr;
+
+  // The size of the key in bytes
+  const auto key_size = metadata->key_schema->GetLength();
+
+// Debug Output
+#ifdef LOG_TRACE_ENABLED
+  std::string comparatorType;
+#endif
+
+  if (key_size <= sizeof(uint64_t)) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "CompactIntsKey<1>";
+#endif
+    index = new BPlusTreeIndex<CompactIntsKey<1>, ItemPointer *,
+                               CompactIntsComparator<1>,
+                               CompactIntsEqualityChecker<1>,
+                               ItemPointerComparator>(metadata);
+  } else if (key_size <= sizeof(uint64_t) * 2) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "CompactIntsKey<2>";
+#endif
+    index = new BPlusTreeIndex<CompactIntsKey<2>, ItemPointer *,
+                               CompactIntsComparator<2>,
+                               CompactIntsEqualityChecker<2>,
+                               ItemPointerComparator>(metadata);
+  } else if (key_size <= sizeof(uint64_t) * 3) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "CompactIntsKey<3>";
+#endif
+    index = new BPlusTreeIndex<CompactIntsKey<3>, ItemPointer *,
+                               CompactIntsComparator<3>,
+                               CompactIntsEqualityChecker<3>,
+                               ItemPointerComparator>(metadata);
+  } else if (key_size <= sizeof(uint64_t) * 4) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "CompactIntsKey<4>";
+#endif
+    index = new BPlusTreeIndex<CompactIntsKey<4>, ItemPointer *,
+                               CompactIntsComparator<4>,
+                               CompactIntsEqualityChecker<4>,
+                               ItemPointerComparator>(metadata);
+  } else {
+    throw IndexException("Unsupported IntsKey scheme");
+  }
+
+#ifdef LOG_TRACE_ENABLED
+  LOG_TRACE("%s", IndexFactory::GetInfo(metadata, comparatorType).c_str());
+#endif
+
+  return index;
+}
+
+Index *IndexFactory::GetBPlusTreeGenericKeyIndex(IndexMetadata *metadata) {
+  // Our new Index!
+  Index *index = nullptr;
+
+  // The size of the key in bytes
+  const auto key_size = metadata->key_schema->GetLength();
+
+// Debug Output
+#ifdef LOG_TRACE_ENABLED
+  std::string comparatorType;
+#endif
+
+  if (key_size <= 4) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "GenericKey<4>";
+#endif
+    index = new BPlusTreeIndex<GenericKey<4>, ItemPointer *,
+                               FastGenericComparator<4>,
+                               GenericEqualityChecker<4>,
+                               ItemPointerComparator>(metadata);
+  } else if (key_size <= 8) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "GenericKey<8>";
+#endif
+    index = new BPlusTreeIndex<GenericKey<8>, ItemPointer *,
+                               FastGenericComparator<8>,
+                               GenericEqualityChecker<8>,
+                               ItemPointerComparator>(metadata);
+  } else if (key_size <= 16) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "GenericKey<16>";
+#endif
+    index = new BPlusTreeIndex<GenericKey<16>, ItemPointer *,
+                               FastGenericComparator<16>,
+                               GenericEqualityChecker<16>,
+                               ItemPointerComparator>(metadata);
+  } else if (key_size <= 64) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "GenericKey<64>";
+#endif
+    index = new BPlusTreeIndex<GenericKey<64>, ItemPointer *,
+                               FastGenericComparator<64>,
+                               GenericEqualityChecker<64>,
+                               ItemPointerComparator>(metadata);
+  } else if (key_size <= 256) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "GenericKey<256>";
+#endif
+    index = new BPlusTreeIndex<GenericKey<256>, ItemPointer *,
+                               FastGenericComparator<256>,
+                               GenericEqualityChecker<256>,
+                               ItemPointerComparator>(metadata);
+  } else {
+    // TupleKey cannot be read optimistically (see bplustree.h), so wide keys
+    // are served by BwTree instead
+    LOG_DEBUG("Key of %u bytes is too wide for BPlusTree, using BwTree",
+              static_cast<uint32_t>(key_size));
+    return IndexFactory::GetBwTreeGenericKeyIndex(metadata);
+  }
+
+#ifdef LOG_TRACE_ENABLED
+  LOG_TRACE("%s", IndexFactory::GetInfo(metadata, comparatorType).c_str());
+#endif
+
+  return index;
+}
+
 std::string IndexFactory::GetInfo(IndexMetadata *metadata,
                                   const std::string &comparator_type) {
   std::ostringstream os;
@@ -0,0 +1,39 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_bench.cpp
+//
+// Identification: src/main/index_bench/index_bench.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/index_bench/index_bench_configuration.h"
+#include "benchmark/index_bench/index_bench_workload.h"
+
+namespace peloton {
+namespace benchmark {
+namespace index_bench {
+
+configuration state;
+
+// Main Entry Point
+void RunBenchmark(int argc, char **argv) {
+  // Parse arguments
+  ParseArguments(argc, argv, state);
+
+  // Run the workload against every index
+  RunBenchmark();
+}
+
+}  // namespace index_bench
+}  // namespace benchmark
+}  // namespace peloton
+
+int main(int argc, char **argv) {
+  peloton::benchmark::index_bench::RunBenchmark(argc, argv);
+
+  return 0;
+}
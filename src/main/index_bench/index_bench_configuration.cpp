@@ -0,0 +1,291 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_bench_configuration.cpp
+//
+// Identification: src/main/index_bench/index_bench_configuration.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <getopt.h>
+#include <sstream>
+
+#include "benchmark/index_bench/index_bench_configuration.h"
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace peloton {
+namespace benchmark {
+namespace index_bench {
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "Command line options : index_bench <options> \n"
+          "   -h --help              :  print help message \n"
+          "   -i --index             :  comma separated index types "
+          "(bwtree, bplustree, art, skiplist) \n"
+          "   -b --backend_count     :  comma separated # of threads \n"
+          "   -c --key_columns       :  # of BIGINT key columns (1-4) \n"
+          "   -g --generic_key_size  :  VARCHAR key width, 0 for integer keys \n"
+          "   -k --key_count         :  # of keys loaded before the run \n"
+          "   -o --operation_count   :  # of operations per thread \n"
+          "   -l --scan_length       :  # of keys covered by a range scan \n"
+          "   -d --distribution      :  uniform or zipfian \n"
+          "   -z --zipf_theta        :  skew of the zipfian distribution \n"
+          "   -m --mix               :  insert, read, read_mostly or scan \n"
+          "   -v --verify            :  check lookups before timing \n");
+}
+
+static struct option opts[] = {
+    {"index", required_argument, NULL, 'i'},
+    {"backend_count", required_argument, NULL, 'b'},
+    {"key_columns", required_argument, NULL, 'c'},
+    {"generic_key_size", required_argument, NULL, 'g'},
+    {"key_count", required_argument, NULL, 'k'},
+    {"operation_count", required_argument, NULL, 'o'},
+    {"scan_length", required_argument, NULL, 'l'},
+    {"distribution", required_argument, NULL, 'd'},
+    {"zipf_theta", required_argument, NULL, 'z'},
+    {"mix", required_argument, NULL, 'm'},
+    {"verify", no_argument, NULL, 'v'},
+    {NULL, 0, NULL, 0}};
+
+std::string KeyDistributionToString(KeyDistribution distribution) {
+  switch (distribution) {
+    case KeyDistribution::UNIFORM:
+      return "uniform";
+    case KeyDistribution::ZIPFIAN:
+      return "zipfian";
+  }
+  return "invalid";
+}
+
+std::string OperationMixToString(OperationMix operation_mix) {
+  switch (operation_mix) {
+    case OperationMix::INSERT_ONLY:
+      return "insert";
+    case OperationMix::READ_ONLY:
+      return "read";
+    case OperationMix::READ_MOSTLY:
+      return "read_mostly";
+    case OperationMix::SCAN_HEAVY:
+      return "scan";
+  }
+  return "invalid";
+}
+
+static std::vector<std::string> SplitList(const std::string &list) {
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty() == false) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+static void ParseIndexTypes(const std::string &list, configuration &state) {
+  state.index_types.clear();
+  for (auto &item : SplitList(list)) {
+    IndexType index_type = IndexType::INVALID;
+    try {
+      index_type = StringToIndexType(item);
+    } catch (ConversionException &e) {
+      index_type = IndexType::INVALID;
+    }
+
+    // There is no hash index behind IndexType::HASH
+    if (index_type == IndexType::INVALID || index_type == IndexType::HASH) {
+      LOG_ERROR("Invalid index type :: %s", item.c_str());
+      exit(EXIT_FAILURE);
+    }
+    if (index_type == IndexType::SKIPLIST) {
+      LOG_WARN("The skip list index is not implemented, its numbers are void");
+    }
+    state.index_types.push_back(index_type);
+  }
+}
+
+static void ParseBackendCounts(const std::string &list, configuration &state) {
+  state.backend_counts.clear();
+  for (auto &item : SplitList(list)) {
+    auto backend_count = std::stoi(item);
+    if (backend_count <= 0) {
+      LOG_ERROR("Invalid backend_count :: %d", backend_count);
+      exit(EXIT_FAILURE);
+    }
+    state.backend_counts.push_back(backend_count);
+  }
+}
+
+static void ValidateKey(const configuration &state) {
+  if (state.generic_key_size == 0 &&
+      (state.key_column_count < 1 || state.key_column_count > 4)) {
+    LOG_ERROR("Invalid key_columns :: %d", state.key_column_count);
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.generic_key_size < 0 || state.generic_key_size > 255) {
+    LOG_ERROR("Invalid generic_key_size :: %d", state.generic_key_size);
+    exit(EXIT_FAILURE);
+  }
+
+  // Keys are zero padded decimal strings, they must be able to hold the
+  // largest key id
+  if (state.generic_key_size != 0 && state.generic_key_size < 20) {
+    LOG_ERROR("generic_key_size must be at least 20 :: %d",
+              state.generic_key_size);
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void ValidateWorkload(const configuration &state) {
+  if (state.key_count == 0) {
+    LOG_ERROR("Invalid key_count :: %lu", state.key_count);
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.operation_count == 0) {
+    LOG_ERROR("Invalid operation_count :: %lu", state.operation_count);
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.scan_length == 0) {
+    LOG_ERROR("Invalid scan_length :: %lu", state.scan_length);
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.zipf_theta <= 0 || state.zipf_theta >= 1) {
+    LOG_ERROR("Invalid zipf_theta :: %.2lf", state.zipf_theta);
+    exit(EXIT_FAILURE);
+  }
+}
+
+void ParseArguments(int argc, char *argv[], configuration &state) {
+  // Default Values
+  state.index_types = {IndexType::BWTREE, IndexType::BPLUSTREE,
+                       IndexType::ART};
+  state.backend_counts = {1, 2, 4, 8};
+  state.key_column_count = 1;
+  state.generic_key_size = 0;
+  state.key_count = 1000000;
+  state.operation_count = 1000000;
+  state.scan_length = 100;
+  state.distribution = KeyDistribution::UNIFORM;
+  state.zipf_theta = 0.99;
+  state.operation_mix = OperationMix::READ_MOSTLY;
+  state.verify = false;
+
+  // Parse args
+  while (1) {
+    int idx = 0;
+    int c = getopt_long(argc, argv, "hi:b:c:g:k:o:l:d:z:m:v", opts, &idx);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'i':
+        ParseIndexTypes(optarg, state);
+        break;
+      case 'b':
+        ParseBackendCounts(optarg, state);
+        break;
+      case 'c':
+        state.key_column_count = atoi(optarg);
+        break;
+      case 'g':
+        state.generic_key_size = atoi(optarg);
+        break;
+      case 'k':
+        state.key_count = atol(optarg);
+        break;
+      case 'o':
+        state.operation_count = atol(optarg);
+        break;
+      case 'l':
+        state.scan_length = atol(optarg);
+        break;
+      case 'd': {
+        std::string distribution = optarg;
+        if (distribution == "uniform") {
+          state.distribution = KeyDistribution::UNIFORM;
+        } else if (distribution == "zipfian") {
+          state.distribution = KeyDistribution::ZIPFIAN;
+        } else {
+          LOG_ERROR("Invalid distribution :: %s", optarg);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      }
+      case 'z':
+        state.zipf_theta = atof(optarg);
+        break;
+      case 'm': {
+        std::string operation_mix = optarg;
+        if (operation_mix == "insert") {
+          state.operation_mix = OperationMix::INSERT_ONLY;
+        } else if (operation_mix == "read") {
+          state.operation_mix = OperationMix::READ_ONLY;
+        } else if (operation_mix == "read_mostly") {
+          state.operation_mix = OperationMix::READ_MOSTLY;
+        } else if (operation_mix == "scan") {
+          state.operation_mix = OperationMix::SCAN_HEAVY;
+        } else {
+          LOG_ERROR("Invalid mix :: %s", optarg);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      }
+      case 'v':
+        state.verify = true;
+        break;
+      case 'h':
+        Usage(stderr);
+        exit(EXIT_FAILURE);
+        break;
+
+      default:
+        LOG_ERROR("Unknown option: -%c-", c);
+        Usage(stderr);
+        exit(EXIT_FAILURE);
+        break;
+    }
+  }
+
+  if (state.index_types.empty() || state.backend_counts.empty()) {
+    Usage(stderr);
+    exit(EXIT_FAILURE);
+  }
+
+  ValidateKey(state);
+  ValidateWorkload(state);
+
+  std::string index_types;
+  for (auto index_type : state.index_types) {
+    index_types += IndexTypeToString(index_type) + " ";
+  }
+  LOG_INFO("%s : %s", "index", index_types.c_str());
+  if (state.generic_key_size == 0) {
+    LOG_INFO("%s : %d BIGINT column(s)", "key", state.key_column_count);
+  } else {
+    LOG_INFO("%s : VARCHAR(%d)", "key", state.generic_key_size);
+  }
+  LOG_INFO("%s : %lu", "key_count", state.key_count);
+  LOG_INFO("%s : %lu", "operation_count", state.operation_count);
+  LOG_INFO("%s : %lu", "scan_length", state.scan_length);
+  LOG_INFO("%s : %s (theta %.2lf)", "distribution",
+           KeyDistributionToString(state.distribution).c_str(),
+           state.zipf_theta);
+  LOG_INFO("%s : %s", "mix",
+           OperationMixToString(state.operation_mix).c_str());
+  LOG_INFO("%s : %d", "verify", state.verify);
+}
+
+}  // namespace index_bench
+}  // namespace benchmark
+}  // namespace peloton
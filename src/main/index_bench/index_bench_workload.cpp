@@ -0,0 +1,520 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_bench_workload.cpp
+//
+// Identification: src/main/index_bench/index_bench_workload.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/index_bench/index_bench_workload.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "catalog/column.h"
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "gc/gc_manager_factory.h"
+#include "index/index.h"
+#include "index/index_factory.h"
+#include "index/scan_optimizer.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/table_factory.h"
+#include "storage/tuple.h"
+#include "type/ephemeral_pool.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace benchmark {
+namespace index_bench {
+
+//===--------------------------------------------------------------------===//
+// Zipfian Distribution
+//===--------------------------------------------------------------------===//
+
+ZipfDistribution::ZipfDistribution(uint64_t n, double theta)
+    : n_(n), theta_(theta), uniform_(0.0, 1.0) {
+  alpha_ = 1.0 / (1.0 - theta_);
+  zetan_ = Zeta(n_, theta_);
+  eta_ = (1.0 - std::pow(2.0 / n_, 1.0 - theta_)) /
+         (1.0 - Zeta(2, theta_) / zetan_);
+}
+
+double ZipfDistribution::Zeta(uint64_t n, double theta) {
+  double sum = 0;
+  for (uint64_t i = 1; i <= n; i++) {
+    sum += 1.0 / std::pow(static_cast<double>(i), theta);
+  }
+  return sum;
+}
+
+uint64_t ZipfDistribution::GetNextNumber(std::mt19937_64 &rng) {
+  double u = uniform_(rng);
+  double uz = u * zetan_;
+
+  uint64_t rank;
+  if (uz < 1.0) {
+    rank = 0;
+  } else if (uz < 1.0 + std::pow(0.5, theta_)) {
+    rank = 1;
+  } else {
+    rank = static_cast<uint64_t>(n_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+  }
+
+  // Scramble (FNV-1a over the bytes of the rank)
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (int byte_itr = 0; byte_itr < 8; byte_itr++) {
+    hash ^= (rank >> (byte_itr * 8)) & 0xFF;
+    hash *= 0x100000001B3ULL;
+  }
+
+  return hash % n_;
+}
+
+//===--------------------------------------------------------------------===//
+// Setup
+//===--------------------------------------------------------------------===//
+
+namespace {
+
+const oid_t INDEX_BENCH_DATABASE_OID = 16000;
+const oid_t INDEX_BENCH_TABLE_OID = 16001;
+const oid_t INDEX_BENCH_INDEX_OID = 16002;
+
+const size_t INDEX_BENCH_TUPLES_PER_TILEGROUP = 1000;
+
+// One in this many operations of a mixed workload is an insert
+const size_t INSERT_PERIOD = 20;
+
+// # of extra entries --verify adds for key id 0, enough for the run of
+// duplicates to span many leaves
+const size_t VERIFY_DUPLICATE_COUNT = 5000;
+
+// Tuples and keys shared by all runs. Key id i is stored in the table at
+// locations[i], and keys[i] is its index key. Ids below key_count are
+// loaded before each run, the rest are inserted during the run.
+struct BenchData {
+  storage::DataTable *table = nullptr;
+
+  const catalog::Schema *tuple_schema = nullptr;
+
+  std::vector<oid_t> key_attrs;
+
+  // schema of the key tuples
+  std::unique_ptr<catalog::Schema> key_schema;
+
+  // key ids in load order
+  std::vector<uint64_t> load_order;
+
+  // # of key ids each thread inserts in the timed phase
+  size_t inserts_per_thread = 0;
+
+  // index entries point here, so this must not be resized once filled
+  std::vector<ItemPointer> locations;
+
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+
+  // more tuples with the key of key id 0, only materialized for --verify
+  std::vector<ItemPointer> duplicate_locations;
+
+  // holds the varlen data of the key tuples
+  std::unique_ptr<type::EphemeralPool> pool;
+};
+
+// Zero padded, so that string order matches key id order
+type::Value GetKeyValue(const configuration &state, uint64_t key_id) {
+  if (state.generic_key_size == 0) {
+    return type::ValueFactory::GetBigIntValue(static_cast<int64_t>(key_id));
+  }
+
+  char key_string[256];
+  snprintf(key_string, sizeof(key_string), "%0*" PRIu64,
+           state.generic_key_size, key_id);
+  return type::ValueFactory::GetVarcharValue(std::string(key_string));
+}
+
+size_t GetInsertsPerThread(const configuration &state) {
+  switch (state.operation_mix) {
+    case OperationMix::INSERT_ONLY:
+      return state.operation_count;
+    case OperationMix::READ_ONLY:
+      return 0;
+    case OperationMix::READ_MOSTLY:
+    case OperationMix::SCAN_HEAVY:
+      return state.operation_count / INSERT_PERIOD;
+  }
+  return 0;
+}
+
+void CreateTable(const configuration &state, BenchData &data) {
+  std::vector<catalog::Column> columns;
+  if (state.generic_key_size == 0) {
+    for (int column_itr = 0; column_itr < state.key_column_count;
+         column_itr++) {
+      columns.push_back(catalog::Column(
+          type::TypeId::BIGINT, type::Type::GetTypeSize(type::TypeId::BIGINT),
+          "key_" + std::to_string(column_itr), true));
+    }
+  } else {
+    columns.push_back(catalog::Column(type::TypeId::VARCHAR,
+                                      state.generic_key_size, "key_0", false));
+  }
+
+  auto tuple_schema = new catalog::Schema(columns);
+  for (oid_t column_itr = 0; column_itr < columns.size(); column_itr++) {
+    data.key_attrs.push_back(column_itr);
+  }
+
+  // The ART index loads keys back from the table through the storage manager
+  auto database = new storage::Database(INDEX_BENCH_DATABASE_OID);
+  database->setDBName("index_bench");
+  storage::StorageManager::GetInstance()->AddDatabaseToStorageManager(database);
+
+  data.table = storage::TableFactory::GetDataTable(
+      INDEX_BENCH_DATABASE_OID, INDEX_BENCH_TABLE_OID, tuple_schema,
+      "index_bench_table", INDEX_BENCH_TUPLES_PER_TILEGROUP, true, false);
+  data.tuple_schema = tuple_schema;
+  database->AddTable(data.table);
+}
+
+void LoadTable(const configuration &state, BenchData &data) {
+  auto max_backend_count = *std::max_element(state.backend_counts.begin(),
+                                             state.backend_counts.end());
+  data.inserts_per_thread = GetInsertsPerThread(state);
+  size_t total_key_count =
+      state.key_count + max_backend_count * data.inserts_per_thread;
+
+  data.key_schema.reset(
+      catalog::Schema::CopySchema(data.tuple_schema, data.key_attrs));
+  data.pool.reset(new type::EphemeralPool());
+  data.locations.reserve(total_key_count);
+  data.keys.reserve(total_key_count);
+
+  storage::Tuple tuple(data.tuple_schema, true);
+  for (uint64_t key_id = 0; key_id < total_key_count; key_id++) {
+    std::unique_ptr<storage::Tuple> key(
+        new storage::Tuple(data.key_schema.get(), true));
+
+    auto key_value = GetKeyValue(state, key_id);
+    for (oid_t column_itr = 0; column_itr < data.key_attrs.size();
+         column_itr++) {
+      tuple.SetValue(column_itr, key_value, data.pool.get());
+      key->SetValue(column_itr, key_value, data.pool.get());
+    }
+
+    data.locations.push_back(data.table->GetEmptyTupleSlot(&tuple));
+    data.keys.push_back(std::move(key));
+  }
+
+  if (state.verify) {
+    auto key_value = GetKeyValue(state, 0);
+    for (oid_t column_itr = 0; column_itr < data.key_attrs.size();
+         column_itr++) {
+      tuple.SetValue(column_itr, key_value, data.pool.get());
+    }
+    data.duplicate_locations.reserve(VERIFY_DUPLICATE_COUNT);
+    for (size_t dup_itr = 0; dup_itr < VERIFY_DUPLICATE_COUNT; dup_itr++) {
+      data.duplicate_locations.push_back(
+          data.table->GetEmptyTupleSlot(&tuple));
+    }
+  }
+
+  data.load_order.resize(state.key_count);
+  for (uint64_t key_id = 0; key_id < state.key_count; key_id++) {
+    data.load_order[key_id] = key_id;
+  }
+  std::mt19937_64 rng(0);
+  std::shuffle(data.load_order.begin(), data.load_order.end(), rng);
+
+  LOG_INFO("Materialized %lu tuples", total_key_count);
+}
+
+index::Index *CreateIndex(const BenchData &data, IndexType index_type) {
+  auto key_schema =
+      catalog::Schema::CopySchema(data.tuple_schema, data.key_attrs);
+  key_schema->SetIndexedColumns(data.key_attrs);
+
+  auto index_metadata = new index::IndexMetadata(
+      "index_bench_index", INDEX_BENCH_INDEX_OID, INDEX_BENCH_TABLE_OID,
+      INDEX_BENCH_DATABASE_OID, index_type, IndexConstraintType::DEFAULT,
+      data.tuple_schema, key_schema, data.key_attrs, false);
+
+  return index::IndexFactory::GetIndex(index_metadata);
+}
+
+//===--------------------------------------------------------------------===//
+// Verification
+//===--------------------------------------------------------------------===//
+
+// Loads a run of duplicates for key id 0 followed by all loaded keys in
+// ascending order, then checks that every key finds exactly its entries.
+// Runs of equal keys longer than a node are where split bugs hide.
+bool VerifyIndex(const configuration &state, BenchData &data,
+                 IndexType index_type) {
+  std::unique_ptr<index::Index> index(CreateIndex(data, index_type));
+
+  for (auto &location : data.duplicate_locations) {
+    index->InsertEntry(data.keys[0].get(), &location);
+  }
+  for (uint64_t key_id = 0; key_id < state.key_count; key_id++) {
+    index->InsertEntry(data.keys[key_id].get(), &data.locations[key_id]);
+  }
+
+  std::vector<ItemPointer *> result;
+  size_t missing_count = 0;
+  for (uint64_t key_id = 0; key_id < state.key_count; key_id++) {
+    size_t expected_count =
+        (key_id == 0) ? data.duplicate_locations.size() + 1 : 1;
+    result.clear();
+    index->ScanKey(data.keys[key_id].get(), result);
+    if (result.size() != expected_count) {
+      missing_count++;
+    }
+  }
+
+  result.clear();
+  index->ScanAllKeys(result);
+  size_t expected_total = state.key_count + data.duplicate_locations.size();
+
+  if (missing_count != 0 || result.size() != expected_total) {
+    LOG_ERROR("%s :: %lu keys with wrong lookups, %lu of %lu entries scanned",
+              IndexTypeToString(index_type).c_str(), missing_count,
+              result.size(), expected_total);
+    return false;
+  }
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Workload
+//===--------------------------------------------------------------------===//
+
+uint64_t GetNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void WaitForStart(std::atomic<int> &ready_count, std::atomic<bool> &start) {
+  ready_count++;
+  while (start.load() == false) {
+    std::this_thread::yield();
+  }
+}
+
+void LoadBackend(BenchData &data, index::Index *index, size_t begin,
+                 size_t end, std::atomic<int> &ready_count,
+                 std::atomic<bool> &start) {
+  WaitForStart(ready_count, start);
+
+  for (size_t load_itr = begin; load_itr < end; load_itr++) {
+    auto key_id = data.load_order[load_itr];
+    index->InsertEntry(data.keys[key_id].get(),
+                       &data.locations[key_id]);
+  }
+}
+
+void RunBackend(const configuration &state, BenchData &data,
+                index::Index *index, size_t thread_id,
+                std::vector<uint64_t> &latencies,
+                std::atomic<int> &ready_count, std::atomic<bool> &start) {
+  std::mt19937_64 rng(thread_id + 1);
+  std::uniform_int_distribution<uint64_t> uniform(0, state.key_count - 1);
+  std::unique_ptr<ZipfDistribution> zipf;
+  if (state.distribution == KeyDistribution::ZIPFIAN) {
+    zipf.reset(new ZipfDistribution(state.key_count, state.zipf_theta));
+  }
+
+  std::vector<ItemPointer *> result;
+  std::vector<oid_t> column_ids = {0, 0};
+  std::vector<ExpressionType> exprs = {
+      ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+      ExpressionType::COMPARE_LESSTHANOREQUALTO};
+
+  uint64_t next_insert_key_id =
+      state.key_count + thread_id * data.inserts_per_thread;
+
+  WaitForStart(ready_count, start);
+
+  for (size_t op_itr = 0; op_itr < state.operation_count; op_itr++) {
+    bool is_insert =
+        (state.operation_mix == OperationMix::INSERT_ONLY) ||
+        (state.operation_mix != OperationMix::READ_ONLY &&
+         op_itr % INSERT_PERIOD == INSERT_PERIOD - 1);
+
+    uint64_t key_id;
+    if (is_insert) {
+      key_id = next_insert_key_id++;
+    } else if (zipf != nullptr) {
+      key_id = zipf->GetNextNumber(rng);
+    } else {
+      key_id = uniform(rng);
+    }
+
+    auto op_begin = GetNanoseconds();
+
+    if (is_insert) {
+      index->InsertEntry(data.keys[key_id].get(),
+                         &data.locations[key_id]);
+    } else if (state.operation_mix == OperationMix::SCAN_HEAVY) {
+      std::vector<type::Value> values = {
+          GetKeyValue(state, key_id),
+          GetKeyValue(state, key_id + state.scan_length - 1)};
+      index::ConjunctionScanPredicate csp(index, values, column_ids, exprs);
+
+      result.clear();
+      index->Scan(values, column_ids, exprs, ScanDirectionType::FORWARD,
+                  result, &csp);
+    } else {
+      result.clear();
+      index->ScanKey(data.keys[key_id].get(), result);
+    }
+
+    latencies[op_itr] = GetNanoseconds() - op_begin;
+  }
+}
+
+double GetPercentile(const std::vector<uint64_t> &sorted_latencies,
+                     double percentile) {
+  if (sorted_latencies.empty()) {
+    return 0;
+  }
+  size_t offset = static_cast<size_t>(percentile * (sorted_latencies.size() - 1));
+  return sorted_latencies[offset] / 1000.0;
+}
+
+IndexBenchResult RunIndex(const configuration &state, BenchData &data,
+                          IndexType index_type, int backend_count) {
+  IndexBenchResult result;
+  std::unique_ptr<index::Index> index(CreateIndex(data, index_type));
+
+  // Load phase
+  {
+    std::atomic<int> ready_count(0);
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+    size_t chunk_size = (state.key_count + backend_count - 1) / backend_count;
+    for (int thread_itr = 0; thread_itr < backend_count; thread_itr++) {
+      size_t begin = std::min(state.key_count, thread_itr * chunk_size);
+      size_t end = std::min(state.key_count, begin + chunk_size);
+      threads.push_back(std::thread(LoadBackend, std::ref(data), index.get(),
+                                    begin, end, std::ref(ready_count),
+                                    std::ref(start)));
+    }
+    while (ready_count.load() < backend_count) {
+      std::this_thread::yield();
+    }
+
+    auto load_begin = GetNanoseconds();
+    start = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto load_duration = (GetNanoseconds() - load_begin) / 1e9;
+    result.load_throughput = state.key_count / load_duration;
+  }
+
+  // Timed phase
+  std::vector<std::vector<uint64_t>> latencies(
+      backend_count, std::vector<uint64_t>(state.operation_count));
+  {
+    std::atomic<int> ready_count(0);
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+    for (int thread_itr = 0; thread_itr < backend_count; thread_itr++) {
+      threads.push_back(std::thread(
+          RunBackend, std::cref(state), std::ref(data), index.get(),
+          thread_itr, std::ref(latencies[thread_itr]), std::ref(ready_count),
+          std::ref(start)));
+    }
+    while (ready_count.load() < backend_count) {
+      std::this_thread::yield();
+    }
+
+    auto run_begin = GetNanoseconds();
+    start = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto run_duration = (GetNanoseconds() - run_begin) / 1e9;
+    result.throughput = backend_count * state.operation_count / run_duration;
+  }
+
+  std::vector<uint64_t> all_latencies;
+  all_latencies.reserve(backend_count * state.operation_count);
+  for (auto &thread_latencies : latencies) {
+    all_latencies.insert(all_latencies.end(), thread_latencies.begin(),
+                         thread_latencies.end());
+  }
+  std::sort(all_latencies.begin(), all_latencies.end());
+  result.latency_p50 = GetPercentile(all_latencies, 0.50);
+  result.latency_p90 = GetPercentile(all_latencies, 0.90);
+  result.latency_p99 = GetPercentile(all_latencies, 0.99);
+  result.latency_p999 = GetPercentile(all_latencies, 0.999);
+
+  if (index->NeedGC()) {
+    index->PerformGC();
+  }
+  result.memory_footprint = index->GetMemoryFootprint();
+
+  return result;
+}
+
+}  // namespace
+
+void RunBenchmark() {
+  // Tuples are never updated or deleted, keep the GC out of the way
+  gc::GCManagerFactory::Configure(0);
+
+  BenchData data;
+  CreateTable(state, data);
+  LoadTable(state, data);
+
+  printf("%-10s %8s %14s %14s %10s %10s %10s %10s %12s\n", "index", "threads",
+         "load(ops/s)", "run(ops/s)", "p50(us)", "p90(us)", "p99(us)",
+         "p999(us)", "memory(KB)");
+
+  if (state.verify) {
+    for (auto index_type : state.index_types) {
+      // The skip list index is a stub and finds nothing
+      if (index_type == IndexType::SKIPLIST) continue;
+
+      if (VerifyIndex(state, data, index_type) == false) {
+        exit(EXIT_FAILURE);
+      }
+      LOG_INFO("Verified %s", IndexTypeToString(index_type).c_str());
+    }
+  }
+
+  for (auto index_type : state.index_types) {
+    for (auto backend_count : state.backend_counts) {
+      auto result = RunIndex(state, data, index_type, backend_count);
+
+      printf("%-10s %8d %14.0lf %14.0lf %10.2lf %10.2lf %10.2lf %10.2lf %12lu\n",
+             IndexTypeToString(index_type).c_str(), backend_count,
+             result.load_throughput, result.throughput, result.latency_p50,
+             result.latency_p90, result.latency_p99, result.latency_p999,
+             result.memory_footprint / 1024);
+      fflush(stdout);
+    }
+  }
+
+  storage::StorageManager::GetInstance()->DestroyDatabases();
+}
+
+}  // namespace index_bench
+}  // namespace benchmark
+}  // namespace peloton
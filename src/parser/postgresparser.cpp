@@ -1047,9 +1047,99 @@ parser::SQLStatement *PostgresParser::CreateTransform(CreateStmt *root) {
     }
   }
 
+  if (root->options != nullptr) {
+    try {
+      StorageOptionsTransform(root->options, result);
+    } catch (ParserException &e) {
+      delete result;
+      throw;
+    }
+  }
+
   return reinterpret_cast<parser::SQLStatement *>(result);
 }
 
+// This helper function takes in the WITH options of a Postgres CreateStmt
+// and sets the partitioning and clustering of the Peloton CreateStatement.
+// The grammar has no PARTITION BY or CLUSTER clause, so both are given as
+// storage parameters:
+//   WITH (partition_by = 'range', partition_key = 'col',
+//         partition_bounds = '10,20')
+//   WITH (partition_by = 'hash', partition_key = 'col', partitions = 4)
+//   WITH (cluster_key = 'col')
+void PostgresParser::StorageOptionsTransform(List *options,
+                                             parser::CreateStatement *stmt) {
+  for (auto cell = options->head; cell != nullptr; cell = cell->next) {
+    auto def_elem = reinterpret_cast<DefElem *>(cell->data.ptr_value);
+    // other storage parameters are ignored
+    if (def_elem->arg == nullptr ||
+        (strncmp(def_elem->defname, "partition", 9) != 0 &&
+         strcmp(def_elem->defname, "cluster_key") != 0)) {
+      continue;
+    }
+
+    // quoted strings and numbers are values, bare words are type names
+    std::string arg;
+    if (def_elem->arg->type == T_TypeName) {
+      auto type_name = reinterpret_cast<TypeName *>(def_elem->arg);
+      arg = reinterpret_cast<value *>(type_name->names->tail->data.ptr_value)
+                ->val.str;
+    } else if (def_elem->arg->type == T_Integer) {
+      arg = std::to_string(reinterpret_cast<value *>(def_elem->arg)->val.ival);
+    } else {
+      arg = reinterpret_cast<value *>(def_elem->arg)->val.str;
+    }
+
+    if (strcmp(def_elem->defname, "partition_by") == 0) {
+      try {
+        stmt->partition_type = StringToPartitionType(arg);
+      } catch (ConversionException &e) {
+        throw ParserException("Unknown partition type " + arg);
+      }
+    } else if (strcmp(def_elem->defname, "partition_key") == 0) {
+      stmt->partition_key = arg;
+    } else if (strcmp(def_elem->defname, "partition_bounds") == 0) {
+      for (auto bound : StringUtil::Split(arg, ',')) {
+        StringUtil::RTrim(bound);
+        bound.erase(0, bound.find_first_not_of(' '));
+        stmt->partition_bounds.push_back(bound);
+      }
+    } else if (strcmp(def_elem->defname, "partitions") == 0) {
+      if (def_elem->arg->type != T_Integer ||
+          reinterpret_cast<value *>(def_elem->arg)->val.ival <= 0) {
+        throw ParserException("partitions must be a positive integer");
+      }
+      stmt->partition_count =
+          reinterpret_cast<value *>(def_elem->arg)->val.ival;
+    } else if (strcmp(def_elem->defname, "cluster_key") == 0) {
+      stmt->cluster_key = arg;
+    }
+  }
+
+  if (stmt->cluster_key.empty() == false &&
+      stmt->partition_type != PartitionType::INVALID) {
+    throw ParserException("a table cannot be both partitioned and clustered");
+  }
+  if (stmt->partition_type == PartitionType::INVALID) {
+    if (stmt->partition_key.empty() == false ||
+        stmt->partition_bounds.empty() == false || stmt->partition_count != 0) {
+      throw ParserException("partition_by is missing");
+    }
+    return;
+  }
+  if (stmt->partition_key.empty()) {
+    throw ParserException("partition_key is missing");
+  }
+  if (stmt->partition_type == PartitionType::RANGE &&
+      stmt->partition_bounds.empty()) {
+    throw ParserException("partition_bounds is missing");
+  }
+  if (stmt->partition_type == PartitionType::HASH &&
+      stmt->partition_count == 0) {
+    throw ParserException("partitions is missing");
+  }
+}
+
 // This helper function takes in a Postgres FunctionParameter object and
 // transforms it into a Peloton FunctionParameter object
 parser::FuncParameter *PostgresParser::FunctionParameterTransform(
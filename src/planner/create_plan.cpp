@@ -137,6 +137,12 @@ CreatePlan::CreatePlan(parser::CreateStatement *parse_tree) {
 
       // TODO: UNIQUE and CHECK constraints
 
+      partition_type = parse_tree->partition_type;
+      partition_key = parse_tree->partition_key;
+      partition_bounds = parse_tree->partition_bounds;
+      partition_count = parse_tree->partition_count;
+      cluster_key = parse_tree->cluster_key;
+
       table_schema = schema;
       break;
     }
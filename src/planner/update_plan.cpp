@@ -34,6 +34,19 @@ UpdatePlan::UpdatePlan(storage::DataTable *table,
         break;
     }
   }
+
+  // the new version of a row may belong to another partition or page, so
+  // an update of the partition or cluster key is also performed as a delete
+  // and an insert
+  if (project_info_ != nullptr && table->IsPlacedByKey() &&
+      update_primary_key_ == false) {
+    for (const auto &target : project_info_->GetTargetList()) {
+      if (table->IsPlacementColumn(target.first)) {
+        update_primary_key_ = true;
+        break;
+      }
+    }
+  }
 }
 
 void UpdatePlan::SetParameterValues(std::vector<type::Value> *values) {
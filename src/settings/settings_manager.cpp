@@ -59,6 +59,13 @@ void SettingsManager::SetString(SettingId id, const std::string &value) {
   GetInstance().SetValue(id, type::ValueFactory::GetVarcharValue(value));
 }
 
+void SettingsManager::RegisterCallback(SettingId id,
+                                       SettingCallback callback) {
+  auto &settings_manager = GetInstance();
+  std::lock_guard<std::mutex> lock(settings_manager.callbacks_mutex_);
+  settings_manager.callbacks_[id].push_back(std::move(callback));
+}
+
 SettingsManager &SettingsManager::GetInstance() {
   static SettingsManager settings_manager;
   return settings_manager;
@@ -172,6 +179,20 @@ void SettingsManager::SetValue(SettingId id, const type::Value &value) {
     }
   }
   param->second.value = value;
+
+  // Notify listeners. They are called without the mutex held, so that they
+  // may register callbacks of their own.
+  std::vector<SettingCallback> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    auto callbacks_itr = callbacks_.find(id);
+    if (callbacks_itr != callbacks_.end()) {
+      callbacks = callbacks_itr->second;
+    }
+  }
+  for (auto &callback : callbacks) {
+    callback(id);
+  }
 }
 
 bool SettingsManager::InsertIntoCatalog(const Param &param) {
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_access_stats.cpp
+//
+// Identification: src/statistics/index_access_stats.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/index_access_stats.h"
+
+#include <mutex>
+
+#include "common/macros.h"
+#include "index/index.h"
+#include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
+#include "statistics/index_metric.h"
+
+namespace peloton {
+namespace stats {
+
+constexpr int IndexAccessStats::STATS_MODE_UNKNOWN;
+
+std::atomic<int> IndexAccessStats::stats_mode_(STATS_MODE_UNKNOWN);
+
+std::atomic<uint64_t> IndexAccessStats::next_instance_id_(1);
+
+namespace {
+
+// Slots of destroyed indexes, and the # of slots ever handed out
+std::mutex slot_mutex;
+std::vector<size_t> free_slots;
+size_t slot_count = 0;
+
+}  // namespace
+
+IndexAccessStats::IndexAccessStats(index::IndexMetadata *metadata)
+    : database_oid_(metadata->GetDatabaseOid()),
+      table_oid_(metadata->GetTableOid()),
+      index_oid_(metadata->GetOid()),
+      instance_id_(next_instance_id_.fetch_add(1)),
+      slot_(AcquireSlot()) {}
+
+IndexAccessStats::~IndexAccessStats() { ReleaseSlot(slot_); }
+
+size_t IndexAccessStats::AcquireSlot() {
+  std::lock_guard<std::mutex> lock(slot_mutex);
+  if (free_slots.empty()) {
+    return slot_count++;
+  }
+  size_t slot = free_slots.back();
+  free_slots.pop_back();
+  return slot;
+}
+
+void IndexAccessStats::ReleaseSlot(size_t slot) {
+  std::lock_guard<std::mutex> lock(slot_mutex);
+  free_slots.push_back(slot);
+}
+
+int IndexAccessStats::RefreshStatsMode() {
+  // Keep the cached mode in sync with later changes to the setting
+  static std::once_flag callback_flag;
+  std::call_once(callback_flag, []() {
+    settings::SettingsManager::RegisterCallback(
+        settings::SettingId::stats_mode,
+        [](settings::SettingId) { RefreshStatsMode(); });
+  });
+
+  auto stats_mode =
+      settings::SettingsManager::GetInt(settings::SettingId::stats_mode);
+  stats_mode_.store(stats_mode, std::memory_order_relaxed);
+  return stats_mode;
+}
+
+AccessMetric &IndexAccessStats::ResolveAccessMetric() {
+  auto index_metric = BackendStatsContext::GetInstance()->GetIndexMetric(
+      database_oid_, table_oid_, index_oid_);
+  PELOTON_ASSERT(index_metric != nullptr);
+
+  // The stats context never drops an index metric, so the pointer stays
+  // valid for the lifetime of the thread
+  auto &thread_slots = GetThreadSlots();
+  if (slot_ >= thread_slots.size()) {
+    thread_slots.resize(slot_ + 1, ThreadSlot{0, nullptr});
+  }
+  thread_slots[slot_] = {instance_id_, &index_metric->GetIndexAccess()};
+
+  return *thread_slots[slot_].metric;
+}
+
+}  // namespace stats
+}  // namespace peloton
@@ -22,13 +22,17 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <string>
 
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/macros.h"
 #include "common/internal_types.h"
+#include "storage/backend_manager.h"
+#include "storage/tile_arena.h"
 
 //===--------------------------------------------------------------------===//
 // GUC Variables
@@ -304,6 +308,9 @@ static void (*Func_drain)(void) = drain_no_pcommit;
 #define DATA_FILE_LEN 1024 * 1024 * UINT64_C(512)  // 512 MB
 #define DATA_FILE_NAME "peloton.pmem"
 
+// Extents are page aligned; the file is extended in multiples of a page.
+#define DATA_FILE_PAGE_SIZE 4096
+
 // global singleton
 BackendManager &BackendManager::GetInstance(void) {
   static BackendManager backend_manager;
@@ -311,135 +318,257 @@ BackendManager &BackendManager::GetInstance(void) {
 }
 
 BackendManager::BackendManager()
-    : data_file_address(nullptr), data_file_len(0), data_file_offset(0) {
-  // // Check if we need a data pool
-  // if (logging::LoggingUtil::IsBasedOnWriteAheadLogging(peloton_logging_mode)
-  // ==
-  //         true ||
-  //     peloton_logging_mode == LoggingType::INVALID) {
-  //   return;
-  // }
-
-  // // Check for instruction availability and flush mode
-  // // (1 -- clflush or 2 -- clwb)
-  // if (is_cpu_clwb_present() && peloton_flush_mode == 2) {
-  //   LOG_TRACE("Found clwb \n");
-  //   Func_flush = flush_clwb;
-  //   Func_predrain_fence = predrain_fence_sfence;
-  // }
-
-  // if (is_cpu_pcommit_present()) {
-  //   LOG_TRACE("Found pcommit \n");
-  //   Func_drain = drain_pcommit;
-  // }
-
-  // // Rest of this stuff is needed only for Write Behind Logging
-  // int data_fd;
-  // std::string data_file_name;
-  // struct stat data_stat;
-
-  // // Initialize file size
-  // if (peloton_data_file_size != 0)
-  //   data_file_len = peloton_data_file_size * 1024 * 1024;  // MB
-  // else
-  //   data_file_len = DATA_FILE_LEN;
-
-  // // Check for relevant file system
-  // bool found_file_system = false;
-
-  // switch (peloton_logging_mode) {
-  //   // Check for NVM FS for data
-  //   case LoggingType::NVM_WBL: {
-  //     int status = stat(NVM_DIR, &data_stat);
-  //     if (status == 0 && S_ISDIR(data_stat.st_mode)) {
-  //       data_file_name = std::string(NVM_DIR) + std::string(DATA_FILE_NAME);
-  //       found_file_system = true;
-  //     }
-
-  //   } break;
-
-  //   // Check for SSD FS for data
-  //   case LoggingType::SSD_WBL: {
-  //     int status = stat(SSD_DIR, &data_stat);
-  //     if (status == 0 && S_ISDIR(data_stat.st_mode)) {
-  //       data_file_name = std::string(SSD_DIR) + std::string(DATA_FILE_NAME);
-  //       found_file_system = true;
-  //     }
-
-  //   } break;
-
-  //   // Check for HDD FS
-  //   case LoggingType::HDD_WBL: {
-  //     int status = stat(HDD_DIR, &data_stat);
-  //     if (status == 0 && S_ISDIR(data_stat.st_mode)) {
-  //       data_file_name = std::string(HDD_DIR) + std::string(DATA_FILE_NAME);
-  //       found_file_system = true;
-  //     }
-
-  //   } break;
-
-  //   default:
-  //     break;
-  // }
-
-  // // Fallback to tmp directory if needed
-  // if (found_file_system == false) {
-  //   int status = stat(TMP_DIR, &data_stat);
-  //   if (status == 0 && S_ISDIR(data_stat.st_mode)) {
-  //     data_file_name = std::string(TMP_DIR) + std::string(DATA_FILE_NAME);
-  //   } else {
-  //     throw Exception("Could not find temp directory : " +
-  //                     std::string(TMP_DIR));
-  //   }
-  // }
-
-  // LOG_TRACE("DATA DIR :: %s ", data_file_name.c_str());
-
-  // // Create a data file
-  // if ((data_fd = open(
-  //          data_file_name.c_str(), O_CREAT | O_TRUNC | O_RDWR,
-  //          S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH)) < 0) {
-  //   perror(data_file_name.c_str());
-  //   exit(EXIT_FAILURE);
-  // }
-
-  // // Allocate the data file
-  // if ((errno = posix_fallocate(data_fd, 0, data_file_len)) != 0) {
-  //   perror("posix_fallocate");
-  //   exit(EXIT_FAILURE);
-  // }
-
-  // // map the data file in memory
-  // if ((data_file_address = mmap(NULL, data_file_len, PROT_READ | PROT_WRITE,
-  //                               MAP_SHARED, data_fd, 0)) == MAP_FAILED) {
-  //   perror("mmap");
-  //   exit(EXIT_FAILURE);
-  // }
-
-  // // close the pmem file -- it will remain mapped
-  // close(data_fd);
-}
+    : data_file_address(nullptr), data_file_len(0) {}
 
 BackendManager::~BackendManager() {
   LOG_TRACE("Allocation count : %ld \n", allocation_count);
 
-  // // Check if we need a PMEM pool
-  // if (peloton_logging_mode != LoggingType::NVM_WBL) return;
-
-  // // sync and unmap the data file
-  // if (data_file_address != nullptr) {
-  //   // sync the mmap'ed file to SSD or HDD
-  //   int status = msync(data_file_address, data_file_len, MS_SYNC);
-  //   if (status != 0) {
-  //     perror("msync");
-  //     exit(EXIT_FAILURE);
-  //   }
-
-  //   if (munmap(data_file_address, data_file_len)) {
-  //     perror("munmap");
-  //     exit(EXIT_FAILURE);
-  //   }
-  // }
+  CloseDataFile();
+}
+
+// maps length bytes of the data file at offset, synchronously on DAX file
+// systems so that flushing the cpu cache is enough to persist a write
+static void *MapDataFile(int data_fd, size_t offset, size_t length,
+                         bool *sync_mapped) {
+  void *address = MAP_FAILED;
+  *sync_mapped = false;
+#if defined(MAP_SYNC) && defined(MAP_SHARED_VALIDATE)
+  address = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                 MAP_SHARED_VALIDATE | MAP_SYNC, data_fd, offset);
+  *sync_mapped = (address != MAP_FAILED);
+#endif
+  if (address == MAP_FAILED) {
+    address = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, data_fd,
+                   offset);
+  }
+  return address;
+}
+
+void BackendManager::OpenDataFile(const std::string &directory,
+                                  size_t length) {
+  data_file_spinlock.Lock();
+  if (data_file_address != nullptr) {
+    data_file_spinlock.Unlock();
+    throw Exception("data file is already open: " + data_file_name);
+  }
+
+  data_file_name = directory;
+  if (data_file_name.empty() == false && data_file_name.back() != '/') {
+    data_file_name += "/";
+  }
+  data_file_name += DATA_FILE_NAME;
+  LOG_INFO("DATA FILE :: %s ", data_file_name.c_str());
+
+  int data_fd = open(data_file_name.c_str(), O_CREAT | O_RDWR,
+                     S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+  if (data_fd < 0) {
+    data_file_spinlock.Unlock();
+    throw Exception("could not open data file " + data_file_name + ": " +
+                    strerror(errno));
+  }
+
+  // the data file does not outlive the process, whatever an earlier run
+  // left in it is discarded
+  length = std::max(length, (size_t)DATA_FILE_PAGE_SIZE);
+  length = (length + DATA_FILE_PAGE_SIZE - 1) & ~(DATA_FILE_PAGE_SIZE - 1);
+  int status = ftruncate(data_fd, 0);
+  if (status == 0) {
+    status = posix_fallocate(data_fd, 0, length);
+  }
+  if (status != 0) {
+    close(data_fd);
+    data_file_spinlock.Unlock();
+    throw Exception("could not allocate data file " + data_file_name);
+  }
+
+  void *address = MapDataFile(data_fd, 0, length, &data_file_sync_mapped);
+  if (address == MAP_FAILED) {
+    close(data_fd);
+    data_file_spinlock.Unlock();
+    throw Exception("could not map data file " + data_file_name + ": " +
+                    strerror(errno));
+  }
+  data_file_fd = data_fd;
+  data_file_address = address;
+  data_file_len = length;
+  data_file_segments.clear();
+  data_file_segments[0] = std::make_pair(reinterpret_cast<char *>(address),
+                                         length);
+
+  allocated_extents.clear();
+  free_extents.clear();
+  free_extents[0] = data_file_len;
+
+  LOG_INFO("Mapped data file %s : %lu bytes", data_file_name.c_str(),
+           data_file_len);
+  data_file_spinlock.Unlock();
+}
+
+void BackendManager::CloseDataFile() {
+  data_file_spinlock.Lock();
+  if (data_file_address != nullptr) {
+    // sync the mmap'ed file to SSD or HDD
+    for (auto &segment : data_file_segments) {
+      int status = msync(segment.second.first, segment.second.second,
+                         MS_SYNC);
+      if (status != 0) {
+        perror("msync");
+      }
+
+      if (munmap(segment.second.first, segment.second.second)) {
+        perror("munmap");
+      }
+    }
+    close(data_file_fd);
+    data_file_fd = -1;
+    data_file_address = nullptr;
+    data_file_len = 0;
+    data_file_segments.clear();
+    allocated_extents.clear();
+    free_extents.clear();
+  }
+  data_file_spinlock.Unlock();
+}
+
+size_t BackendManager::GetDataFileOffset(void *address) const {
+  auto byte = reinterpret_cast<char *>(address);
+  for (auto &segment : data_file_segments) {
+    if (byte >= segment.second.first &&
+        byte < segment.second.first + segment.second.second) {
+      return segment.first + (byte - segment.second.first);
+    }
+  }
+  return data_file_len;
+}
+
+bool BackendManager::GrowDataFile(size_t length) {
+  // double the file, so that there are few segments
+  size_t offset = data_file_len;
+  length = std::max(length, data_file_len);
+
+  int status = posix_fallocate(data_file_fd, offset, length);
+  if (status != 0) {
+    LOG_ERROR("Could not grow data file %s to %lu bytes: %s",
+              data_file_name.c_str(), offset + length, strerror(status));
+    return false;
+  }
+
+  bool sync_mapped = false;
+  void *address = MapDataFile(data_file_fd, offset, length, &sync_mapped);
+  if (address == MAP_FAILED) {
+    LOG_ERROR("Could not map data file %s: %s", data_file_name.c_str(),
+              strerror(errno));
+    return false;
+  }
+  data_file_sync_mapped = data_file_sync_mapped && sync_mapped;
+  data_file_segments[offset] =
+      std::make_pair(reinterpret_cast<char *>(address), length);
+  data_file_len = offset + length;
+
+  free_extents[offset] = length;
+  LOG_INFO("Grew data file %s to %lu bytes", data_file_name.c_str(),
+           data_file_len);
+  return true;
+}
+
+// extents are only recorded in memory, Sync() writes tile data back to the
+// file
+void *BackendManager::AllocateExtent(size_t size) {
+  size_t length =
+      (size + DATA_FILE_PAGE_SIZE - 1) & ~((size_t)DATA_FILE_PAGE_SIZE - 1);
+
+  data_file_spinlock.Lock();
+  if (data_file_address == nullptr) {
+    data_file_spinlock.Unlock();
+    throw Exception("no data file is open");
+  }
+
+  // first fit
+  auto free_extent = free_extents.begin();
+  while (free_extent != free_extents.end() && free_extent->second < length) {
+    free_extent++;
+  }
+  if (free_extent == free_extents.end()) {
+    if (GrowDataFile(length) == false) {
+      data_file_spinlock.Unlock();
+      throw Exception("no more memory available in data file: size : " +
+                      std::to_string(size) + " length : " +
+                      std::to_string(data_file_len));
+    }
+    free_extent = std::prev(free_extents.end());
+  }
+
+  size_t offset = free_extent->first;
+  size_t free_length = free_extent->second;
+  free_extents.erase(free_extent);
+  if (free_length > length) {
+    free_extents[offset + length] = free_length - length;
+  }
+  allocated_extents[offset] = length;
+
+  auto segment = std::prev(data_file_segments.upper_bound(offset));
+  void *address = segment->second.first + (offset - segment->first);
+  data_file_spinlock.Unlock();
+  return address;
+}
+
+void BackendManager::ReleaseExtent(void *address) {
+  data_file_spinlock.Lock();
+  if (data_file_address == nullptr) {
+    data_file_spinlock.Unlock();
+    return;
+  }
+
+  size_t offset = GetDataFileOffset(address);
+  auto allocated_extent = allocated_extents.find(offset);
+  if (allocated_extent == allocated_extents.end()) {
+    data_file_spinlock.Unlock();
+    LOG_ERROR("Releasing unknown data file extent at offset %lu", offset);
+    return;
+  }
+  size_t length = allocated_extent->second;
+  allocated_extents.erase(allocated_extent);
+
+  // coalesce with the neighboring free extents of the same segment
+  auto next = free_extents.lower_bound(offset);
+  if (next != free_extents.end() && offset + length == next->first &&
+      data_file_segments.count(next->first) == 0) {
+    length += next->second;
+    next = free_extents.erase(next);
+  }
+  if (next != free_extents.begin() &&
+      data_file_segments.count(offset) == 0) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == offset) {
+      offset = prev->first;
+      length += prev->second;
+      free_extents.erase(prev);
+    }
+  }
+  free_extents[offset] = length;
+
+  data_file_spinlock.Unlock();
+}
+
+void BackendManager::SyncDataFile(void *address, size_t length) {
+  if (data_file_sync_mapped == true) {
+    // the mapping is synchronous, flushing the cpu cache persists the data
+    Func_flush(address, length);
+    Func_drain();
+    clflush_count++;
+    return;
+  }
+
+  // msync works on whole pages
+  auto begin = reinterpret_cast<uintptr_t>(address) &
+               ~(uintptr_t)(DATA_FILE_PAGE_SIZE - 1);
+  auto end = reinterpret_cast<uintptr_t>(address) + length;
+  int status = msync(reinterpret_cast<void *>(begin), end - begin, MS_SYNC);
+  if (status != 0) {
+    throw Exception("could not sync data file " + data_file_name + ": " +
+                    strerror(errno));
+  }
+  msync_count++;
 }
 
 void *BackendManager::Allocate(BackendType type, size_t size) {
@@ -452,56 +581,38 @@ void *BackendManager::Allocate(BackendType type, size_t size) {
       return ::operator new(size);
     } break;
 
+    case BackendType::HUGE_PAGE: {
+      return TileArena::GetInstance().Allocate(size);
+    } break;
+
     case BackendType::SSD:
     case BackendType::HDD: {
-      {
-        size_t cache_data_file_offset = 0;
-
-        // Lock the file
-        data_file_spinlock.Lock();
-
-        // Check if within bounds
-        if (data_file_offset < data_file_len) {
-          cache_data_file_offset = data_file_offset;
-
-          // Offset by the requested size
-          data_file_offset += size;
-
-          // Unlock the file
-          data_file_spinlock.Unlock();
-
-          void *address = reinterpret_cast<char *>(data_file_address) +
-                          cache_data_file_offset;
-          return address;
-        }
-
-        data_file_spinlock.Unlock();
-        throw Exception("no more memory available: offset : " +
-                        std::to_string(data_file_offset) + " length : " +
-                        std::to_string(data_file_len));
-
-        return nullptr;
-      }
+      return AllocateExtent(size);
     } break;
 
     case BackendType::INVALID:
     default: {
-      throw Exception("invalid backend: " + std::to_string(data_file_len));
+      throw Exception("invalid backend: " + BackendTypeToString(type));
       return nullptr;
     }
   }
 }
 
-void BackendManager::Release(BackendType type, void *address) {
+void BackendManager::Release(BackendType type, void *address, size_t size) {
   switch (type) {
     case BackendType::MM:
     case BackendType::NVM: {
       ::operator delete(address);
     } break;
 
+    case BackendType::HUGE_PAGE: {
+      PELOTON_ASSERT(size != 0);
+      TileArena::GetInstance().Release(address, size);
+    } break;
+
     case BackendType::SSD:
     case BackendType::HDD: {
-      // Nothing to do here
+      ReleaseExtent(address);
     } break;
 
     case BackendType::INVALID:
@@ -514,7 +625,8 @@ void BackendManager::Release(BackendType type, void *address) {
 
 void BackendManager::Sync(BackendType type, void *address, size_t length) {
   switch (type) {
-    case BackendType::MM: {
+    case BackendType::MM:
+    case BackendType::HUGE_PAGE: {
       // Nothing to do here
     } break;
 
@@ -527,14 +639,8 @@ void BackendManager::Sync(BackendType type, void *address, size_t length) {
 
     case BackendType::SSD:
     case BackendType::HDD: {
-      // sync the mmap'ed file to SSD or HDD
-      int status = msync(data_file_address, data_file_len, MS_SYNC);
-      if (status != 0) {
-        perror("msync");
-        exit(EXIT_FAILURE);
-      }
-
-      msync_count++;
+      // sync the written range of the mmap'ed file to SSD or HDD
+      SyncDataFile(address, length);
     } break;
 
     case BackendType::INVALID:
@@ -0,0 +1,278 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// clustered_directory.cpp
+//
+// Identification: src/storage/clustered_directory.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/clustered_directory.h"
+
+#include <sstream>
+
+#include "common/exception.h"
+#include "expression/abstract_expression.h"
+#include "storage/partition_scheme.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+bool ValueLessThan(const type::Value &left, const type::Value &right) {
+  return left.CompareLessThan(right) == CmpBool::CmpTrue;
+}
+
+bool ValueLessThanOrEqual(const type::Value &left, const type::Value &right) {
+  return left.CompareLessThanEquals(right) == CmpBool::CmpTrue;
+}
+
+}  // namespace
+
+ClusteredDirectory::ClusteredDirectory(oid_t key_column_id,
+                                       std::shared_ptr<TileGroup> first_page)
+    : key_column_id_(key_column_id) {
+  PELOTON_ASSERT(first_page != nullptr);
+  std::unique_ptr<Page> page(new Page());
+  page->tile_group = std::move(first_page);
+  pages_by_id_[page->tile_group->GetTileGroupId()] = page.get();
+  pages_.push_back(std::move(page));
+}
+
+size_t ClusteredDirectory::GetPageCount() const {
+  latch_.ReadLock();
+  size_t page_count = pages_.size();
+  latch_.Unlock();
+  return page_count;
+}
+
+size_t ClusteredDirectory::FindPage(const type::Value &key) const {
+  if (key.IsNull()) {
+    return 0;
+  }
+
+  // the last page whose low key is not above the key
+  size_t low = 1;
+  size_t high = pages_.size();
+  while (low < high) {
+    size_t mid = (low + high) / 2;
+    if (ValueLessThan(key, pages_[mid]->low_key)) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  return low - 1;
+}
+
+TileGroup *ClusteredDirectory::GetPage(const type::Value &key) const {
+  latch_.ReadLock();
+  auto tile_group = pages_[FindPage(key)]->tile_group.get();
+  latch_.Unlock();
+  return tile_group;
+}
+
+void ClusteredDirectory::RecordKey(const oid_t &tile_group_id,
+                                   const type::Value &key) {
+  if (key.IsNull()) {
+    return;
+  }
+
+  latch_.ReadLock();
+  auto page_itr = pages_by_id_.find(tile_group_id);
+  if (page_itr != pages_by_id_.end()) {
+    auto page = page_itr->second;
+    page->bounds_latch.Lock();
+    if (page->min_key.IsNull() || ValueLessThan(key, page->min_key)) {
+      page->min_key = key.Copy();
+    }
+    if (page->max_key.IsNull() || ValueLessThan(page->max_key, key)) {
+      page->max_key = key.Copy();
+    }
+    page->bounds_latch.Unlock();
+  }
+  latch_.Unlock();
+}
+
+bool ClusteredDirectory::AddFreeSlot(const oid_t &tile_group_id,
+                                     const oid_t &tuple_slot) {
+  latch_.ReadLock();
+  auto page_itr = pages_by_id_.find(tile_group_id);
+  bool is_page = (page_itr != pages_by_id_.end());
+  if (is_page) {
+    auto page = page_itr->second;
+    page->free_slot_latch.Lock();
+    page->free_slots.push_back(tuple_slot);
+    page->free_slot_latch.Unlock();
+  }
+  latch_.Unlock();
+  return is_page;
+}
+
+oid_t ClusteredDirectory::TakeFreeSlot(const oid_t &tile_group_id) {
+  oid_t tuple_slot = INVALID_OID;
+
+  latch_.ReadLock();
+  auto page_itr = pages_by_id_.find(tile_group_id);
+  if (page_itr != pages_by_id_.end()) {
+    auto page = page_itr->second;
+    page->free_slot_latch.Lock();
+    if (page->free_slots.empty() == false) {
+      tuple_slot = page->free_slots.back();
+      page->free_slots.pop_back();
+    }
+    page->free_slot_latch.Unlock();
+  }
+  latch_.Unlock();
+  return tuple_slot;
+}
+
+void ClusteredDirectory::SplitPage(TileGroup *page, const type::Value &key,
+                                   std::shared_ptr<TileGroup> new_page) {
+  latch_.WriteLock();
+  size_t page_offset = FindPage(key);
+  if (pages_[page_offset]->tile_group.get() != page) {
+    latch_.Unlock();
+    return;
+  }
+
+  auto &old_page = pages_[page_offset];
+  std::unique_ptr<Page> split_page(new Page());
+  split_page->tile_group = std::move(new_page);
+
+  // keys below those of the full page get the lower part of its range, so
+  // that descending inserts stay clustered. any other key splits the range
+  // at the key, which keeps ascending inserts clustered.
+  if (key.IsNull() == false && old_page->min_key.IsNull() == false &&
+      ValueLessThan(key, old_page->min_key)) {
+    split_page->low_key = old_page->low_key;
+    old_page->low_key = old_page->min_key;
+  } else {
+    split_page->low_key = key.Copy();
+    page_offset++;
+  }
+
+  pages_by_id_[split_page->tile_group->GetTileGroupId()] = split_page.get();
+  pages_.insert(pages_.begin() + page_offset, std::move(split_page));
+  latch_.Unlock();
+}
+
+std::vector<oid_t> ClusteredDirectory::GetPages(
+    const expression::AbstractExpression *predicate,
+    const std::vector<type::Value> *params) const {
+  std::vector<oid_t> tile_group_ids;
+
+  latch_.ReadLock();
+  auto pages = MatchPages(predicate, params);
+  for (size_t i = 0; i < pages_.size(); i++) {
+    if (pages[i] == true) {
+      tile_group_ids.push_back(pages_[i]->tile_group->GetTileGroupId());
+    }
+  }
+  latch_.Unlock();
+
+  return tile_group_ids;
+}
+
+std::vector<bool> ClusteredDirectory::MatchPages(
+    const expression::AbstractExpression *predicate,
+    const std::vector<type::Value> *params) const {
+  if (predicate == nullptr) {
+    return std::vector<bool>(pages_.size(), true);
+  }
+
+  switch (predicate->GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND:
+    case ExpressionType::CONJUNCTION_OR: {
+      auto left = MatchPages(predicate->GetChild(0), params);
+      auto right = MatchPages(predicate->GetChild(1), params);
+      bool is_and =
+          predicate->GetExpressionType() == ExpressionType::CONJUNCTION_AND;
+      for (size_t i = 0; i < pages_.size(); i++) {
+        left[i] = is_and ? (left[i] && right[i]) : (left[i] || right[i]);
+      }
+      return left;
+    }
+    default:
+      return MatchComparison(predicate, params);
+  }
+}
+
+std::vector<bool> ClusteredDirectory::MatchComparison(
+    const expression::AbstractExpression *predicate,
+    const std::vector<type::Value> *params) const {
+  std::vector<bool> pages(pages_.size(), true);
+
+  ExpressionType comparison;
+  type::Value key;
+  if (PartitionScheme::GetKeyComparison(predicate, key_column_id_, params,
+                                        comparison, key) == false) {
+    return pages;
+  }
+
+  // a comparison with NULL is never true
+  if (key.IsNull()) {
+    return std::vector<bool>(pages_.size(), false);
+  }
+
+  for (size_t i = 0; i < pages_.size(); i++) {
+    auto &page = pages_[i];
+    page->bounds_latch.Lock();
+    type::Value min_key = page->min_key;
+    type::Value max_key = page->max_key;
+    page->bounds_latch.Unlock();
+
+    // an empty page holds nothing to match
+    if (min_key.IsNull()) {
+      pages[i] = false;
+      continue;
+    }
+
+    // values that do not compare with the key type match every page
+    try {
+      switch (comparison) {
+        case ExpressionType::COMPARE_EQUAL:
+          pages[i] = ValueLessThanOrEqual(min_key, key) &&
+                     ValueLessThanOrEqual(key, max_key);
+          break;
+        case ExpressionType::COMPARE_LESSTHAN:
+          pages[i] = ValueLessThan(min_key, key);
+          break;
+        case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+          pages[i] = ValueLessThanOrEqual(min_key, key);
+          break;
+        case ExpressionType::COMPARE_GREATERTHAN:
+          pages[i] = ValueLessThan(key, max_key);
+          break;
+        default:
+          pages[i] = ValueLessThanOrEqual(key, max_key);
+          break;
+      }
+    } catch (Exception &e) {
+      return std::vector<bool>(pages_.size(), true);
+    }
+  }
+  return pages;
+}
+
+const std::string ClusteredDirectory::GetInfo() const {
+  std::ostringstream os;
+  latch_.ReadLock();
+  os << "CLUSTERED ON (column " << key_column_id_ << ") " << pages_.size()
+     << " pages";
+  for (auto &page : pages_) {
+    os << std::endl
+       << "  page " << page->tile_group->GetTileGroupId() << " from "
+       << (page->low_key.IsNull() ? "-inf" : page->low_key.ToString());
+  }
+  latch_.Unlock();
+  return os.str();
+}
+
+}  // namespace storage
+}  // namespace peloton
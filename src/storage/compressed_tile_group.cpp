@@ -0,0 +1,496 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_tile_group.cpp
+//
+// Identification: src/storage/compressed_tile_group.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/compressed_tile_group.h"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <sstream>
+
+#include "catalog/schema.h"
+#include "expression/abstract_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "storage/abstract_table.h"
+#include "storage/partition_scheme.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+// run length encoding pays off once runs average this many tuples
+const size_t MIN_RUN_LENGTH = 4;
+
+// dictionary encoding pays off once values repeat this many times on average
+const size_t MIN_DICTIONARY_REPEATS = 4;
+
+// a compressed column is kept next to the raw one, it is only worth its
+// memory if it is at most this fraction (1 / n) of the size of the raw one
+const size_t MIN_COMPRESSION_RATIO = 2;
+
+bool IsIntegerType(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+int64_t GetInteger(const type::Value &value) {
+  switch (value.GetTypeId()) {
+    case type::TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case type::TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case type::TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+// the raw bytes of a string value, which compare like the value
+std::string GetString(const type::Value &value) {
+  return std::string(value.GetData(), value.GetLength());
+}
+
+// # of bits needed to hold values up to max_value
+uint32_t GetBitWidth(uint64_t max_value) {
+  return max_value == 0 ? 0 : 64 - __builtin_clzll(max_value);
+}
+
+// clears the bits of the tuples outside [begin, end)
+void ClearOutside(oid_t begin, oid_t end, std::vector<uint64_t> &matches) {
+  for (size_t word_id = 0; word_id < matches.size(); word_id++) {
+    oid_t word_begin = word_id * 64;
+    uint64_t mask = 0;
+    if (end > word_begin && begin < word_begin + 64) {
+      uint32_t from = (begin > word_begin) ? begin - word_begin : 0;
+      uint32_t to = std::min<oid_t>(end - word_begin, 64);
+      mask = (to == 64) ? ~0ull : ((1ull << to) - 1);
+      mask &= ~((1ull << from) - 1);
+    }
+    matches[word_id] &= mask;
+  }
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Compressed Column
+//===--------------------------------------------------------------------===//
+
+std::unique_ptr<CompressedColumn> CompressedColumn::Compress(
+    TileGroup *tile_group, oid_t column_id, oid_t tuple_count) {
+  auto schema = tile_group->GetAbstractTable()->GetSchema();
+  auto &schema_column = schema->GetColumn(column_id);
+  auto type_id = schema_column.GetType();
+  std::unique_ptr<CompressedColumn> column;
+  if (IsIntegerType(type_id)) {
+    column = CompressIntegers(tile_group, column_id, tuple_count);
+  } else if (type_id == type::TypeId::VARCHAR) {
+    column = CompressStrings(tile_group, column_id, tuple_count);
+  }
+
+  // the raw size of a VARCHAR column only counts its pointers
+  size_t raw_size = tuple_count * schema_column.GetFixedLength();
+  if (column != nullptr &&
+      column->GetSize() * MIN_COMPRESSION_RATIO > raw_size) {
+    return nullptr;
+  }
+  return column;
+}
+
+std::unique_ptr<CompressedColumn> CompressedColumn::CompressIntegers(
+    TileGroup *tile_group, oid_t column_id, oid_t tuple_count) {
+  std::vector<int64_t> values(tuple_count, 0);
+  std::vector<uint64_t> nulls((tuple_count + 63) / 64, 0);
+  bool has_nulls = false;
+  int64_t min_value = std::numeric_limits<int64_t>::max();
+  int64_t max_value = std::numeric_limits<int64_t>::min();
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    auto value = tile_group->GetValue(tuple_id, column_id);
+    if (value.IsNull()) {
+      nulls[tuple_id / 64] |= 1ull << (tuple_id % 64);
+      has_nulls = true;
+      continue;
+    }
+    values[tuple_id] = GetInteger(value);
+    min_value = std::min(min_value, values[tuple_id]);
+    max_value = std::max(max_value, values[tuple_id]);
+  }
+
+  // sorted columns without NULLs are run length encoded if their runs are
+  // long enough
+  if (has_nulls == false && tuple_count > 0) {
+    bool sorted = true;
+    size_t run_count = 1;
+    for (oid_t tuple_id = 1; tuple_id < tuple_count && sorted; tuple_id++) {
+      sorted = values[tuple_id - 1] <= values[tuple_id];
+      if (values[tuple_id - 1] != values[tuple_id]) {
+        run_count++;
+      }
+    }
+    if (sorted == true && run_count * MIN_RUN_LENGTH <= tuple_count) {
+      std::unique_ptr<CompressedColumn> column(
+          new CompressedColumn(Encoding::RUN_LENGTH, tuple_count));
+      for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+        if (tuple_id > 0 && values[tuple_id - 1] == values[tuple_id]) {
+          column->run_ends_.back() = tuple_id + 1;
+          continue;
+        }
+        column->run_values_.push_back(values[tuple_id]);
+        column->run_ends_.push_back(tuple_id + 1);
+      }
+      return column;
+    }
+  }
+
+  std::unique_ptr<CompressedColumn> column(
+      new CompressedColumn(Encoding::BIT_PACKED, tuple_count));
+  if (min_value > max_value) {
+    // every value is NULL
+    min_value = max_value = 0;
+  }
+  column->base_ = min_value;
+  column->bit_width_ = GetBitWidth(static_cast<uint64_t>(max_value) -
+                                   static_cast<uint64_t>(min_value));
+  column->packed_.resize((tuple_count * column->bit_width_ + 63) / 64 + 1, 0);
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    if ((nulls[tuple_id / 64] & (1ull << (tuple_id % 64))) == 0) {
+      column->Pack(tuple_id, static_cast<uint64_t>(values[tuple_id]) -
+                                 static_cast<uint64_t>(min_value));
+    }
+  }
+  if (has_nulls == true) {
+    column->nulls_ = std::move(nulls);
+  }
+  return column;
+}
+
+std::unique_ptr<CompressedColumn> CompressedColumn::CompressStrings(
+    TileGroup *tile_group, oid_t column_id, oid_t tuple_count) {
+  std::vector<std::string> values(tuple_count);
+  std::vector<uint64_t> nulls((tuple_count + 63) / 64, 0);
+  bool has_nulls = false;
+  std::set<std::string> distinct_values;
+  size_t max_distinct_count = tuple_count / MIN_DICTIONARY_REPEATS;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    auto value = tile_group->GetValue(tuple_id, column_id);
+    if (value.IsNull()) {
+      nulls[tuple_id / 64] |= 1ull << (tuple_id % 64);
+      has_nulls = true;
+      continue;
+    }
+    values[tuple_id] = GetString(value);
+    distinct_values.insert(values[tuple_id]);
+    if (distinct_values.size() > max_distinct_count) {
+      return nullptr;
+    }
+  }
+
+  std::unique_ptr<CompressedColumn> column(
+      new CompressedColumn(Encoding::DICTIONARY, tuple_count));
+  column->dictionary_.assign(distinct_values.begin(), distinct_values.end());
+  column->bit_width_ = GetBitWidth(
+      column->dictionary_.empty() ? 0 : column->dictionary_.size() - 1);
+  column->packed_.resize((tuple_count * column->bit_width_ + 63) / 64 + 1, 0);
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    if ((nulls[tuple_id / 64] & (1ull << (tuple_id % 64))) == 0) {
+      auto code = std::lower_bound(column->dictionary_.begin(),
+                                   column->dictionary_.end(),
+                                   values[tuple_id]) -
+                  column->dictionary_.begin();
+      column->Pack(tuple_id, code);
+    }
+  }
+  if (has_nulls == true) {
+    column->nulls_ = std::move(nulls);
+  }
+  return column;
+}
+
+size_t CompressedColumn::GetSize() const {
+  size_t size = (nulls_.size() + packed_.size()) * sizeof(uint64_t) +
+                run_values_.size() * (sizeof(int64_t) + sizeof(oid_t));
+  for (auto &value : dictionary_) {
+    size += value.size();
+  }
+  return size;
+}
+
+void CompressedColumn::Pack(oid_t tuple_id, uint64_t value) {
+  if (bit_width_ == 0) {
+    return;
+  }
+  uint64_t bit = static_cast<uint64_t>(tuple_id) * bit_width_;
+  uint32_t offset = bit % 64;
+  packed_[bit / 64] |= value << offset;
+  if (offset + bit_width_ > 64) {
+    packed_[bit / 64 + 1] |= value >> (64 - offset);
+  }
+}
+
+inline uint64_t CompressedColumn::Unpack(oid_t tuple_id) const {
+  if (bit_width_ == 0) {
+    return 0;
+  }
+  uint64_t bit = static_cast<uint64_t>(tuple_id) * bit_width_;
+  uint32_t offset = bit % 64;
+  uint64_t value = packed_[bit / 64] >> offset;
+  if (offset + bit_width_ > 64) {
+    value |= packed_[bit / 64 + 1] << (64 - offset);
+  }
+  return (bit_width_ == 64) ? value : (value & ((1ull << bit_width_) - 1));
+}
+
+void CompressedColumn::FilterPacked(uint64_t low, uint64_t high,
+                                    std::vector<uint64_t> &matches) const {
+  uint64_t range = high - low;
+  for (size_t word_id = 0; word_id < matches.size(); word_id++) {
+    if (matches[word_id] == 0) {
+      continue;
+    }
+    // a branch free loop over the 64 tuples of the word
+    oid_t begin = word_id * 64;
+    oid_t end = std::min<oid_t>(begin + 64, tuple_count_);
+    uint64_t word = 0;
+    for (oid_t tuple_id = begin; tuple_id < end; tuple_id++) {
+      word |= static_cast<uint64_t>(Unpack(tuple_id) - low <= range)
+              << (tuple_id - begin);
+    }
+    matches[word_id] &= word;
+  }
+}
+
+void CompressedColumn::FilterRuns(int64_t low, int64_t high,
+                                  std::vector<uint64_t> &matches) const {
+  // the runs are sorted, so the values in range make up consecutive runs
+  size_t first_run =
+      std::lower_bound(run_values_.begin(), run_values_.end(), low) -
+      run_values_.begin();
+  size_t last_run =
+      std::upper_bound(run_values_.begin(), run_values_.end(), high) -
+      run_values_.begin();
+  oid_t begin = (first_run == 0) ? 0 : run_ends_[first_run - 1];
+  oid_t end = (last_run == 0) ? 0 : run_ends_[last_run - 1];
+  ClearOutside(begin, std::max(begin, end), matches);
+}
+
+bool CompressedColumn::Filter(ExpressionType comparison,
+                              const type::Value &constant,
+                              std::vector<uint64_t> &matches) const {
+  // a comparison with NULL is never true
+  if (constant.IsNull()) {
+    std::fill(matches.begin(), matches.end(), 0);
+    return true;
+  }
+
+  if (encoding_ == Encoding::DICTIONARY) {
+    if (constant.GetTypeId() != type::TypeId::VARCHAR) {
+      return false;
+    }
+
+    // the codes of the matching values, in [low, high)
+    auto key = GetString(constant);
+    uint64_t lower =
+        std::lower_bound(dictionary_.begin(), dictionary_.end(), key) -
+        dictionary_.begin();
+    uint64_t upper =
+        std::upper_bound(dictionary_.begin(), dictionary_.end(), key) -
+        dictionary_.begin();
+    uint64_t low = 0;
+    uint64_t high = dictionary_.size();
+    switch (comparison) {
+      case ExpressionType::COMPARE_EQUAL:
+        low = lower;
+        high = upper;
+        break;
+      case ExpressionType::COMPARE_LESSTHAN:
+        high = lower;
+        break;
+      case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        high = upper;
+        break;
+      case ExpressionType::COMPARE_GREATERTHAN:
+        low = upper;
+        break;
+      case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+        low = lower;
+        break;
+      default:
+        return false;
+    }
+    if (low >= high) {
+      std::fill(matches.begin(), matches.end(), 0);
+      return true;
+    }
+    FilterPacked(low, high - 1, matches);
+  } else {
+    if (IsIntegerType(constant.GetTypeId()) == false) {
+      return false;
+    }
+
+    // the matching values, in [low, high]
+    int64_t key = GetInteger(constant);
+    int64_t low = std::numeric_limits<int64_t>::min();
+    int64_t high = std::numeric_limits<int64_t>::max();
+    bool is_empty = false;
+    switch (comparison) {
+      case ExpressionType::COMPARE_EQUAL:
+        low = high = key;
+        break;
+      case ExpressionType::COMPARE_LESSTHAN:
+        is_empty = (key == low);
+        high = key - (is_empty ? 0 : 1);
+        break;
+      case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        high = key;
+        break;
+      case ExpressionType::COMPARE_GREATERTHAN:
+        is_empty = (key == high);
+        low = key + (is_empty ? 0 : 1);
+        break;
+      case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+        low = key;
+        break;
+      default:
+        return false;
+    }
+    if (encoding_ == Encoding::BIT_PACKED) {
+      is_empty = is_empty || high < base_;
+    }
+    if (is_empty) {
+      std::fill(matches.begin(), matches.end(), 0);
+      return true;
+    }
+
+    if (encoding_ == Encoding::RUN_LENGTH) {
+      FilterRuns(low, high, matches);
+    } else {
+      // offsets from the base, values below it match from offset 0
+      uint64_t packed_low = (low <= base_) ? 0
+                                           : static_cast<uint64_t>(low) -
+                                                 static_cast<uint64_t>(base_);
+      uint64_t packed_high =
+          static_cast<uint64_t>(high) - static_cast<uint64_t>(base_);
+      FilterPacked(packed_low, packed_high, matches);
+    }
+  }
+
+  for (size_t word_id = 0; word_id < nulls_.size(); word_id++) {
+    matches[word_id] &= ~nulls_[word_id];
+  }
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Compressed Tile Group
+//===--------------------------------------------------------------------===//
+
+CompressedTileGroup::CompressedTileGroup(TileGroup *tile_group)
+    : tile_group_id_(tile_group->GetTileGroupId()),
+      tuple_count_(std::min<oid_t>(tile_group->GetNextTupleSlot(),
+                                   tile_group->GetAllocatedTupleCount())) {
+  auto column_count =
+      tile_group->GetAbstractTable()->GetSchema()->GetColumnCount();
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    columns_.push_back(
+        CompressedColumn::Compress(tile_group, column_id, tuple_count_));
+  }
+}
+
+size_t CompressedTileGroup::GetCompressedColumnCount() const {
+  return std::count_if(columns_.begin(), columns_.end(),
+                       [](const std::unique_ptr<CompressedColumn> &column) {
+                         return column != nullptr;
+                       });
+}
+
+size_t CompressedTileGroup::GetSize() const {
+  size_t size = 0;
+  for (auto &column : columns_) {
+    if (column != nullptr) {
+      size += column->GetSize();
+    }
+  }
+  return size;
+}
+
+bool CompressedTileGroup::Filter(
+    const expression::AbstractExpression *predicate,
+    const std::vector<type::Value> *params, std::vector<uint64_t> &matches,
+    bool &exact) const {
+  matches.assign((tuple_count_ + 63) / 64, ~0ull);
+  if (tuple_count_ % 64 != 0) {
+    matches.back() = (1ull << (tuple_count_ % 64)) - 1;
+  }
+  exact = true;
+  return FilterConjunct(predicate, params, matches, exact);
+}
+
+bool CompressedTileGroup::FilterConjunct(
+    const expression::AbstractExpression *predicate,
+    const std::vector<type::Value> *params, std::vector<uint64_t> &matches,
+    bool &exact) const {
+  if (predicate->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    bool left = FilterConjunct(predicate->GetChild(0), params, matches, exact);
+    bool right =
+        FilterConjunct(predicate->GetChild(1), params, matches, exact);
+    return left || right;
+  }
+
+  // the compared column may be on either side
+  for (size_t i = 0; i < predicate->GetChildrenSize(); i++) {
+    auto child = predicate->GetChild(i);
+    if (child->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+      continue;
+    }
+    auto column_id =
+        static_cast<const expression::TupleValueExpression *>(child)
+            ->GetColumnId();
+    if (column_id < 0 || static_cast<size_t>(column_id) >= columns_.size() ||
+        columns_[column_id] == nullptr) {
+      break;
+    }
+
+    ExpressionType comparison;
+    type::Value constant;
+    if (PartitionScheme::GetKeyComparison(predicate, column_id, params,
+                                          comparison, constant) &&
+        columns_[column_id]->Filter(comparison, constant, matches)) {
+      return true;
+    }
+    break;
+  }
+
+  exact = false;
+  return false;
+}
+
+const std::string CompressedTileGroup::GetInfo() const {
+  std::ostringstream os;
+  os << "COMPRESSED TILE GROUP " << tile_group_id_ << ": "
+     << GetCompressedColumnCount() << " of " << columns_.size()
+     << " columns, " << GetSize() << " bytes for " << tuple_count_
+     << " tuples";
+  return os.str();
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <mutex>
 #include <utility>
 
@@ -40,6 +41,7 @@
 #include "tuning/sample.h"
 #include "masstree/encoder.h"
 #include "type/type_id.h"
+#include "type/value_factory.h"
 #include "climits"
 #include "index/compact_ints_key.h"
 
@@ -62,6 +64,26 @@ oid_t DataTable::invalid_tile_group_id = -1;
 size_t DataTable::default_active_tilegroup_count_ = 1;
 size_t DataTable::default_active_indirection_array_count_ = 1;
 
+namespace {
+
+// source of the per thread insert lane seeds
+std::atomic<size_t> next_insert_lane_seed(0);
+
+// the calling thread inserts into lane (seed % # of lanes) of every table
+size_t GetInsertLaneSeed() {
+  static thread_local size_t insert_lane_seed = next_insert_lane_seed++;
+  return insert_lane_seed;
+}
+
+// # of recycled slots moved from the GC to the free list of a lane at a time
+constexpr size_t FREE_SLOT_BATCH_SIZE = 32;
+
+// # of inserts for which a lane stops asking the GC for recycled slots of
+// its table after the GC had none
+constexpr uint32_t FREE_SLOT_POLL_INTERVAL = 64;
+
+}  // namespace
+
 DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
                      const oid_t &database_oid, const oid_t &table_oid,
                      const size_t &tuples_per_tilegroup, const bool own_schema,
@@ -71,6 +93,7 @@ DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
       database_oid(database_oid),
       table_name(table_name),
       tuples_per_tilegroup_(tuples_per_tilegroup),
+      sparse_indexed_(-1),
       current_layout_oid_(ATOMIC_VAR_INIT(COLUMN_STORE_LAYOUT_OID)),
       adapt_table_(adapt_table),
       trigger_list_(new trigger::TriggerList()) {
@@ -84,13 +107,16 @@ DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
   }
 
   active_tile_groups_.resize(active_tilegroup_count_);
-
-  active_indirection_arrays_.resize(active_indirection_array_count_);
-  // Create tile groups.
+  insert_lanes_.reset(new InsertLane[active_tilegroup_count_]);
   for (size_t i = 0; i < active_tilegroup_count_; ++i) {
-    AddDefaultTileGroup(i);
+    insert_lanes_[i].tile_group = nullptr;
   }
 
+  active_indirection_arrays_.resize(active_indirection_array_count_);
+  // Create the tile group of the first lane. The other lanes get theirs
+  // when a thread first inserts into them.
+  AddDefaultTileGroup(0);
+
   // Create indirection layers.
   for (size_t i = 0; i < active_indirection_array_count_; ++i) {
     AddDefaultIndirectionArray(i);
@@ -158,6 +184,31 @@ bool DataTable::CheckConstraints(const AbstractTuple *tuple) const {
   // DEFAULT constraint should not be handled here
   // Handled in higher hierarchy
 
+  return CheckSchemaConstraints();
+}
+
+bool DataTable::CheckConstraints(
+    const std::vector<const storage::Tuple *> &tuples) const {
+  // NOT NULL constraint, a column at a time
+  for (oid_t column_id : schema->GetNotNullColumns()) {
+    if (schema->AllowNull(column_id) == true) {
+      continue;
+    }
+    for (auto tuple : tuples) {
+      if (CheckNotNulls(tuple, column_id) == false) {
+        std::string error = StringUtil::Format(
+            "NOT NULL constraint violated on column '%s' : %s",
+            schema->GetColumn(column_id).GetName().c_str(),
+            tuple->GetInfo().c_str());
+        throw ConstraintException(error);
+      }
+    }
+  }
+
+  return CheckSchemaConstraints();
+}
+
+bool DataTable::CheckSchemaConstraints() const {
   // multi-column constraints
   for (auto cons_pair : schema->GetConstraints()) {
     auto cons = cons_pair.second;
@@ -214,30 +265,69 @@ bool DataTable::CheckConstraints(const AbstractTuple *tuple) const {
 // however, when performing insert, we have to copy data immediately,
 // and the argument cannot be set to nullptr.
 ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
+  // a tuple goes to the partition of its key
+  size_t partition = 0;
+  if (IsPartitioned() == true && tuple != nullptr) {
+    partition = partition_scheme_->GetPartition(tuple);
+  }
+
+  // a tuple goes to the page of its key, which recycles its own slots
+  if (IsClustered() == true) {
+    auto key_column_id = clustered_directory_->GetKeyColumnId();
+    auto key = (tuple != nullptr)
+                   ? tuple->GetValue(key_column_id)
+                   : type::ValueFactory::GetNullValueByType(
+                         schema->GetType(key_column_id));
+    return ClaimClusteredTupleSlot(tuple, key, nullptr);
+  }
+
   //=============== garbage collection==================
-  // check if there are recycled tuple slots
-  auto &gc_manager = gc::GCManagerFactory::GetInstance();
-  auto free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
+  // check if there are recycled tuple slots.
+  auto free_item_pointer = ClaimRecycledTupleSlot(tuple, partition);
   if (free_item_pointer.IsNull() == false) {
-    // when inserting a tuple
-    if (tuple != nullptr) {
-      auto tile_group = storage::StorageManager::GetInstance()->GetTileGroup(
-          free_item_pointer.block);
-      tile_group->CopyTuple(tuple, free_item_pointer.offset);
-    }
     return free_item_pointer;
   }
   //====================================================
-  // active_tile_group_id is the index of the array(active_tile_groups)
-  size_t active_tile_group_id = number_of_tuples_ % active_tilegroup_count_;
-  std::shared_ptr<storage::TileGroup> tile_group;
+  return ClaimTupleSlot(tuple, partition);
+}
+
+// slots of tile groups being compacted (immutable) or already dropped are
+// not reused
+ItemPointer DataTable::ClaimRecycledTupleSlot(const storage::Tuple *tuple,
+                                              const size_t &partition) {
+  auto free_item_pointer = GetRecycledTupleSlot(partition);
+  while (free_item_pointer.IsNull() == false) {
+    auto tile_group = storage::StorageManager::GetInstance()->GetTileGroup(
+        free_item_pointer.block);
+    if (tile_group != nullptr &&
+        tile_group->GetHeader()->GetImmutability() == false) {
+      // when inserting a tuple
+      if (tuple != nullptr) {
+        tile_group->CopyTuple(tuple, free_item_pointer.offset);
+        auto value = tuple->GetValue(0);
+        UpdateSparseIndex(free_item_pointer.block, value, value);
+      }
+      return free_item_pointer;
+    }
+    free_item_pointer = GetRecycledTupleSlot(partition);
+  }
+  return INVALID_ITEMPOINTER;
+}
+
+ItemPointer DataTable::ClaimTupleSlot(const storage::Tuple *tuple,
+                                      const size_t &partition) {
+  // every thread inserts into the active tile group of its own lane. the
+  // tile group is owned by active_tile_groups_ and the storage manager, so
+  // there is no need to pin it with a shared_ptr copy here.
+  size_t lane = partition * active_tilegroup_count_ + GetInsertLane();
+  storage::TileGroup *tile_group = nullptr;
   oid_t tuple_slot = INVALID_OID;
   oid_t tile_group_id = INVALID_OID;
 
   // get valid tuple.
   while (true) {
-    // get the last tile group.
-    tile_group = active_tile_groups_[active_tile_group_id];
+    // get the last tile group of the lane.
+    tile_group = GetLaneTileGroup(lane);
 
     tuple_slot = tile_group->InsertTuple(tuple);
 
@@ -251,36 +341,197 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
   // if this is the last tuple slot we can get
   // then create a new tile group
   if (tuple_slot == tile_group->GetAllocatedTupleCount() - 1) {
-    AddDefaultTileGroup(active_tile_group_id);
+    AddDefaultTileGroup(lane);
   }
 
   LOG_TRACE("tile group count: %lu, tile group id: %u, address: %p",
             tile_group_count_.load(), tile_group->GetTileGroupId(),
-            tile_group.get());
-  type::Value tp_0 = tile_group->GetValue(0,0);
-  type::Value tp_slot= tuple->GetValue(0);
-  if(storage::StorageManager::GetInstance()->GetDatabaseWithOid(database_oid)->GetDBName()=="default_database"){
-    if(this->sparse_index.Contains((oid_t)tile_group_count_) == true ){
-      this->sparse_index.Update((oid_t)tile_group_count_,std::make_pair(tp_0,tp_slot) );
-    }else{
-      this->sparse_index.Insert((oid_t)tile_group_count_,std::make_pair(tp_0,tp_slot) );
-    }
+            tile_group);
+  if (tuple != nullptr) {
+    auto value = tuple->GetValue(0);
+    UpdateSparseIndex(tile_group_id, value, value);
   }
 
   // Set tuple location
   ItemPointer location(tile_group_id, tuple_slot);
 
-  location.SetLocation(tile_group.get());
+  location.SetLocation(tile_group);
 
   return location;
 }
 
+ItemPointer DataTable::ClaimClusteredTupleSlot(const storage::Tuple *tuple,
+                                               const type::Value &key,
+                                               storage::TileGroup *tile_group) {
+  // the pages of a clustered table are owned by its directory
+  while (true) {
+    if (tile_group == nullptr) {
+      tile_group = clustered_directory_->GetPage(key);
+    }
+
+    oid_t tuple_slot =
+        clustered_directory_->TakeFreeSlot(tile_group->GetTileGroupId());
+    if (tuple_slot != INVALID_OID) {
+      if (tuple != nullptr) {
+        tile_group->CopyTuple(tuple, tuple_slot);
+      }
+    } else {
+      tuple_slot = tile_group->InsertTuple(tuple);
+    }
+
+    if (tuple_slot != INVALID_OID) {
+      clustered_directory_->RecordKey(tile_group->GetTileGroupId(), key);
+
+      ItemPointer location(tile_group->GetTileGroupId(), tuple_slot);
+      location.SetLocation(tile_group);
+      return location;
+    }
+
+    // the page is full, unless some other thread already split it
+    auto page = clustered_directory_->GetPage(key);
+    if (page == tile_group) {
+      SplitClusteredPage(page, key);
+    }
+    tile_group = nullptr;
+  }
+}
+
+void DataTable::RecycleClusteredTupleSlot(const ItemPointer &location) {
+  // slots of tile groups the table had before it was clustered are not
+  // reused
+  if (clustered_directory_->AddFreeSlot(location.block, location.offset) ==
+      false) {
+    LOG_TRACE("Dropped freed slot (%u, %u) of table %s", location.block,
+              location.offset, table_name.c_str());
+  }
+}
+
+void DataTable::SplitClusteredPage(storage::TileGroup *page,
+                                   const type::Value &key) {
+  std::lock_guard<std::mutex> lock(data_table_mutex_);
+  if (clustered_directory_->GetPage(key) != page) {
+    return;
+  }
+  clustered_directory_->SplitPage(page, key, CreateDefaultTileGroup(0));
+  LOG_TRACE("Split a page of table %s: %s", table_name.c_str(),
+            clustered_directory_->GetInfo().c_str());
+}
+
+size_t DataTable::GetInsertLane() {
+  if (active_tilegroup_count_ == 1) {
+    return 0;
+  }
+  return GetInsertLaneSeed() % active_tilegroup_count_;
+}
+
+TileGroup *DataTable::GetLaneTileGroup(const size_t &lane) {
+  auto tile_group =
+      insert_lanes_[lane].tile_group.load(std::memory_order_acquire);
+  if (tile_group != nullptr) {
+    return tile_group;
+  }
+
+  // first insert into the lane, the threads sharing it race to open it
+  std::lock_guard<std::mutex> lock(data_table_mutex_);
+  tile_group = insert_lanes_[lane].tile_group.load(std::memory_order_acquire);
+  if (tile_group == nullptr) {
+    InstallDefaultTileGroup(lane);
+    tile_group = insert_lanes_[lane].tile_group.load(std::memory_order_acquire);
+  }
+  return tile_group;
+}
+
+// Recycled slots are moved from the GC in batches to the free list of the
+// calling thread's lane, so that most inserts neither look up the table in
+// the GC nor touch its shared recycle queue. The free list belongs to the
+// table, slots a thread took are reused by the others of its lane once it
+// stops inserting.
+ItemPointer DataTable::GetRecycledTupleSlot(const size_t &partition) {
+  if (gc::GCManagerFactory::GetGCType() != GarbageCollectionType::ON) {
+    return INVALID_ITEMPOINTER;
+  }
+
+  auto &lane = insert_lanes_[partition * active_tilegroup_count_ +
+                             GetInsertLane()];
+  ItemPointer free_item_pointer;
+
+  lane.free_slot_latch.Lock();
+  if (lane.free_slots.empty()) {
+    if (lane.skipped_polls > 0) {
+      lane.skipped_polls--;
+      lane.free_slot_latch.Unlock();
+      return INVALID_ITEMPOINTER;
+    }
+
+    auto &gc_manager = gc::GCManagerFactory::GetInstance();
+    for (size_t i = 0; i < FREE_SLOT_BATCH_SIZE; i++) {
+      free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid, partition);
+      if (free_item_pointer.IsNull() == true) {
+        break;
+      }
+      lane.free_slots.push_back(free_item_pointer);
+    }
+
+    if (lane.free_slots.empty()) {
+      lane.skipped_polls = FREE_SLOT_POLL_INTERVAL;
+      lane.free_slot_latch.Unlock();
+      return INVALID_ITEMPOINTER;
+    }
+  }
+
+  free_item_pointer = lane.free_slots.back();
+  lane.free_slots.pop_back();
+  lane.free_slot_latch.Unlock();
+  return free_item_pointer;
+}
+
+// the sparse index keeps the smallest and the largest value of the first
+// column of every tile group. the threads of a lane append to its tile group
+// concurrently and recycled slots are refilled in any order, so the range is
+// widened under the lock of the entry instead of being taken from the first
+// and the latest tuple.
+void DataTable::UpdateSparseIndex(const oid_t &tile_group_id,
+                                  const type::Value &min_value,
+                                  const type::Value &max_value) {
+  if (IsSparseIndexed() == false) {
+    return;
+  }
+  auto widen = [&min_value,
+                &max_value](std::pair<type::Value, type::Value> &range) {
+    if (min_value.CompareLessThan(range.first) == CmpBool::CmpTrue) {
+      range.first = min_value;
+    }
+    if (max_value.CompareGreaterThan(range.second) == CmpBool::CmpTrue) {
+      range.second = max_value;
+    }
+  };
+  sparse_index.Upsert(tile_group_id, widen,
+                      std::make_pair(min_value, max_value));
+}
+
+bool DataTable::IsSparseIndexed() {
+  int sparse_indexed = sparse_indexed_.load(std::memory_order_relaxed);
+  if (sparse_indexed != -1) {
+    return sparse_indexed == 1;
+  }
+
+  // the database may not be registered yet while the table is being set up
+  auto storage_manager = storage::StorageManager::GetInstance();
+  if (storage_manager->HasDatabase(database_oid) == false) {
+    return false;
+  }
+  sparse_indexed = storage_manager->GetDatabaseWithOid(database_oid)
+                       ->GetDBName() == "default_database";
+  sparse_indexed_.store(sparse_indexed, std::memory_order_relaxed);
+  return sparse_indexed == 1;
+}
+
 //===--------------------------------------------------------------------===//
 // INSERT
 //===--------------------------------------------------------------------===//
-ItemPointer DataTable::InsertEmptyVersion() {
+ItemPointer DataTable::InsertEmptyVersion(const ItemPointer &old_location) {
   // First, claim a slot
-  ItemPointer location = GetEmptyTupleSlot(nullptr);
+  ItemPointer location = ClaimVersionSlot(old_location);
   if (location.block == INVALID_OID) {
     LOG_TRACE("Failed to get tuple slot.");
     return INVALID_ITEMPOINTER;
@@ -292,9 +543,9 @@ ItemPointer DataTable::InsertEmptyVersion() {
   return location;
 }
 
-ItemPointer DataTable::AcquireVersion() {
+ItemPointer DataTable::AcquireVersion(const ItemPointer &old_location) {
   // First, claim a slot
-  ItemPointer location = GetEmptyTupleSlot(nullptr);
+  ItemPointer location = ClaimVersionSlot(old_location);
   if (location.block == INVALID_OID) {
     LOG_TRACE("Failed to get tuple slot.");
     return INVALID_ITEMPOINTER;
@@ -306,6 +557,51 @@ ItemPointer DataTable::AcquireVersion() {
   return location;
 }
 
+// versions keep the key of the row (key updates are a delete and an
+// insert), so they stay in its partition, and in a clustered table are
+// placed next to the old version when its page has room
+ItemPointer DataTable::ClaimVersionSlot(const ItemPointer &old_location) {
+  if (old_location.IsNull() == true) {
+    return GetEmptyTupleSlot(nullptr);
+  }
+
+  if (IsPartitioned() == true) {
+    size_t partition = GetTileGroupPartition(old_location.block);
+    auto free_item_pointer = ClaimRecycledTupleSlot(nullptr, partition);
+    if (free_item_pointer.IsNull() == false) {
+      return free_item_pointer;
+    }
+    return ClaimTupleSlot(nullptr, partition);
+  }
+
+  if (IsClustered() == true) {
+    auto tile_group =
+        storage::StorageManager::GetInstance()->GetTileGroup(
+            old_location.block);
+    auto key = tile_group->GetValue(old_location.offset,
+                                    clustered_directory_->GetKeyColumnId());
+    return ClaimClusteredTupleSlot(nullptr, key, tile_group.get());
+  }
+
+  return GetEmptyTupleSlot(nullptr);
+}
+
+ItemPointer DataTable::AcquireMovedVersion(const AbstractTuple *tuple) {
+  ItemPointer location = ClaimTupleSlot(nullptr, 0);
+  if (location.block == INVALID_OID) {
+    LOG_TRACE("Failed to get tuple slot.");
+    return INVALID_ITEMPOINTER;
+  }
+
+  // the old tile group keeps its range until it is dropped, older
+  // transactions may still read the row there
+  auto value = tuple->GetValue(0);
+  UpdateSparseIndex(location.block, value, value);
+
+  IncreaseTupleCount(1);
+  return location;
+}
+
 bool DataTable::InstallVersion(const AbstractTuple *tuple,
                                const TargetList *targets_ptr,
                                concurrency::TransactionContext *transaction,
@@ -328,16 +624,8 @@ ItemPointer DataTable::InsertTuple(const storage::Tuple *tuple,
                                    concurrency::TransactionContext *transaction,
                                    ItemPointer **index_entry_ptr,
                                    bool check_fk) {
-  type::Value c0 = tuple->GetValue(0);
-  if(c0.GetTypeId() == type::TypeId::INTEGER){
-    int32_t max_= std::numeric_limits<int32_t>::max() - 1;
-    if(c0.CompareEquals(type::ValueFactory::GetIntegerValue(max_))==CmpBool::CmpTrue){
-      LOG_DEBUG("start kev store");
-      for(size_t i=0;i<this->tile_group_count_;i++){
-        KVStoreTileGroup(i);
-      }
-      return INVALID_ITEMPOINTER;
-    }
+  if (HandleKVStoreRequest(tuple) == true) {
+    return INVALID_ITEMPOINTER;
   }
 
   ItemPointer location = GetEmptyTupleSlot(tuple);
@@ -355,6 +643,21 @@ ItemPointer DataTable::InsertTuple(const storage::Tuple *tuple,
   return location;
 }
 
+bool DataTable::HandleKVStoreRequest(const storage::Tuple *tuple) {
+  type::Value c0 = tuple->GetValue(0);
+  if(c0.GetTypeId() == type::TypeId::INTEGER){
+    int32_t max_= std::numeric_limits<int32_t>::max() - 1;
+    if(c0.CompareEquals(type::ValueFactory::GetIntegerValue(max_))==CmpBool::CmpTrue){
+      LOG_DEBUG("start kev store");
+      for(size_t i=0;i<this->tile_group_count_;i++){
+        KVStoreTileGroup(i);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
 void DataTable::KVStoreTileGroup(const oid_t &tile_group_offset){
   // First, check if the tile group is in this table
   if (tile_group_offset >= tile_groups_.GetSize()) {
@@ -640,25 +943,116 @@ ItemPointer DataTable::InsertTuple(const storage::Tuple *tuple) {
   return location;
 }
 
-/**
- * @brief Insert a tuple into all indexes. If index is primary/unique,
- * check visibility of existing
- * index entries.
- * @warning This still doesn't guarantee serializability.
- *
- * @returns True on success, false if a visible entry exists (in case of
- *primary/unique).
- */
-bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
-                                ItemPointer location,
-                                concurrency::TransactionContext *transaction,
-                                ItemPointer **index_entry_ptr) {
-  int index_count = GetIndexCount();
+bool DataTable::InsertTuples(const std::vector<const storage::Tuple *> &tuples,
+                             concurrency::TransactionContext *transaction,
+                             std::vector<ItemPointer> &locations,
+                             bool check_fk) {
+  locations.clear();
+  if (tuples.empty() == true) {
+    return true;
+  }
+
+  for (auto tuple : tuples) {
+    if (HandleKVStoreRequest(tuple) == true) {
+      return false;
+    }
+  }
+
+  // check the whole batch before claiming any slot
+  if (CheckConstraints(tuples) == false) {
+    LOG_TRACE("InsertTuples(): Constraint violated");
+    return false;
+  }
+
+  // claim runs of consecutive slots in the tile group of the thread's lane.
+  // recycled slots are not contiguous and are left to single inserts. the
+  // tuples of partitioned and clustered tables are routed one at a time.
+  locations.reserve(tuples.size());
+  if (IsPlacedByKey() == true) {
+    for (auto tuple : tuples) {
+      locations.push_back(GetEmptyTupleSlot(tuple));
+    }
+  }
+  size_t lane = GetInsertLane();
+  size_t tuple_itr = locations.size();
+  while (tuple_itr < tuples.size()) {
+    auto tile_group = GetLaneTileGroup(lane);
+    oid_t tuple_count = tuples.size() - tuple_itr;
+    oid_t tuple_slot = tile_group->InsertTuples(tuples, tuple_itr, tuple_count);
+
+    // some other thread is adding the next tile group of the lane
+    if (tuple_slot == INVALID_OID) {
+      continue;
+    }
+
+    // if the last tuple slot was reserved, then create a new tile group
+    if (tuple_slot + tuple_count == tile_group->GetAllocatedTupleCount()) {
+      AddDefaultTileGroup(lane);
+    }
+
+    if (IsSparseIndexed() == true) {
+      auto min_value = tuples[tuple_itr]->GetValue(0);
+      auto max_value = min_value;
+      for (oid_t slot_itr = 1; slot_itr < tuple_count; slot_itr++) {
+        auto value = tuples[tuple_itr + slot_itr]->GetValue(0);
+        if (value.CompareLessThan(min_value) == CmpBool::CmpTrue) {
+          min_value = value;
+        } else if (value.CompareGreaterThan(max_value) == CmpBool::CmpTrue) {
+          max_value = value;
+        }
+      }
+      UpdateSparseIndex(tile_group->GetTileGroupId(), min_value, max_value);
+    }
+
+    for (oid_t slot_itr = 0; slot_itr < tuple_count; slot_itr++) {
+      ItemPointer location(tile_group->GetTileGroupId(), tuple_slot + slot_itr);
+      location.SetLocation(tile_group);
+      locations.push_back(location);
+    }
+    tuple_itr += tuple_count;
+  }
+
+  // the transaction owns the new versions before they are indexed, so that
+  // duplicate keys within the batch violate primary and unique indexes.
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto index_count = GetIndexCount();
+  std::vector<ItemPointer *> index_entry_ptrs(tuples.size(), nullptr);
+  for (size_t itr = 0; itr < tuples.size(); itr++) {
+    if (index_count != 0) {
+      index_entry_ptrs[itr] = AllocateIndirection(locations[itr]);
+    }
+    transaction_manager.PerformInsert(transaction, locations[itr],
+                                      index_entry_ptrs[itr]);
+  }
+
+  // Index checks and updates
+  if (index_count != 0 &&
+      InsertInIndexes(tuples, index_entry_ptrs, transaction) == false) {
+    LOG_TRACE("Index constraint violated");
+    return false;
+  }
 
+  // ForeignKey checks
+  if (check_fk == true) {
+    for (auto tuple : tuples) {
+      if (CheckForeignKeyConstraints(tuple, transaction) == false) {
+        LOG_TRACE("ForeignKey constraint violated");
+        return false;
+      }
+    }
+  }
+
+  IncreaseTupleCount(tuples.size());
+  return true;
+}
+
+ItemPointer *DataTable::AllocateIndirection(const ItemPointer &location) {
   size_t active_indirection_array_id =
-      number_of_tuples_ % active_indirection_array_count_;
+      GetInsertLaneSeed() % active_indirection_array_count_;
 
   size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
+  ItemPointer *index_entry_ptr = nullptr;
 
   while (true) {
     auto active_indirection_array =
@@ -666,19 +1060,39 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
     indirection_offset = active_indirection_array->AllocateIndirection();
 
     if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
-      *index_entry_ptr =
+      index_entry_ptr =
           active_indirection_array->GetIndirectionByOffset(indirection_offset);
       break;
     }
   }
 
-  (*index_entry_ptr)->block = location.block;
-  (*index_entry_ptr)->offset = location.offset;
+  index_entry_ptr->block = location.block;
+  index_entry_ptr->offset = location.offset;
 
   if (indirection_offset == INDIRECTION_ARRAY_MAX_SIZE - 1) {
     AddDefaultIndirectionArray(active_indirection_array_id);
   }
 
+  return index_entry_ptr;
+}
+
+/**
+ * @brief Insert a tuple into all indexes. If index is primary/unique,
+ * check visibility of existing
+ * index entries.
+ * @warning This still doesn't guarantee serializability.
+ *
+ * @returns True on success, false if a visible entry exists (in case of
+ *primary/unique).
+ */
+bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
+                                ItemPointer location,
+                                concurrency::TransactionContext *transaction,
+                                ItemPointer **index_entry_ptr) {
+  int index_count = GetIndexCount();
+
+  *index_entry_ptr = AllocateIndirection(location);
+
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
 
@@ -729,6 +1143,70 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
   return true;
 }
 
+/**
+ * @brief Insert a batch into all indexes. Every index receives the batch
+ * sorted by its key, so that consecutive inserts descend the same paths.
+ *
+ * @returns True on success, false if a visible entry exists (in case of
+ *primary/unique).
+ */
+bool DataTable::InsertInIndexes(
+    const std::vector<const storage::Tuple *> &tuples,
+    const std::vector<ItemPointer *> &index_entry_ptrs,
+    concurrency::TransactionContext *transaction) {
+  int index_count = GetIndexCount();
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  std::function<bool(const void *)> fn =
+      std::bind(&concurrency::TransactionManager::IsOccupied,
+                &transaction_manager, transaction, std::placeholders::_1);
+
+  std::vector<std::unique_ptr<storage::Tuple>> keys(tuples.size());
+  std::vector<size_t> key_order(tuples.size());
+
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+    if (index == nullptr) continue;
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+
+    for (size_t itr = 0; itr < tuples.size(); itr++) {
+      keys[itr].reset(new storage::Tuple(index_schema, true));
+      keys[itr]->SetFromTuple(tuples[itr], indexed_columns, index->GetPool());
+      key_order[itr] = itr;
+    }
+    std::stable_sort(key_order.begin(), key_order.end(),
+                     [&keys](const size_t &lhs, const size_t &rhs) {
+                       return keys[lhs]->Compare(*keys[rhs]) < 0;
+                     });
+
+    for (auto itr : key_order) {
+      bool res = true;
+      switch (index->GetIndexType()) {
+        case IndexConstraintType::PRIMARY_KEY:
+        case IndexConstraintType::UNIQUE: {
+          res = index->CondInsertEntry(keys[itr].get(), index_entry_ptrs[itr],
+                                       fn);
+        } break;
+
+        case IndexConstraintType::DEFAULT:
+        default:
+          index->InsertEntry(keys[itr].get(), index_entry_ptrs[itr]);
+          break;
+      }
+
+      if (res == false) {
+        return false;
+      }
+    }
+    LOG_TRACE("Index constraint check on %s passed.", index->GetName().c_str());
+  }
+
+  return true;
+}
+
 bool DataTable::InsertInSecondaryIndexes(
     const AbstractTuple *tuple, const TargetList *targets_ptr,
     concurrency::TransactionContext *transaction,
@@ -921,7 +1399,7 @@ bool DataTable::CheckForeignKeySrcAndCascade(
                   }
                 }
 
-                ItemPointer new_loc = src_table->InsertEmptyVersion();
+                ItemPointer new_loc = src_table->InsertEmptyVersion(*ptr);
 
                 if (new_loc.IsNull()) {
                   if (src_is_owner == false) {
@@ -1121,11 +1599,30 @@ oid_t DataTable::AddDefaultIndirectionArray(
 }
 
 oid_t DataTable::AddDefaultTileGroup() {
-  size_t active_tile_group_id = number_of_tuples_ % active_tilegroup_count_;
-  return AddDefaultTileGroup(active_tile_group_id);
+  return AddDefaultTileGroup(GetInsertLane());
 }
 
 oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
+  // lanes may add tile groups concurrently
+  std::lock_guard<std::mutex> lock(data_table_mutex_);
+  return InstallDefaultTileGroup(active_tile_group_id);
+}
+
+oid_t DataTable::InstallDefaultTileGroup(const size_t &active_tile_group_id) {
+  auto tile_group =
+      CreateDefaultTileGroup(active_tile_group_id / active_tilegroup_count_);
+
+  COMPILER_MEMORY_FENCE;
+
+  active_tile_groups_[active_tile_group_id] = tile_group;
+  insert_lanes_[active_tile_group_id].tile_group.store(
+      tile_group.get(), std::memory_order_release);
+
+  return tile_group->GetTileGroupId();
+}
+
+std::shared_ptr<TileGroup> DataTable::CreateDefaultTileGroup(
+    const size_t &partition) {
   oid_t tile_group_id = INVALID_OID;
 
   // Create a tile group with that partitioning
@@ -1135,6 +1632,12 @@ oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
 
   tile_group_id = tile_group->GetTileGroupId();
 
+  // the partition of the tile group is known before any slot of it is
+  // handed out
+  if (partition != 0) {
+    tile_group_partitions_.Upsert(tile_group_id, partition);
+  }
+
   LOG_TRACE("Added a tile group ");
   tile_groups_.Append(tile_group_id);
 
@@ -1152,7 +1655,6 @@ oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
 
   COMPILER_MEMORY_FENCE;
 
-  active_tile_groups_[active_tile_group_id] = tile_group;
   tile_group_array_.push_back(tile_group.get());
   // we must guarantee that the compiler always add tile group before adding
   // tile_group_count_.
@@ -1166,7 +1668,7 @@ oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
   this->tile_group_id_latest = tile_group_id;
 //  LOG_DEBUG("Recording latest tile group : %u , %p", tile_group_id, &tile_group_latest);
 
-  return tile_group_id;
+  return tile_group;
 }
 
 void DataTable::AddTileGroupWithOidForRecovery(const oid_t &tile_group_id) {
@@ -1213,9 +1715,12 @@ void DataTable::AddTileGroupWithOidForRecovery(const oid_t &tile_group_id) {
 
 // NOTE: This function is only used in test cases.
 void DataTable::AddTileGroup(const std::shared_ptr<TileGroup> &tile_group) {
-  size_t active_tile_group_id = number_of_tuples_ % active_tilegroup_count_;
+  size_t active_tile_group_id = GetInsertLane();
 
+  std::lock_guard<std::mutex> lock(data_table_mutex_);
   active_tile_groups_[active_tile_group_id] = tile_group;
+  insert_lanes_[active_tile_group_id].tile_group.store(
+      tile_group.get(), std::memory_order_release);
 
   oid_t tile_group_id = tile_group->GetTileGroupId();
 
@@ -1242,6 +1747,125 @@ void DataTable::AddTileGroup(const std::shared_ptr<TileGroup> &tile_group) {
 
 size_t DataTable::GetTileGroupCount() const { return tile_group_count_; }
 
+//===--------------------------------------------------------------------===//
+// PARTITIONS
+//===--------------------------------------------------------------------===//
+
+// The lanes of the new partitions are opened on first insert. Updates keep
+// a row in the partition of its old version, an update of the partition key
+// is performed as a delete and an insert (see planner::UpdatePlan). The GC
+// recycles the slots freed in a partition through a queue of its own.
+void DataTable::SetPartitionScheme(
+    std::unique_ptr<PartitionScheme> partition_scheme) {
+  PELOTON_ASSERT(partition_scheme != nullptr);
+  std::lock_guard<std::mutex> lock(data_table_mutex_);
+  if (partition_scheme_ != nullptr || IsClustered() ||
+      GetTupleCount() != 0) {
+    throw Exception(
+        "table " + table_name +
+        " must be empty, not partitioned and not clustered to be partitioned");
+  }
+
+  size_t lane_count =
+      active_tilegroup_count_ * partition_scheme->GetPartitionCount();
+  std::unique_ptr<InsertLane[]> insert_lanes(new InsertLane[lane_count]);
+  for (size_t lane = 0; lane < lane_count; lane++) {
+    insert_lanes[lane].tile_group = nullptr;
+  }
+  // the lanes of the table become those of partition 0, along with the
+  // slots they recycle
+  for (size_t lane = 0; lane < active_tilegroup_count_; lane++) {
+    insert_lanes[lane].tile_group =
+        insert_lanes_[lane].tile_group.load(std::memory_order_acquire);
+    insert_lanes_[lane].free_slot_latch.Lock();
+    insert_lanes[lane].free_slots.swap(insert_lanes_[lane].free_slots);
+    insert_lanes_[lane].free_slot_latch.Unlock();
+  }
+  active_tile_groups_.resize(lane_count);
+  insert_lanes_ = std::move(insert_lanes);
+
+  partition_scheme_ = std::move(partition_scheme);
+  gc::GCManagerFactory::GetInstance().RegisterPartitions(
+      table_oid, partition_scheme_->GetPartitionCount());
+
+  LOG_TRACE("Partitioned table %s: %s", table_name.c_str(),
+            partition_scheme_->GetInfo().c_str());
+}
+
+size_t DataTable::GetTileGroupPartition(const oid_t &tile_group_id) const {
+  if (IsPartitioned() == false) {
+    return 0;
+  }
+  oid_t partition = 0;
+  tile_group_partitions_.Find(tile_group_id, partition);
+  return partition;
+}
+
+//===--------------------------------------------------------------------===//
+// CLUSTERING
+//===--------------------------------------------------------------------===//
+
+// The tile group of the first lane becomes the first page, the other lanes
+// are never opened. A slot is tied to the key range of its page, so the GC
+// hands the slots it frees back to their page instead of queueing them.
+void DataTable::SetClusterKey(const oid_t &key_column_id) {
+  std::lock_guard<std::mutex> lock(data_table_mutex_);
+  if (partition_scheme_ != nullptr || IsClustered() ||
+      GetTupleCount() != 0) {
+    throw Exception(
+        "table " + table_name +
+        " must be empty, not partitioned and not clustered to be clustered");
+  }
+  if (key_column_id >= schema->GetColumnCount()) {
+    throw Exception("invalid cluster key column " +
+                    std::to_string(key_column_id) + " of table " +
+                    table_name);
+  }
+
+  clustered_directory_.reset(
+      new ClusteredDirectory(key_column_id, active_tile_groups_[0]));
+
+  LOG_TRACE("Clustered table %s: %s", table_name.c_str(),
+            clustered_directory_->GetInfo().c_str());
+}
+
+bool DataTable::IsPlacementColumn(const oid_t &column_id) const {
+  return (IsPartitioned() &&
+          partition_scheme_->GetKeyColumnId() == column_id) ||
+         (IsClustered() &&
+          clustered_directory_->GetKeyColumnId() == column_id);
+}
+
+//===--------------------------------------------------------------------===//
+// COMPACTION
+//===--------------------------------------------------------------------===//
+
+// The offsets of the other tile groups do not change, the dropped one is
+// left as a hole in tile_groups_ that scans skip.
+bool DataTable::DropCompactedTileGroup(const oid_t &tile_group_id) {
+  std::lock_guard<std::mutex> lock(data_table_mutex_);
+  for (auto &active_tile_group : active_tile_groups_) {
+    if (active_tile_group != nullptr &&
+        active_tile_group->GetTileGroupId() == tile_group_id) {
+      return false;
+    }
+  }
+
+  auto tile_group_count = tile_groups_.GetSize();
+  for (size_t offset = 0; offset < tile_group_count; offset++) {
+    if (tile_groups_.Find(offset) == tile_group_id) {
+      tile_groups_.Erase(offset, invalid_tile_group_id);
+      storage::StorageManager::GetInstance()->DropTileGroup(
+          table_oid, offset, tile_group_id);
+      sparse_index.Erase(tile_group_id);
+      LOG_TRACE("Dropped compacted tile group %u of table %s", tile_group_id,
+                table_name.c_str());
+      return true;
+    }
+  }
+  return false;
+}
+
 std::shared_ptr<storage::TileGroup> DataTable::GetTileGroup(
     const std::size_t &tile_group_offset) const {
   PELOTON_ASSERT(tile_group_offset < GetTileGroupCount());
@@ -1331,8 +1955,9 @@ std::shared_ptr<index::Index> DataTable::GetIndexWithOid(
   auto index_count = indexes_.GetSize();
 
   for (std::size_t index_itr = 0; index_itr < index_count; index_itr++) {
-    ret_index = indexes_.Find(index_itr);
-    if (ret_index != nullptr && ret_index->GetOid() == index_oid) {
+    auto index = indexes_.Find(index_itr);
+    if (index != nullptr && index->GetOid() == index_oid) {
+      ret_index = index;
       break;
     }
   }
@@ -1344,17 +1969,23 @@ std::shared_ptr<index::Index> DataTable::GetIndexWithOid(
 }
 
 void DataTable::DropIndexWithOid(const oid_t &index_oid) {
-  oid_t index_offset = 0;
+  oid_t index_offset = INVALID_OID;
   std::shared_ptr<index::Index> index;
   auto index_count = indexes_.GetSize();
 
   for (std::size_t index_itr = 0; index_itr < index_count; index_itr++) {
     index = indexes_.Find(index_itr);
     if (index != nullptr && index->GetOid() == index_oid) {
+      index_offset = index_itr;
       break;
     }
   }
 
+  // Already dropped
+  if (index_offset == INVALID_OID) {
+    return;
+  }
+
   PELOTON_ASSERT(index_offset < indexes_.GetSize());
 
   // Drop the index
@@ -0,0 +1,273 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partition_scheme.cpp
+//
+// Identification: src/storage/partition_scheme.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/partition_scheme.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "common/abstract_tuple.h"
+#include "common/exception.h"
+#include "expression/abstract_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+bool ValueLessThan(const type::Value &left, const type::Value &right) {
+  return left.CompareLessThan(right) == CmpBool::CmpTrue;
+}
+
+// the comparison with its operands swapped, e.g. (5 < a) -> (a > 5)
+ExpressionType MirrorComparison(ExpressionType type) {
+  switch (type) {
+    case ExpressionType::COMPARE_LESSTHAN:
+      return ExpressionType::COMPARE_GREATERTHAN;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return ExpressionType::COMPARE_LESSTHAN;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return ExpressionType::COMPARE_LESSTHANOREQUALTO;
+    default:
+      return type;
+  }
+}
+
+}  // namespace
+
+PartitionScheme::PartitionScheme(PartitionType partition_type,
+                                 oid_t key_column_id, type::TypeId key_type,
+                                 size_t partition_count,
+                                 std::vector<type::Value> range_bounds)
+    : partition_type_(partition_type),
+      key_column_id_(key_column_id),
+      key_type_(key_type),
+      partition_count_(partition_type == PartitionType::RANGE
+                           ? range_bounds.size() + 1
+                           : partition_count) {
+  if (partition_type_ == PartitionType::RANGE) {
+    for (auto &bound : range_bounds) {
+      if (bound.IsNull()) {
+        throw Exception("a partition bound cannot be NULL");
+      }
+      range_bounds_.push_back(bound.CastAs(key_type_));
+    }
+    std::sort(range_bounds_.begin(), range_bounds_.end(), ValueLessThan);
+    for (size_t i = 1; i < range_bounds_.size(); i++) {
+      if (range_bounds_[i - 1].CompareEquals(range_bounds_[i]) ==
+          CmpBool::CmpTrue) {
+        throw Exception("duplicate partition bound " +
+                        range_bounds_[i].ToString());
+      }
+    }
+  } else if (partition_type_ != PartitionType::HASH) {
+    throw Exception("invalid partition type " +
+                    PartitionTypeToString(partition_type_));
+  }
+
+  if (partition_count_ == 0) {
+    throw Exception("a partitioned table needs at least one partition");
+  }
+}
+
+size_t PartitionScheme::GetPartition(const type::Value &key) const {
+  if (key.IsNull()) {
+    return 0;
+  }
+
+  if (partition_type_ == PartitionType::HASH) {
+    if (key.GetTypeId() != key_type_) {
+      return key.CastAs(key_type_).Hash() % partition_count_;
+    }
+    return key.Hash() % partition_count_;
+  }
+
+  // # of bounds not above the key
+  auto bound_itr = std::upper_bound(range_bounds_.begin(), range_bounds_.end(),
+                                    key, ValueLessThan);
+  return bound_itr - range_bounds_.begin();
+}
+
+size_t PartitionScheme::GetPartition(const AbstractTuple *tuple) const {
+  return GetPartition(tuple->GetValue(key_column_id_));
+}
+
+std::vector<bool> PartitionScheme::Prune(
+    const expression::AbstractExpression *predicate,
+    const std::vector<type::Value> *params) const {
+  if (predicate == nullptr) {
+    return std::vector<bool>(partition_count_, true);
+  }
+
+  switch (predicate->GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND:
+    case ExpressionType::CONJUNCTION_OR: {
+      auto left = Prune(predicate->GetChild(0), params);
+      auto right = Prune(predicate->GetChild(1), params);
+      bool is_and =
+          predicate->GetExpressionType() == ExpressionType::CONJUNCTION_AND;
+      for (size_t i = 0; i < partition_count_; i++) {
+        left[i] = is_and ? (left[i] && right[i]) : (left[i] || right[i]);
+      }
+      return left;
+    }
+    default:
+      return PruneComparison(predicate, params);
+  }
+}
+
+std::vector<bool> PartitionScheme::PruneComparison(
+    const expression::AbstractExpression *predicate,
+    const std::vector<type::Value> *params) const {
+  std::vector<bool> partitions(partition_count_, true);
+
+  ExpressionType comparison;
+  type::Value key;
+  if (GetKeyComparison(predicate, key_column_id_, params, comparison, key) ==
+      false) {
+    return partitions;
+  }
+
+  // a comparison with NULL is never true
+  if (key.IsNull()) {
+    return std::vector<bool>(partition_count_, false);
+  }
+
+  // values that do not compare with or cast to the key type are not
+  // pruned on
+  size_t partition = 0;
+  try {
+    partition = GetPartition(key);
+  } catch (Exception &e) {
+    return partitions;
+  }
+  if (comparison == ExpressionType::COMPARE_EQUAL) {
+    std::fill(partitions.begin(), partitions.end(), false);
+    partitions[partition] = true;
+    return partitions;
+  }
+
+  // the order of hash partitions says nothing about their keys
+  if (partition_type_ == PartitionType::HASH) {
+    return partitions;
+  }
+
+  size_t low = 0;
+  size_t high = partition_count_ - 1;
+  switch (comparison) {
+    case ExpressionType::COMPARE_LESSTHAN:
+      high = partition;
+      // no key of the partition is below its lower bound
+      if (partition > 0 && range_bounds_[partition - 1].CompareEquals(key) ==
+                               CmpBool::CmpTrue) {
+        high--;
+      }
+      break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      high = partition;
+      break;
+    default:
+      low = partition;
+      break;
+  }
+
+  // NULL keys live in partition 0 but satisfy no comparison. the partition
+  // is kept anyway, it may hold non NULL keys in range.
+  for (size_t i = 0; i < partition_count_; i++) {
+    partitions[i] = (i >= low && i <= high);
+  }
+  return partitions;
+}
+
+bool PartitionScheme::GetKeyComparison(
+    const expression::AbstractExpression *predicate, oid_t key_column_id,
+    const std::vector<type::Value> *params, ExpressionType &comparison,
+    type::Value &value) {
+  comparison = predicate->GetExpressionType();
+  switch (comparison) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      return false;
+  }
+  if (predicate->GetChildrenSize() != 2) {
+    return false;
+  }
+
+  // bring the key column to the left
+  auto key_expr = predicate->GetChild(0);
+  auto value_expr = predicate->GetChild(1);
+  if (key_expr->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    std::swap(key_expr, value_expr);
+    comparison = MirrorComparison(comparison);
+  }
+  if (key_expr->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+      static_cast<const expression::TupleValueExpression *>(key_expr)
+              ->GetColumnId() != static_cast<int>(key_column_id)) {
+    return false;
+  }
+
+  return GetKeyValue(value_expr, params, value);
+}
+
+bool PartitionScheme::GetKeyValue(const expression::AbstractExpression *expr,
+                                  const std::vector<type::Value> *params,
+                                  type::Value &value) {
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::VALUE_CONSTANT:
+      value = static_cast<const expression::ConstantValueExpression *>(expr)
+                  ->GetValue();
+      break;
+    case ExpressionType::VALUE_PARAMETER: {
+      auto value_idx =
+          static_cast<const expression::ParameterValueExpression *>(expr)
+              ->GetValueIdx();
+      if (params == nullptr || value_idx < 0 ||
+          static_cast<size_t>(value_idx) >= params->size()) {
+        return false;
+      }
+      value = (*params)[value_idx];
+      break;
+    }
+    default:
+      return false;
+  }
+
+  return true;
+}
+
+const std::string PartitionScheme::GetInfo() const {
+  std::ostringstream os;
+  os << "PARTITION BY " << PartitionTypeToString(partition_type_)
+     << " (column " << key_column_id_ << ") " << partition_count_
+     << " partitions";
+  if (partition_type_ == PartitionType::RANGE &&
+      range_bounds_.empty() == false) {
+    os << " bounds";
+    for (auto &bound : range_bounds_) {
+      os << " " << bound.ToString();
+    }
+  }
+  return os.str();
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -185,6 +185,21 @@ void StorageManager::DropTileGroup(const oid_t oid) {
   tile_group_locator_.Erase(oid);
 }
 
+void StorageManager::DropTileGroup(oid_t table_id, oid_t tile_group_offset,
+                                   oid_t tile_group_id) {
+  auto tile_group = GetTileGroup(tile_group_id);
+  DropTileGroup(tile_group_id);
+  if (tile_group == nullptr) {
+    return;
+  }
+
+  index::CompactIntsKey<2> key_g_;
+  key_g_.AddInteger(table_id, 0);
+  key_g_.AddInteger(tile_group_offset, sizeof(table_id));
+  tile_group_tree_.erase(key_g_);
+  tile_group_list_.remove(tile_group.get());
+}
+
 std::shared_ptr<storage::TileGroup> StorageManager::GetTileGroup(
     const oid_t oid) {
   std::shared_ptr<storage::TileGroup> location;
@@ -243,7 +258,10 @@ storage::TileGroup *StorageManager::GetTileGroupByBTree(oid_t table_id, oid_t ti
   key_g_h.AddInteger(table_id,0);
   key_g_h.AddInteger(tile_group_offset,sizeof(table_id));
 
-  val = tile_group_tree_.find(key_g_h)->second.get();
+  auto tile_group_itr = tile_group_tree_.find(key_g_h);
+  val = (tile_group_itr != tile_group_tree_.end())
+            ? tile_group_itr->second.get()
+            : nullptr;
 
   return val;
 }
@@ -18,7 +18,7 @@
 #include "common/macros.h"
 #include "type/serializer.h"
 #include "common/internal_types.h"
-#include "type/ephemeral_pool.h"
+#include "type/arena_pool.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/backend_manager.h"
 #include "storage/tile.h"
@@ -53,11 +53,9 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
   tile_size = tuple_count * tuple_length;
 
   // allocate tuple storage space for inlined data
-  // auto &storage_manager = storage::StorageManager::GetInstance();
-  // data = reinterpret_cast<char *>(
-  // storage_manager.Allocate(backend_type, tile_size));
-
-  data = new char[tile_size];
+  auto &backend_manager = storage::BackendManager::GetInstance();
+  data = reinterpret_cast<char *>(
+      backend_manager.Allocate(backend_type, tile_size));
   PELOTON_ASSERT(data != NULL);
 
   // zero out the data
@@ -65,16 +63,14 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
 
   // allocate pool for blob storage if schema not inlined
   // if (schema.IsInlined() == false) {
-  pool = new type::EphemeralPool();
+  pool = new type::ArenaPool();
   //}
 }
 
 Tile::~Tile() {
   // reclaim the tile memory (INLINED data)
-  // auto &storage_manager = storage::StorageManager::GetInstance();
-  // storage_manager.Release(backend_type, data);
-
-  delete[] data;
+  auto &backend_manager = storage::BackendManager::GetInstance();
+  backend_manager.Release(backend_type, data, tile_size);
   data = NULL;
 
   // reclaim the tile memory (UNINLINED data)
@@ -488,8 +484,8 @@ oid_t Tile::GetActiveTupleCount() const {
 
 void Tile::Sync() {
   // Sync the tile data
-  // auto &storage_manager = storage::StorageManager::GetInstance();
-  // storage_manager.Sync(backend_type, data, tile_size);
+  auto &storage_manager = storage::BackendManager::GetInstance();
+  storage_manager.Sync(backend_type, data, tile_size);
 }
 
 //===--------------------------------------------------------------------===//
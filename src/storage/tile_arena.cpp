@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_arena.cpp
+//
+// Identification: src/storage/tile_arena.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sys/mman.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "storage/tile_arena.h"
+
+namespace peloton {
+namespace storage {
+
+const size_t TileArena::HUGE_PAGE_SIZE;
+const size_t TileArena::MIN_BLOCK_SIZE;
+const size_t TileArena::SIZE_CLASS_COUNT;
+const size_t TileArena::REGION_SIZE;
+
+// global singleton. it is never destroyed, since tiles owned by other
+// singletons may be released during static destruction.
+TileArena &TileArena::GetInstance() {
+  static TileArena *tile_arena = new TileArena();
+  return *tile_arena;
+}
+
+TileArena::TileArena()
+    : use_hugetlb_(true), mapped_size_(0), allocated_size_(0) {}
+
+size_t TileArena::GetSizeClass(size_t size) {
+  size_t size_class = 0;
+  while (GetSizeClassSize(size_class) < size) {
+    size_class++;
+  }
+  return size_class;
+}
+
+size_t TileArena::GetSizeClassSize(size_t size_class) {
+  return MIN_BLOCK_SIZE << size_class;
+}
+
+void *TileArena::Allocate(size_t size) {
+  PELOTON_ASSERT(size > 0);
+  allocated_size_ += size;
+
+  // large tiles get a mapping of their own
+  if (size > GetSizeClassSize(SIZE_CLASS_COUNT - 1)) {
+    return Map(size);
+  }
+
+  auto size_class = GetSizeClass(size);
+  auto &pool = pools_[size_class];
+
+  pool.latch.Lock();
+  if (pool.free_blocks.empty() == false) {
+    void *address = pool.free_blocks.back();
+    pool.free_blocks.pop_back();
+    pool.latch.Unlock();
+    return address;
+  }
+  pool.latch.Unlock();
+
+  return Carve(size_class);
+}
+
+void TileArena::Release(void *address, size_t size) {
+  if (address == nullptr) {
+    return;
+  }
+  allocated_size_ -= size;
+
+  if (size > GetSizeClassSize(SIZE_CLASS_COUNT - 1)) {
+    Unmap(address, size);
+    return;
+  }
+
+  auto &pool = pools_[GetSizeClass(size)];
+  pool.latch.Lock();
+  pool.free_blocks.push_back(address);
+  pool.latch.Unlock();
+}
+
+void *TileArena::Carve(size_t size_class) {
+  size_t block_size = GetSizeClassSize(size_class);
+
+  region_latch_.Lock();
+
+  // blocks are aligned to their size, so a 2MB block covers exactly one
+  // huge page
+  auto cursor = reinterpret_cast<uintptr_t>(region_cursor_);
+  cursor = (cursor + block_size - 1) & ~(uintptr_t)(block_size - 1);
+  if (region_cursor_ == nullptr ||
+      cursor + block_size > reinterpret_cast<uintptr_t>(region_end_)) {
+    char *region = nullptr;
+    try {
+      region = reinterpret_cast<char *>(Map(REGION_SIZE));
+    } catch (Exception &e) {
+      region_latch_.Unlock();
+      throw;
+    }
+    // the rest of the previous region is given up
+    regions_.push_back(region);
+    region_cursor_ = region;
+    region_end_ = region + REGION_SIZE;
+    cursor = reinterpret_cast<uintptr_t>(region_cursor_);
+  }
+
+  region_cursor_ = reinterpret_cast<char *>(cursor + block_size);
+  region_latch_.Unlock();
+
+  return reinterpret_cast<void *>(cursor);
+}
+
+void *TileArena::Map(size_t size) {
+  size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+
+#ifdef MAP_HUGETLB
+  // explicit huge pages, only if the system has some reserved
+  if (use_hugetlb_ == true) {
+    void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (address != MAP_FAILED) {
+      mapped_size_ += size;
+      return address;
+    }
+    LOG_DEBUG("No explicit huge pages available, using transparent ones");
+    use_hugetlb_ = false;
+  }
+#endif
+
+  // over-allocate so that the mapping can be aligned to a huge page
+  size_t mapping_size = size + HUGE_PAGE_SIZE;
+  void *mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) {
+    throw Exception("could not map " + std::to_string(size) +
+                    " bytes of tile memory: " + std::strerror(errno));
+  }
+
+  auto begin = reinterpret_cast<uintptr_t>(mapping);
+  auto aligned = (begin + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+  if (aligned != begin) {
+    munmap(mapping, aligned - begin);
+  }
+  size_t tail = (begin + mapping_size) - (aligned + size);
+  if (tail != 0) {
+    munmap(reinterpret_cast<void *>(aligned + size), tail);
+  }
+
+  void *address = reinterpret_cast<void *>(aligned);
+#ifdef MADV_HUGEPAGE
+  if (madvise(address, size, MADV_HUGEPAGE) != 0) {
+    LOG_TRACE("madvise(MADV_HUGEPAGE) failed: %s", std::strerror(errno));
+  }
+#endif
+
+  mapped_size_ += size;
+  return address;
+}
+
+void TileArena::Unmap(void *address, size_t size) {
+  size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+  munmap(address, size);
+  mapped_size_ -= size;
+}
+
+}  // namespace storage
+}  // namespace peloton
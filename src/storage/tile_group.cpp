@@ -162,6 +162,61 @@ oid_t TileGroup::InsertTuple(const Tuple *tuple) {
   return tuple_slot_id;
 }
 
+/**
+ * Grab consecutive slots (thread-safe) and fill in the tuples
+ *
+ * Values are copied a column at a time over the whole batch. Inlined columns
+ * that have the same type in the tuples are copied as raw bytes.
+ */
+oid_t TileGroup::InsertTuples(const std::vector<const Tuple *> &tuples,
+                              const size_t &offset, oid_t &tuple_count) {
+  PELOTON_ASSERT(offset + tuple_count <= tuples.size());
+  oid_t tuple_slot_id = tile_group_header->GetNextEmptyTupleSlots(tuple_count);
+
+  LOG_TRACE("Tile Group Id :: %u status :: %u (+%u) out of %u slots ",
+            tile_group_id, tuple_slot_id, tuple_count, num_tuple_slots_);
+
+  // No more slots
+  if (tuple_slot_id == INVALID_OID) {
+    LOG_TRACE("Failed to get next empty tuple slots within tile group.");
+    return INVALID_OID;
+  }
+
+  oid_t column_itr = 0;
+
+  for (oid_t tile_itr = 0; tile_itr < tile_count_; tile_itr++) {
+    storage::Tile *tile = GetTile(tile_itr);
+    PELOTON_ASSERT(tile);
+    const catalog::Schema *schema = tile->GetSchema();
+    oid_t tile_column_count = schema->GetColumnCount();
+
+    for (oid_t tile_column_itr = 0; tile_column_itr < tile_column_count;
+         tile_column_itr++, column_itr++) {
+      size_t column_offset = schema->GetOffset(tile_column_itr);
+      bool is_inlined = schema->IsInlined(tile_column_itr);
+      type::TypeId column_type = schema->GetType(tile_column_itr);
+
+      for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+        const Tuple *tuple = tuples[offset + tuple_itr];
+        const catalog::Schema *tuple_schema = tuple->GetSchema();
+        char *field_location =
+            tile->GetTupleLocation(tuple_slot_id + tuple_itr) + column_offset;
+
+        if (is_inlined && tuple_schema->IsInlined(column_itr) &&
+            tuple_schema->GetType(column_itr) == column_type) {
+          PELOTON_MEMCPY(field_location, tuple->GetDataPtr(column_itr),
+                         schema->GetLength(tile_column_itr));
+        } else {
+          tile->SetValue(tuple->GetValue(column_itr),
+                         tuple_slot_id + tuple_itr, tile_column_itr);
+        }
+      }
+    }
+  }
+
+  return tuple_slot_id;
+}
+
 /**
  * Grab specific slot and fill in the tuple
  * Used by recovery
@@ -24,12 +24,14 @@ extern peloton::LoggingType peloton_logging_mode;
 namespace peloton {
 namespace storage {
 
+BackendType TileGroupFactory::default_backend_type_ = BackendType::MM;
+
 TileGroup *TileGroupFactory::GetTileGroup(
     oid_t database_id, oid_t table_id, oid_t tile_group_id,
     AbstractTable *table, const std::vector<catalog::Schema> &schemas,
     std::shared_ptr<const Layout> layout, int tuple_count) {
   // Allocate the data on appropriate backend
-  BackendType backend_type = BackendType::MM;
+  BackendType backend_type = default_backend_type_;
       // logging::LoggingUtil::GetBackendType(peloton_logging_mode);
   // Ensure that the layout of the new TileGroup is not null.
   if (layout == nullptr) {
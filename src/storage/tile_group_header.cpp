@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 #include "storage/tile_group_header.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -37,7 +38,14 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
       num_tuple_slots(tuple_count),
       next_tuple_slot(0),
       tile_header_lock() {
-  tuple_headers_.reset(new TupleHeader[tuple_count]);
+  tuple_headers_ = new TupleHeader[tuple_count];
+  compact_headers_ = nullptr;
+  header_mode_ = HeaderMode::FULL;
+  frozen_read_ts_ = INVALID_CID;
+  all_visible_cid_ = MAX_CID;
+  all_visible_count_ = 0;
+  tuple_latches_.reset(new common::synchronization::SpinLatch[tuple_count]);
+  tuple_indirections_.reset(new ItemPointer *[tuple_count]);
 
   // Set MVCC Initial Value
   for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
@@ -55,6 +63,184 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
   immutable = false;
 }
 
+TileGroupHeader::~TileGroupHeader() {
+  delete[] tuple_headers_.load();
+  delete compact_headers_.load();
+}
+
+//===--------------------------------------------------------------------===//
+// Freezing
+//===--------------------------------------------------------------------===//
+
+bool TileGroupHeader::IsFreezable(const TupleHeader &tuple_header,
+                                  ItemPointer *indirection,
+                                  const cid_t &visible_cid) {
+  // a committed version every transaction sees. its next (older) version, if
+  // any, is garbage no transaction reaches.
+  if (tuple_header.txn_id == INITIAL_TXN_ID) {
+    return tuple_header.begin_ts <= visible_cid &&
+           tuple_header.end_ts == MAX_CID && tuple_header.prev.IsNull();
+  }
+  // an empty slot, reset by the garbage collector
+  return tuple_header.txn_id == INVALID_TXN_ID &&
+         tuple_header.begin_ts == MAX_CID && tuple_header.end_ts == MAX_CID &&
+         tuple_header.next.IsNull() && tuple_header.prev.IsNull() &&
+         indirection == nullptr;
+}
+
+bool TileGroupHeader::BeginFreeze(const cid_t &visible_cid) {
+  // a full tile group only gets new tuples in slots recycled by the garbage
+  // collector, and writing them cancels the freeze
+  if (next_tuple_slot < num_tuple_slots ||
+      header_mode_.load() != HeaderMode::FULL) {
+    return false;
+  }
+
+  auto tuple_headers = tuple_headers_.load();
+  for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
+       tuple_slot_id++) {
+    if (IsFreezable(tuple_headers[tuple_slot_id],
+                    tuple_indirections_[tuple_slot_id],
+                    visible_cid) == false) {
+      return false;
+    }
+  }
+
+  auto header_mode = HeaderMode::FULL;
+  return header_mode_.compare_exchange_strong(header_mode,
+                                              HeaderMode::FREEZING);
+}
+
+bool TileGroupHeader::FinishFreeze(const cid_t &visible_cid,
+                                   RetiredTupleHeaders &retired) {
+  freeze_latch_.Lock();
+  if (header_mode_.load() != HeaderMode::FREEZING) {
+    freeze_latch_.Unlock();
+    return false;
+  }
+
+  // no transaction writes the tuple headers while the tile group is freezing,
+  // but tuples may have been deleted and garbage collected meanwhile
+  auto tuple_headers = tuple_headers_.load();
+  std::unique_ptr<CompactTupleHeaders> compact_headers(
+      new CompactTupleHeaders());
+  compact_headers->begin_ts = INVALID_CID;
+  compact_headers->deleted.reset(new uint64_t[(num_tuple_slots + 63) / 64]());
+  cid_t read_ts = INVALID_CID;
+  for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
+       tuple_slot_id++) {
+    auto &tuple_header = tuple_headers[tuple_slot_id];
+    if (IsFreezable(tuple_header, tuple_indirections_[tuple_slot_id],
+                    visible_cid) == false) {
+      header_mode_ = HeaderMode::FULL;
+      freeze_latch_.Unlock();
+      return false;
+    }
+
+    if (tuple_header.txn_id == INVALID_TXN_ID) {
+      compact_headers->deleted[tuple_slot_id / 64] |=
+          UINT64_C(1) << (tuple_slot_id % 64);
+    } else {
+      compact_headers->begin_ts =
+          std::max(compact_headers->begin_ts, tuple_header.begin_ts);
+    }
+    read_ts = std::max(read_ts, tuple_header.read_ts);
+  }
+  RaiseFrozenReadCommitId(read_ts);
+
+  // publish the compact tuple headers before readers can miss the full ones
+  retired.compact_headers.reset(
+      compact_headers_.exchange(compact_headers.release()));
+  header_mode_ = HeaderMode::COMPACT;
+  retired.tuple_headers.reset(tuple_headers_.exchange(nullptr));
+
+  freeze_latch_.Unlock();
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// All visible mark
+//===--------------------------------------------------------------------===//
+
+bool TileGroupHeader::MarkAllVisible() {
+  // writes clear the mark after they are made, so a write that lands while
+  // the tuples are checked makes the final compare and swap fail
+  cid_t visible_cid = MAX_CID;
+  if (all_visible_cid_.compare_exchange_strong(visible_cid, INVALID_CID) ==
+      false) {
+    return false;
+  }
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  oid_t tuple_count = GetCurrentNextTupleSlot();
+  visible_cid = INVALID_CID;
+  for (oid_t tuple_slot_id = START_OID; tuple_slot_id < tuple_count;
+       tuple_slot_id++) {
+    cid_t begin_cid = GetBeginCommitId(tuple_slot_id);
+    if (GetTransactionId(tuple_slot_id) != INITIAL_TXN_ID ||
+        begin_cid == MAX_CID || GetEndCommitId(tuple_slot_id) != MAX_CID) {
+      visible_cid = MAX_CID;
+      break;
+    }
+    visible_cid = std::max(visible_cid, begin_cid);
+  }
+  if (tuple_count == 0) {
+    visible_cid = MAX_CID;
+  }
+
+  all_visible_count_.store(tuple_count, std::memory_order_release);
+  cid_t marking_cid = INVALID_CID;
+  return all_visible_cid_.compare_exchange_strong(marking_cid, visible_cid) &&
+         visible_cid != MAX_CID;
+}
+
+TupleHeader *TileGroupHeader::Thaw() const {
+  freeze_latch_.Lock();
+  switch (header_mode_.load()) {
+    case HeaderMode::FREEZING: {
+      // the write cancels the freeze
+      header_mode_ = HeaderMode::FULL;
+    } break;
+
+    case HeaderMode::COMPACT: {
+      auto compact_headers = compact_headers_.load();
+      auto tuple_headers = new TupleHeader[num_tuple_slots];
+      for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
+           tuple_slot_id++) {
+        auto &tuple_header = tuple_headers[tuple_slot_id];
+        bool deleted = (compact_headers->deleted[tuple_slot_id / 64] >>
+                        (tuple_slot_id % 64)) & 1;
+        tuple_header.txn_id = deleted ? INVALID_TXN_ID : INITIAL_TXN_ID;
+        // frozen_read_ts_ keeps covering the reads of the frozen tile group
+        tuple_header.read_ts = INVALID_CID;
+        tuple_header.begin_ts = deleted ? MAX_CID : compact_headers->begin_ts;
+        tuple_header.end_ts = MAX_CID;
+        tuple_header.next = INVALID_ITEMPOINTER;
+        tuple_header.prev = INVALID_ITEMPOINTER;
+      }
+      // compact_headers_ stay until the next freeze, for readers that still
+      // see the tile group frozen
+      tuple_headers_ = tuple_headers;
+      header_mode_ = HeaderMode::FULL;
+      LOG_TRACE("Thawed tile group header %p", this);
+    } break;
+
+    case HeaderMode::FULL:
+    default:
+      break;
+  }
+  auto tuple_headers = tuple_headers_.load();
+  freeze_latch_.Unlock();
+  return tuple_headers;
+}
+
+void TileGroupHeader::RaiseFrozenReadCommitId(const cid_t &read_cid) const {
+  cid_t read_ts = frozen_read_ts_.load();
+  while (read_ts < read_cid &&
+         frozen_read_ts_.compare_exchange_weak(read_ts, read_cid) == false) {
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // Tile Group Header
 //===--------------------------------------------------------------------===//
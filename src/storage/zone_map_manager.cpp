@@ -64,7 +64,10 @@ void ZoneMapManager::CreateZoneMapsForTable(
   for (size_t i = 0; i < num_tile_groups; i++) {
     auto tile_group = table->GetTileGroup(i);
     auto tile_group_ptr = tile_group.get();
-    PELOTON_ASSERT(tile_group_ptr != nullptr);
+    // dropped after compaction
+    if (tile_group_ptr == nullptr) {
+      continue;
+    }
     auto tile_group_header = tile_group_ptr->GetHeader();
     PELOTON_ASSERT(tile_group_header != nullptr);
     bool immutable = tile_group_header->GetImmutability();
@@ -231,6 +234,11 @@ ZoneMapManager::GetResultVectorAsZoneMap(
 bool ZoneMapManager::ShouldScanTileGroup(
     storage::PredicateInfo *parsed_predicates, int32_t num_predicates,
     storage::DataTable *table, int64_t tile_group_idx) {
+  // dropped after compaction
+  if (table->GetTileGroup(tile_group_idx) == nullptr) {
+    return false;
+  }
+
   for (int32_t i = 0; i < num_predicates; i++) {
     // Extract the col_id, operator and predicate_value
     int col_id = parsed_predicates[i].col_id;
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parallel_for.cpp
+//
+// Identification: src/threadpool/parallel_for.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "threadpool/parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+#include "threadpool/mono_queue_pool.h"
+
+namespace peloton {
+namespace threadpool {
+
+namespace {
+
+// shared with the pool threads, which may only get to run once the
+// caller has returned
+struct ParallelForState {
+  ParallelForState(size_t task_count, const std::function<void(size_t)> &task)
+      : task_count(task_count), task(task) {}
+
+  const size_t task_count;
+  const std::function<void(size_t)> &task;
+
+  // the next task to run
+  std::atomic<size_t> next_task{0};
+
+  std::mutex mutex;
+  std::condition_variable task_done;
+  size_t done_count = 0;
+  std::exception_ptr error;
+};
+
+void RunTasks(ParallelForState &state) {
+  size_t task_id;
+  while ((task_id = state.next_task.fetch_add(1)) < state.task_count) {
+    std::exception_ptr error;
+    try {
+      state.task(task_id);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (error != nullptr && state.error == nullptr) {
+      state.error = error;
+    }
+    if (++state.done_count == state.task_count) {
+      state.task_done.notify_all();
+    }
+  }
+}
+
+}  // namespace
+
+void ParallelFor(size_t task_count, const std::function<void(size_t)> &task) {
+  auto &worker_pool = MonoQueuePool::GetExecutionInstance();
+  size_t helper_count =
+      std::min<size_t>(worker_pool.NumWorkers(), task_count / 2);
+  if (helper_count == 0) {
+    for (size_t task_id = 0; task_id < task_count; task_id++) {
+      task(task_id);
+    }
+    return;
+  }
+
+  // task is only called while the caller waits, a helper that starts later
+  // finds no task left
+  auto state = std::make_shared<ParallelForState>(task_count, task);
+  for (size_t i = 0; i < helper_count; i++) {
+    worker_pool.SubmitTask([state] { RunTasks(*state); });
+  }
+  RunTasks(*state);
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->task_done.wait(
+      lock, [&state] { return state->done_count == state->task_count; });
+  if (state->error != nullptr) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+}  // namespace threadpool
+}  // namespace peloton
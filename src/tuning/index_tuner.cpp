@@ -24,6 +24,7 @@
 #include "index/index_factory.h"
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "tuning/clusterer.h"
 
 namespace peloton {
@@ -51,9 +52,16 @@ void IndexTuner::Start() {
   LOG_INFO("Started index tuner");
 }
 
+// Name prefix of indexes constructed by the tuner
+static const std::string ADHOC_INDEX_PREFIX = "adhoc_index_";
+
+// Largest key that the non-BwTree indexes can hold in a GenericKey
+static const size_t MAX_GENERIC_KEY_SIZE = 256;
+
 // Add an ad-hoc index
-static void AddIndex(storage::DataTable *table,
-                     std::set<oid_t> suggested_index_attrs) {
+static std::shared_ptr<index::Index> AddIndex(
+    storage::DataTable *table, std::set<oid_t> suggested_index_attrs,
+    IndexType index_type = IndexType::BWTREE) {
   // Construct index metadata
   std::vector<oid_t> key_attrs(suggested_index_attrs.size());
   std::copy(suggested_index_attrs.begin(), suggested_index_attrs.end(),
@@ -73,8 +81,8 @@ static void AddIndex(storage::DataTable *table,
   unique = true;
 
   index_metadata = new index::IndexMetadata(
-      "adhoc_index_" + std::to_string(index_oid), index_oid, table->GetOid(),
-      table->GetDatabaseOid(), IndexType::BWTREE,
+      ADHOC_INDEX_PREFIX + std::to_string(index_oid), index_oid,
+      table->GetOid(), table->GetDatabaseOid(), index_type,
       IndexConstraintType::PRIMARY_KEY, tuple_schema, key_schema, key_attrs,
       unique);
 
@@ -89,6 +97,26 @@ static void AddIndex(storage::DataTable *table,
   table->AddIndex(adhoc_index);
 
   LOG_DEBUG("Creating index : %s", index_metadata->GetInfo().c_str());
+
+  return adhoc_index;
+}
+
+// Get the samples that access exactly the given attributes
+static std::vector<tuning::Sample> GetAttributeSamples(
+    const std::vector<tuning::Sample> &samples,
+    const std::set<oid_t> &index_attrs) {
+  std::vector<tuning::Sample> attribute_samples;
+
+  for (auto &sample : samples) {
+    auto columns = sample.GetColumnsAccessed();
+    std::set<oid_t> columns_set(columns.begin(), columns.end());
+
+    if (columns_set == index_attrs) {
+      attribute_samples.push_back(sample);
+    }
+  }
+
+  return attribute_samples;
 }
 
 void IndexTuner::BuildIndex(storage::DataTable *table,
@@ -108,23 +136,33 @@ void IndexTuner::BuildIndex(storage::DataTable *table,
         new storage::Tuple(table_schema, true));
 
     auto tile_group = table->GetTileGroup(index_tile_group_offset);
-    auto tile_group_id = tile_group->GetTileGroupId();
+    // dropped after compaction, nothing to index
+    if (tile_group == nullptr) {
+      index->IncrementIndexedTileGroupOffset();
+      index_tile_group_offset++;
+      continue;
+    }
     oid_t active_tuple_count = tile_group->GetNextTupleSlot();
 
+    auto tile_group_header = tile_group->GetHeader();
+
     for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      // Index entries point to the version chain's indirection,
+      // skip slots that were never committed
+      auto location = tile_group_header->GetIndirection(tuple_id);
+      if (location == nullptr) {
+        continue;
+      }
+
       // Setup container tuple
       ContainerTuple<storage::TileGroup> container_tuple(tile_group.get(),
                                                          tuple_id);
 
-      // Set the location
-      ItemPointer location(tile_group_id, tuple_id);
-
       // Set the key
       key->SetFromTuple(&container_tuple, indexed_columns, index->GetPool());
 
       // Insert in specific index
-      // TODO: Allocate itempointer ?
-      index->InsertEntry(key.get(), &location);
+      index->InsertEntry(key.get(), location);
     }
 
     // Update indexed tile group offset (set of tgs indexed)
@@ -138,6 +176,103 @@ void IndexTuner::BuildIndex(storage::DataTable *table,
 }
 
 void IndexTuner::BuildIndices(storage::DataTable *table) {
+  auto table_oid = table->GetOid();
+
+  // Go over the replacement indexes of this table
+  auto rebuild_itr = pending_rebuilds_.lower_bound(std::make_pair(table_oid, 0));
+  while (rebuild_itr != pending_rebuilds_.end() &&
+         rebuild_itr->first.first == table_oid) {
+    auto new_index_oid = rebuild_itr->first.second;
+    auto old_index_oid = rebuild_itr->second;
+
+    // Get index, the replacement may have been dropped in the meantime
+    std::shared_ptr<index::Index> index;
+    try {
+      index = table->GetIndexWithOid(new_index_oid);
+    } catch (CatalogException &e) {
+      rebuild_itr = pending_rebuilds_.erase(rebuild_itr);
+      continue;
+    }
+
+    // Build index
+    BuildIndex(table, index);
+
+    // Not done yet, continue in the next iteration
+    if (index->GetIndexedTileGroupOff() < table->GetTileGroupCount()) {
+      ++rebuild_itr;
+      continue;
+    }
+
+    // Swap in the replacement
+    auto index_metadata = index->GetMetadata();
+    index_metadata->SetVisibility(true);
+    table->DropIndexWithOid(old_index_oid);
+
+    LOG_INFO("Rebuilt index %s as %s", index_metadata->GetName().c_str(),
+             IndexTypeToString(index_metadata->GetIndexType()).c_str());
+
+    rebuild_itr = pending_rebuilds_.erase(rebuild_itr);
+  }
+}
+
+IndexType IndexTuner::ChooseIndexType(
+    const catalog::Schema *key_schema,
+    const std::vector<tuning::Sample> &samples) const {
+  if (index_type_selection == false) {
+    return IndexType::BWTREE;
+  }
+
+  // Only the BwTree falls back to a TupleKey for wide keys
+  if (key_schema->GetLength() > MAX_GENERIC_KEY_SIZE) {
+    return IndexType::BWTREE;
+  }
+
+  double total_read_weight = 0;
+  double total_write_weight = 0;
+  double total_point_weight = 0;
+  double total_range_weight = 0;
+
+  // Go over all samples
+  for (auto &sample : samples) {
+    if (sample.GetSampleType() == SampleType::UPDATE) {
+      total_write_weight += sample.GetWeight();
+      continue;
+    }
+
+    total_read_weight += sample.GetWeight();
+    if (sample.GetAccessType() == SampleAccessType::POINT) {
+      total_point_weight += sample.GetWeight();
+    } else if (sample.GetAccessType() == SampleAccessType::RANGE) {
+      total_range_weight += sample.GetWeight();
+    }
+  }
+
+  // Nothing known about the access pattern
+  auto total_access_weight = total_point_weight + total_range_weight;
+  if (total_access_weight == 0) {
+    return IndexType::BWTREE;
+  }
+
+  // Write-heavy: the delta chains absorb concurrent updates without latches
+  auto write_ratio =
+      total_write_weight / (total_read_weight + total_write_weight);
+  if (write_ratio > index_type_write_ratio_threshold) {
+    return IndexType::BWTREE;
+  }
+
+  // Range-heavy: dense sorted leaves make scans cheap
+  auto range_ratio = total_range_weight / total_access_weight;
+  if (range_ratio > range_ratio_threshold) {
+    return IndexType::BPLUSTREE;
+  }
+
+  // Point-heavy: the radix tree resolves a lookup in one pass over the key
+  return IndexType::ART;
+}
+
+void IndexTuner::RebuildIndexes(storage::DataTable *table,
+                                const std::vector<tuning::Sample> &samples) {
+  auto table_oid = table->GetOid();
   oid_t index_count = table->GetIndexCount();
 
   for (oid_t index_itr = 0; index_itr < index_count; index_itr++) {
@@ -147,8 +282,67 @@ void IndexTuner::BuildIndices(storage::DataTable *table) {
       continue;
     }
 
-    // Build index
-    // BuildIndex(table, index);
+    // Only ad-hoc indexes are owned by the tuner
+    auto index_metadata = index->GetMetadata();
+    if (index_metadata->GetName().compare(0, ADHOC_INDEX_PREFIX.size(),
+                                          ADHOC_INDEX_PREFIX) != 0) {
+      continue;
+    }
+
+    // Skip indexes that are being rebuilt or are a replacement
+    auto index_oid = index->GetOid();
+    auto index_key = std::make_pair(table_oid, index_oid);
+    bool rebuilding = (pending_rebuilds_.count(index_key) != 0);
+    for (auto &pending_rebuild : pending_rebuilds_) {
+      if (pending_rebuild.first.first == table_oid &&
+          pending_rebuild.second == index_oid) {
+        rebuilding = true;
+      }
+    }
+    if (rebuilding == true) {
+      continue;
+    }
+
+    auto index_attrs = table->GetIndexAttrs(index_itr);
+    auto index_samples = GetAttributeSamples(samples, index_attrs);
+    if (index_samples.empty()) {
+      continue;
+    }
+
+    auto current_index_type = index_metadata->GetIndexType();
+    auto preferred_index_type =
+        ChooseIndexType(index->GetKeySchema(), index_samples);
+
+    // Require consecutive agreement to avoid flapping between structures
+    if (preferred_index_type == current_index_type) {
+      index_type_votes_.erase(index_key);
+      continue;
+    }
+
+    auto &votes = index_type_votes_[index_key];
+    if (votes.first != preferred_index_type) {
+      votes = std::make_pair(preferred_index_type, 0);
+    }
+    votes.second++;
+
+    if (votes.second < index_type_switch_threshold) {
+      continue;
+    }
+    index_type_votes_.erase(index_key);
+
+    // Construct the replacement, invisible until it is fully built
+    auto new_index = AddIndex(table, index_attrs, preferred_index_type);
+    auto new_index_metadata = new_index->GetMetadata();
+    new_index_metadata->SetUtility(index_metadata->GetUtility());
+    new_index_metadata->SetVisibility(false);
+
+    pending_rebuilds_[std::make_pair(table_oid, new_index->GetOid())] =
+        index_oid;
+
+    LOG_INFO("Rebuilding index %s : %s -> %s",
+             index_metadata->GetName().c_str(),
+             IndexTypeToString(current_index_type).c_str(),
+             IndexTypeToString(preferred_index_type).c_str());
   }
 }
 
@@ -327,7 +521,8 @@ void IndexTuner::DropIndexes(storage::DataTable *table) {
 
 void IndexTuner::AddIndexes(
     storage::DataTable *table,
-    const std::vector<std::vector<double>> &suggested_indices) {
+    const std::vector<std::vector<double>> &suggested_indices,
+    const std::vector<tuning::Sample> &samples) {
   oid_t valid_index_count = table->GetValidIndexCount();
   size_t constructed_index_itr = 0;
 
@@ -364,7 +559,15 @@ void IndexTuner::AddIndexes(
       LOG_TRACE("Did not find suggested index.");
 
       // Add adhoc index with given utility
-      AddIndex(table, suggested_index_set);
+      auto tuple_schema = table->GetSchema();
+      std::vector<oid_t> key_attrs(suggested_index_set.begin(),
+                                   suggested_index_set.end());
+      std::unique_ptr<catalog::Schema> key_schema(
+          catalog::Schema::CopySchema(tuple_schema, key_attrs));
+      auto index_type = ChooseIndexType(
+          key_schema.get(), GetAttributeSamples(samples, suggested_index_set));
+
+      AddIndex(table, suggested_index_set, index_type);
       constructed_index_itr++;
     }
     // Found suggested index, enable it
@@ -481,7 +684,12 @@ void IndexTuner::Analyze(storage::DataTable *table) {
   }
 
   // Add indexes if needed
-  AddIndexes(table, suggested_indices);
+  AddIndexes(table, suggested_indices, samples);
+
+  // Rebuild indexes whose structure no longer fits the workload
+  if (visibility_mode_ == false) {
+    RebuildIndexes(table, samples);
+  }
 
   // Update index utility
   if (visibility_mode_ == false) {
@@ -568,11 +776,15 @@ void IndexTuner::AddTable(storage::DataTable *table) {
     std::lock_guard<std::mutex> lock(index_tuner_mutex);
     tables.push_back(table);
   }
+  table->SetIndexSampling(true);
 }
 
 void IndexTuner::ClearTables() {
   {
     std::lock_guard<std::mutex> lock(index_tuner_mutex);
+    for (auto table : tables) {
+      table->SetIndexSampling(false);
+    }
     tables.clear();
   }
 }
@@ -0,0 +1,207 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena_pool.cpp
+//
+// Identification: src/type/arena_pool.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/arena_pool.h"
+
+#include <algorithm>
+#include <new>
+
+namespace peloton {
+namespace type {
+
+const size_t ArenaPool::MIN_BLOCK_SIZE;
+const uint32_t ArenaPool::SIZE_CLASS_COUNT;
+const uint32_t ArenaPool::NO_SIZE_CLASS;
+const size_t ArenaPool::MIN_CHUNK_SIZE;
+const size_t ArenaPool::MAX_CHUNK_SIZE;
+
+ArenaPool::ArenaPool(bool reuse_freed_blocks)
+    : reuse_freed_blocks_(reuse_freed_blocks),
+      current_chunk_(nullptr),
+      chunk_size_(0) {
+  for (auto &free_list : free_lists_) {
+    free_list.block_count = 0;
+  }
+}
+
+ArenaPool::~ArenaPool() {
+  auto chunk = chunks_;
+  while (chunk != nullptr) {
+    auto next = chunk->next;
+    chunk->~Chunk();
+    delete[] reinterpret_cast<char *>(chunk);
+    chunk = next;
+  }
+
+  auto large_block = large_blocks_;
+  while (large_block != nullptr) {
+    auto next = large_block->next;
+    large_block->~LargeBlock();
+    delete[] reinterpret_cast<char *>(large_block);
+    large_block = next;
+  }
+}
+
+uint32_t ArenaPool::GetSizeClass(size_t size) {
+  uint32_t size_class = 0;
+  while (size_class < SIZE_CLASS_COUNT &&
+         (MIN_BLOCK_SIZE << size_class) < size) {
+    size_class++;
+  }
+  return size_class;
+}
+
+void *ArenaPool::Allocate(size_t size) {
+  uint32_t size_class = GetSizeClass(size);
+
+  if (reuse_freed_blocks_ == true && size_class != NO_SIZE_CLASS) {
+    auto block = TakeFreeBlock(size_class);
+    if (block != nullptr) {
+      return block;
+    }
+  }
+
+  // blocks of a size class are rounded up to the class, so that a freed
+  // block fits any later request of the class
+  size_t block_size =
+      (size_class != NO_SIZE_CLASS) ? (MIN_BLOCK_SIZE << size_class) : size;
+  block_size = sizeof(BlockHeader) +
+               ((block_size + sizeof(BlockHeader) - 1) &
+                ~(sizeof(BlockHeader) - 1));
+
+  char *block = nullptr;
+  if (size_class == NO_SIZE_CLASS) {
+    block = AllocateLarge(block_size);
+  } else {
+    while (true) {
+      auto chunk = current_chunk_.load(std::memory_order_acquire);
+      if (chunk != nullptr) {
+        auto offset = chunk->used.fetch_add(block_size,
+                                            std::memory_order_relaxed);
+        if (offset + block_size <= chunk->capacity) {
+          block = chunk->GetData() + offset;
+          break;
+        }
+      }
+      Grow(chunk, block_size);
+    }
+  }
+
+  auto header = reinterpret_cast<BlockHeader *>(block);
+  header->size_class = size_class;
+  return block + sizeof(BlockHeader);
+}
+
+void ArenaPool::Free(void *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  auto block = reinterpret_cast<char *>(ptr) - sizeof(BlockHeader);
+  auto size_class = reinterpret_cast<BlockHeader *>(block)->size_class;
+  // large blocks are not kept around, whether or not freed blocks are
+  // reused. a tile lives as long as its table and would hold on to every
+  // large value it ever stored
+  if (size_class == NO_SIZE_CLASS) {
+    FreeLarge(block);
+    return;
+  }
+
+  if (reuse_freed_blocks_ == false) {
+    return;
+  }
+
+  auto &free_list = free_lists_[size_class];
+  free_list.latch.Lock();
+  free_list.blocks.push_back(reinterpret_cast<char *>(ptr));
+  free_list.block_count.store(free_list.blocks.size(),
+                              std::memory_order_release);
+  free_list.latch.Unlock();
+}
+
+char *ArenaPool::TakeFreeBlock(uint32_t size_class) {
+  auto &free_list = free_lists_[size_class];
+  // only take the latch when there is something to take
+  if (free_list.block_count.load(std::memory_order_acquire) == 0) {
+    return nullptr;
+  }
+
+  char *block = nullptr;
+  free_list.latch.Lock();
+  if (free_list.blocks.empty() == false) {
+    block = free_list.blocks.back();
+    free_list.blocks.pop_back();
+    free_list.block_count.store(free_list.blocks.size(),
+                                std::memory_order_release);
+  }
+  free_list.latch.Unlock();
+  return block;
+}
+
+void ArenaPool::Grow(Chunk *full_chunk, size_t block_size) {
+  chunk_latch_.Lock();
+  if (current_chunk_.load(std::memory_order_acquire) != full_chunk) {
+    chunk_latch_.Unlock();
+    return;
+  }
+
+  // chunks double in size up to MAX_CHUNK_SIZE
+  size_t capacity = (full_chunk == nullptr)
+                        ? MIN_CHUNK_SIZE
+                        : std::min(full_chunk->capacity * 2, MAX_CHUNK_SIZE);
+  capacity = std::max(capacity, block_size);
+
+  auto memory = new char[sizeof(Chunk) + capacity];
+  auto chunk = new (memory) Chunk(chunks_, capacity);
+  chunks_ = chunk;
+  chunk_size_ += capacity;
+
+  current_chunk_.store(chunk, std::memory_order_release);
+  chunk_latch_.Unlock();
+}
+
+char *ArenaPool::AllocateLarge(size_t block_size) {
+  auto memory = new char[sizeof(LargeBlock) + block_size];
+
+  large_block_latch_.Lock();
+  auto large_block = new (memory) LargeBlock(large_blocks_, block_size);
+  if (large_blocks_ != nullptr) {
+    large_blocks_->prev = large_block;
+  }
+  large_blocks_ = large_block;
+  large_block_latch_.Unlock();
+  chunk_size_ += block_size;
+
+  return memory + sizeof(LargeBlock);
+}
+
+void ArenaPool::FreeLarge(char *block) {
+  auto large_block = reinterpret_cast<LargeBlock *>(block - sizeof(LargeBlock));
+
+  large_block_latch_.Lock();
+  if (large_block->prev != nullptr) {
+    large_block->prev->next = large_block->next;
+  } else {
+    large_blocks_ = large_block->next;
+  }
+  if (large_block->next != nullptr) {
+    large_block->next->prev = large_block->prev;
+  }
+  large_block_latch_.Unlock();
+  chunk_size_ -= large_block->size;
+
+  large_block->~LargeBlock();
+  delete[] reinterpret_cast<char *>(large_block);
+}
+
+}  // namespace type
+}  // namespace peloton
@@ -3,6 +3,8 @@
 
 #include <atomic>
 #include <array>
+#include <limits>
+#include <thread>
 
 #include "libcuckoo/cuckoohash_map.hh"
 
@@ -41,12 +43,28 @@ class DeletionList {
   LabelDelete *freeLabelDeletes = nullptr;
   std::size_t deletitionListCount = 0;
 
+  // Protects the list against the owning thread and an external GC thread
+  // (see Epoch::cleanupAll()) working on it at the same time
+  std::atomic<bool> latch{false};
+
  public:
-  std::atomic<uint64_t> localEpoch;
+  std::atomic<uint64_t> localEpoch{std::numeric_limits<uint64_t>::max()};
   size_t thresholdCounter{0};
 
   ~DeletionList();
 
+  void lock() {
+    while (latch.exchange(true, std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+
+  void unlock() { latch.store(false, std::memory_order_release); }
+
+  /// Free all garbage older than the given epoch, returning the number of
+  /// freed objects. The caller must hold the latch.
+  std::size_t freeOlderThan(uint64_t oldestEpoch);
+
   LabelDelete *head();
 
   void add(void *n, Deleter deleter_func, uint64_t globalEpoch);
@@ -84,6 +102,9 @@ class Epoch {
   friend class ThreadInfo;
   std::atomic<uint64_t> currentEpoch{0};
 
+  // Number of objects marked for deletion but not yet freed, over all threads
+  std::atomic<uint64_t> pendingCount{0};
+
   // A container mapping all threads to their garbage
   cuckoohash_map<std::thread::id, DeletionList *> deletionLists;
 
@@ -102,6 +123,14 @@ class Epoch {
 
   void exitEpochAndCleanup(ThreadInfo &threadInfo);
 
+  /// Advance the epoch and free the garbage of all threads that no thread can
+  /// still observe. Safe to call from any thread, including one that never
+  /// operated on the tree. Returns the number of freed objects.
+  std::size_t cleanupAll();
+
+  /// Whether there is garbage waiting to be freed
+  bool hasGarbage() const { return pendingCount.load() != 0; }
+
   void showDeleteRatio();
 
   DeletionList &getDeletionList();
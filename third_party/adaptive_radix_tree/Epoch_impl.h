@@ -63,10 +63,33 @@ void DeletionList::add(void *n, Deleter deleter_func, uint64_t globalEpoch) {
 
 LabelDelete *DeletionList::head() { return headDeletionList; }
 
+std::size_t DeletionList::freeOlderThan(uint64_t oldestEpoch) {
+  std::size_t freed = 0;
+  LabelDelete *cur = head(), *next, *prev = nullptr;
+  while (cur != nullptr) {
+    next = cur->next;
+
+    if (cur->epoch < oldestEpoch) {
+      for (std::size_t i = 0; i < cur->nodesCount; ++i) {
+        cur->nodes[i].Delete();
+      }
+      freed += cur->nodesCount;
+      remove(cur, prev);
+    } else {
+      prev = cur;
+    }
+    cur = next;
+  }
+  return freed;
+}
+
 void Epoch::enterEpoch(ThreadInfo &threadInfo) {
   unsigned long curEpoch = currentEpoch.load(std::memory_order_relaxed);
+  // This store must be visible to a concurrent cleanupAll() before this thread
+  // reads any node, hence sequential consistency (a release store could be
+  // reordered after the subsequent loads)
   threadInfo.getDeletionList().localEpoch.store(curEpoch,
-                                                std::memory_order_release);
+                                                std::memory_order_seq_cst);
 }
 
 namespace {
@@ -81,8 +104,12 @@ void Epoch::markNodeForDeletion(void *n, ThreadInfo &threadInfo) {
 
 void Epoch::markNodeForDeletion(void *n, Deleter deleter_func,
                                 ThreadInfo &threadInfo) {
-  threadInfo.getDeletionList().add(n, deleter_func, currentEpoch.load());
-  threadInfo.getDeletionList().thresholdCounter++;
+  DeletionList &deletionList = threadInfo.getDeletionList();
+  deletionList.lock();
+  deletionList.add(n, deleter_func, currentEpoch.load());
+  pendingCount.fetch_add(1);
+  deletionList.unlock();
+  deletionList.thresholdCounter++;
 }
 
 void Epoch::exitEpochAndCleanup(ThreadInfo &threadInfo) {
@@ -91,7 +118,10 @@ void Epoch::exitEpochAndCleanup(ThreadInfo &threadInfo) {
     currentEpoch++;
   }
   if (deletionList.thresholdCounter > startGCThreshhold) {
-    if (deletionList.size() == 0) {
+    deletionList.lock();
+    bool empty = (deletionList.size() == 0);
+    deletionList.unlock();
+    if (empty) {
       deletionList.thresholdCounter = 0;
       return;
     }
@@ -109,22 +139,38 @@ void Epoch::exitEpochAndCleanup(ThreadInfo &threadInfo) {
       }
     }
 
-    LabelDelete *cur = deletionList.head(), *next, *prev = nullptr;
-    while (cur != nullptr) {
-      next = cur->next;
+    deletionList.lock();
+    pendingCount.fetch_sub(deletionList.freeOlderThan(oldestEpoch));
+    deletionList.unlock();
+    deletionList.thresholdCounter = 0;
+  }
+}
 
-      if (cur->epoch < oldestEpoch) {
-        for (std::size_t i = 0; i < cur->nodesCount; ++i) {
-          cur->nodes[i].Delete();
-        }
-        deletionList.remove(cur, prev);
-      } else {
-        prev = cur;
-      }
-      cur = next;
+std::size_t Epoch::cleanupAll() {
+  // Garbage marked from now on carries a newer epoch than anything a thread
+  // entering afterwards can observe
+  currentEpoch++;
+
+  std::size_t freed = 0;
+  auto locked_table = deletionLists.lock_table();
+
+  uint64_t oldestEpoch = std::numeric_limits<uint64_t>::max();
+  for (auto &iter : locked_table) {
+    auto e = iter.second->localEpoch.load();
+    if (e < oldestEpoch) {
+      oldestEpoch = e;
     }
-    deletionList.thresholdCounter = 0;
   }
+
+  for (auto &iter : locked_table) {
+    auto *deletionList = iter.second;
+    deletionList->lock();
+    freed += deletionList->freeOlderThan(oldestEpoch);
+    deletionList->unlock();
+  }
+
+  pendingCount.fetch_sub(freed);
+  return freed;
 }
 
 Epoch::~Epoch() {
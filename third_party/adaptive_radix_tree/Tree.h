@@ -53,6 +53,13 @@ class Tree {
 
   void setLoadKeyFunc(LoadKeyFunction loadKey, void *ctx);
 
+  /// Whether there are unlinked nodes waiting to be reclaimed
+  bool needGC() const { return epoch.hasGarbage(); }
+
+  /// Reclaim all unlinked nodes that no concurrent operation can still
+  /// reference. Returns the number of reclaimed nodes.
+  std::size_t performGC() { return epoch.cleanupAll(); }
+
  private:
   // Class to help loading the key for a given TID
   class KeyLoader {